@@ -0,0 +1,85 @@
+"""
+GTSAM Copyright 2010-2019, Georgia Tech Research Corporation,
+Atlanta, Georgia 30332-0415
+All Rights Reserved
+Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+See LICENSE for the license information
+
+Solve independent pose graphs on several Python threads.
+The optimizers release the GIL while they run, so the wall-clock time
+drops with the number of threads, up to the number of cores.
+"""
+# pylint: disable=invalid-name, E1101
+
+from __future__ import print_function
+
+import argparse
+import math
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+import gtsam
+from gtsam.utils.concurrent import optimize_async
+
+
+def pose_graph(n, seed):
+    """A noisy Pose2 chain of n poses around a circle, with loop closures."""
+    rng = np.random.RandomState(seed)
+    odometry = gtsam.noiseModel_Diagonal.Sigmas(np.array([0.1, 0.1, 0.05]))
+    graph = gtsam.NonlinearFactorGraph()
+    initial = gtsam.Values()
+    graph.add(gtsam.PriorFactorPose2(
+        0, gtsam.Pose2(), gtsam.noiseModel_Isotropic.Sigma(3, 0.01)))
+    step = gtsam.Pose2(1.0, 0.0, 2 * math.pi / 100)
+    pose = gtsam.Pose2()
+    for i in range(n):
+        noise = rng.normal(0, [0.1, 0.1, 0.02])
+        initial.insert(i, pose.compose(gtsam.Pose2(*noise)))
+        pose = pose.compose(step)
+        if i > 0:
+            graph.add(gtsam.BetweenFactorPose2(i - 1, i, step, odometry))
+        if i >= 100:
+            graph.add(gtsam.BetweenFactorPose2(
+                i - 100, i, gtsam.Pose2(), odometry))
+    return graph, initial
+
+
+def solve_all(problems, threads):
+    """Optimize all problems with the given number of threads, return seconds."""
+    start = time.time()
+    with ThreadPoolExecutor(max_workers=threads) as executor:
+        futures = [optimize_async(gtsam.LevenbergMarquardtOptimizer(
+            graph, initial), executor) for graph, initial in problems]
+        for future in futures:
+            future.result()
+    return time.time() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time independent solves on 1..N threads.")
+    parser.add_argument('-p', '--problems', type=int, default=8,
+                        help="number of independent pose graphs")
+    parser.add_argument('-n', '--poses', type=int, default=2000,
+                        help="number of poses per graph")
+    parser.add_argument('-t', '--threads', type=int, default=4,
+                        help="maximum number of threads")
+    args = parser.parse_args()
+
+    problems = [pose_graph(args.poses, seed) for seed in range(args.problems)]
+    serial = solve_all(problems, 1)
+    print("threads  seconds  speedup")
+    print("{:7d}  {:7.3f}  {:7.2f}".format(1, serial, 1.0))
+    threads = 2
+    while threads <= args.threads:
+        elapsed = solve_all(problems, threads)
+        print("{:7d}  {:7.3f}  {:7.2f}".format(
+            threads, elapsed, serial / elapsed))
+        threads *= 2
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,60 @@
+"""
+GTSAM Copyright 2010-2019, Georgia Tech Research Corporation,
+Atlanta, Georgia 30332-0415
+All Rights Reserved
+
+See LICENSE for the license information
+
+Unit tests for the bulk accessors in utilities.
+"""
+# pylint: disable=invalid-name, E1101, E0611
+import unittest
+
+import numpy as np
+
+import gtsam
+from gtsam import Pose2, Pose3, Rot3, Values, VectorValues
+from gtsam.utils.test_case import GtsamTestCase
+
+
+class TestUtilities(GtsamTestCase):
+
+    def test_pose3s(self):
+        keys = gtsam.createKeyVector(np.array([3, 1, 2]))
+        poses = np.zeros((3, 12), order='F')
+        for j in range(3):
+            R = Rot3.Rz(0.1 * j).matrix()
+            poses[j, :9] = R.flatten()
+            poses[j, 9:] = [j, 2 * j, 3 * j]
+
+        values = Values()
+        gtsam.insertPose3s(values, keys, poses)
+        self.gtsamAssertEquals(values.atPose3(1), Pose3(Rot3.Rz(0.1), gtsam.Point3(1, 2, 3)))
+        np.testing.assert_allclose(gtsam.extractPose3(values, keys), poses)
+
+    def test_pose2s(self):
+        keys = gtsam.createKeyVector(np.array([5, 7]))
+        poses = np.array([[1., 2., 0.3], [4., 5., -0.6]], order='F')
+        values = Values()
+        gtsam.insertPose2s(values, keys, poses)
+        self.gtsamAssertEquals(values.atPose2(7), Pose2(4, 5, -0.6))
+        np.testing.assert_allclose(gtsam.extractPose2(values, keys), poses)
+
+    def test_vectors(self):
+        keys = gtsam.createKeyVector(np.array([0, 1]))
+        vectors = np.array([[1., 2., 3.], [4., 5., 6.]], order='F')
+        x = VectorValues()
+        gtsam.insertVectors(x, keys, vectors)
+        np.testing.assert_allclose(x.at(1), vectors[1])
+        np.testing.assert_allclose(gtsam.extractVectors(x, keys), vectors)
+
+    def test_jacobian_block(self):
+        A1 = np.array([[1., 2.], [3., 4.]], order='F')
+        A2 = np.array([[5., 6., 7.], [8., 9., 10.]], order='F')
+        factor = gtsam.JacobianFactor(0, A1, 1, A2, np.zeros(2),
+                                      gtsam.noiseModel_Unit.Create(2))
+        np.testing.assert_allclose(gtsam.extractJacobianBlock(factor, 1), A2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,57 @@
+"""
+GTSAM Copyright 2010-2019, Georgia Tech Research Corporation,
+Atlanta, Georgia 30332-0415
+All Rights Reserved
+
+See LICENSE for the license information
+
+Unit tests for optimizations on Python threads.
+"""
+# pylint: disable=invalid-name, no-name-in-module
+
+from __future__ import print_function
+
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+
+import gtsam
+from gtsam import (ISAM2, LevenbergMarquardtOptimizer, NonlinearFactorGraph,
+                   Point2, PriorFactorPoint2, Values)
+from gtsam.utils.concurrent import optimize_async, update_async
+from gtsam.utils.test_case import GtsamTestCase
+
+
+def problem(x):
+    """A prior on Point2 key 1 at (x, x), with the estimate at the origin."""
+    graph = NonlinearFactorGraph()
+    graph.add(PriorFactorPoint2(1, Point2(x, x),
+                                gtsam.noiseModel_Unit.Create(2)))
+    initial = Values()
+    initial.insert(1, Point2(0, 0))
+    return graph, initial
+
+
+class TestConcurrent(GtsamTestCase):
+
+    def test_optimize_async(self):
+        """Solve independent problems on several threads."""
+        with ThreadPoolExecutor(max_workers=3) as executor:
+            futures = []
+            for i in range(6):
+                graph, initial = problem(i)
+                optimizer = LevenbergMarquardtOptimizer(graph, initial)
+                futures.append(optimize_async(optimizer, executor))
+            for i, future in enumerate(futures):
+                self.gtsamAssertEquals(
+                    future.result().atPoint2(1), Point2(i, i), 1e-6)
+
+    def test_update_async(self):
+        graph, initial = problem(2)
+        isam = ISAM2()
+        update_async(isam, graph, initial).result()
+        self.gtsamAssertEquals(
+            isam.calculateEstimate().atPoint2(1), Point2(2, 2), 1e-6)
+
+
+if __name__ == "__main__":
+    unittest.main()
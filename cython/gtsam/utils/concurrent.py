@@ -0,0 +1,48 @@
+"""
+GTSAM Copyright 2010-2019, Georgia Tech Research Corporation,
+Atlanta, Georgia 30332-0415
+All Rights Reserved
+
+See LICENSE for the license information
+
+Run optimizations on Python threads.
+The wrapped optimize/update methods release the GIL while they run in C++,
+so solves on different threads proceed in parallel.
+Objects shared between threads still need to be protected by the caller:
+do not modify a graph or Values while a solve that uses it is running.
+"""
+# pylint: disable=invalid-name
+
+# On Python 2, concurrent.futures comes from the futures backport, and without
+# absolute imports this module would shadow it
+from __future__ import absolute_import
+
+from concurrent.futures import ThreadPoolExecutor
+
+_default_executor = None
+
+
+def _executor(executor):
+    global _default_executor  # pylint: disable=global-statement
+    if executor is not None:
+        return executor
+    if _default_executor is None:
+        _default_executor = ThreadPoolExecutor(max_workers=4)
+    return _default_executor
+
+
+def optimize_async(optimizer, executor=None):
+    """
+    Start optimizer.optimize() on a worker thread.
+    Returns a concurrent.futures.Future with the optimized gtsam.Values.
+    The optimizer must not be used by other threads until the future is done.
+    """
+    return _executor(executor).submit(optimizer.optimize)
+
+
+def update_async(isam, graph, values, executor=None):
+    """
+    Start isam.update(graph, values) on a worker thread.
+    Returns a concurrent.futures.Future with the gtsam.ISAM2Result.
+    """
+    return _executor(executor).submit(isam.update, graph, values)
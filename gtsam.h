@@ -27,6 +27,8 @@
  *     - Specify by-value (not reference) return types, even if C++ method returns reference
  *     - Must start with a letter (upper or lowercase)
  *     - Overloads are supported
+ *     - Append "nogil" (after "const") to release the Python GIL while the method runs;
+ *       all overloads must agree. Constructors take "nogil" per overload.
  *   Static methods
  *     - Must start with a letter (upper or lowercase) and use the "static" keyword
  *     - The first letter will be made uppercase in the generated MATLAB interface
@@ -1997,13 +1999,13 @@ class Values {
 #include <gtsam/nonlinear/Marginals.h>
 class Marginals {
   Marginals(const gtsam::NonlinearFactorGraph& graph,
-      const gtsam::Values& solution);
+      const gtsam::Values& solution) nogil;
 
   void print(string s) const;
-  Matrix marginalCovariance(size_t variable) const;
-  Matrix marginalInformation(size_t variable) const;
-  gtsam::JointMarginal jointMarginalCovariance(const gtsam::KeyVector& variables) const;
-  gtsam::JointMarginal jointMarginalInformation(const gtsam::KeyVector& variables) const;
+  Matrix marginalCovariance(size_t variable) const nogil;
+  Matrix marginalInformation(size_t variable) const nogil;
+  gtsam::JointMarginal jointMarginalCovariance(const gtsam::KeyVector& variables) const nogil;
+  gtsam::JointMarginal jointMarginalInformation(const gtsam::KeyVector& variables) const nogil;
 };
 
 class JointMarginal {
@@ -2135,12 +2137,12 @@ virtual class DoglegParams : gtsam::NonlinearOptimizerParams {
 
 #include <gtsam/nonlinear/NonlinearOptimizer.h>
 virtual class NonlinearOptimizer {
-  gtsam::Values optimize();
-  gtsam::Values optimizeSafely();
+  gtsam::Values optimize() nogil;
+  gtsam::Values optimizeSafely() nogil;
   double error() const;
   int iterations() const;
   gtsam::Values values() const;
-  gtsam::GaussianFactorGraph* iterate() const;
+  gtsam::GaussianFactorGraph* iterate() const nogil;
 };
 
 #include <gtsam/nonlinear/GaussNewtonOptimizer.h>
@@ -2235,6 +2237,10 @@ class ISAM2Params {
   void setEnableDetailedResults(bool enableDetailedResults);
   bool isEnablePartialRelinearizationCheck() const;
   void setEnablePartialRelinearizationCheck(bool enablePartialRelinearizationCheck);
+  size_t getMaxFactorSlotMoves() const;
+  void setMaxFactorSlotMoves(size_t maxFactorSlotMoves);
+  bool isIncrementalReordering() const;
+  void setIncrementalReordering(bool incrementalReordering);
 };
 
 class ISAM2Clique {
@@ -2268,10 +2274,10 @@ class ISAM2 {
   void printStats() const;
   void saveGraph(string s) const;
 
-  gtsam::ISAM2Result update();
-  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta);
-  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::FactorIndices& removeFactorIndices);
-  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::FactorIndices& removeFactorIndices, const gtsam::KeyGroupMap& constrainedKeys);
+  gtsam::ISAM2Result update() nogil;
+  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta) nogil;
+  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::FactorIndices& removeFactorIndices) nogil;
+  gtsam::ISAM2Result update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::FactorIndices& removeFactorIndices, const gtsam::KeyGroupMap& constrainedKeys) nogil;
   // TODO: wrap the full version of update
  //void update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::KeyVector& removeFactorIndices, FastMap<Key,int>& constrainedKeys);
   //void update(const gtsam::NonlinearFactorGraph& newFactors, const gtsam::Values& newTheta, const gtsam::KeyVector& removeFactorIndices, FastMap<Key,int>& constrainedKeys, bool force_relinearize);
@@ -2898,6 +2904,17 @@ namespace utilities {
   Matrix extractPose2(const gtsam::Values& values);
   gtsam::Values allPose3s(gtsam::Values& values);
   Matrix extractPose3(const gtsam::Values& values);
+  Matrix extractPoint2(const gtsam::Values& values, const gtsam::KeyVector& keys);
+  Matrix extractPoint3(const gtsam::Values& values, const gtsam::KeyVector& keys);
+  Matrix extractPose2(const gtsam::Values& values, const gtsam::KeyVector& keys);
+  Matrix extractPose3(const gtsam::Values& values, const gtsam::KeyVector& keys);
+  Matrix extractVectors(const gtsam::VectorValues& x, const gtsam::KeyVector& keys);
+  Matrix extractJacobianBlock(const gtsam::JacobianFactor& factor, size_t i);
+  void insertPoint2s(gtsam::Values& values, const gtsam::KeyVector& keys, Matrix points);
+  void insertPoint3s(gtsam::Values& values, const gtsam::KeyVector& keys, Matrix points);
+  void insertPose2s(gtsam::Values& values, const gtsam::KeyVector& keys, Matrix poses);
+  void insertPose3s(gtsam::Values& values, const gtsam::KeyVector& keys, Matrix poses);
+  void insertVectors(gtsam::VectorValues& x, const gtsam::KeyVector& keys, Matrix vectors);
   void perturbPoint2(gtsam::Values& values, double sigma, int seed);
   void perturbPose2 (gtsam::Values& values, double sigmaT, double sigmaR, int seed);
   void perturbPoint3(gtsam::Values& values, double sigma, int seed);
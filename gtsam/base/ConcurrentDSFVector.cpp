@@ -0,0 +1,108 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ConcurrentDSFVector.cpp
+ * @brief A lock-free disjoint set forest over the keys 0...numNodes-1
+ */
+
+#include <gtsam/base/ConcurrentDSFVector.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <utility>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+ConcurrentDSFVector::ConcurrentDSFVector(size_t numNodes) :
+    parent_(numNodes) {
+  for (size_t i = 0; i < numNodes; i++)
+    parent_[i].store(i, memory_order_relaxed);
+}
+
+/* ************************************************************************* */
+size_t ConcurrentDSFVector::find(size_t key) const {
+  // Path halving: point every other node on the path to its grandparent. Links
+  // only go to smaller indices, so a failed compare-and-swap just means another
+  // thread already moved the node further up, and can be ignored.
+  size_t parent = parent_[key].load(memory_order_acquire);
+  while (parent != key) {
+    size_t grandparent = parent_[parent].load(memory_order_acquire);
+    if (grandparent != parent)
+      parent_[key].compare_exchange_weak(parent, grandparent,
+          memory_order_release, memory_order_relaxed);
+    key = grandparent;
+    parent = parent_[key].load(memory_order_acquire);
+  }
+  return key;
+}
+
+/* ************************************************************************* */
+bool ConcurrentDSFVector::merge(size_t i1, size_t i2) {
+  while (true) {
+    i1 = find(i1);
+    i2 = find(i2);
+    if (i1 == i2)
+      return false;
+    // Link the larger root below the smaller one, if it is still a root
+    if (i1 < i2)
+      swap(i1, i2);
+    size_t expected = i1;
+    if (parent_[i1].compare_exchange_strong(expected, i2,
+        memory_order_acq_rel, memory_order_acquire))
+      return true;
+  }
+}
+
+/* ************************************************************************* */
+bool ConcurrentDSFVector::sameSet(size_t i1, size_t i2) const {
+  while (true) {
+    i1 = find(i1);
+    i2 = find(i2);
+    if (i1 == i2)
+      return true;
+    // If i1 is still a root, i1 and i2 were in different sets when i2 was found
+    if (parent_[i1].load(memory_order_acquire) == i1)
+      return false;
+  }
+}
+
+/* ************************************************************************* */
+vector<size_t> ConcurrentDSFVector::labels() const {
+  const size_t n = parent_.size();
+  vector<size_t> labels(n);
+  parallelFor(n, [&](size_t key) { labels[key] = find(key); });
+  return labels;
+}
+
+/* ************************************************************************* */
+map<size_t, set<size_t> > ConcurrentDSFVector::sets() const {
+  const vector<size_t> labels = this->labels();
+  map<size_t, set<size_t> > sets;
+  for (size_t key = 0; key < labels.size(); ++key) {
+    set<size_t>& s = sets[labels[key]];
+    s.insert(s.end(), key);
+  }
+  return sets;
+}
+
+/* ************************************************************************* */
+map<size_t, vector<size_t> > ConcurrentDSFVector::arrays() const {
+  const vector<size_t> labels = this->labels();
+  map<size_t, vector<size_t> > arrays;
+  for (size_t key = 0; key < labels.size(); ++key)
+    arrays[labels[key]].push_back(key);
+  return arrays;
+}
+
+} // namespace gtsam
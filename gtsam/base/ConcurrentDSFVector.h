@@ -0,0 +1,76 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ConcurrentDSFVector.h
+ * @brief A lock-free disjoint set forest over the keys 0...numNodes-1
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * A disjoint set forest like DSFBase, except that find and merge may be called
+ * concurrently from several threads without locks. Roots are linked with a
+ * compare-and-swap, always from the larger to the smaller index so no cycles can
+ * form, and find compresses paths by path halving, which only ever replaces a
+ * parent by one of its ancestors. find never blocks on another thread.
+ *
+ * The partition can be extracted with labels(), sets() or arrays(), which run
+ * the finds in parallel when TBB is enabled. These should only be called once
+ * all merges have completed.
+ * @addtogroup base
+ */
+class GTSAM_EXPORT ConcurrentDSFVector {
+
+private:
+  mutable std::vector<std::atomic<size_t> > parent_; ///< representative iff parent_[i]==i
+
+public:
+  /// Constructor, allows for keys 0...numNodes-1, each in its own set
+  explicit ConcurrentDSFVector(size_t numNodes);
+
+  /// Number of keys
+  size_t size() const { return parent_.size(); }
+
+  /// Find the label of the set in which {key} lives, the smallest key in that set
+  size_t find(size_t key) const;
+
+  /// Merge the sets containing i1 and i2, returns false if they were already in the same set
+  bool merge(size_t i1, size_t i2);
+
+  /// Whether i1 and i2 are in the same set
+  bool sameSet(size_t i1, size_t i2) const;
+
+  /// Label of every key, i.e., find(key) for all keys
+  std::vector<size_t> labels() const;
+
+  /// Return all sets, i.e. a partition of all elements.
+  std::map<size_t, std::set<size_t> > sets() const;
+
+  /// Return all sets, i.e. a partition of all elements, each set sorted.
+  std::map<size_t, std::vector<size_t> > arrays() const;
+
+private:
+  ConcurrentDSFVector(const ConcurrentDSFVector&);
+  ConcurrentDSFVector& operator=(const ConcurrentDSFVector&);
+};
+
+}
@@ -0,0 +1,166 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SlabPool.cpp
+ * @brief   Slab allocation of small objects, with slabs released once they are empty
+ */
+
+#include <gtsam/base/SlabPool.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+
+namespace gtsam {
+
+namespace {
+
+struct SizeClass;
+
+// Header at the start of every slab, which a block finds by rounding its
+// address down to the slab alignment
+struct Slab {
+  SizeClass* sizeClass;
+  size_t live;        // blocks handed out and not freed yet
+  char* unused;       // first block that was never handed out
+  void* freeBlocks;   // freed blocks, linked through their first word
+  Slab* prev;         // neighbours in the list of slabs with freed blocks
+  Slab* next;
+  bool hasFreeBlocks; // whether the slab is in that list
+};
+
+// Blocks start past the header, at a multiple of the granularity
+const size_t kHeaderSize = (sizeof(Slab) + SlabPool::kGranularity - 1)
+    / SlabPool::kGranularity * SlabPool::kGranularity;
+
+struct SizeClass {
+  std::mutex mutex;
+  size_t blockSize = 0;
+  Slab* current = nullptr;     // slab that new blocks are carved from
+  Slab* withFreeBlocks = nullptr; // slabs with freed blocks, reused first
+};
+
+struct Pools {
+  SizeClass classes[SlabPool::kMaxBlockSize / SlabPool::kGranularity];
+  std::atomic<size_t> nrSlabs;
+
+  Pools() : nrSlabs(0) {
+    for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++)
+      classes[i].blockSize = (i + 1) * SlabPool::kGranularity;
+  }
+};
+
+// Never destroyed, since pooled objects may be freed during static destruction
+Pools& pools() {
+  static Pools* pools = new Pools();
+  return *pools;
+}
+
+Slab* slabOf(void* block) {
+  return reinterpret_cast<Slab*>(reinterpret_cast<std::uintptr_t>(block)
+      & ~std::uintptr_t(SlabPool::kSlabSize - 1));
+}
+
+bool isFull(const Slab* slab) {
+  return reinterpret_cast<const char*>(slab) + SlabPool::kSlabSize - slab->unused
+      < std::ptrdiff_t(slab->sizeClass->blockSize);
+}
+
+void link(SizeClass& c, Slab* slab) {
+  slab->prev = nullptr;
+  slab->next = c.withFreeBlocks;
+  if (c.withFreeBlocks) c.withFreeBlocks->prev = slab;
+  c.withFreeBlocks = slab;
+  slab->hasFreeBlocks = true;
+}
+
+void unlink(SizeClass& c, Slab* slab) {
+  if (slab->prev) slab->prev->next = slab->next;
+  else c.withFreeBlocks = slab->next;
+  if (slab->next) slab->next->prev = slab->prev;
+  slab->hasFreeBlocks = false;
+}
+
+Slab* newSlab(SizeClass& c) {
+  void* memory = boost::alignment::aligned_alloc(SlabPool::kSlabSize, SlabPool::kSlabSize);
+  if (!memory) throw std::bad_alloc();
+  Slab* slab = new (memory) Slab();
+  slab->sizeClass = &c;
+  slab->live = 0;
+  slab->unused = static_cast<char*>(memory) + kHeaderSize;
+  slab->freeBlocks = nullptr;
+  slab->prev = slab->next = nullptr;
+  slab->hasFreeBlocks = false;
+  pools().nrSlabs++;
+  return slab;
+}
+
+void freeSlab(Slab* slab) {
+  slab->~Slab();
+  boost::alignment::aligned_free(slab);
+  pools().nrSlabs--;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+void* SlabPool::Allocate(size_t size) {
+  assert(Fits(size, 1));
+  SizeClass& c = pools().classes[size == 0 ? 0 : (size - 1) / kGranularity];
+  std::lock_guard<std::mutex> lock(c.mutex);
+
+  // Reuse a freed block
+  if (Slab* slab = c.withFreeBlocks) {
+    void* block = slab->freeBlocks;
+    slab->freeBlocks = *static_cast<void**>(block);
+    if (!slab->freeBlocks) unlink(c, slab);
+    slab->live++;
+    return block;
+  }
+
+  // Otherwise carve a new one. A full current slab has no freed blocks, as
+  // they would have been reused above, so it stays until its blocks are freed.
+  if (!c.current || isFull(c.current))
+    c.current = newSlab(c);
+  void* block = c.current->unused;
+  c.current->unused += c.blockSize;
+  c.current->live++;
+  return block;
+}
+
+/* ************************************************************************* */
+void SlabPool::Deallocate(void* block) {
+  Slab* slab = slabOf(block);
+  SizeClass& c = *slab->sizeClass;
+  std::lock_guard<std::mutex> lock(c.mutex);
+  assert(slab->live > 0);
+  slab->live--;
+
+  // An empty slab goes back to the system, except the one blocks are carved
+  // from, so that allocating and freeing a single block does not thrash
+  if (slab->live == 0 && slab != c.current) {
+    if (slab->hasFreeBlocks) unlink(c, slab);
+    freeSlab(slab);
+    return;
+  }
+  *static_cast<void**>(block) = slab->freeBlocks;
+  slab->freeBlocks = block;
+  if (!slab->hasFreeBlocks) link(c, slab);
+}
+
+/* ************************************************************************* */
+size_t SlabPool::NrSlabs() {
+  return pools().nrSlabs;
+}
+
+}  // namespace gtsam
@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SlabPool.h
+ * @brief   Slab allocation of small objects, with slabs released once they are empty
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <boost/align/aligned_alloc.hpp>
+#include <boost/make_shared.hpp>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace gtsam {
+
+/**
+ * A pool of small fixed-size blocks, carved out of 64kB slabs with one set of
+ * slabs per block size. Freed blocks are handed out again before new ones are
+ * carved, and a slab goes back to the system as soon as all of its blocks are
+ * free. Objects that are created together and die together, such as the
+ * cliques, conditionals and factors of an elimination that ISAM2 later
+ * discards in removeTop, hence release their memory a slab at a time, and a
+ * long-running process does not hold on to the most memory it ever used, as
+ * the boost pool does. All functions are thread-safe.
+ * @addtogroup base
+ */
+class GTSAM_EXPORT SlabPool {
+public:
+  static const size_t kSlabSize = 64 * 1024; ///< Size and alignment of a slab
+  static const size_t kGranularity = 16; ///< Block sizes are multiples of this, and so is their alignment
+  static const size_t kMaxBlockSize = 1024; ///< Largest block in the pool
+
+  /// Whether a block of size bytes and the given alignment comes from the pool
+  static bool Fits(size_t size, size_t alignment) {
+    return size <= kMaxBlockSize && alignment <= kGranularity;
+  }
+
+  /// Allocate a block of size bytes, for which Fits has to be true
+  static void* Allocate(size_t size);
+
+  /// Free a block allocated with Allocate
+  static void Deallocate(void* block);
+
+  /// Number of slabs currently held, for tests and timing
+  static size_t NrSlabs();
+};
+
+/**
+ * Allocator that takes objects that fit from SlabPool, and others from the
+ * system, aligned as they require.
+ */
+template<typename T>
+struct SlabAllocator {
+  typedef T value_type;
+  template<typename U> struct rebind { typedef SlabAllocator<U> other; };
+
+  SlabAllocator() {}
+  template<typename U> SlabAllocator(const SlabAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    const size_t size = n * sizeof(T);
+    void* p = SlabPool::Fits(size, alignof(T)) ? SlabPool::Allocate(size)
+        : boost::alignment::aligned_alloc(alignof(T), size);
+    if (!p) throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (SlabPool::Fits(n * sizeof(T), alignof(T)))
+      SlabPool::Deallocate(p);
+    else
+      boost::alignment::aligned_free(p);
+  }
+
+  template<typename U> bool operator==(const SlabAllocator<U>&) const { return true; }
+  template<typename U> bool operator!=(const SlabAllocator<U>&) const { return false; }
+};
+
+/**
+ * Like boost::make_shared, but allocates the object and its reference count
+ * together from SlabPool. Used for the cliques, conditionals and factors
+ * created during elimination.
+ */
+template<typename T, typename... Args>
+boost::shared_ptr<T> makeSlabShared(Args&&... args) {
+  return boost::allocate_shared<T>(SlabAllocator<T>(), std::forward<Args>(args)...);
+}
+
+}  // namespace gtsam
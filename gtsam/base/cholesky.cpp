@@ -18,10 +18,14 @@
  */
 
 #include <gtsam/base/cholesky.h>
+#include <gtsam/base/parallelFor.h>
 #include <gtsam/base/timing.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
 
 #include <boost/format.hpp>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -31,6 +35,9 @@ static const double negativePivotThreshold = -1e-1;
 static const double zeroPivotThreshold = 1e-6;
 static const double underconstrainedPrior = 1e-5;
 static const int underconstrainedExponentDifference = 12;
+#ifdef GTSAM_USE_TBB
+static const size_t blockedThreshold = 1024; // fronts at least this large are tiled
+#endif
 
 /* ************************************************************************* */
 static inline int choleskyStep(Matrix& ATA, size_t k, size_t order) {
@@ -104,6 +111,72 @@ pair<size_t, bool> choleskyCareful(Matrix& ATA, int order) {
   return make_pair(maxrank, success);
 }
 
+/* ************************************************************************* */
+// Right-looking tiled Cholesky on the upper triangle of the n*n block at topleft,
+// eliminating the first nFrontal rows. Every step factors one diagonal tile, then
+// solves the tiles to its right and updates the trailing tiles, which are independent.
+static bool factorBlocked(Matrix& ABC, size_t nFrontal, size_t topleft, size_t n,
+    size_t tile) {
+  vector<pair<size_t, size_t> > updates;
+  for (size_t k0 = 0; k0 < nFrontal; k0 += tile) {
+    // Tiles of this step follow the frontal boundary, so the last one may be narrower
+    const size_t kb = std::min(tile, nFrontal - k0);
+    const size_t k = topleft + k0;
+
+    // Factor the diagonal tile
+    auto Akk = ABC.block(k, k, kb, kb);
+    Eigen::LLT<Matrix, Eigen::Upper> llt(Akk);
+    if (llt.info() != Eigen::Success)
+      return false;
+    Akk.triangularView<Eigen::Upper>() = llt.matrixU();
+    const size_t rest = n - (k0 + kb);
+    if (rest == 0)
+      continue;
+
+    // Solve for the row panel to the right, one tile column at a time
+    const size_t first = k0 + kb, nrRest = (rest + tile - 1) / tile;
+    auto colStart = [&](size_t j) { return topleft + first + j * tile; };
+    auto colWidth = [&](size_t j) { return std::min(tile, rest - j * tile); };
+    parallelFor(nrRest, [&](size_t j) {
+      auto Akj = ABC.block(k, colStart(j), kb, colWidth(j));
+      ABC.block(k, k, kb, kb).triangularView<Eigen::Upper>().transpose().solveInPlace(Akj);
+    });
+
+    // Update the trailing upper triangle, every tile (i,j) with i <= j independently
+    updates.clear();
+    for (size_t j = 0; j < nrRest; ++j)
+      for (size_t i = 0; i <= j; ++i)
+        updates.push_back(make_pair(i, j));
+    parallelFor(updates.size(), [&](size_t u) {
+      const size_t i = updates[u].first, j = updates[u].second;
+      const auto Aki = ABC.block(k, colStart(i), kb, colWidth(i));
+      auto Aij = ABC.block(colStart(i), colStart(j), colWidth(i), colWidth(j));
+      if (i == j)
+        Aij.selfadjointView<Eigen::Upper>().rankUpdate(Aki.transpose(), -1.0);
+      else
+        Aij.noalias() -= Aki.transpose() * ABC.block(k, colStart(j), kb, colWidth(j));
+    });
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+// Check last diagonal element - Eigen does not check it
+static bool checkLastPivots(const Matrix& ABC, size_t nFrontal, size_t topleft) {
+  if (nFrontal >= 2) {
+    int exp2, exp1;
+    (void)frexp(ABC(topleft + nFrontal - 2, topleft + nFrontal - 2), &exp2);
+    (void)frexp(ABC(topleft + nFrontal - 1, topleft + nFrontal - 1), &exp1);
+    return (exp2 - exp1 < underconstrainedExponentDifference);
+  } else if (nFrontal == 1) {
+    int exp1;
+    (void)frexp(ABC(topleft, topleft), &exp1);
+    return (exp1 > -underconstrainedExponentDifference);
+  } else {
+    return true;
+  }
+}
+
 /* ************************************************************************* */
 bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft) {
   gttic(choleskyPartial);
@@ -115,6 +188,12 @@ bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft) {
   const size_t n = static_cast<size_t>(ABC.rows() - topleft);
   assert(nFrontal <= size_t(n));
 
+#ifdef GTSAM_USE_TBB
+  // Tiling only pays off when the trailing updates run in parallel
+  if (n >= blockedThreshold)
+    return choleskyPartialBlocked(ABC, nFrontal, topleft);
+#endif
+
   // Create views on blocks
   auto A = ABC.block(topleft, topleft, nFrontal, nFrontal);
   auto B = ABC.block(topleft, topleft + nFrontal, nFrontal, n - nFrontal);
@@ -142,19 +221,31 @@ bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft) {
     C.selfadjointView<Eigen::Upper>().rankUpdate(B.transpose(), -1.0);
   gttoc(compute_L);
 
-  // Check last diagonal element - Eigen does not check it
-  if (nFrontal >= 2) {
-    int exp2, exp1;
-    // NOTE(gareth): R is already the size of A, so we don't need to add topleft here.
-    (void)frexp(R(nFrontal - 2, nFrontal - 2), &exp2);
-    (void)frexp(R(nFrontal - 1, nFrontal - 1), &exp1);
-    return (exp2 - exp1 < underconstrainedExponentDifference);
-  } else if (nFrontal == 1) {
-    int exp1;
-    (void)frexp(R(0, 0), &exp1);
-    return (exp1 > -underconstrainedExponentDifference);
-  } else {
+  return checkLastPivots(ABC, nFrontal, topleft);
+}
+
+/* ************************************************************************* */
+bool choleskyPartialBlocked(Matrix& ABC, size_t nFrontal, size_t topleft,
+    size_t tileSize) {
+  gttic(choleskyPartialBlocked);
+  if (nFrontal == 0)
     return true;
+
+  assert(ABC.cols() == ABC.rows());
+  assert(ABC.rows() >= topleft);
+  assert(tileSize > 0);
+  const size_t n = static_cast<size_t>(ABC.rows() - topleft);
+  assert(nFrontal <= size_t(n));
+
+  // A tile after the first may turn out not to be positive definite once earlier
+  // steps have overwritten ABC, so keep a copy to leave ABC unchanged on failure,
+  // as choleskyPartial does. It costs O(n^2) against the O(n^3) factorization.
+  const Matrix saved = ABC.block(topleft, topleft, n, n);
+  if (!factorBlocked(ABC, nFrontal, topleft, n, tileSize)) {
+    ABC.block(topleft, topleft, n, n) = saved;
+    return false;
   }
+  return checkLastPivots(ABC, nFrontal, topleft);
 }
+
 }  // namespace gtsam
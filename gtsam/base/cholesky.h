@@ -58,9 +58,22 @@ GTSAM_EXPORT std::pair<size_t,bool> choleskyCareful(Matrix& ATA, int order = -1)
  * if non-zero, factorization proceeds in bottom-right corner starting at topleft
  *
  * @return \c true if the decomposition is successful, \c false if \c A was
- * not positive-definite.
+ * not positive-definite, in which case \c ABC is left unchanged.
  */
 GTSAM_EXPORT bool choleskyPartial(Matrix& ABC, size_t nFrontal, size_t topleft=0);
 
+/**
+ * Tiled version of choleskyPartial, with the same inputs and results. It is a
+ * right-looking blocked Cholesky: each step factors a tileSize*tileSize
+ * diagonal tile, then solves the tiles to its right and updates all trailing
+ * tiles, which are independent and run as parallel TBB tasks. When GTSAM is built
+ * with TBB, choleskyPartial switches to it for large fronts (1024 dimensions
+ * and up), e.g., root cliques with large separators. If \c A is not
+ * positive-definite, \c ABC is restored from a copy taken before the first
+ * tile, so it is left unchanged as by choleskyPartial.
+ */
+GTSAM_EXPORT bool choleskyPartialBlocked(Matrix& ABC, size_t nFrontal,
+    size_t topleft = 0, size_t tileSize = 256);
+
 }
 
@@ -0,0 +1,41 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    parallelFor.cpp
+ * @brief   Loop over an index range, in parallel if GTSAM is built with TBB
+ */
+
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace gtsam {
+
+/* ************************************************************************* */
+void parallelFor(size_t n, const std::function<void(size_t)>& body) {
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+      [&body](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i)
+          body(i);
+      });
+#else
+  for (size_t i = 0; i < n; ++i)
+    body(i);
+#endif
+}
+
+}  // namespace gtsam
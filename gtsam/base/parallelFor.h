@@ -0,0 +1,34 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    parallelFor.h
+ * @brief   Loop over an index range, in parallel if GTSAM is built with TBB
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace gtsam {
+
+/**
+ * Call body(i) for all i in [0, n). When GTSAM is built with TBB the range is
+ * split into chunks that run as parallel tasks, so calls for different i must
+ * not write to the same data. Otherwise the calls are made in order. Defined in
+ * a .cpp file, so that headers using it do not pull in TBB.
+ */
+GTSAM_EXPORT void parallelFor(size_t n, const std::function<void(size_t)>& body);
+
+}  // namespace gtsam
@@ -66,6 +66,42 @@ TEST(cholesky, choleskyPartial) {
   EXPECT(assert_equal(expected, actual, 1e-9));
 }
 
+/* ************************************************************************* */
+TEST(cholesky, choleskyPartialBlocked) {
+  // A random positive definite matrix, of which only the upper triangle is used
+  const Matrix M = Matrix::Random(23, 23);
+  const Matrix ABC = M.transpose() * M + 23 * Matrix::Identity(23, 23);
+
+  for (size_t topleft : {0, 2}) {
+    for (size_t nFrontal : {1, 7, 12, 21}) {
+      Matrix expected(ABC);
+      const bool expectedResult = choleskyPartial(expected, nFrontal, topleft);
+      for (size_t tileSize : {1, 3, 4, 8, 64}) {
+        Matrix actual(ABC);
+        EXPECT(expectedResult == choleskyPartialBlocked(actual, nFrontal, topleft, tileSize));
+        EXPECT(assert_equal(Matrix(expected.triangularView<Eigen::Upper>()),
+                            Matrix(actual.triangularView<Eigen::Upper>()), 1e-9));
+      }
+    }
+  }
+
+  // Not positive definite
+  Matrix indefinite = -ABC;
+  EXPECT(!choleskyPartialBlocked(indefinite, 10, 0, 4));
+
+  // Failing in the third tile, after the first two have been factored, still
+  // leaves the matrix unchanged, as choleskyPartial does
+  for (size_t topleft : {0, 2}) {
+    Matrix late(ABC);
+    late(topleft + 9, topleft + 9) = -100.0;
+    Matrix expected(late), actual(late);
+    EXPECT(!choleskyPartial(expected, 12, topleft));
+    EXPECT(!choleskyPartialBlocked(actual, 12, topleft, 4));
+    EXPECT(assert_equal(late, expected));
+    EXPECT(assert_equal(late, actual));
+  }
+}
+
 /* ************************************************************************* */
 TEST(cholesky, BadScalingCholesky) {
   Matrix A = (Matrix(2,2) <<
@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testConcurrentDSFVector.cpp
+ * @brief unit tests for ConcurrentDSFVector
+ */
+
+#include <gtsam/base/ConcurrentDSFVector.h>
+#include <gtsam/base/DSFVector.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/assign/std/set.hpp>
+using namespace boost::assign;
+
+#include <thread>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(ConcurrentDSFVector, merge) {
+  ConcurrentDSFVector dsf(4);
+  EXPECT(dsf.find(0) != dsf.find(2));
+  EXPECT(dsf.merge(2, 0));
+  EXPECT(!dsf.merge(0, 2));
+  EXPECT(dsf.merge(3, 2));
+  EXPECT(dsf.sameSet(0, 3));
+  EXPECT(!dsf.sameSet(1, 3));
+  LONGS_EQUAL(0, dsf.find(3));
+}
+
+/* ************************************************************************* */
+TEST(ConcurrentDSFVector, sets) {
+  ConcurrentDSFVector dsf(5);
+  dsf.merge(0, 1);
+  dsf.merge(4, 3);
+  map<size_t, set<size_t> > actual = dsf.sets();
+  set<size_t> expected1, expected2, expected3;
+  expected1 += 0, 1;
+  expected2 += 2;
+  expected3 += 3, 4;
+  LONGS_EQUAL(3, actual.size());
+  EXPECT(expected1 == actual[0]);
+  EXPECT(expected2 == actual[2]);
+  EXPECT(expected3 == actual[3]);
+}
+
+/* ************************************************************************* */
+TEST(ConcurrentDSFVector, concurrentMerges) {
+  // Several threads merge interleaved pairs, the result should match DSFVector
+  const size_t n = 10000, nrThreads = 4;
+  vector<pair<size_t, size_t> > matches;
+  for (size_t k = 0; k < 4 * n; k++)
+    matches.push_back(make_pair((k * 7919) % n, (k * 104729 + 13) % n));
+
+  ConcurrentDSFVector dsf(n);
+  vector<thread> threads;
+  for (size_t t = 0; t < nrThreads; t++)
+    threads.push_back(thread([&dsf, &matches, t, nrThreads]() {
+      for (size_t k = t; k < matches.size(); k += nrThreads)
+        dsf.merge(matches[k].first, matches[k].second);
+    }));
+  for (thread& th : threads)
+    th.join();
+
+  DSFVector expected(n);
+  for (const pair<size_t, size_t>& match : matches)
+    expected.merge(match.first, match.second);
+  map<size_t, vector<size_t> > expectedArrays = expected.arrays(),
+      actualArrays = dsf.arrays();
+  LONGS_EQUAL(expectedArrays.size(), actualArrays.size());
+  for (const pair<const size_t, vector<size_t> >& set : expectedArrays)
+    EXPECT(set.second == actualArrays[set.second.front()]);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
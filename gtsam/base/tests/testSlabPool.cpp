@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSlabPool.cpp
+ * @brief   Unit tests for SlabPool and makeSlabShared
+ */
+
+#include <gtsam/base/SlabPool.h>
+#include <gtsam/base/Matrix.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+// Blocks of a size no other test allocates, so slab counts are not shared
+static const size_t kSize = 1000;
+
+/* ************************************************************************* */
+TEST(SlabPool, reuse) {
+  void* a = SlabPool::Allocate(kSize);
+  void* b = SlabPool::Allocate(kSize);
+  EXPECT(a != b);
+  SlabPool::Deallocate(a);
+  EXPECT(SlabPool::Allocate(kSize) == a);
+  SlabPool::Deallocate(a);
+  SlabPool::Deallocate(b);
+}
+
+/* ************************************************************************* */
+TEST(SlabPool, release) {
+  const size_t before = SlabPool::NrSlabs();
+
+  // Fill slabs until four more are held
+  vector<void*> blocks;
+  while (SlabPool::NrSlabs() < before + 4)
+    blocks.push_back(SlabPool::Allocate(kSize));
+  for (void* block : blocks)
+    EXPECT_LONGS_EQUAL(0, reinterpret_cast<uintptr_t>(block) % SlabPool::kGranularity);
+
+  // A slab is released as soon as all of its blocks are freed
+  const uintptr_t mask = ~uintptr_t(SlabPool::kSlabSize - 1);
+  const uintptr_t first = reinterpret_cast<uintptr_t>(blocks.front()) & mask;
+  vector<void*> others;
+  for (void* block : blocks) {
+    if ((reinterpret_cast<uintptr_t>(block) & mask) == first)
+      SlabPool::Deallocate(block);
+    else
+      others.push_back(block);
+  }
+  EXPECT_LONGS_EQUAL(before + 3, SlabPool::NrSlabs());
+
+  // except the one that new blocks are carved from
+  for (void* block : others)
+    SlabPool::Deallocate(block);
+  EXPECT(SlabPool::NrSlabs() <= before + 1);
+}
+
+/* ************************************************************************* */
+namespace {
+struct Counted {
+  static int live;
+  Matrix4 fixed; // aligned like the fixed-size Eigen members of factors
+  Vector dynamic;
+  Counted(double x) : fixed(Matrix4::Constant(x)), dynamic(Vector::Constant(100, x)) { live++; }
+  ~Counted() { live--; }
+};
+int Counted::live = 0;
+
+struct Large {
+  char bytes[2 * SlabPool::kMaxBlockSize];
+};
+}
+
+TEST(SlabPool, makeSlabShared) {
+  {
+    boost::shared_ptr<Counted> p = makeSlabShared<Counted>(2.0);
+    EXPECT_LONGS_EQUAL(1, Counted::live);
+    EXPECT_LONGS_EQUAL(0, reinterpret_cast<uintptr_t>(p.get()) % alignof(Counted));
+    EXPECT(assert_equal(Matrix(Matrix4::Constant(2.0)), Matrix(p->fixed)));
+    EXPECT_LONGS_EQUAL(100, p->dynamic.size());
+
+    // Objects that do not fit come from the system
+    const size_t before = SlabPool::NrSlabs();
+    boost::shared_ptr<Large> large = makeSlabShared<Large>();
+    large->bytes[sizeof(Large) - 1] = 1;
+    EXPECT_LONGS_EQUAL(before, SlabPool::NrSlabs());
+  }
+  EXPECT_LONGS_EQUAL(0, Counted::live);
+}
+
+/* ************************************************************************* */
+TEST(SlabPool, concurrent) {
+  // Blocks allocated and freed on different threads, when built with TBB
+  const size_t before = SlabPool::NrSlabs();
+  vector<void*> blocks(2000);
+  parallelFor(blocks.size(), [&](size_t i) { blocks[i] = SlabPool::Allocate(kSize); });
+  parallelFor(blocks.size(), [&](size_t i) {
+    SlabPool::Deallocate(blocks[(i * 7) % blocks.size()]);
+  });
+  EXPECT(SlabPool::NrSlabs() <= before + 1);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -87,6 +87,7 @@ namespace gtsam {
       virtual Ptr apply_g_op_fC(const Choice&, const Binary&) const = 0;
       virtual Ptr choose(const L& label, size_t index) const = 0;
       virtual bool isLeaf() const = 0;
+      virtual size_t nrLeaves() const = 0;
     };
     /** ------------------------ Node base class --------------------------- */
 
@@ -185,6 +186,11 @@ namespace gtsam {
     /** combine subtrees on key with binary operation "op" */
     DecisionTree combine(const L& label, size_t cardinality, const Binary& op) const;
 
+    /** return the number of leaves, a measure of how compressed the tree is */
+    size_t nrLeaves() const {
+      return root_->nrLeaves();
+    }
+
     /** combine with LabelC for convenience */
     DecisionTree combine(const LabelC& labelC, const Binary& op) const {
       return combine(labelC.first, labelC.second, op);
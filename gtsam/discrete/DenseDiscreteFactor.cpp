@@ -0,0 +1,287 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file DenseDiscreteFactor.cpp
+ * @brief A discrete factor stored as a flat, row-major table
+ */
+
+#include <gtsam/discrete/DenseDiscreteFactor.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+  namespace {
+    // Same semantics as Potentials::safe_div
+    double safe_div(const double& a, const double& b) {
+      return (a == 0 || b == 0) ? 0 : (a / b);
+    }
+  }
+
+  /* ******************************************************************************** */
+  DenseDiscreteFactor::DenseDiscreteFactor() : table_(1, 1.0) {
+  }
+
+  /* ******************************************************************************** */
+  DenseDiscreteFactor::DenseDiscreteFactor(const DiscreteKeys& keys,
+      const vector<double>& table) :
+      DiscreteFactor(keys.indices()), discreteKeys_(keys), table_(table) {
+    computeStrides();
+  }
+
+  /* ******************************************************************************** */
+  DenseDiscreteFactor::DenseDiscreteFactor(const DiscreteKeys& keys,
+      const string& table) :
+      DiscreteFactor(keys.indices()), discreteKeys_(keys) {
+    istringstream iss(table);
+    copy(istream_iterator<double>(iss), istream_iterator<double>(),
+        back_inserter(table_));
+    computeStrides();
+  }
+
+  /* ******************************************************************************** */
+  DenseDiscreteFactor::DenseDiscreteFactor(const DecisionTreeFactor& f) :
+      DiscreteFactor(f.keys()) {
+    size_t n = 1;
+    for (Key j : f.keys()) {
+      discreteKeys_.push_back(DiscreteKey(j, f.cardinality(j)));
+      n *= f.cardinality(j);
+    }
+    table_.resize(n);
+    computeStrides();
+
+    // Walk all assignments in row-major order, updating the assignment in place
+    Values values;
+    vector<size_t*> counters;
+    for (const DiscreteKey& key : discreteKeys_)
+      counters.push_back(&(values[key.first] = 0));
+    for (size_t index = 0; index < n; ++index) {
+      table_[index] = f(values);
+      for (size_t i = counters.size(); i > 0; --i) {
+        if (++(*counters[i - 1]) < discreteKeys_[i - 1].second) break;
+        *counters[i - 1] = 0;
+      }
+    }
+  }
+
+  /* ******************************************************************************** */
+  void DenseDiscreteFactor::computeStrides() {
+    strides_.resize(discreteKeys_.size());
+    size_t n = 1;
+    for (size_t i = discreteKeys_.size(); i > 0; --i) {
+      strides_[i - 1] = n;
+      n *= discreteKeys_[i - 1].second;
+    }
+    if (table_.size() != n) throw invalid_argument(
+        (boost::format(
+            "DenseDiscreteFactor: expected %d values but got %d instead")
+            % n % table_.size()).str());
+  }
+
+  /* ************************************************************************* */
+  bool DenseDiscreteFactor::equals(const DiscreteFactor& other, double tol) const {
+    const DenseDiscreteFactor* f = dynamic_cast<const DenseDiscreteFactor*>(&other);
+    if (!f || f->discreteKeys_ != discreteKeys_)
+      return false;
+    for (size_t i = 0; i < table_.size(); ++i)
+      if (fabs(table_[i] - f->table_[i]) > tol)
+        return false;
+    return true;
+  }
+
+  /* ************************************************************************* */
+  void DenseDiscreteFactor::print(const string& s,
+      const KeyFormatter& formatter) const {
+    cout << s;
+    cout << " keys:";
+    for (const DiscreteKey& key : discreteKeys_)
+      cout << " " << formatter(key.first) << "(" << key.second << ")";
+    cout << "\n table:";
+    for (double value : table_)
+      cout << " " << value;
+    cout << endl;
+  }
+
+  /* ************************************************************************* */
+  double DenseDiscreteFactor::operator()(const Values& values) const {
+    size_t index = 0;
+    for (size_t i = 0; i < discreteKeys_.size(); ++i)
+      index += values.at(discreteKeys_[i].first) * strides_[i];
+    return table_[index];
+  }
+
+  /* ************************************************************************* */
+  DecisionTreeFactor DenseDiscreteFactor::toDecisionTreeFactor() const {
+    if (discreteKeys_.empty())
+      return DecisionTreeFactor(discreteKeys_, ADT(table_[0]));
+
+    // DecisionTree::create is much faster when labels are given highest to
+    // lowest, so transpose the table into that order before building the tree
+    const size_t nrKeys = discreteKeys_.size();
+    vector<size_t> order(nrKeys);
+    for (size_t i = 0; i < nrKeys; ++i) order[i] = i;
+    sort(order.begin(), order.end(), [this](size_t i, size_t j) {
+      return discreteKeys_[i].first > discreteKeys_[j].first;
+    });
+
+    DiscreteKeys sortedKeys;
+    for (size_t i : order) sortedKeys.push_back(discreteKeys_[i]);
+    vector<double> sortedTable(table_.size());
+    vector<size_t> counters(nrKeys, 0);
+    size_t offset = 0;
+    for (size_t index = 0; index < sortedTable.size(); ++index) {
+      sortedTable[index] = table_[offset];
+      for (size_t i = nrKeys; i > 0; --i) {
+        offset += strides_[order[i - 1]];
+        if (++counters[i - 1] < sortedKeys[i - 1].second) break;
+        offset -= strides_[order[i - 1]] * counters[i - 1];
+        counters[i - 1] = 0;
+      }
+    }
+    return DecisionTreeFactor(discreteKeys_, ADT(sortedKeys, sortedTable));
+  }
+
+  /* ************************************************************************* */
+  DenseDiscreteFactor DenseDiscreteFactor::operator/(const DenseDiscreteFactor& f) const {
+    return apply(f, safe_div);
+  }
+
+  /* ************************************************************************* */
+  size_t DenseDiscreteFactor::cardinality(Key j) const {
+    for (const DiscreteKey& key : discreteKeys_)
+      if (key.first == j) return key.second;
+    throw out_of_range("DenseDiscreteFactor::cardinality: key not found");
+  }
+
+  /* ************************************************************************* */
+  DenseDiscreteFactor DenseDiscreteFactor::apply(const DenseDiscreteFactor& f,
+      Binary op) const {
+    // make unique key-cardinality map, sorted as in DecisionTreeFactor::apply
+    map<Key, size_t> cs;
+    for (const DiscreteKey& key : discreteKeys_) cs[key.first] = key.second;
+    for (const DiscreteKey& key : f.discreteKeys_) cs[key.first] = key.second;
+
+    // Strides of both operands along each key of the result, zero if absent
+    DiscreteKeys keys;
+    const size_t nrKeys = cs.size();
+    vector<size_t> sa(nrKeys, 0), sb(nrKeys, 0);
+    size_t n = 1;
+    for (const pair<const Key, size_t>& key : cs) {
+      const size_t i = keys.size();
+      for (size_t k = 0; k < discreteKeys_.size(); ++k)
+        if (discreteKeys_[k].first == key.first) sa[i] = strides_[k];
+      for (size_t k = 0; k < f.discreteKeys_.size(); ++k)
+        if (f.discreteKeys_[k].first == key.first) sb[i] = f.strides_[k];
+      keys.push_back(key);
+      n *= key.second;
+    }
+
+    // Walk the result in row-major order, moving both operand offsets along
+    vector<double> table(n);
+    vector<size_t> counters(nrKeys, 0);
+    size_t a = 0, b = 0;
+    for (size_t index = 0; index < n; ++index) {
+      table[index] = op(table_[a], f.table_[b]);
+      for (size_t i = nrKeys; i > 0; --i) {
+        a += sa[i - 1];
+        b += sb[i - 1];
+        if (++counters[i - 1] < keys[i - 1].second) break;
+        a -= sa[i - 1] * counters[i - 1];
+        b -= sb[i - 1] * counters[i - 1];
+        counters[i - 1] = 0;
+      }
+    }
+    return DenseDiscreteFactor(keys, table);
+  }
+
+  /* ************************************************************************* */
+  void DenseDiscreteFactor::combineKey(size_t position, Binary op) {
+    const size_t cardinality = discreteKeys_[position].second;
+    const size_t inner = strides_[position];
+    const size_t outer = table_.size() / (cardinality * inner);
+
+    // For each slice before the key, fold the cardinality contiguous blocks of size inner
+    vector<double> table(outer * inner);
+    for (size_t o = 0; o < outer; ++o) {
+      const double* in = &table_[o * cardinality * inner];
+      double* out = &table[o * inner];
+      for (size_t i = 0; i < inner; ++i)
+        out[i] = in[i];
+      for (size_t v = 1; v < cardinality; ++v) {
+        in += inner;
+        for (size_t i = 0; i < inner; ++i)
+          out[i] = op(out[i], in[i]);
+      }
+    }
+
+    table_.swap(table);
+    discreteKeys_.erase(discreteKeys_.begin() + position);
+    keys_.erase(keys_.begin() + position);
+    computeStrides();
+  }
+
+  /* ************************************************************************* */
+  DenseDiscreteFactor::shared_ptr DenseDiscreteFactor::combine(size_t nrFrontals,
+      Binary op) const {
+
+    if (nrFrontals > size()) throw invalid_argument(
+        (boost::format(
+            "DenseDiscreteFactor::combine: invalid number of frontal keys %d, nr.keys=%d")
+            % nrFrontals % size()).str());
+
+    shared_ptr result = boost::make_shared<DenseDiscreteFactor>(*this);
+    for (size_t i = 0; i < nrFrontals; i++)
+      result->combineKey(0, op);
+    return result;
+  }
+
+  /* ************************************************************************* */
+  DenseDiscreteFactor::shared_ptr DenseDiscreteFactor::combine(
+      const Ordering& frontalKeys, Binary op) const {
+
+    if (frontalKeys.size() > size()) throw invalid_argument(
+        (boost::format(
+            "DenseDiscreteFactor::combine: invalid number of frontal keys %d, nr.keys=%d")
+            % frontalKeys.size() % size()).str());
+
+    // combine one key at a time, in the given order, as DecisionTreeFactor does
+    shared_ptr result = boost::make_shared<DenseDiscreteFactor>(*this);
+    for (Key j : frontalKeys) {
+      KeyVector::const_iterator it = std::find(result->keys_.begin(), result->keys_.end(), j);
+      if (it == result->keys_.end())
+        throw invalid_argument("DenseDiscreteFactor::combine: frontal key not in factor");
+      result->combineKey(it - result->keys_.begin(), op);
+    }
+    return result;
+  }
+
+  /* ************************************************************************* */
+  double DenseDiscreteFactor::Density(const DecisionTreeFactor& f) {
+    double n = 1.0;
+    for (Key j : f.keys())
+      n *= f.cardinality(j);
+    return f.nrLeaves() / n;
+  }
+
+/* ************************************************************************* */
+} // namespace gtsam
@@ -0,0 +1,178 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file DenseDiscreteFactor.h
+ * @brief A discrete factor stored as a flat, row-major table
+ */
+
+#pragma once
+
+#include <gtsam/discrete/DecisionTreeFactor.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+  /**
+   * A discrete factor that stores its values in a flat, row-major table, with the first key
+   * varying slowest (the same layout as the table constructors of DecisionTreeFactor).
+   * For dense tables, i.e., tables where the decision tree cannot prune many leaves, products,
+   * sums and maximizations are computed by strided loops over contiguous memory instead of by
+   * allocating new tree nodes.
+   */
+  class GTSAM_EXPORT DenseDiscreteFactor: public DiscreteFactor {
+
+  public:
+
+    // typedefs needed to play nice with gtsam
+    typedef DenseDiscreteFactor This;
+    typedef DiscreteFactor Base; ///< Typedef to base class
+    typedef boost::shared_ptr<DenseDiscreteFactor> shared_ptr;
+    typedef AlgebraicDecisionTree<Key> ADT;
+
+    /// Binary operator on table entries, e.g., ADT::Ring::mul
+    typedef double (*Binary)(const double&, const double&);
+
+  protected:
+
+    DiscreteKeys discreteKeys_; ///< Keys with cardinalities, in the same order as keys()
+    std::vector<size_t> strides_; ///< Stride in table_ of each key
+    std::vector<double> table_; ///< Row-major values, last key varies fastest
+
+  public:
+
+    /// @name Standard Constructors
+    /// @{
+
+    /** Default constructor creates a constant factor equal to one */
+    DenseDiscreteFactor();
+
+    /** Constructor from keys and a row-major table of values */
+    DenseDiscreteFactor(const DiscreteKeys& keys, const std::vector<double>& table);
+
+    /** Constructor from keys and a table of values given as a string */
+    DenseDiscreteFactor(const DiscreteKeys& keys, const std::string& table);
+
+    /** Convert from a DecisionTreeFactor, by evaluating every assignment */
+    explicit DenseDiscreteFactor(const DecisionTreeFactor& f);
+
+    /// @}
+    /// @name Testable
+    /// @{
+
+    /// equality
+    bool equals(const DiscreteFactor& other, double tol = 1e-9) const;
+
+    // print
+    virtual void print(const std::string& s = "DenseDiscreteFactor:\n",
+        const KeyFormatter& formatter = DefaultKeyFormatter) const;
+
+    /// @}
+    /// @name Standard Interface
+    /// @{
+
+    /// Value is a table lookup
+    virtual double operator()(const Values& values) const;
+
+    /// Multiply in a DecisionTreeFactor, the result is a DecisionTreeFactor
+    virtual DecisionTreeFactor operator*(const DecisionTreeFactor& f) const {
+      return toDecisionTreeFactor() * f;
+    }
+
+    /// Convert into a decisiontree
+    virtual DecisionTreeFactor toDecisionTreeFactor() const;
+
+    /// multiply two factors
+    DenseDiscreteFactor operator*(const DenseDiscreteFactor& f) const {
+      return apply(f, ADT::Ring::mul);
+    }
+
+    /// divide by factor f (safely)
+    DenseDiscreteFactor operator/(const DenseDiscreteFactor& f) const;
+
+    /// Create new factor by summing all values with the same separator values
+    shared_ptr sum(size_t nrFrontals) const {
+      return combine(nrFrontals, ADT::Ring::add);
+    }
+
+    /// Create new factor by summing all values with the same separator values
+    shared_ptr sum(const Ordering& keys) const {
+      return combine(keys, ADT::Ring::add);
+    }
+
+    /// Create new factor by maximizing over all values with the same separator values
+    shared_ptr max(size_t nrFrontals) const {
+      return combine(nrFrontals, ADT::Ring::max);
+    }
+
+    /// Create new factor by maximizing over all values with the same separator values
+    shared_ptr max(const Ordering& keys) const {
+      return combine(keys, ADT::Ring::max);
+    }
+
+    /// Cardinality of key j
+    size_t cardinality(Key j) const;
+
+    /// Keys with their cardinalities
+    const DiscreteKeys& discreteKeys() const { return discreteKeys_; }
+
+    /// The row-major table of values
+    const std::vector<double>& table() const { return table_; }
+
+    /// @}
+    /// @name Advanced Interface
+    /// @{
+
+    /**
+     * Apply binary operator (*this) "op" f. The keys of the result are sorted, as in
+     * DecisionTreeFactor::apply, and each entry is computed by walking the tables of both
+     * operands with their strides.
+     */
+    DenseDiscreteFactor apply(const DenseDiscreteFactor& f, Binary op) const;
+
+    /**
+     * Combine the first nrFrontals keys using binary operator "op"
+     * @return shared pointer to newly created DenseDiscreteFactor
+     */
+    shared_ptr combine(size_t nrFrontals, Binary op) const;
+
+    /**
+     * Combine frontal variables in an Ordering using binary operator "op"
+     * @return shared pointer to newly created DenseDiscreteFactor
+     */
+    shared_ptr combine(const Ordering& keys, Binary op) const;
+
+    /**
+     * Fraction of the dense table size taken up by the leaves of a decision tree factor. Values
+     * close to one mean the tree gains nothing from pruning and a dense table will be faster.
+     */
+    static double Density(const DecisionTreeFactor& f);
+
+    /// @}
+
+  private:
+
+    /// Compute strides_ from discreteKeys_
+    void computeStrides();
+
+    /// Combine a single key, in place
+    void combineKey(size_t position, Binary op);
+  };
+  // DenseDiscreteFactor
+
+// traits
+template<> struct traits<DenseDiscreteFactor> : public Testable<DenseDiscreteFactor> {};
+
+}// namespace gtsam
@@ -22,6 +22,7 @@
 #include <gtsam/discrete/DiscreteBayesTree.h>
 #include <gtsam/discrete/DiscreteEliminationTree.h>
 #include <gtsam/discrete/DiscreteJunctionTree.h>
+#include <gtsam/discrete/DenseDiscreteFactor.h>
 #include <gtsam/inference/FactorGraph-inst.h>
 #include <gtsam/inference/EliminateableFactorGraph-inst.h>
 #include <boost/make_shared.hpp>
@@ -100,21 +101,65 @@ namespace gtsam {
     return BaseEliminateable::eliminateSequential()->optimize();
   }
 
+  /* ************************************************************************* */
+  namespace {
+    // Largest product table, in entries, that will be computed densely
+    const double kMaxDenseProductSize = 1 << 22;
+    // Smallest DenseDiscreteFactor::Density of every factor for which dense
+    // products pay off, see timing/timeDiscreteElimination.cpp
+    const double kMinDenseProductDensity = 0.25;
+
+    // Decide whether the product of these factors is better computed as a flat
+    // table: only if all factors are DecisionTreeFactors whose trees are mostly
+    // unpruned, and the table of the product is small enough to fit in memory.
+    bool PreferDenseProduct(const DiscreteFactorGraph& factors) {
+      std::map<Key, size_t> cardinalities;
+      for(const DiscreteFactor::shared_ptr& factor: factors) {
+        const DecisionTreeFactor* f = dynamic_cast<const DecisionTreeFactor*>(factor.get());
+        if (!f || DenseDiscreteFactor::Density(*f) < kMinDenseProductDensity)
+          return false;
+        for(Key j: f->keys())
+          cardinalities[j] = f->cardinality(j);
+      }
+      double productSize = 1;
+      for(const std::pair<const Key, size_t>& key_cardinality: cardinalities)
+        productSize *= key_cardinality.second;
+      return productSize <= kMaxDenseProductSize;
+    }
+  }
+
   /* ************************************************************************* */
   std::pair<DiscreteConditional::shared_ptr, DecisionTreeFactor::shared_ptr>  //
   EliminateDiscrete(const DiscreteFactorGraph& factors, const Ordering& frontalKeys) {
 
-    // PRODUCT: multiply all factors
-    gttic(product);
     DecisionTreeFactor product;
-    for(const DiscreteFactor::shared_ptr& factor: factors)
-      product = (*factor) * product;
-    gttoc(product);
-
-    // sum out frontals, this is the factor on the separator
-    gttic(sum);
-    DecisionTreeFactor::shared_ptr sum = product.sum(frontalKeys);
-    gttoc(sum);
+    DecisionTreeFactor::shared_ptr sum;
+    if (PreferDenseProduct(factors)) {
+      // PRODUCT and SUM on flat tables, converting back to trees at the end
+      gttic(dense_product);
+      DenseDiscreteFactor denseProduct;
+      for(const DiscreteFactor::shared_ptr& factor: factors)
+        denseProduct = DenseDiscreteFactor(
+            static_cast<const DecisionTreeFactor&>(*factor)) * denseProduct;
+      product = denseProduct.toDecisionTreeFactor();
+      gttoc(dense_product);
+
+      gttic(dense_sum);
+      sum = boost::make_shared<DecisionTreeFactor>(
+          denseProduct.sum(frontalKeys)->toDecisionTreeFactor());
+      gttoc(dense_sum);
+    } else {
+      // PRODUCT: multiply all factors
+      gttic(product);
+      for(const DiscreteFactor::shared_ptr& factor: factors)
+        product = (*factor) * product;
+      gttoc(product);
+
+      // sum out frontals, this is the factor on the separator
+      gttic(sum);
+      sum = product.sum(frontalKeys);
+      gttoc(sum);
+    }
 
     // Ordering keys for the conditional so that frontalKeys are really in front
     Ordering orderedKeys;
@@ -0,0 +1,228 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file LoopyBeliefPropagation.cpp
+ * @brief Approximate sum-product and max-product inference on a DiscreteFactorGraph
+ */
+
+#include <gtsam/discrete/LoopyBeliefPropagation.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+  namespace {
+    // Normalize a message in place, a message that is all zero becomes uniform
+    void normalize(double* message, size_t cardinality) {
+      double sum = 0.0;
+      for (size_t x = 0; x < cardinality; ++x)
+        sum += message[x];
+      if (sum > 0.0)
+        for (size_t x = 0; x < cardinality; ++x)
+          message[x] /= sum;
+      else
+        for (size_t x = 0; x < cardinality; ++x)
+          message[x] = 1.0 / cardinality;
+    }
+  }
+
+  /* ************************************************************************* */
+  LoopyBeliefPropagation::LoopyBeliefPropagation(const DiscreteFactorGraph& graph,
+      const Parameters& params) :
+      params_(params), iterations_(0), converged_(false) {
+
+    if (params_.damping < 0.0 || params_.damping >= 1.0)
+      throw invalid_argument("LoopyBeliefPropagation: damping must be in [0,1)");
+
+    // Convert factors to flat tables and lay out the edges
+    size_t bufferSize = 0;
+    factors_.reserve(graph.size());
+    for (const DiscreteFactor::shared_ptr& factor : graph) {
+      if (!factor) continue;
+      const DecisionTreeFactor* tree = dynamic_cast<const DecisionTreeFactor*>(factor.get());
+      factors_.push_back(tree ? DenseDiscreteFactor(*tree)
+          : DenseDiscreteFactor(factor->toDecisionTreeFactor()));
+      factorEdges_.push_back(edges_.size());
+      for (const DiscreteKey& key : factors_.back().discreteKeys()) {
+        FastMap<Key, size_t>::const_iterator it = variableIndex_.find(key.first);
+        size_t variable;
+        if (it == variableIndex_.end()) {
+          variable = variables_.size();
+          variableIndex_.insert(make_pair(key.first, variable));
+          variables_.push_back(key);
+          variableEdges_.push_back(vector<size_t>());
+        } else {
+          variable = it->second;
+          if (variables_[variable].second != key.second)
+            throw invalid_argument("LoopyBeliefPropagation: inconsistent cardinality for a key");
+        }
+        variableEdges_[variable].push_back(edges_.size());
+        Edge edge = { variable, bufferSize };
+        edges_.push_back(edge);
+        bufferSize += key.second;
+      }
+    }
+    factorEdges_.push_back(edges_.size());
+
+    // All messages start out uniform
+    factorToVariable_.resize(bufferSize);
+    for (const Edge& edge : edges_) {
+      const size_t cardinality = variables_[edge.variable].second;
+      fill(factorToVariable_.begin() + edge.offset,
+          factorToVariable_.begin() + edge.offset + cardinality, 1.0 / cardinality);
+    }
+    variableToFactor_ = factorToVariable_;
+    newFactorToVariable_ = factorToVariable_;
+    counters_.resize(edges_.size());
+    factorChange_.resize(factors_.size());
+  }
+
+  /* ************************************************************************* */
+  double LoopyBeliefPropagation::updateFactorMessages(size_t f) {
+    const size_t begin = factorEdges_[f], end = factorEdges_[f + 1];
+    const vector<double>& table = factors_[f].table();
+
+    for (size_t e = begin; e < end; ++e) {
+      fill(newFactorToVariable_.begin() + edges_[e].offset,
+          newFactorToVariable_.begin() + edges_[e].offset + variables_[edges_[e].variable].second, 0.0);
+      counters_[e] = 0;
+    }
+
+    // Walk the table in row-major order, accumulating into every outgoing message
+    for (size_t index = 0; index < table.size(); ++index) {
+      if (table[index] != 0.0) {
+        for (size_t t = begin; t < end; ++t) {
+          double p = table[index];
+          for (size_t s = begin; s < end; ++s)
+            if (s != t) p *= variableToFactor_[edges_[s].offset + counters_[s]];
+          double& out = newFactorToVariable_[edges_[t].offset + counters_[t]];
+          out = params_.maxProduct ? std::max(out, p) : out + p;
+        }
+      }
+      for (size_t e = end; e > begin; --e) {
+        if (++counters_[e - 1] < variables_[edges_[e - 1].variable].second) break;
+        counters_[e - 1] = 0;
+      }
+    }
+
+    // Normalize, damp, and measure the change
+    double change = 0.0;
+    for (size_t e = begin; e < end; ++e) {
+      const size_t cardinality = variables_[edges_[e].variable].second;
+      double* message = &newFactorToVariable_[edges_[e].offset];
+      const double* old = &factorToVariable_[edges_[e].offset];
+      normalize(message, cardinality);
+      for (size_t x = 0; x < cardinality; ++x) {
+        message[x] = (1.0 - params_.damping) * message[x] + params_.damping * old[x];
+        change = std::max(change, fabs(message[x] - old[x]));
+      }
+    }
+    return change;
+  }
+
+  /* ************************************************************************* */
+  void LoopyBeliefPropagation::updateVariableMessage(size_t edge) {
+    const size_t variable = edges_[edge].variable;
+    const size_t cardinality = variables_[variable].second;
+    double* message = &variableToFactor_[edges_[edge].offset];
+    fill(message, message + cardinality, 1.0);
+    for (size_t other : variableEdges_[variable]) {
+      if (other == edge) continue;
+      const double* incoming = &factorToVariable_[edges_[other].offset];
+      for (size_t x = 0; x < cardinality; ++x)
+        message[x] *= incoming[x];
+    }
+    normalize(message, cardinality);
+  }
+
+  /* ************************************************************************* */
+  double LoopyBeliefPropagation::iterate() {
+    gttic(LoopyBeliefPropagation_iterate);
+    double change = 0.0;
+
+    if (params_.schedule == Parameters::PARALLEL) {
+      // All factors read the previous variable messages, so they can be updated concurrently
+      parallelFor(factors_.size(), [this](size_t f) {
+        factorChange_[f] = updateFactorMessages(f);
+      });
+      factorToVariable_.swap(newFactorToVariable_);
+      for (double factorChange : factorChange_)
+        change = std::max(change, factorChange);
+      for (size_t e = 0; e < edges_.size(); ++e)
+        updateVariableMessage(e);
+    } else {
+      // Gauss-Seidel: each factor sees the messages updated earlier in this sweep
+      for (size_t f = 0; f < factors_.size(); ++f) {
+        for (size_t e = factorEdges_[f]; e < factorEdges_[f + 1]; ++e)
+          updateVariableMessage(e);
+        change = std::max(change, updateFactorMessages(f));
+        for (size_t e = factorEdges_[f]; e < factorEdges_[f + 1]; ++e)
+          copy(newFactorToVariable_.begin() + edges_[e].offset,
+              newFactorToVariable_.begin() + edges_[e].offset + variables_[edges_[e].variable].second,
+              factorToVariable_.begin() + edges_[e].offset);
+      }
+    }
+
+    ++iterations_;
+    return change;
+  }
+
+  /* ************************************************************************* */
+  size_t LoopyBeliefPropagation::run() {
+    gttic(LoopyBeliefPropagation_run);
+    converged_ = false;
+    size_t iterations = 0;
+    while (iterations < params_.maxIterations && !converged_) {
+      converged_ = iterate() <= params_.tolerance;
+      ++iterations;
+    }
+    return iterations;
+  }
+
+  /* ************************************************************************* */
+  Vector LoopyBeliefPropagation::belief(size_t variable) const {
+    const size_t cardinality = variables_[variable].second;
+    Vector result = Vector::Ones(cardinality);
+    for (size_t edge : variableEdges_[variable]) {
+      const double* incoming = &factorToVariable_[edges_[edge].offset];
+      for (size_t x = 0; x < cardinality; ++x)
+        result(x) *= incoming[x];
+    }
+    normalize(result.data(), cardinality);
+    return result;
+  }
+
+  /* ************************************************************************* */
+  Vector LoopyBeliefPropagation::marginalProbabilities(const DiscreteKey& key) const {
+    return belief(variableIndex_.at(key.first));
+  }
+
+  /* ************************************************************************* */
+  DiscreteFactor::sharedValues LoopyBeliefPropagation::optimize() const {
+    DiscreteFactor::sharedValues values = boost::make_shared<DiscreteFactor::Values>();
+    for (size_t variable = 0; variable < variables_.size(); ++variable) {
+      Vector::Index best;
+      belief(variable).maxCoeff(&best);
+      (*values)[variables_[variable].first] = best;
+    }
+    return values;
+  }
+
+} // namespace gtsam
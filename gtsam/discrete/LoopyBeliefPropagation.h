@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file LoopyBeliefPropagation.h
+ * @brief Approximate sum-product and max-product inference on a DiscreteFactorGraph
+ */
+
+#pragma once
+
+#include <gtsam/discrete/DiscreteFactorGraph.h>
+#include <gtsam/discrete/DenseDiscreteFactor.h>
+#include <gtsam/base/FastMap.h>
+#include <gtsam/base/Vector.h>
+
+#include <vector>
+
+namespace gtsam {
+
+  /**
+   * Parameters for LoopyBeliefPropagation
+   */
+  struct GTSAM_EXPORT LoopyBeliefPropagationParams {
+
+    /// Order in which messages are updated
+    enum Schedule {
+      PARALLEL, ///< Flooding: all factor messages are computed from the previous iteration, in parallel if TBB is available
+      SEQUENTIAL ///< Factors are visited in order and see the messages already updated in the same iteration
+    };
+
+    size_t maxIterations; ///< Maximum number of iterations (default: 100)
+    double tolerance; ///< Stop when no message changes by more than this (default: 1e-6)
+    double damping; ///< Fraction of the previous message kept in each update, in [0,1) (default: 0)
+    bool maxProduct; ///< Compute max-marginals for MAP estimation instead of marginals (default: false)
+    Schedule schedule; ///< Message schedule (default: PARALLEL)
+
+    LoopyBeliefPropagationParams(bool maxProduct = false) :
+        maxIterations(100), tolerance(1e-6), damping(0.0), maxProduct(maxProduct), schedule(PARALLEL) {
+    }
+  };
+
+  /**
+   * Loopy belief propagation on a DiscreteFactorGraph. This is an approximate alternative to
+   * elimination for graphs with large treewidth, e.g., grid-structured labeling problems. On
+   * graphs without loops it converges to the exact marginals (or max-marginals).
+   *
+   * Each factor is converted once to a DenseDiscreteFactor, and all factor-to-variable and
+   * variable-to-factor messages live in flat buffers allocated at construction, so that
+   * iterating does not allocate.
+   */
+  class GTSAM_EXPORT LoopyBeliefPropagation {
+
+  public:
+
+    typedef LoopyBeliefPropagationParams Parameters;
+
+    /** Construct from a factor graph, with all messages initialized to uniform */
+    LoopyBeliefPropagation(const DiscreteFactorGraph& graph, const Parameters& params = Parameters());
+
+    /** Update all messages once, returns the largest change of any factor-to-variable message */
+    double iterate();
+
+    /** Iterate until convergence or until the maximum number of iterations, returns the number of iterations */
+    size_t run();
+
+    /** Whether the last call to run() converged */
+    bool converged() const { return converged_; }
+
+    /** Number of iterations performed so far */
+    size_t iterations() const { return iterations_; }
+
+    /** Normalized belief (marginal, or max-marginal with maxProduct) of a variable */
+    Vector marginalProbabilities(const DiscreteKey& key) const;
+
+    /** Assignment maximizing each variable's belief, the MAP estimate when run with maxProduct */
+    DiscreteFactor::sharedValues optimize() const;
+
+  private:
+
+    /// An edge between a factor and one of its variables, with its message offset in the buffers
+    struct Edge {
+      size_t variable; ///< Index in variables_
+      size_t offset; ///< Offset of both messages along this edge in the message buffers
+    };
+
+    Parameters params_;
+    std::vector<DenseDiscreteFactor> factors_;
+    DiscreteKeys variables_; ///< Keys and cardinalities of the variables
+    FastMap<Key, size_t> variableIndex_; ///< Index of each key in variables_
+    std::vector<std::vector<size_t> > variableEdges_; ///< Edges adjacent to each variable
+    std::vector<Edge> edges_; ///< All edges, grouped by factor in the order of the factor keys
+    std::vector<size_t> factorEdges_; ///< First edge of each factor, plus one past the last edge
+
+    std::vector<double> factorToVariable_; ///< Current factor-to-variable messages
+    std::vector<double> variableToFactor_; ///< Current variable-to-factor messages
+    std::vector<double> newFactorToVariable_; ///< Scratch buffer for updated factor-to-variable messages
+    std::vector<size_t> counters_; ///< Scratch assignment counters, one per edge
+    std::vector<double> factorChange_; ///< Largest message change of each factor in the last update
+
+    size_t iterations_;
+    bool converged_;
+
+    /// Compute the messages from factor f into newFactorToVariable_, returns the largest change
+    double updateFactorMessages(size_t f);
+
+    /// Compute the message from the variable to the factor along an edge
+    void updateVariableMessage(size_t edge);
+
+    /// Product of all incoming factor messages of a variable, normalized
+    Vector belief(size_t variable) const;
+  };
+
+} // namespace gtsam
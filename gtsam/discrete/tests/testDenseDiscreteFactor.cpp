@@ -0,0 +1,145 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/*
+ * testDenseDiscreteFactor.cpp
+ */
+
+#include <gtsam/discrete/DenseDiscreteFactor.h>
+#include <gtsam/discrete/DiscreteFactorGraph.h>
+#include <gtsam/discrete/DiscreteConditional.h>
+#include <gtsam/base/Testable.h>
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST( DenseDiscreteFactor, constructors)
+{
+  DiscreteKey X(0,2), Y(1,3), Z(2,2);
+
+  DenseDiscreteFactor f1(X, "2 8");
+  DenseDiscreteFactor f2(X & Y, "2 5 3 6 4 7");
+  DenseDiscreteFactor f3(X & Y & Z, "2 5 3 6 4 7 25 55 35 65 45 75");
+  EXPECT_LONGS_EQUAL(1,f1.size());
+  EXPECT_LONGS_EQUAL(2,f2.size());
+  EXPECT_LONGS_EQUAL(3,f3.size());
+
+  DenseDiscreteFactor::Values values;
+  values[0] = 1; // x
+  values[1] = 2; // y
+  values[2] = 1; // z
+  EXPECT_DOUBLES_EQUAL(8, f1(values), 1e-9);
+  EXPECT_DOUBLES_EQUAL(7, f2(values), 1e-9);
+  EXPECT_DOUBLES_EQUAL(75, f3(values), 1e-9);
+
+  CHECK_EXCEPTION(DenseDiscreteFactor(X & Y, "1 2 3"), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST( DenseDiscreteFactor, conversion)
+{
+  DiscreteKey X(0,2), Y(1,3), Z(2,2);
+  DecisionTreeFactor tree(Z & X & Y, "2 5 3 6 4 7 25 55 35 65 45 75");
+
+  DenseDiscreteFactor dense(tree);
+  DenseDiscreteFactor expected(Z & X & Y, "2 5 3 6 4 7 25 55 35 65 45 75");
+  EXPECT(assert_equal(expected, dense));
+  EXPECT(assert_equal(tree, dense.toDecisionTreeFactor()));
+
+  // The same function with the keys in a different order
+  DenseDiscreteFactor transposed(X & Y & Z, "2 25 5 55 3 35 6 65 4 45 7 75");
+  DecisionTreeFactor actual = transposed.toDecisionTreeFactor();
+  EXPECT(assert_equal(tree, actual));
+  EXPECT(transposed.keys() == actual.keys());
+
+  EXPECT_DOUBLES_EQUAL(1.0, DenseDiscreteFactor::Density(tree), 1e-9);
+  EXPECT_DOUBLES_EQUAL(1.0 / 4.0, DenseDiscreteFactor::Density(DecisionTreeFactor(X & Z, "1 1 1 1")), 1e-9);
+}
+
+/* ************************************************************************* */
+TEST( DenseDiscreteFactor, multiplication)
+{
+  // Declare a bunch of keys
+  DiscreteKey v0(0,2), v1(1,2), v2(2,2);
+
+  // Create a factor
+  DenseDiscreteFactor f1(v0 & v1, "1 2 3 4");
+  DenseDiscreteFactor f2(v1 & v2, "5 6 7 8");
+
+  DenseDiscreteFactor expected(v0 & v1 & v2, "5 6 14 16 15 18 28 32");
+  EXPECT(assert_equal(expected, f1 * f2));
+
+  // Operands with keys out of order
+  DenseDiscreteFactor f3(v2 & v0, "1 2 3 4");
+  EXPECT(assert_equal((f1.toDecisionTreeFactor() * f3.toDecisionTreeFactor()),
+      (f1 * f3).toDecisionTreeFactor()));
+  EXPECT(assert_equal((f3.toDecisionTreeFactor() / f1.toDecisionTreeFactor()),
+      (f3 / f1).toDecisionTreeFactor()));
+}
+
+/* ************************************************************************* */
+TEST( DenseDiscreteFactor, sum_max)
+{
+  // Declare a bunch of keys
+  DiscreteKey v0(0,3), v1(1,2);
+
+  // Create a factor
+  DenseDiscreteFactor f1(v0 & v1, "1 2  3 4  5 6");
+
+  DenseDiscreteFactor expected(v1, "9 12");
+  EXPECT(assert_equal(expected, *f1.sum(1), 1e-5));
+
+  DenseDiscreteFactor expected2(v1, "5 6");
+  EXPECT(assert_equal(expected2, *f1.max(1)));
+
+  DenseDiscreteFactor expected3(v0, "3 7 11");
+  Ordering frontal;
+  frontal.push_back(1);
+  EXPECT(assert_equal(expected3, *f1.sum(frontal)));
+  EXPECT(assert_equal(*f1.toDecisionTreeFactor().sum(frontal), f1.sum(frontal)->toDecisionTreeFactor()));
+
+  DenseDiscreteFactor expected4(DiscreteKeys(), "21");
+  EXPECT(assert_equal(expected4, *f1.sum(2)));
+}
+
+/* ************************************************************************* */
+TEST( DenseDiscreteFactor, EliminateDiscrete)
+{
+  // A dense chain of three variables, eliminated with the dense path
+  DiscreteKey A(0,3), B(1,4), C(2,3);
+  DiscreteFactorGraph graph;
+  graph.add(A & B, "1 2 3 4 5 6 7 8 9 10 11 12");
+  graph.add(B & C, "3 1 4 1 5 9 2 6 5 3 5 8");
+
+  Ordering frontal;
+  frontal.push_back(1);
+  std::pair<DiscreteConditional::shared_ptr, DecisionTreeFactor::shared_ptr> actual =
+      EliminateDiscrete(graph, frontal);
+
+  // Compare with the decision tree computations
+  DecisionTreeFactor product = graph.product();
+  DecisionTreeFactor::shared_ptr sum = product.sum(frontal);
+  EXPECT(assert_equal(*sum, *actual.second));
+  Ordering orderedKeys;
+  orderedKeys.push_back(1);
+  orderedKeys.push_back(0);
+  orderedKeys.push_back(2);
+  EXPECT(assert_equal(DiscreteConditional(product, *sum, orderedKeys), *actual.first));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
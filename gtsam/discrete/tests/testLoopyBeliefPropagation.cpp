@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/*
+ * testLoopyBeliefPropagation.cpp
+ */
+
+#include <gtsam/discrete/LoopyBeliefPropagation.h>
+#include <gtsam/discrete/DiscreteMarginals.h>
+#include <gtsam/base/Testable.h>
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+// The chain from testDiscreteMarginals, which has no loops so belief propagation is exact
+DiscreteFactorGraph createChain(vector<DiscreteKey>& key) {
+  const int nrNodes = 10;
+  const size_t nrStates = 7;
+  for (int i = 0; i < nrNodes; i++)
+    key.push_back(DiscreteKey(i, nrStates));
+
+  DiscreteFactorGraph graph;
+  graph.add(key[0], ".3 .6 .1 0 0 0 0");
+  for (int i = 1; i < nrNodes; i++)
+    graph.add(key[i], "1 1 1 1 1 1 1");
+
+  const std::string edgePotential =   ".08 .9 .01 0 0 0 .01 "
+                                      ".03 .95 .01 0 0 0 .01 "
+                                      ".06 .06 .75 .05 .05 .02 .01 "
+                                      "0 0 0 .3 .6 .09 .01 "
+                                      "0 0 0 .02 .95 .02 .01 "
+                                      "0 0 0 .01 .01 .97 .01 "
+                                      "0 0 0 0 0 0 1";
+  for (int i = 0; i < nrNodes - 1; i++)
+    graph.add(key[i] & key[i + 1], edgePotential);
+  return graph;
+}
+
+}
+
+/* ************************************************************************* */
+TEST( LoopyBeliefPropagation, chainMarginals ) {
+  vector<DiscreteKey> key;
+  DiscreteFactorGraph graph = createChain(key);
+  DiscreteMarginals marginals(graph);
+
+  LoopyBeliefPropagation::Parameters parallel, sequential;
+  sequential.schedule = LoopyBeliefPropagation::Parameters::SEQUENTIAL;
+  LoopyBeliefPropagation bp1(graph, parallel), bp2(graph, sequential);
+  bp1.run();
+  bp2.run();
+  EXPECT(bp1.converged());
+  EXPECT(bp2.converged());
+  EXPECT(bp2.iterations() <= bp1.iterations());
+
+  for (const DiscreteKey& k : key) {
+    EXPECT(assert_equal(marginals.marginalProbabilities(k), bp1.marginalProbabilities(k), 1e-5));
+    EXPECT(assert_equal(marginals.marginalProbabilities(k), bp2.marginalProbabilities(k), 1e-5));
+  }
+}
+
+/* ************************************************************************* */
+TEST( LoopyBeliefPropagation, chainMPE ) {
+  vector<DiscreteKey> key;
+  DiscreteFactorGraph graph = createChain(key);
+
+  LoopyBeliefPropagation bp(graph, LoopyBeliefPropagation::Parameters(true));
+  bp.run();
+  EXPECT(bp.converged());
+  EXPECT(assert_equal(*graph.optimize(), *bp.optimize()));
+}
+
+/* ************************************************************************* */
+TEST( LoopyBeliefPropagation, loop ) {
+  // A single loop of four binary variables, with attractive pairwise potentials
+  DiscreteKey A(0,2), B(1,2), C(2,2), D(3,2);
+  DiscreteFactorGraph graph;
+  graph.add(A, "0.3 0.7");
+  graph.add(A & B, "4 1 1 4");
+  graph.add(B & C, "4 1 1 4");
+  graph.add(C & D, "4 1 1 4");
+  graph.add(D & A, "4 1 1 4");
+
+  LoopyBeliefPropagation::Parameters params(true);
+  params.damping = 0.5;
+  LoopyBeliefPropagation bp(graph, params);
+  bp.run();
+  EXPECT(bp.converged());
+  EXPECT(assert_equal(*graph.optimize(), *bp.optimize()));
+
+  // Invalid damping is rejected
+  params.damping = 1.0;
+  CHECK_EXCEPTION(LoopyBeliefPropagation(graph, params), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
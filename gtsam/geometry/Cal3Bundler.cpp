@@ -93,6 +93,43 @@ Point2 Cal3Bundler::uncalibrate(const Point2& p, //
   return Point2(u0_ + f_ * u, v0_ + f_ * v);
 }
 
+/* ************************************************************************* */
+Matrix uncalibratePoints(const Cal3Bundler& K, const Matrix& pn,
+    boost::optional<Matrix&> Dcal, boost::optional<Matrix&> Dp) {
+  // As Cal3Bundler::uncalibrate, with arrays over all points
+  typedef Eigen::Array<double, 1, Eigen::Dynamic> Row;
+  const Eigen::Index n = pn.cols();
+  const double f = K.fx(), k1 = K.k1(), k2 = K.k2();
+  const Row x = pn.row(0).array(), y = pn.row(1).array();
+  const Row r = x * x + y * y;
+  const Row g = 1. + (k1 + k2 * r) * r;
+  Matrix pi(2, n);
+  pi.row(0) = (K.u0() + f * g * x).matrix();
+  pi.row(1) = (K.v0() + f * g * y).matrix();
+
+  // Column c of a stacked Jacobian, as a 2*N matrix with point j in column j
+  auto column = [n](Matrix& H, int c) {
+    return Eigen::Map<Matrix>(H.col(c).data(), 2, n);
+  };
+  if (Dcal) {
+    Dcal->resize(2 * n, 3);
+    const Row fr = f * r;
+    column(*Dcal, 0) = (pn.array().rowwise() * g).matrix();
+    column(*Dcal, 1) = (pn.array().rowwise() * fr).matrix();
+    column(*Dcal, 2) = (pn.array().rowwise() * (fr * r)).matrix();
+  }
+  if (Dp) {
+    Dp->resize(2 * n, 2);
+    const Row a = 2. * (k1 + 2. * k2 * r);
+    const Row faxy = f * a * x * y;
+    column(*Dp, 0).row(0) = (f * (g + a * x * x)).matrix();
+    column(*Dp, 0).row(1) = faxy.matrix();
+    column(*Dp, 1).row(0) = faxy.matrix();
+    column(*Dp, 1).row(1) = (f * (g + a * y * y)).matrix();
+  }
+  return pi;
+}
+
 /* ************************************************************************* */
 Point2 Cal3Bundler::calibrate(const Point2& pi, const double tol) const {
   // Copied from Cal3DS2 :-(
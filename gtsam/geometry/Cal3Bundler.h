@@ -176,4 +176,16 @@ struct traits<Cal3Bundler> : public internal::Manifold<Cal3Bundler> {};
 template<>
 struct traits<const Cal3Bundler> : public internal::Manifold<Cal3Bundler> {};
 
+/**
+ * Cal3Bundler::uncalibrate on a batch of points, one per column of pn, as array
+ * operations over all points. Overloads the per-point uncalibratePoints in
+ * PinholePose.h, so PinholeBaseK::projectPoints uses it.
+ * @param Dcal if given, resized to the 2N*3 stacked Jacobians w.r.t. calibration
+ * @param Dp if given, resized to the 2N*2 stacked Jacobians w.r.t. pn
+ * @return 2*N matrix, the image coordinates of point j in column j
+ */
+GTSAM_EXPORT Matrix uncalibratePoints(const Cal3Bundler& K, const Matrix& pn,
+    boost::optional<Matrix&> Dcal = boost::none,
+    boost::optional<Matrix&> Dp = boost::none);
+
 } // namespace gtsam
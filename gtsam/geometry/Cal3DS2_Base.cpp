@@ -131,26 +131,56 @@ Point2 Cal3DS2_Base::uncalibrate(const Point2& p,
 
 /* ************************************************************************* */
 Point2 Cal3DS2_Base::calibrate(const Point2& pi, const double tol) const {
-  // Use the following fixed point iteration to invert the radial distortion.
+  // Invert the distortion with Newton's method on uncalibrate(pn) = pi, using
+  // the analytic Jacobian of uncalibrate wrpt the intrinsic coordinates.
+  // Each step solves Dp*delta = pi - uncalibrate(pn) for the 2*2 Jacobian Dp.
+  // When that step does not reduce the error, or Dp is close to singular near a
+  // fold of the distortion, the step of the fixed point iteration
   // pn_{t+1} = (inv(K)*pi - dp(pn_{t})) / g(pn_{t})
+  // is taken instead if it reduces the error or the Newton step is not finite.
 
   const Point2 invKPi ((1 / fx_) * (pi.x() - u0_ - (s_ / fy_) * (pi.y() - v0_)),
                        (1 / fy_) * (pi.y() - v0_));
 
-  // initialize by ignoring the distortion at all, might be problematic for pixels around boundary
+  // initialize by ignoring the distortion at all
   Point2 pn = invKPi;
 
   // iterate until the uncalibrate is close to the actual pixel coordinate
   const int maxIterations = 10;
   int iteration;
+  Matrix2 Dp;
+  Point2 error = pi - uncalibrate(pn, boost::none, Dp);
   for (iteration = 0; iteration < maxIterations; ++iteration) {
-    if (distance2(uncalibrate(pn), pi) <= tol) break;
-    const double x = pn.x(), y = pn.y(), xy = x * y, xx = x * x, yy = y * y;
-    const double rr = xx + yy;
-    const double g = (1 + k1_ * rr + k2_ * rr * rr);
-    const double dx = 2 * p1_ * xy + p2_ * (rr + 2 * xx);
-    const double dy = 2 * p2_ * xy + p1_ * (rr + 2 * yy);
-    pn = (invKPi - Point2(dx, dy)) / g;
+    const double errorNorm = error.norm();
+    if (errorNorm <= tol) break;
+
+    // |det(Dp)| / |Dp|_F^2 is about the inverse condition number of Dp
+    Matrix2 Dnext;
+    Point2 next, nextError;
+    double nextErrorNorm = std::numeric_limits<double>::infinity();
+    if (std::abs(Dp.determinant()) > 1e-9 * Dp.squaredNorm()) {
+      next = pn + Point2(Dp.inverse() * error);
+      nextError = pi - uncalibrate(next, boost::none, Dnext);
+      nextErrorNorm = nextError.norm();
+    }
+    if (!(nextErrorNorm < errorNorm)) {
+      const double x = pn.x(), y = pn.y(), xy = x * y, xx = x * x, yy = y * y;
+      const double rr = xx + yy;
+      const double g = (1 + k1_ * rr + k2_ * rr * rr);
+      const double dx = 2 * p1_ * xy + p2_ * (rr + 2 * xx);
+      const double dy = 2 * p2_ * xy + p1_ * (rr + 2 * yy);
+      const Point2 fixed = (invKPi - Point2(dx, dy)) / g;
+      Matrix2 Dfixed;
+      const Point2 fixedError = pi - uncalibrate(fixed, boost::none, Dfixed);
+      if (fixedError.norm() < errorNorm || !std::isfinite(nextErrorNorm)) {
+        next = fixed;
+        nextError = fixedError;
+        Dnext = Dfixed;
+      }
+    }
+    pn = next;
+    error = nextError;
+    Dp = Dnext;
   }
 
   if ( iteration >= maxIterations )
@@ -159,6 +189,32 @@ Point2 Cal3DS2_Base::calibrate(const Point2& pi, const double tol) const {
   return pn;
 }
 
+/* ************************************************************************* */
+Point2 Cal3DS2_Base::calibrate(const Point2& pi, OptionalJacobian<2,9> Dcal,
+    OptionalJacobian<2,2> Dp, const double tol) const {
+  const Point2 pn = calibrate(pi, tol);
+  if (Dcal || Dp) {
+    // pn is defined implicitly by uncalibrate(pn) = pi
+    Matrix29 H1;
+    Matrix2 H2;
+    uncalibrate(pn, H1, H2);
+    const Matrix2 H2inv = H2.inverse();
+    if (Dcal) *Dcal = -H2inv * H1;
+    if (Dp) *Dp = H2inv;
+  }
+  return pn;
+}
+
+/* ************************************************************************* */
+Matrix Cal3DS2_Base::calibratePoints(const Matrix& pi, const double tol) const {
+  if (pi.rows() != 2)
+    throw std::invalid_argument("Cal3DS2::calibratePoints expects a 2*N matrix");
+  Matrix pn(2, pi.cols());
+  for (Eigen::Index j = 0; j < pi.cols(); ++j)
+    pn.col(j) = calibrate(Point2(pi.col(j)), tol);
+  return pn;
+}
+
 /* ************************************************************************* */
 Matrix2 Cal3DS2_Base::D2d_intrinsic(const Point2& p) const {
   const double x = p.x(), y = p.y(), xx = x * x, yy = y * y;
@@ -128,6 +128,25 @@ public:
   /// Convert (distorted) image coordinates uv to intrinsic coordinates xy
   Point2 calibrate(const Point2& p, const double tol=1e-5) const;
 
+  /**
+   * Convert (distorted) image coordinates uv to intrinsic coordinates xy,
+   * with derivatives obtained by inverting those of uncalibrate
+   * @param p point in (distorted) image coordinates
+   * @param Dcal 2*9 Jacobian wrpt Cal3DS2 parameters
+   * @param Dp optional 2*2 Jacobian wrpt image coordinates
+   * @param tol tolerance on the image distance of the round trip
+   * @return point in intrinsic coordinates
+   */
+  Point2 calibrate(const Point2& p, OptionalJacobian<2,9> Dcal,
+      OptionalJacobian<2,2> Dp = boost::none, const double tol=1e-5) const;
+
+  /**
+   * Convert a batch of (distorted) image coordinates to intrinsic coordinates
+   * @param pi 2*N matrix, one point in image coordinates per column
+   * @return 2*N matrix of points in intrinsic coordinates
+   */
+  Matrix calibratePoints(const Matrix& pi, const double tol=1e-5) const;
+
   /// Derivative of uncalibrate wrpt intrinsic coordinates
   Matrix2 D2d_intrinsic(const Point2& p) const ;
 
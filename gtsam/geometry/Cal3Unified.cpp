@@ -110,6 +110,32 @@ Point2 Cal3Unified::calibrate(const Point2& pi, const double tol) const {
   // call nplane to space
   return this->nPlaneToSpace(pnplane);
 }
+
+/* ************************************************************************* */
+Point2 Cal3Unified::calibrate(const Point2& pi, OptionalJacobian<2,10> Dcal,
+    OptionalJacobian<2,2> Dp, const double tol) const {
+  const Point2 p = calibrate(pi, tol);
+  if (Dcal || Dp) {
+    // p is defined implicitly by uncalibrate(p) = pi
+    Eigen::Matrix<double, 2, 10> H1;
+    Matrix2 H2;
+    uncalibrate(p, H1, H2);
+    const Matrix2 H2inv = H2.inverse();
+    if (Dcal) *Dcal = -H2inv * H1;
+    if (Dp) *Dp = H2inv;
+  }
+  return p;
+}
+
+/* ************************************************************************* */
+Matrix Cal3Unified::calibratePoints(const Matrix& pi, const double tol) const {
+  if (pi.rows() != 2)
+    throw std::invalid_argument("Cal3Unified::calibratePoints expects a 2*N matrix");
+  Matrix pn(2, pi.cols());
+  for (Eigen::Index j = 0; j < pi.cols(); ++j)
+    pn.col(j) = calibrate(Point2(pi.col(j)), tol);
+  return pn;
+}
 /* ************************************************************************* */
 Point2 Cal3Unified::nPlaneToSpace(const Point2& p) const {
 
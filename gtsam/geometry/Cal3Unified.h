@@ -101,6 +101,21 @@ public:
   /// Conver a pixel coordinate to ideal coordinate
   Point2 calibrate(const Point2& p, const double tol=1e-5) const;
 
+  /**
+   * Convert a pixel coordinate to ideal coordinate, with derivatives
+   * obtained by inverting those of uncalibrate
+   * @param p point in image coordinates
+   * @param Dcal 2*10 Jacobian wrpt Cal3Unified parameters
+   * @param Dp optional 2*2 Jacobian wrpt image coordinates
+   * @param tol tolerance on the image distance of the round trip
+   * @return point in intrinsic coordinates
+   */
+  Point2 calibrate(const Point2& p, OptionalJacobian<2,10> Dcal,
+      OptionalJacobian<2,2> Dp = boost::none, const double tol=1e-5) const;
+
+  /// Convert a batch of pixel coordinates, one per column, to ideal coordinates
+  Matrix calibratePoints(const Matrix& pi, const double tol=1e-5) const;
+
   /// Convert a 3D point to normalized unit plane
   Point2 spaceToNPlane(const Point2& p) const;
 
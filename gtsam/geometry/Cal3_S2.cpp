@@ -88,6 +88,38 @@ Point2 Cal3_S2::uncalibrate(const Point2& p, OptionalJacobian<2, 5> Dcal,
   return Point2(fx_ * x + s_ * y + u0_, fy_ * y + v0_);
 }
 
+/* ************************************************************************* */
+Matrix uncalibratePoints(const Cal3_S2& K, const Matrix& pn,
+    boost::optional<Matrix&> Dcal, boost::optional<Matrix&> Dp) {
+  const Eigen::Index n = pn.cols();
+  const Eigen::Array<double, 1, Eigen::Dynamic> x = pn.row(0).array(),
+      y = pn.row(1).array();
+  Matrix pi(2, n);
+  pi.row(0) = (K.fx() * x + K.skew() * y + K.px()).matrix();
+  pi.row(1) = (K.fy() * y + K.py()).matrix();
+
+  // Column c of a stacked Jacobian, as a 2*N matrix with point j in column j
+  auto column = [n](Matrix& H, int c) {
+    return Eigen::Map<Matrix>(H.col(c).data(), 2, n);
+  };
+  if (Dcal) {
+    Dcal->setZero(2 * n, 5);
+    column(*Dcal, 0).row(0) = pn.row(0);
+    column(*Dcal, 1).row(1) = pn.row(1);
+    column(*Dcal, 2).row(0) = pn.row(1);
+    column(*Dcal, 3).row(0).setOnes();
+    column(*Dcal, 4).row(1).setOnes();
+  }
+  if (Dp) {
+    Dp->resize(2 * n, 2);
+    column(*Dp, 0).row(0).setConstant(K.fx());
+    column(*Dp, 0).row(1).setZero();
+    column(*Dp, 1).row(0).setConstant(K.skew());
+    column(*Dp, 1).row(1).setConstant(K.fy());
+  }
+  return pi;
+}
+
 /* ************************************************************************* */
 Point2 Cal3_S2::calibrate(const Point2& p, OptionalJacobian<2,5> Dcal,
                            OptionalJacobian<2,2> Dp) const {
@@ -25,6 +25,38 @@
 
 namespace gtsam {
 
+/**
+ * Convert a batch of intrinsic coordinates, one per column of pn, to image
+ * coordinates, by calling uncalibrate on one point at a time. Calibrations can
+ * overload this function next to their class with a kernel that works on all
+ * points at once, as Cal3_S2 and Cal3Bundler do, and PinholeBaseK::projectPoints
+ * picks that overload by argument-dependent lookup.
+ * @param K the calibration
+ * @param pn 2*N matrix, the intrinsic coordinates of point j in column j
+ * @param Dcal if given, resized to the 2N*DimK stacked Jacobians w.r.t. calibration
+ * @param Dp if given, resized to the 2N*2 stacked Jacobians w.r.t. pn
+ * @return 2*N matrix, the image coordinates of point j in column j
+ */
+template<class CALIBRATION>
+Matrix uncalibratePoints(const CALIBRATION& K, const Matrix& pn,
+    boost::optional<Matrix&> Dcal = boost::none,
+    boost::optional<Matrix&> Dp = boost::none) {
+  static const int DimK = FixedDimension<CALIBRATION>::value;
+  const Eigen::Index n = pn.cols();
+  if (Dcal) Dcal->resize(2 * n, DimK);
+  if (Dp) Dp->resize(2 * n, 2);
+  Matrix pi(2, n);
+  Eigen::Matrix<double, 2, DimK> Dpi_cal;
+  Matrix2 Dpi_pn;
+  for (Eigen::Index j = 0; j < n; j++) {
+    pi.col(j) = K.uncalibrate(Point2(pn.col(j)), Dcal ? &Dpi_cal : 0,
+        Dp ? &Dpi_pn : 0);
+    if (Dcal) Dcal->middleRows<2>(2 * j) = Dpi_cal;
+    if (Dp) Dp->middleRows<2>(2 * j) = Dpi_pn;
+  }
+  return pi;
+}
+
 /**
  * A pinhole camera class that has a Pose3 and a *fixed* Calibration.
  * @addtogroup geometry
@@ -40,6 +72,11 @@ private:
   // Get dimensions of calibration type at compile time
   static const int DimK = FixedDimension<CALIBRATION>::value;
 
+  // Column c of a 2N-row stacked Jacobian, as a 2*N matrix
+  static Eigen::Map<Matrix> StackedColumn(Matrix& H, int c) {
+    return Eigen::Map<Matrix>(H.col(c).data(), 2, H.rows() / 2);
+  }
+
 public:
 
   typedef CALIBRATION CalibrationType;
@@ -128,6 +165,78 @@ public:
     return _project(pw, Dpose, Dpoint, Dcal);
   }
 
+  /**
+   * Project a batch of 3D points from world coordinates into the image.
+   * The transformation to camera coordinates, the perspective division and the
+   * chain rule are done on all points at once, as array operations, and so is
+   * the calibration if it has a batched uncalibratePoints, as Cal3_S2 and
+   * Cal3Bundler do. The Jacobians of point j are stored in rows 2j and 2j+1 of
+   * the stacked matrices, so that they can be copied into the factors' blocks
+   * without further allocation.
+   * @param points the N points in world coordinates
+   * @param Dpose if given, resized to the 2N*6 stacked Jacobians w.r.t. pose
+   * @param Dpoints if given, resized to the 2N*3 stacked Jacobians w.r.t. the points
+   * @param Dcal if given, resized to the 2N*DimK stacked Jacobians w.r.t. calibration
+   * @return 2*N matrix, the image coordinates of point j in column j
+   */
+  Matrix projectPoints(const std::vector<Point3>& points,
+      boost::optional<Matrix&> Dpose = boost::none,
+      boost::optional<Matrix&> Dpoints = boost::none,
+      boost::optional<Matrix&> Dcal = boost::none) const {
+    typedef Eigen::Array<double, 1, Eigen::Dynamic> Row;
+    const size_t n = points.size();
+    Eigen::Matrix<double, 3, Eigen::Dynamic> pw(3, n);
+    for (size_t j = 0; j < n; j++)
+      pw.col(j) = points[j];
+
+    // world to camera coordinates, q = R'*(p - t), and normalized coordinates
+    const Matrix3 Rt = pose().rotation().transpose();
+    const Eigen::Matrix<double, 3, Eigen::Dynamic> q = Rt
+        * (pw.colwise() - Vector3(pose().translation()));
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+    if (n > 0 && q.row(2).minCoeff() <= 0)
+      throw CheiralityException();
+#endif
+    const Row d = q.row(2).array().inverse();
+    const Matrix pn = (q.topRows<2>().array().rowwise() * d).matrix();
+
+    // uncalibrate to pixel coordinates
+    Matrix Dpi_pn;
+    const Matrix pi = uncalibratePoints(calibration(), pn, Dcal,
+        Dpose || Dpoints ? boost::optional<Matrix&>(Dpi_pn) : boost::none);
+    if (!Dpose && !Dpoints) return pi;
+
+    // Chain rule for all points at once. Column c of a stacked Jacobian, seen
+    // as a 2*N matrix, has the Jacobian of point j in column j, which is
+    // Dpi_pn of point j times the rows E(j) and O(j) of column c of Dpn
+    const Eigen::Map<Matrix> P0 = StackedColumn(Dpi_pn, 0),
+        P1 = StackedColumn(Dpi_pn, 1);
+    auto chain = [&](Matrix& H, int c, const Row& E, const Row& O) {
+      StackedColumn(H, c) =
+          (P0.array().rowwise() * E + P1.array().rowwise() * O).matrix();
+    };
+    const Row u = pn.row(0).array(), v = pn.row(1).array();
+    if (Dpose) {
+      // see PinholeBase::Dpose
+      Dpose->resize(2 * n, 6);
+      const Row uv = u * v;
+      chain(*Dpose, 0, uv, 1 + v * v);
+      chain(*Dpose, 1, -1 - u * u, -uv);
+      chain(*Dpose, 2, v, -u);
+      chain(*Dpose, 3, -d, Row::Zero(n));
+      chain(*Dpose, 4, Row::Zero(n), -d);
+      chain(*Dpose, 5, d * u, d * v);
+    }
+    if (Dpoints) {
+      // see PinholeBase::Dpoint
+      Dpoints->resize(2 * n, 3);
+      for (int c = 0; c < 3; c++)
+        chain(*Dpoints, c, d * (Rt(0, c) - u * Rt(2, c)),
+            d * (Rt(1, c) - v * Rt(2, c)));
+    }
+    return pi;
+  }
+
   /// backproject a 2-dimensional point to a 3-dimensional point at given depth
   Point3 backproject(const Point2& p, double depth,
                      OptionalJacobian<3, 6> Dresult_dpose = boost::none,
@@ -0,0 +1,97 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file UndistortionGrid.h
+ * @brief Lookup grid of calibrated coordinates for a fixed calibration
+ */
+
+#pragma once
+
+#include <gtsam/geometry/Point2.h>
+#include <gtsam/base/Matrix.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gtsam {
+
+/**
+ * Precomputed calibrate() of a fixed calibration, e.g. Cal3DS2 or Cal3Unified,
+ * on a regular grid of pixels covering the image. A pixel inside the image is
+ * calibrated by bilinear interpolation between the four surrounding grid nodes,
+ * which replaces the iterative undistortion with a few multiply-adds. The
+ * interpolation error shrinks quadratically with the grid step; pixels outside
+ * the image fall back to the calibration's own calibrate().
+ * @addtogroup geometry
+ */
+template <class CALIBRATION>
+class UndistortionGrid {
+
+  CALIBRATION K_; ///< calibration the grid was computed for
+  double step_; ///< distance in pixels between grid nodes
+  size_t cols_, rows_; ///< number of grid nodes in x and y
+  Matrix table_; ///< calibrated coordinates, node (i,j) in column i*cols_+j
+
+public:
+
+  /**
+   * Compute the grid for an image of the given size
+   * @param K the calibration
+   * @param width image width in pixels
+   * @param height image height in pixels
+   * @param step distance in pixels between grid nodes
+   */
+  UndistortionGrid(const CALIBRATION& K, double width, double height,
+      double step = 4.0) :
+      K_(K), step_(step) {
+    if (!(step > 0) || !(width > 0) || !(height > 0))
+      throw std::invalid_argument("UndistortionGrid: image size and step must be positive");
+    cols_ = static_cast<size_t>(std::ceil(width / step)) + 1;
+    rows_ = static_cast<size_t>(std::ceil(height / step)) + 1;
+    table_.resize(2, rows_ * cols_);
+    for (size_t i = 0; i < rows_; i++)
+      for (size_t j = 0; j < cols_; j++)
+        table_.col(i * cols_ + j) = K_.calibrate(Point2(j * step_, i * step_));
+  }
+
+  /// The calibration the grid was computed for
+  const CALIBRATION& calibration() const { return K_; }
+
+  /// Convert image coordinates to intrinsic coordinates
+  Point2 calibrate(const Point2& p) const {
+    const double u = p.x() / step_, v = p.y() / step_;
+    if (!(u >= 0 && v >= 0 && u <= cols_ - 1 && v <= rows_ - 1))
+      return K_.calibrate(p);
+    const size_t j = std::min(static_cast<size_t>(u), cols_ - 2);
+    const size_t i = std::min(static_cast<size_t>(v), rows_ - 2);
+    const double a = u - j, b = v - i;
+    const size_t k = i * cols_ + j;
+    return Point2((1 - b) * ((1 - a) * table_.col(k) + a * table_.col(k + 1))
+        + b * ((1 - a) * table_.col(k + cols_) + a * table_.col(k + cols_ + 1)));
+  }
+
+  /// Convert a batch of image coordinates, one per column, to intrinsic coordinates
+  Matrix calibratePoints(const Matrix& pi) const {
+    if (pi.rows() != 2)
+      throw std::invalid_argument("UndistortionGrid::calibratePoints expects a 2*N matrix");
+    Matrix pn(2, pi.cols());
+    for (Eigen::Index j = 0; j < pi.cols(); ++j)
+      pn.col(j) = calibrate(Point2(pi.col(j)));
+    return pn;
+  }
+
+  /// Number of grid nodes
+  size_t size() const { return rows_ * cols_; }
+};
+
+} // \namespace gtsam
@@ -36,6 +36,7 @@
 #include <iostream>
 #include <limits>
 #include <cmath>
+#include <stdexcept>
 #include <vector>
 
 using namespace std;
@@ -79,63 +80,36 @@ static Point3 CalculateBestAxis(const Point3& n) {
 }
 
 /* ************************************************************************* */
-const Matrix32& Unit3::basis(OptionalJacobian<6, 2> H) const {
-#ifdef GTSAM_USE_TBB
-  // NOTE(hayk): At some point it seemed like this reproducably resulted in
-  // deadlock. However, I don't know why and I can no longer reproduce it.
-  // It either was a red herring or there is still a latent bug left to debug.
-  tbb::mutex::scoped_lock lock(B_mutex_);
-#endif
-
-  const bool cachedBasis = static_cast<bool>(B_);
-  const bool cachedJacobian = static_cast<bool>(H_B_);
+Matrix32 Unit3::basis(OptionalJacobian<6, 2> H) const {
+  Matrix32 B;
+  const Point3 n(p_), axis = CalculateBestAxis(n);
 
   if (H) {
-    if (!cachedJacobian) {
-      // Compute Jacobian. Recomputes B_
-      Matrix32 B;
-      Matrix62 jacobian;
-      Matrix33 H_B1_n, H_b1_B1, H_b2_n, H_b2_b1;
-
-      // Choose the direction of the first basis vector b1 in the tangent plane
-      // by crossing n with the chosen axis.
-      const Point3 n(p_), axis = CalculateBestAxis(n);
-      const Point3 B1 = gtsam::cross(n, axis, &H_B1_n);
-
-      // Normalize result to get a unit vector: b1 = B1 / |B1|.
-      B.col(0) = normalize(B1, &H_b1_B1);
-
-      // Get the second basis vector b2, which is orthogonal to n and b1.
-      B.col(1) = gtsam::cross(n, B.col(0), &H_b2_n, &H_b2_b1);
-
-      // Chain rule tomfoolery to compute the jacobian.
-      const Matrix32& H_n_p = B;
-      jacobian.block<3, 2>(0, 0) = H_b1_B1 * H_B1_n * H_n_p;
-      auto H_b1_p = jacobian.block<3, 2>(0, 0);
-      jacobian.block<3, 2>(3, 0) = H_b2_n * H_n_p + H_b2_b1 * H_b1_p;
-
-      // Cache the result and jacobian
-      H_B_.reset(jacobian);
-      B_.reset(B);
-    }
+    Matrix33 H_B1_n, H_b1_B1, H_b2_n, H_b2_b1;
 
-    // Return cached jacobian, possibly computed just above
-    *H = *H_B_;
-  }
+    // Choose the direction of the first basis vector b1 in the tangent plane
+    // by crossing n with the chosen axis.
+    const Point3 B1 = gtsam::cross(n, axis, &H_B1_n);
 
-  if (!cachedBasis) {
-    // Same calculation as above, without derivatives.
-    // Done after H block, as that possibly computes B_ for the first time
-    Matrix32 B;
+    // Normalize result to get a unit vector: b1 = B1 / |B1|.
+    B.col(0) = normalize(B1, &H_b1_B1);
+
+    // Get the second basis vector b2, which is orthogonal to n and b1.
+    B.col(1) = gtsam::cross(n, B.col(0), &H_b2_n, &H_b2_b1);
 
-    const Point3 n(p_), axis = CalculateBestAxis(n);
+    // Chain rule tomfoolery to compute the jacobian.
+    const Matrix32& H_n_p = B;
+    const Matrix32 H_b1_p = H_b1_B1 * H_B1_n * H_n_p;
+    H->block<3, 2>(0, 0) = H_b1_p;
+    H->block<3, 2>(3, 0) = H_b2_n * H_n_p + H_b2_b1 * H_b1_p;
+  } else {
+    // Same calculation as above, without derivatives.
     const Point3 B1 = gtsam::cross(n, axis);
     B.col(0) = normalize(B1);
     B.col(1) = gtsam::cross(n, B.col(0));
-    B_.reset(B);
   }
 
-  return *B_;
+  return B;
 }
 
 /* ************************************************************************* */
@@ -196,9 +170,10 @@ double Unit3::dot(const Unit3& q, OptionalJacobian<1, 2> H_p,
 /* ************************************************************************* */
 Vector2 Unit3::error(const Unit3& q, OptionalJacobian<2, 2> H_q) const {
   // 2D error is equal to B'*q, as B is 3x2 matrix and q is 3x1
-  const Vector2 xi = basis().transpose() * q.p_;
+  const Matrix23 Bt = basis().transpose();
+  const Vector2 xi = Bt * q.p_;
   if (H_q) {
-    *H_q = basis().transpose() * q.basis();
+    *H_q = Bt * q.basis();
   }
   return xi;
 }
@@ -252,7 +227,8 @@ double Unit3::distance(const Unit3& q, OptionalJacobian<1, 2> H) const {
 /* ************************************************************************* */
 Unit3 Unit3::retract(const Vector2& v, OptionalJacobian<2,2> H) const {
   // Compute the 3D xi_hat vector
-  const Vector3 xi_hat = basis() * v;
+  const Matrix32 B = basis();
+  const Vector3 xi_hat = B * v;
   const double theta = xi_hat.norm();
   const double c = std::cos(theta);
 
@@ -263,7 +239,7 @@ Unit3 Unit3::retract(const Vector2& v, OptionalJacobian<2,2> H) const {
                                                  H? &H_from_point : nullptr);
     if (H) { // Jacobian
       *H = H_from_point *
-          (-p_ * xi_hat.transpose() + Matrix33::Identity()) * basis();
+          (-p_ * xi_hat.transpose() + Matrix33::Identity()) * B;
     }
     return exp_p_xi_hat;
   }
@@ -274,7 +250,7 @@ Unit3 Unit3::retract(const Vector2& v, OptionalJacobian<2,2> H) const {
   if (H) { // Jacobian
     *H = H_from_point *
         (p_ * -st * xi_hat.transpose() + st * Matrix33::Identity() +
-        xi_hat * ((c - st) / std::pow(theta, 2)) * xi_hat.transpose()) * basis();
+        xi_hat * ((c - st) / std::pow(theta, 2)) * xi_hat.transpose()) * B;
   }
   return exp_p_xi_hat;
 }
@@ -299,6 +275,27 @@ Vector2 Unit3::localCoordinates(const Unit3& other) const {
   }
   return basis().transpose() * y * (other.p_ - x * p_);
 }
+/* ************************************************************************* */
+Matrix Unit3::ErrorVectors(const std::vector<Unit3>& p, const std::vector<Unit3>& q) {
+  if (p.size() != q.size())
+    throw std::invalid_argument("Unit3::ErrorVectors: p and q have different sizes");
+  Matrix errors(2, p.size());
+  for (size_t i = 0; i < p.size(); ++i)
+    errors.col(i) = p[i].errorVector(q[i]);
+  return errors;
+}
+
+/* ************************************************************************* */
+std::vector<Unit3> Unit3::Retract(const std::vector<Unit3>& p, const Matrix& v) {
+  if (v.rows() != 2 || (size_t)v.cols() != p.size())
+    throw std::invalid_argument("Unit3::Retract: v must be 2*n for n directions");
+  std::vector<Unit3> result;
+  result.reserve(p.size());
+  for (size_t i = 0; i < p.size(); ++i)
+    result.push_back(p[i].retract(v.col(i)));
+  return result;
+}
+
 /* ************************************************************************* */
 
 }  // namespace gtsam
@@ -31,10 +31,7 @@
 #include <boost/serialization/nvp.hpp>
 
 #include <string>
-
-#ifdef GTSAM_USE_TBB
-#include <tbb/mutex.h>
-#endif
+#include <vector>
 
 namespace gtsam {
 
@@ -44,12 +41,6 @@ class GTSAM_EXPORT Unit3 {
 private:
 
   Vector3 p_; ///< The location of the point on the unit sphere
-  mutable boost::optional<Matrix32> B_; ///< Cached basis
-  mutable boost::optional<Matrix62> H_B_; ///< Cached basis derivative
-
-#ifdef GTSAM_USE_TBB
-  mutable tbb::mutex B_mutex_; ///< Mutex to protect the cached basis.
-#endif
 
 public:
 
@@ -82,17 +73,6 @@ public:
     p_.normalize();
   }
 
-  /// Copy constructor
-  Unit3(const Unit3& u) {
-    p_ = u.p_;
-  }
-
-  /// Copy assignment
-  Unit3& operator=(const Unit3 & u) {
-    p_ = u.p_;
-    return *this;
-  }
-
   /// Named constructor from Point3 with optional Jacobian
   static Unit3 FromPoint3(const Point3& point, //
       OptionalJacobian<2, 3> H = boost::none);
@@ -124,8 +104,11 @@ public:
    * It is a 3*2 matrix [b1 b2] composed of two orthogonal directions
    * tangent to the sphere at the current direction.
    * Provides derivatives of the basis with the two basis vectors stacked up as a 6x1.
+   * The basis is a deterministic function of the direction and is computed on
+   * every call rather than cached, which keeps Unit3 a plain 3-vector that is
+   * cheap to copy and safe to share between threads.
    */
-  const Matrix32& basis(OptionalJacobian<6, 2> H = boost::none) const;
+  Matrix32 basis(OptionalJacobian<6, 2> H = boost::none) const;
 
   /// Return skew-symmetric associated with 3D point on unit sphere
   Matrix3 skew() const;
@@ -195,6 +178,17 @@ public:
 
   /// @}
 
+  /// @name Batch operations
+  /// @{
+
+  /// errorVector between p[i] and q[i] for all i, as the columns of a 2*n matrix
+  static Matrix ErrorVectors(const std::vector<Unit3>& p, const std::vector<Unit3>& q);
+
+  /// Retract p[i] by the i-th column of the 2*n matrix v, for all i
+  static std::vector<Unit3> Retract(const std::vector<Unit3>& p, const Matrix& v);
+
+  /// @}
+
 private:
 
   /// @name Advanced Interface
@@ -76,6 +76,27 @@ TEST( Cal3Bundler, Duncalibrate)
   CHECK(assert_equal(Dcombined,K.D2d_intrinsic_calibration(p),1e-7));
 }
 
+/* ************************************************************************* */
+TEST( Cal3Bundler, uncalibratePoints)
+{
+  // Batch against one point at a time, with the Jacobians of point j in rows 2j, 2j+1
+  Matrix pn(2, 3);
+  pn << 2.0, -0.2, 0.5,
+        3.0, 0.5, 0.5;
+  Matrix Dcal, Dp;
+  const Matrix actual = uncalibratePoints(K, pn, Dcal, Dp);
+  LONGS_EQUAL(2 * pn.cols(), Dcal.rows());
+  LONGS_EQUAL(2 * pn.cols(), Dp.rows());
+  for (int j = 0; j < pn.cols(); j++) {
+    Matrix H1, H2;
+    const Point2 expected = K.uncalibrate(Point2(pn.col(j)), H1, H2);
+    CHECK(assert_equal(expected, Point2(actual.col(j)), 1e-9));
+    CHECK(assert_equal(H1, Matrix(Dcal.middleRows(2 * j, 2)), 1e-9));
+    CHECK(assert_equal(H2, Matrix(Dp.middleRows(2 * j, 2)), 1e-9));
+  }
+  CHECK(assert_equal(actual, uncalibratePoints(K, pn)));
+}
+
 /* ************************************************************************* */
 TEST( Cal3Bundler, assert_equal)
 {
@@ -19,6 +19,7 @@
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/numericalDerivative.h>
 #include <gtsam/geometry/Cal3DS2.h>
+#include <gtsam/geometry/UndistortionGrid.h>
 
 using namespace gtsam;
 
@@ -51,7 +52,66 @@ TEST( Cal3DS2, calibrate )
   CHECK( traits<Point2>::Equals(pn, pn_hat, 1e-5));
 }
 
+/* ************************************************************************* */
+// A lens with strong barrel distortion, as in OpenCV calibrations
+static Cal3DS2 Kopencv(520, 515, 0, 320, 240, -0.3, 0.1, 1e-3, -2e-3);
+
+TEST( Cal3DS2, calibrateNewton )
+{
+  // Round trip over the normalized coordinates of a 640*480 image
+  double maxError = 0;
+  for (double x = -0.6; x <= 0.6; x += 0.05)
+    for (double y = -0.45; y <= 0.45; y += 0.05) {
+      const Point2 pn(x, y);
+      const Point2 pn_hat = Kopencv.calibrate(Kopencv.uncalibrate(pn), 1e-9);
+      maxError = std::max(maxError, distance2(pn, pn_hat));
+    }
+  EXPECT(maxError < 1e-10);
+}
+
+TEST( Cal3DS2, calibrateStrongDistortion )
+{
+  // Near the corner plain Newton steps overshoot and do not
+  // converge within the iteration limit, fixed point steps recover them
+  Cal3DS2 K(500, 500, 0, 320, 240, -0.5, 0.1, 1e-3, -2e-3);
+  const Point2 pi(640, 435);
+  const Point2 pn = K.calibrate(pi);
+  EXPECT(assert_equal(pi, K.uncalibrate(pn), 1e-5));
+}
+
+/* ************************************************************************* */
+TEST( Cal3DS2, calibratePoints )
+{
+  Matrix pi(2, 3);
+  pi << 0, 320, 639, 0, 240, 479;
+  const Matrix pn = Kopencv.calibratePoints(pi);
+  for (int j = 0; j < 3; j++)
+    EXPECT(assert_equal(Kopencv.calibrate(Point2(pi.col(j))), Point2(pn.col(j))));
+  CHECK_EXCEPTION(Kopencv.calibratePoints(Matrix::Zero(3, 1)), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST( Cal3DS2, undistortionGrid )
+{
+  // Bilinear interpolation on a 4-pixel grid, accurate to 1e-2 pixels in the
+  // strongly distorted corners
+  UndistortionGrid<Cal3DS2> grid(Kopencv, 640, 480, 4.0);
+  double maxError = 0;
+  for (double u = 0.5; u < 640; u += 7.3)
+    for (double v = 0.5; v < 480; v += 5.1) {
+      const Point2 pi(u, v);
+      maxError = std::max(maxError,
+          distance2(Kopencv.calibrate(pi, 1e-9), grid.calibrate(pi)));
+    }
+  EXPECT(maxError * 520 < 2e-2);
+
+  // Grid nodes are exact, and pixels outside the image fall back to calibrate
+  EXPECT(assert_equal(Kopencv.calibrate(Point2(320, 240)), grid.calibrate(Point2(320, 240)), 1e-9));
+  EXPECT(assert_equal(Kopencv.calibrate(Point2(-10, 500)), grid.calibrate(Point2(-10, 500)), 1e-9));
+}
+
 Point2 uncalibrate_(const Cal3DS2& k, const Point2& pt) { return k.uncalibrate(pt); }
+Point2 calibrate_(const Cal3DS2& k, const Point2& pt) { return k.calibrate(pt, 1e-12); }
 
 /* ************************************************************************* */
 TEST( Cal3DS2, Duncalibrate1)
@@ -74,6 +134,17 @@ TEST( Cal3DS2, Duncalibrate2)
   CHECK(assert_equal(numerical,separate,1e-5));
 }
 
+/* ************************************************************************* */
+TEST( Cal3DS2, Dcalibrate)
+{
+  const Point2 pi = Kopencv.uncalibrate(Point2(0.4, -0.3));
+  Matrix29 Dcal;
+  Matrix2 Dp;
+  Kopencv.calibrate(pi, Dcal, Dp, 1e-12);
+  EXPECT(assert_equal(numericalDerivative21(calibrate_, Kopencv, pi, 1e-7), Matrix(Dcal), 1e-5));
+  EXPECT(assert_equal(numericalDerivative22(calibrate_, Kopencv, pi, 1e-7), Matrix(Dp), 1e-5));
+}
+
 /* ************************************************************************* */
 TEST( Cal3DS2, assert_equal)
 {
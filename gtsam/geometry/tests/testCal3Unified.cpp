@@ -18,6 +18,7 @@
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/numericalDerivative.h>
 #include <gtsam/geometry/Cal3Unified.h>
+#include <gtsam/geometry/UndistortionGrid.h>
 
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/inference/Key.h>
@@ -62,7 +63,31 @@ TEST( Cal3Unified, calibrate)
   CHECK( traits<Point2>::Equals(p, pn_hat, 1e-8));
 }
 
+/* ************************************************************************* */
+TEST( Cal3Unified, calibratePoints)
+{
+  Matrix pi(2, 2);
+  pi << K.uncalibrate(p), K.uncalibrate(Point2(-0.3, 0.2));
+  const Matrix pn = K.calibratePoints(pi);
+  EXPECT(assert_equal(p, Point2(pn.col(0)), 1e-8));
+  EXPECT(assert_equal(Point2(-0.3, 0.2), Point2(pn.col(1)), 1e-8));
+}
+
+/* ************************************************************************* */
+TEST( Cal3Unified, undistortionGrid)
+{
+  UndistortionGrid<Cal3Unified> grid(K, 640, 480, 4.0);
+  double maxError = 0;
+  for (double u = 0.5; u < 640; u += 7.3)
+    for (double v = 0.5; v < 480; v += 5.1) {
+      const Point2 pi(u, v);
+      maxError = std::max(maxError, distance2(K.calibrate(pi, 1e-9), grid.calibrate(pi)));
+    }
+  EXPECT(maxError < 1e-4);
+}
+
 Point2 uncalibrate_(const Cal3Unified& k, const Point2& pt) { return k.uncalibrate(pt); }
+Point2 calibrate_(const Cal3Unified& k, const Point2& pt) { return k.calibrate(pt, 1e-12); }
 
 /* ************************************************************************* */
 TEST( Cal3Unified, Duncalibrate1)
@@ -82,6 +107,17 @@ TEST( Cal3Unified, Duncalibrate2)
   CHECK(assert_equal(numerical,computed,1e-6));
 }
 
+/* ************************************************************************* */
+TEST( Cal3Unified, Dcalibrate)
+{
+  const Point2 pi = K.uncalibrate(p);
+  Eigen::Matrix<double, 2, 10> Dcal;
+  Matrix2 Dp;
+  K.calibrate(pi, Dcal, Dp, 1e-12);
+  EXPECT(assert_equal(numericalDerivative21(calibrate_, K, pi, 1e-7), Matrix(Dcal), 1e-5));
+  EXPECT(assert_equal(numericalDerivative22(calibrate_, K, pi, 1e-7), Matrix(Dp), 1e-5));
+}
+
 /* ************************************************************************* */
 TEST( Cal3Unified, assert_equal)
 {
@@ -96,6 +96,27 @@ TEST(Cal3_S2, Dcalibrate2)
     CHECK(assert_equal(numerical, computed, 1e-8));
 }
 
+/* ************************************************************************* */
+TEST( Cal3_S2, uncalibratePoints)
+{
+  // Batch against one point at a time, with the Jacobians of point j in rows 2j, 2j+1
+  Matrix pn(2, 3);
+  pn << 1.0, -0.2, 0.3,
+        -2.0, 0.5, 0.0;
+  Matrix Dcal, Dp;
+  const Matrix actual = uncalibratePoints(K, pn, Dcal, Dp);
+  LONGS_EQUAL(2 * pn.cols(), Dcal.rows());
+  LONGS_EQUAL(2 * pn.cols(), Dp.rows());
+  for (int j = 0; j < pn.cols(); j++) {
+    Matrix H1, H2;
+    const Point2 expected = K.uncalibrate(Point2(pn.col(j)), H1, H2);
+    CHECK(assert_equal(expected, Point2(actual.col(j)), 1e-9));
+    CHECK(assert_equal(H1, Matrix(Dcal.middleRows(2 * j, 2)), 1e-9));
+    CHECK(assert_equal(H2, Matrix(Dp.middleRows(2 * j, 2)), 1e-9));
+  }
+  CHECK(assert_equal(actual, uncalibratePoints(K, pn)));
+}
+
 /* ************************************************************************* */
 TEST( Cal3_S2, assert_equal)
 {
@@ -18,6 +18,8 @@
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/Cal3_S2.h>
 #include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/Cal3DS2.h>
+#include <gtsam/geometry/Cal3Unified.h>
 #include <gtsam/geometry/Pose2.h>
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/numericalDerivative.h>
@@ -336,6 +338,54 @@ TEST( PinholeCamera, range3) {
   EXPECT(assert_equal(Hexpected2, D2, 1e-7));
 }
 
+/* ************************************************************************* */
+namespace {
+// Check batch projection against projecting one point at a time
+template <class CAMERA>
+bool checkProjectPoints(const CAMERA& camera, const vector<Point3>& points) {
+  const int DimK = FixedDimension<typename CAMERA::CalibrationType>::value;
+  Matrix Dpose, Dpoints, Dcal;
+  const Matrix actual = camera.projectPoints(points, Dpose, Dpoints, Dcal);
+  bool ok = actual.cols() == (int)points.size() && Dpose.rows() == 2 * actual.cols()
+      && Dpoints.rows() == 2 * actual.cols() && Dcal.rows() == 2 * actual.cols();
+  for (size_t j = 0; ok && j < points.size(); j++) {
+    Matrix26 H1;
+    Matrix23 H2;
+    Eigen::Matrix<double, 2, DimK> H3;
+    const Point2 expected = camera.PinholeBaseK<typename CAMERA::CalibrationType>::project(
+        points[j], H1, H2, H3);
+    ok = assert_equal(expected, Point2(actual.col(j)), 1e-9)
+        && assert_equal(Matrix(H1), Matrix(Dpose.middleRows(2 * j, 2)), 1e-9)
+        && assert_equal(Matrix(H2), Matrix(Dpoints.middleRows(2 * j, 2)), 1e-9)
+        && assert_equal(Matrix(H3), Matrix(Dcal.middleRows(2 * j, 2)), 1e-9);
+  }
+  return ok && assert_equal(actual, camera.projectPoints(points));
+}
+}
+
+TEST( PinholeCamera, projectPoints)
+{
+  vector<Point3> points;
+  points.push_back(point1);
+  points.push_back(point2);
+  points.push_back(point3);
+  points.push_back(point4);
+  points.push_back(Point3(0.3, -0.2, -2.0));
+
+  EXPECT(checkProjectPoints(camera, points));
+  EXPECT(checkProjectPoints(PinholeCamera<Cal3Bundler>(pose,
+      Cal3Bundler(500, 1e-3, 1e-3, 1000, 2000)), points));
+  EXPECT(checkProjectPoints(PinholeCamera<Cal3DS2>(pose,
+      Cal3DS2(500, 100, 0.1, 320, 240, 1e-3, 2.0 * 1e-3, 3.0 * 1e-3, 4.0 * 1e-3)), points));
+  EXPECT(checkProjectPoints(PinholeCamera<Cal3Unified>(pose,
+      Cal3Unified(100, 105, 0.0, 320, 240, 1e-3, 2e-3, 3e-3, 4e-3, 0.1)), points));
+  EXPECT(checkProjectPoints(PinholePose<Cal3_S2>(pose,
+      boost::make_shared<Cal3_S2>(K)), points));
+
+  // an empty batch
+  EXPECT_LONGS_EQUAL(0, camera.projectPoints(vector<Point3>()).cols());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
 /* ************************************************************************* */
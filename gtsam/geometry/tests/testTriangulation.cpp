@@ -432,6 +432,116 @@ TEST( triangulation, StereotriangulateNonlinear ) {
   }
 }
 
+//******************************************************************************
+TEST( triangulation, batch) {
+  Pose3 pose3 = pose1 * Pose3(Rot3::Ypr(0.1, 0.2, 0.1), Point3(0.1, -2, -.1));
+  PinholeCamera<Cal3_S2> camera3(pose3, Cal3_S2(700, 500, 0, 640, 480));
+  CameraSet<PinholeCamera<Cal3_S2> > cameras;
+  cameras += camera1, camera2, camera3;
+
+  // Three tracks: noise-free in two cameras, noisy in three, and a single observation
+  Point3 landmark2(6, -0.5, 0.8);
+  Point2Vector measurements;
+  measurements += z1, z2;
+  measurements += camera1.project(landmark2) + Point2(0.3, -0.2),
+      camera2.project(landmark2) + Point2(-0.1, 0.2),
+      camera3.project(landmark2) + Point2(0.2, 0.1);
+  measurements += camera3.project(landmark);
+  vector<size_t> cameraIndices, trackOffsets;
+  cameraIndices += 0, 1, 0, 1, 2, 2;
+  trackOffsets += 0, 2, 5, 6;
+
+  // Each track agrees with the single-track functions
+  TriangulationParameters params(1.0, true);
+  vector<TriangulationResult> actual = triangulateBatch(cameras, measurements,
+      cameraIndices, trackOffsets, params);
+  LONGS_EQUAL(3, actual.size());
+  EXPECT(actual[0].valid());
+  EXPECT(assert_equal(landmark, *actual[0], 1e-6));
+  Point2Vector measurements2(measurements.begin() + 2, measurements.begin() + 5);
+  Point3 expected = triangulatePoint3<PinholeCamera<Cal3_S2> >(cameras,
+      measurements2, 1e-9, true);
+  EXPECT(actual[1].valid());
+  EXPECT(assert_equal(expected, *actual[1], 1e-4));
+  EXPECT(actual[2].degenerate());
+
+  // The outlier threshold is checked as in triangulateSafe
+  TriangulationParameters params2(1.0, true, -1, 0.01);
+  actual = triangulateBatch(cameras, measurements, cameraIndices, trackOffsets,
+      params2);
+  EXPECT(actual[0].valid());
+  EXPECT(actual[1].outlier());
+
+  // Even without tracks, the offsets hold the end of the last one
+  CHECK_EXCEPTION(triangulateBatch(cameras, Point2Vector(), vector<size_t>(),
+      vector<size_t>(), params), std::invalid_argument);
+  EXPECT(triangulateBatch(cameras, Point2Vector(), vector<size_t>(),
+      vector<size_t>(1, 0), params).empty());
+}
+
+//******************************************************************************
+TEST( triangulation, batchInvalidInput) {
+  CameraSet<PinholeCamera<Cal3_S2> > cameras;
+  cameras += camera1, camera2;
+  Point2Vector measurements;
+  measurements += z1, z2, z1, z2;
+  vector<size_t> cameraIndices, trackOffsets;
+  cameraIndices += 0, 1, 0, 1;
+  trackOffsets += 0, 2, 4;
+  TriangulationParameters params(1.0);
+  EXPECT_LONGS_EQUAL(2, triangulateBatch(cameras, measurements, cameraIndices,
+      trackOffsets, params).size());
+
+  // A camera index is missing
+  vector<size_t> tooFewIndices(cameraIndices.begin(), cameraIndices.end() - 1);
+  CHECK_EXCEPTION(triangulateBatch(cameras, measurements, tooFewIndices,
+      trackOffsets, params), std::invalid_argument);
+
+  // A camera index is out of range
+  vector<size_t> badIndices(cameraIndices);
+  badIndices[3] = 2;
+  CHECK_EXCEPTION(triangulateBatch(cameras, measurements, badIndices,
+      trackOffsets, params), std::invalid_argument);
+
+  // The offsets decrease
+  vector<size_t> decreasing;
+  decreasing += 0, 3, 2, 4;
+  CHECK_EXCEPTION(triangulateBatch(cameras, measurements, cameraIndices,
+      decreasing, params), std::invalid_argument);
+
+  // The offsets end before or after the last measurement
+  vector<size_t> endsEarly, endsLate;
+  endsEarly += 0, 2, 3;
+  endsLate += 0, 2, 5;
+  CHECK_EXCEPTION(triangulateBatch(cameras, measurements, cameraIndices,
+      endsEarly, params), std::invalid_argument);
+  CHECK_EXCEPTION(triangulateBatch(cameras, measurements, cameraIndices,
+      endsLate, params), std::invalid_argument);
+}
+
+//******************************************************************************
+TEST( triangulation, batchNarrowBaseline) {
+  // A tenth of a millimeter baseline makes the DLT system badly conditioned
+  PinholeCamera<Cal3_S2> camera3(pose1 * Pose3(Rot3(), Point3(1e-4, 0, 0)),
+      *sharedCal);
+  CameraSet<PinholeCamera<Cal3_S2> > cameras;
+  cameras += camera1, camera3;
+  Point2Vector measurements;
+  measurements += camera1.project(landmark) + Point2(0.01, -0.02),
+      camera3.project(landmark);
+  vector<size_t> cameraIndices, trackOffsets;
+  cameraIndices += 0, 1;
+  trackOffsets += 0, 2;
+
+  // Batch and single-track DLT agree
+  Point3 expected = triangulatePoint3<PinholeCamera<Cal3_S2> >(cameras,
+      measurements, 1e-9, false);
+  vector<TriangulationResult> actual = triangulateBatch(cameras, measurements,
+      cameraIndices, trackOffsets, TriangulationParameters(1e-9));
+  EXPECT(actual[0].valid());
+  EXPECT(assert_equal(expected, *actual[0], 1e-9));
+}
+
 //******************************************************************************
 int main() {
   TestResult tr;
@@ -320,19 +320,16 @@ TEST(Unit3, basis) {
   Matrix62 expectedH = numericalDerivative11<Vector6, Unit3>(
       boost::bind(BasisTest, _1, boost::none), p);
 
-  // without H, first time
+  // without H
   EXPECT(assert_equal(expected, p.basis(), 1e-6));
 
-  // without H, cached
-  EXPECT(assert_equal(expected, p.basis(), 1e-6));
-
-  // with H, first time
+  // with H
   EXPECT(assert_equal(expected, p.basis(actualH), 1e-6));
   EXPECT(assert_equal(expectedH, actualH, 1e-8));
 
-  // with H, cached
-  EXPECT(assert_equal(expected, p.basis(actualH), 1e-6));
-  EXPECT(assert_equal(expectedH, actualH, 1e-8));
+  // the basis does not depend on previous calls
+  EXPECT(assert_equal(expected, p.basis(), 1e-6));
+  EXPECT(assert_equal(expected, Unit3(p).basis(), 1e-6));
 }
 
 //*******************************************************************************
@@ -352,6 +349,30 @@ TEST(Unit3, basis_derivatives) {
   }
 }
 
+//*******************************************************************************
+TEST(Unit3, batch) {
+  boost::mt19937 rng(42);
+  std::vector<Unit3> p, q;
+  Matrix v(2, 10);
+  for (size_t i = 0; i < 10; i++) {
+    p.push_back(Unit3::Random(rng));
+    q.push_back(Unit3::Random(rng));
+    v.col(i) << 0.01 * i, -0.02 * i;
+  }
+
+  const Matrix errors = Unit3::ErrorVectors(p, q);
+  const std::vector<Unit3> retracted = Unit3::Retract(p, v);
+  EXPECT_LONGS_EQUAL(10, errors.cols());
+  EXPECT_LONGS_EQUAL(10, retracted.size());
+  for (size_t i = 0; i < 10; i++) {
+    EXPECT(assert_equal(p[i].errorVector(q[i]), Vector2(errors.col(i))));
+    EXPECT(assert_equal(p[i].retract(v.col(i)), retracted[i]));
+  }
+
+  CHECK_EXCEPTION(Unit3::ErrorVectors(p, std::vector<Unit3>(3)), std::invalid_argument);
+  CHECK_EXCEPTION(Unit3::Retract(p, Matrix::Zero(2, 3)), std::invalid_argument);
+}
+
 //*******************************************************************************
 TEST(Unit3, retract) {
   {
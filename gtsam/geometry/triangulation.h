@@ -25,6 +25,12 @@
 #include <gtsam/slam/PriorFactor.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace gtsam {
 
@@ -514,5 +520,171 @@ TriangulationResult triangulateSafe(const CameraSet<CAMERA>& cameras,
     }
 }
 
+namespace internal {
+
+/**
+ * Triangulate one track of a batch: DLT on a 4*4 triangular system, followed by
+ * at most maxIterations Gauss-Newton steps when params.enableEPI is set, and the
+ * same checks as triangulateSafe.
+ */
+template<class CAMERA>
+TriangulationResult triangulateTrack(const CameraSet<CAMERA>& cameras,
+    const std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> >& projections,
+    const Point2Vector& measurements, const std::vector<size_t>& cameraIndices,
+    size_t begin, size_t end, const TriangulationParameters& params,
+    size_t maxIterations) {
+
+  if (end - begin < 2)
+    return TriangulationResult::Degenerate();
+
+  // Reduce the DLT system A to a 4*4 triangular R with the same singular values,
+  // two rows at a time, and take the SVD of R as triangulateDLT does of A.
+  // Unlike the normal equations A'*A, this does not square the condition number.
+  Matrix4 R = Matrix4::Zero();
+  Eigen::Matrix<double, 6, 4> stacked;
+  for (size_t k = begin; k < end; k++) {
+    const Matrix34& P = projections[cameraIndices[k]];
+    const Point2& p = measurements[k];
+    stacked << R, p.x() * P.row(2) - P.row(0), p.y() * P.row(2) - P.row(1);
+    const Eigen::HouseholderQR<Eigen::Matrix<double, 6, 4> > qr(stacked);
+    R = qr.matrixQR().template topRows<4>().template triangularView<Eigen::Upper>();
+  }
+  const Eigen::JacobiSVD<Matrix4> svd(R, Eigen::ComputeFullV);
+  int rank = 0;
+  for (int j = 0; j < 4; j++)
+    if (svd.singularValues()(j) > params.rankTolerance)
+      rank++;
+  const Vector4 v = svd.matrixV().col(3);
+  if (rank < 3 || v[3] == 0.0)
+    return TriangulationResult::Degenerate();
+  Point3 point(v.head<3>() / v[3]);
+
+  try {
+    // Refine with Gauss-Newton on the reprojection error, stopping as soon as
+    // a step does not decrease the error
+    if (params.enableEPI) {
+      double previousError = std::numeric_limits<double>::infinity();
+      Point3 previousPoint = point;
+      for (size_t iteration = 0; iteration <= maxIterations; iteration++) {
+        Matrix3 H = Matrix3::Zero();
+        Vector3 g = Vector3::Zero();
+        double error = 0.0;
+        for (size_t k = begin; k < end; k++) {
+          Matrix23 D;
+          const Vector2 e = cameras[cameraIndices[k]].project2(point,
+              boost::none, D) - measurements[k];
+          H.noalias() += D.transpose() * D;
+          g.noalias() += D.transpose() * e;
+          error += e.squaredNorm();
+        }
+        if (error > previousError) {
+          point = previousPoint;
+          break;
+        }
+        if (iteration == maxIterations) break;
+        // A singular normal matrix leaves the point undetermined
+        const Eigen::LDLT<Matrix3> ldlt(H);
+        const Vector3 delta = ldlt.solve(g);
+        if (ldlt.info() != Eigen::Success || !delta.allFinite()
+            || ldlt.vectorD().minCoeff() <= 1e-12 * ldlt.vectorD().maxCoeff())
+          return TriangulationResult::Degenerate();
+        previousError = error;
+        previousPoint = point;
+        point = point - delta;
+        if (delta.norm() < 1e-9 * (1.0 + point.norm())) break;
+      }
+    }
+
+    // Check landmark distance and re-projection errors to avoid outliers
+    double maxReprojError = 0.0;
+    for (size_t k = begin; k < end; k++) {
+      const CAMERA& camera = cameras[cameraIndices[k]];
+      const Pose3& pose = camera.pose();
+      if (params.landmarkDistanceThreshold > 0
+          && distance3(pose.translation(), point)
+              > params.landmarkDistanceThreshold)
+        return TriangulationResult::FarPoint();
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+      if (pose.transformTo(point).z() <= 0)
+        return TriangulationResult::BehindCamera();
+#endif
+      if (params.dynamicOutlierRejectionThreshold > 0) {
+        const Point2 reprojectionError(camera.project(point) - measurements[k]);
+        maxReprojError = std::max(maxReprojError, reprojectionError.norm());
+      }
+    }
+    if (params.dynamicOutlierRejectionThreshold > 0
+        && maxReprojError > params.dynamicOutlierRejectionThreshold)
+      return TriangulationResult::Outlier();
+  } catch (CheiralityException&) {
+    return TriangulationResult::BehindCamera();
+  }
+
+  return TriangulationResult(point);
+}
+
+} // \namespace internal
+
+/**
+ * Triangulate many tracks at once, e.g., all landmarks of a structure from
+ * motion problem. The observations of all tracks are passed in flat arrays, and
+ * each track is triangulated with a DLT on a fixed-size 4*4 system, optionally
+ * followed by a few Gauss-Newton steps, without building a factor graph. Tracks
+ * are processed in parallel if TBB is enabled.
+ * @param cameras all cameras, shared by the tracks
+ * @param measurements measurements of all tracks, one track after the other
+ * @param cameraIndices index in cameras of each measurement
+ * @param trackOffsets index of the first measurement of each track, plus one
+ *        past the last measurement, i.e., track j is [trackOffsets[j], trackOffsets[j+1])
+ * @param params rank tolerance and outlier thresholds as in triangulateSafe,
+ *        enableEPI turns on Gauss-Newton refinement
+ * @param maxIterations maximum number of Gauss-Newton iterations per track
+ * @return a TriangulationResult per track, with the reason a track is invalid
+ * @throws std::invalid_argument if measurements and cameraIndices differ in
+ *         size, a camera index is out of range, or trackOffsets is empty,
+ *         decreasing, or does not end at the number of measurements
+ */
+template<class CAMERA>
+std::vector<TriangulationResult> triangulateBatch(
+    const CameraSet<CAMERA>& cameras, const Point2Vector& measurements,
+    const std::vector<size_t>& cameraIndices,
+    const std::vector<size_t>& trackOffsets,
+    const TriangulationParameters& params, size_t maxIterations = 5) {
+
+  if (measurements.size() != cameraIndices.size())
+    throw std::invalid_argument(
+        "triangulateBatch: need one camera index per measurement");
+  if (trackOffsets.empty())
+    throw std::invalid_argument(
+        "triangulateBatch: trackOffsets needs at least the end of the last track");
+  if (!std::is_sorted(trackOffsets.begin(), trackOffsets.end()))
+    throw std::invalid_argument(
+        "triangulateBatch: trackOffsets must not decrease");
+  if (trackOffsets.back() != measurements.size())
+    throw std::invalid_argument(
+        "triangulateBatch: trackOffsets must end at the number of measurements");
+  for (size_t index : cameraIndices)
+    if (index >= cameras.size())
+      throw std::invalid_argument(
+          "triangulateBatch: camera index out of range");
+
+  // Projection matrices are computed once per camera, not once per observation
+  std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> > projections;
+  projections.reserve(cameras.size());
+  for (const CAMERA& camera : cameras)
+    projections.push_back(
+        CameraProjectionMatrix<typename CAMERA::CalibrationType>(
+            camera.calibration())(camera.pose()));
+
+  const size_t nrTracks = trackOffsets.size() - 1;
+  std::vector<TriangulationResult> results(nrTracks);
+  parallelFor(nrTracks, [&](size_t j) {
+    results[j] = internal::triangulateTrack<CAMERA>(cameras, projections,
+        measurements, cameraIndices, trackOffsets[j], trackOffsets[j + 1],
+        params, maxIterations);
+  });
+  return results;
+}
+
 } // \namespace gtsam
 
@@ -12,6 +12,7 @@
 #include <gtsam/inference/ClusterTree.h>
 #include <gtsam/inference/BayesTree.h>
 #include <gtsam/inference/Ordering.h>
+#include <gtsam/base/SlabPool.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/base/treeTraversal-inst.h>
 
@@ -122,7 +123,7 @@ struct EliminationData {
   boost::shared_ptr<BTNode> bayesTreeNode;
 
   EliminationData(EliminationData* _parentData, size_t nChildren) :
-      parentData(_parentData), bayesTreeNode(boost::make_shared<BTNode>()) {
+      parentData(_parentData), bayesTreeNode(makeSlabShared<BTNode>()) {
     if (parentData) {
       myIndexInParent = parentData->childFactors.size();
       parentData->childFactors.push_back(sharedFactor());
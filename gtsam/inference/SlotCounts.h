@@ -0,0 +1,61 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SlotCounts.h
+ * @brief   Epoch-stamped counts on dense slots, cleared in constant time
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Counts on dense slots such as factor indices, meant to be filled and cleared
+ * over and over, e.g., the number of affected keys of every factor in each
+ * ISAM2 update. A count is valid if its slot carries the current epoch, so
+ * clear() only increments the epoch, and increment() and count() are array
+ * accesses.
+ */
+class SlotCounts {
+  std::vector<size_t> stamps_; ///< Epoch at which each count was last set
+  std::vector<size_t> counts_;
+  size_t epoch_;
+
+public:
+  SlotCounts() : epoch_(1) {}
+
+  /// Set all counts to zero, in constant time
+  void clear() { ++epoch_; }
+
+  /// Increment the count of slot, and return the new count
+  size_t increment(size_t slot) {
+    if (slot >= stamps_.size()) {
+      stamps_.resize(slot + 1, 0);
+      counts_.resize(slot + 1);
+    }
+    if (stamps_[slot] != epoch_) {
+      stamps_[slot] = epoch_;
+      counts_[slot] = 0;
+    }
+    return ++counts_[slot];
+  }
+
+  /// Count of slot
+  size_t count(size_t slot) const {
+    return slot < stamps_.size() && stamps_[slot] == epoch_ ? counts_[slot] : 0;
+  }
+};
+
+} // namespace gtsam
@@ -15,7 +15,9 @@
  * @date    March 26, 2013
  */
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 #include <gtsam/inference/VariableIndex.h>
 
@@ -42,6 +44,25 @@ void VariableIndex::print(const string& str, const KeyFormatter& keyFormatter) c
   cout.flush();
 }
 
+/* ************************************************************************* */
+void VariableIndex::renumberFactor(FactorIndex from, FactorIndex to,
+    const KeyVector& keys) {
+  for (Key key : keys) {
+    const KeyMap::iterator item = index_.find(key);
+    if (item == index_.end())
+      throw std::invalid_argument(
+          "VariableIndex::renumberFactor: requested non-existent variable");
+    const Factors::iterator entry =
+        std::find(item->second.begin(), item->second.end(), from);
+    if (entry == item->second.end())
+      throw std::invalid_argument(
+          "VariableIndex::renumberFactor: factor is not in the index of its keys");
+    *entry = to;
+  }
+  if (to >= nFactors_)
+    nFactors_ = to + 1;
+}
+
 /* ************************************************************************* */
 void VariableIndex::outputMetisFormat(ostream& os) const {
   os << size() << " " << nFactors() << "\n";
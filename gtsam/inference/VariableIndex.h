@@ -142,6 +142,19 @@ public:
   template<typename ITERATOR>
   void removeUnusedVariables(ITERATOR firstKey, ITERATOR lastKey);
 
+  /**
+   * Renumber factor \c from, which involves \c keys, to the unused index \c to,
+   * when compacting a factor graph. Takes time linear in the number of factors
+   * of each of the keys.
+   */
+  void renumberFactor(FactorIndex from, FactorIndex to, const KeyVector& keys);
+
+  /**
+   * Set the number of factors after the empty slots at the end of the factor
+   * graph were dropped. No entry may refer to a factor index >= \c nFactors.
+   */
+  void truncateFactors(size_t nFactors) { nFactors_ = nFactors; }
+
   /// Iterator to the first variable entry
   const_iterator begin() const { return index_.begin(); }
 
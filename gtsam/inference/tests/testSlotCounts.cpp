@@ -0,0 +1,53 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSlotCounts.cpp
+ * @brief   Unit tests for SlotCounts
+ */
+
+#include <gtsam/inference/SlotCounts.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(SlotCounts, increment) {
+  SlotCounts counts;
+  EXPECT_LONGS_EQUAL(0, counts.count(0));
+  EXPECT_LONGS_EQUAL(0, counts.count(100));
+
+  EXPECT_LONGS_EQUAL(1, counts.increment(0));
+  EXPECT_LONGS_EQUAL(1, counts.increment(2));
+  EXPECT_LONGS_EQUAL(2, counts.increment(2));
+  EXPECT_LONGS_EQUAL(1, counts.count(0));
+  EXPECT_LONGS_EQUAL(0, counts.count(1));
+  EXPECT_LONGS_EQUAL(2, counts.count(2));
+}
+
+/* ************************************************************************* */
+TEST(SlotCounts, clear) {
+  SlotCounts counts;
+  counts.increment(0);
+  counts.increment(2);
+  counts.increment(2);
+
+  counts.clear();
+  EXPECT_LONGS_EQUAL(0, counts.count(0));
+  EXPECT_LONGS_EQUAL(0, counts.count(2));
+  EXPECT_LONGS_EQUAL(1, counts.increment(2));
+  EXPECT_LONGS_EQUAL(1, counts.count(2));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -0,0 +1,216 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file FixedKalmanFilter.h
+ * @brief Square-root information Kalman filter for a state of fixed dimension
+ */
+
+#pragma once
+
+#include <gtsam/linear/KalmanFilter.h>
+
+#include <boost/make_shared.hpp>
+
+#include <stdexcept>
+
+namespace gtsam {
+
+/**
+ * Kalman filter for a state of compile-time dimension N.
+ *
+ * It performs the same square-root information predict and update steps as
+ * KalmanFilter, but instead of building and eliminating a GaussianFactorGraph it
+ * stacks the current square-root information [R d] with the whitened motion or
+ * measurement model and re-triangulates with a fixed-size Householder QR, so a
+ * step does not allocate on the heap. Unlike KalmanFilter, the filter holds its
+ * density and every step modifies it in place; state() and setState() convert
+ * from and to the KalmanFilter::State of the factor-graph filter.
+ *
+ * The density is 0.5*|R*x - d|^2, with R upper-triangular. Noise models must
+ * not be constrained.
+ */
+template <int N>
+class FixedKalmanFilter {
+
+public:
+
+  typedef Eigen::Matrix<double, N, 1> VectorN;
+  typedef Eigen::Matrix<double, N, N> MatrixN;
+
+private:
+
+  Key k_; ///< step index, as KalmanFilter::step
+  MatrixN R_; ///< upper-triangular square-root information
+  VectorN d_; ///< right-hand side, mean = R\d
+
+  // Whitening weights of a diagonal noise model of dimension M, copied straight
+  // from the model's storage so that no dynamic-size vector is created
+  template <int M>
+  static void invsigmas(const SharedDiagonal& model, Eigen::Matrix<double, M, 1>& w) {
+    if (!model) {
+      w.setOnes();
+      return;
+    }
+    if (model->isConstrained())
+      throw std::invalid_argument("FixedKalmanFilter: constrained noise models are not supported");
+    if (model->dim() != M)
+      throw std::invalid_argument("FixedKalmanFilter: noise model has the wrong dimension");
+    w = Eigen::Map<const Eigen::Matrix<double, M, 1> >(model->invsigmas().data());
+  }
+
+  /// Eliminate x_k from |R*x_k - d|^2 + |A0*x_k + A1*x_{k+1} - b|^2, keeping P(x_{k+1})
+  void predictWhitened(const MatrixN& A0, const MatrixN& A1, const VectorN& b) {
+    Eigen::Matrix<double, 2 * N, 2 * N + 1> Ab;
+    Ab << R_, MatrixN::Zero(), d_, A0, A1, b;
+    const Eigen::HouseholderQR<Eigen::Matrix<double, 2 * N, 2 * N + 1> > qr(Ab);
+    R_ = qr.matrixQR().template block<N, N>(N, N).template triangularView<Eigen::Upper>();
+    d_ = qr.matrixQR().template block<N, 1>(N, 2 * N);
+    ++k_;
+  }
+
+  /// Combine |R*x - d|^2 + |A*x - b|^2 into a new square-root information
+  template <int M>
+  void updateWhitened(const Eigen::Matrix<double, M, N>& A, const Eigen::Matrix<double, M, 1>& b) {
+    Eigen::Matrix<double, N + M, N + 1> Ab;
+    Ab << R_, d_, A, b;
+    const Eigen::HouseholderQR<Eigen::Matrix<double, N + M, N + 1> > qr(Ab);
+    R_ = qr.matrixQR().template topLeftCorner<N, N>().template triangularView<Eigen::Upper>();
+    d_ = qr.matrixQR().template block<N, 1>(0, N);
+  }
+
+public:
+
+  /// Constructor, call init or setState before predicting or updating
+  FixedKalmanFilter() : k_(0), R_(MatrixN::Identity()), d_(VectorN::Zero()) {}
+
+  /**
+   * Create initial state, i.e., prior density at time k=0
+   * @param x0 estimate at time 0
+   * @param P0 covariance at time 0, given as a diagonal Gaussian 'model'
+   */
+  void init(const VectorN& x0, const SharedDiagonal& P0) {
+    k_ = 0;
+    VectorN w;
+    invsigmas<N>(P0, w);
+    R_ = w.asDiagonal();
+    d_ = R_ * x0;
+  }
+
+  /// version of init with a full covariance matrix
+  void init(const VectorN& x0, const MatrixN& P0) {
+    k_ = 0;
+    const Eigen::LLT<MatrixN, Eigen::Upper> llt(MatrixN(P0.inverse()));
+    R_ = llt.matrixU();
+    d_ = R_ * x0;
+  }
+
+  /// Step index k, starts at 0, incremented at each predict
+  Key step() const { return k_; }
+
+  /// Square-root information matrix
+  const MatrixN& R() const { return R_; }
+
+  /// Right-hand side of the square-root information form
+  const VectorN& d() const { return d_; }
+
+  /// Mean of the current density
+  VectorN mean() const { return R_.template triangularView<Eigen::Upper>().solve(d_); }
+
+  /// Information matrix of the current density
+  MatrixN information() const { return R_.transpose() * R_; }
+
+  /// Covariance of the current density
+  MatrixN covariance() const {
+    const MatrixN Rinv = R_.template triangularView<Eigen::Upper>().solve(MatrixN::Identity());
+    return Rinv * Rinv.transpose();
+  }
+
+  /// The current density as the state of the factor-graph KalmanFilter
+  KalmanFilter::State state() const {
+    return boost::make_shared<GaussianDensity>(k_, Vector(d_), Matrix(R_));
+  }
+
+  /// Continue from a KalmanFilter state
+  void setState(const KalmanFilter::State& p) {
+    if (p->R().rows() != N)
+      throw std::invalid_argument("FixedKalmanFilter::setState: state has the wrong dimension");
+    k_ = KalmanFilter::step(p);
+    R_ = p->R();
+    d_ = p->d();
+    if (p->get_model()) {
+      VectorN w;
+      invsigmas<N>(p->get_model(), w);
+      R_ = w.asDiagonal() * R_;
+      d_ = w.asDiagonal() * d_;
+    }
+  }
+
+  /**
+   * Predict the state P(x_{t+1}|Z^t), for the motion model x_{t+1} = F*x_{t} + B*u_{t} + w,
+   * with w zero-mean Gaussian white noise with diagonal covariance modelQ.
+   */
+  template <class DERIVEDB, class DERIVEDU>
+  void predict(const MatrixN& F, const Eigen::MatrixBase<DERIVEDB>& B,
+      const Eigen::MatrixBase<DERIVEDU>& u, const SharedDiagonal& modelQ) {
+    VectorN w;
+    invsigmas<N>(modelQ, w);
+    predictWhitened(-(w.asDiagonal() * F), MatrixN(w.asDiagonal()), w.asDiagonal() * VectorN(B * u));
+  }
+
+  /// Version of predict with full covariance Q
+  template <class DERIVEDB, class DERIVEDU>
+  void predictQ(const MatrixN& F, const Eigen::MatrixBase<DERIVEDB>& B,
+      const Eigen::MatrixBase<DERIVEDU>& u, const MatrixN& Q) {
+    // Whiten with inv(L), where Q = L*L'
+    const Eigen::LLT<MatrixN> llt(Q);
+    const auto L = llt.matrixL();
+    predictWhitened(L.solve(-F), L.solve(MatrixN::Identity()), L.solve(VectorN(B * u)));
+  }
+
+  /// Predict with a motion model |A0*x_{t} + A1*x_{t+1} - b|^2, with an optional noise model
+  void predict2(const MatrixN& A0, const MatrixN& A1, const VectorN& b,
+      const SharedDiagonal& model) {
+    VectorN w;
+    invsigmas<N>(model, w);
+    predictWhitened(w.asDiagonal() * A0, w.asDiagonal() * A1, w.asDiagonal() * b);
+  }
+
+  /**
+   * Update with a measurement z = H*x_{t} + v, with v zero-mean Gaussian white noise
+   * with diagonal covariance model.
+   */
+  template <int M>
+  void update(const Eigen::Matrix<double, M, N>& H, const Eigen::Matrix<double, M, 1>& z,
+      const SharedDiagonal& model) {
+    Eigen::Matrix<double, M, 1> w;
+    invsigmas<M>(model, w);
+    updateWhitened<M>(w.asDiagonal() * H, w.asDiagonal() * z);
+  }
+
+  /// Version of update with full measurement covariance
+  template <int M>
+  void updateQ(const Eigen::Matrix<double, M, N>& H, const Eigen::Matrix<double, M, 1>& z,
+      const Eigen::Matrix<double, M, M>& Q) {
+    const Eigen::LLT<Eigen::Matrix<double, M, M> > llt(Q);
+    const auto L = llt.matrixL();
+    updateWhitened<M>(L.solve(H), L.solve(z));
+  }
+
+  /// print
+  void print(const std::string& s = "") const {
+    std::cout << "FixedKalmanFilter " << s << ", dim = " << N << ", step = " << k_ << std::endl;
+  }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // \namespace gtsam
@@ -26,6 +26,7 @@
 #include <gtsam/base/debug.h>
 #include <gtsam/base/FastMap.h>
 #include <gtsam/base/Matrix.h>
+#include <gtsam/base/SlabPool.h>
 #include <gtsam/base/ThreadsafeException.h>
 #include <gtsam/base/timing.h>
 
@@ -482,7 +483,7 @@ boost::shared_ptr<GaussianConditional> HessianFactor::eliminateCholesky(const Or
 
     // TODO(frank): pre-allocate GaussianConditional and write into it
     const VerticalBlockMatrix Ab = info_.split(nFrontals);
-    conditional = boost::make_shared<GaussianConditional>(keys_, nFrontals, Ab);
+    conditional = makeSlabShared<GaussianConditional>(keys_, nFrontals, Ab);
 
     // Erase the eliminated keys in this factor
     keys_.erase(begin(), begin() + nFrontals);
@@ -534,7 +535,7 @@ EliminateCholesky(const GaussianFactorGraph& factors, const Ordering& keys) {
   HessianFactor::shared_ptr jointFactor;
   try {
     Scatter scatter(factors, keys);
-    jointFactor = boost::make_shared<HessianFactor>(factors, scatter);
+    jointFactor = makeSlabShared<HessianFactor>(factors, scatter);
   } catch (std::invalid_argument&) {
     throw InvalidDenseElimination(
         "EliminateCholesky was called with a request to eliminate variables that are not\n"
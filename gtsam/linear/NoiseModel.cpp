@@ -728,6 +728,10 @@ Fair::Fair(double c, const ReweightScheme reweight) : Base(reweight), c_(c) {
 // Fair
 /* ************************************************************************* */
 
+Vector Fair::weight(const Vector& error) const {
+  return (1.0 + error.array().abs() / c_).inverse().matrix();
+}
+
 void Fair::print(const std::string &s="") const
 { cout << s << "fair (" << c_ << ")" << endl; }
 
@@ -750,6 +754,11 @@ Huber::Huber(double k, const ReweightScheme reweight) : Base(reweight), k_(k) {
   }
 }
 
+Vector Huber::weight(const Vector& error) const {
+  // k/max(e,k) is 1 wherever error < k, without branching
+  return (k_ / error.array().max(k_)).matrix();
+}
+
 void Huber::print(const std::string &s="") const {
   cout << s << "huber (" << k_ << ")" << endl;
 }
@@ -774,6 +783,10 @@ Cauchy::Cauchy(double k, const ReweightScheme reweight) : Base(reweight), k_(k),
   }
 }
 
+Vector Cauchy::weight(const Vector& error) const {
+  return (ksquared_ / (ksquared_ + error.array().square())).matrix();
+}
+
 void Cauchy::print(const std::string &s="") const {
   cout << s << "cauchy (" << k_ << ")" << endl;
 }
@@ -793,6 +806,11 @@ Cauchy::shared_ptr Cauchy::Create(double c, const ReweightScheme reweight) {
 /* ************************************************************************* */
 Tukey::Tukey(double c, const ReweightScheme reweight) : Base(reweight), c_(c), csquared_(c * c) {}
 
+Vector Tukey::weight(const Vector& error) const {
+  // clamping at zero covers |error| > c
+  return (1.0 - error.array().square() / csquared_).max(0.0).square().matrix();
+}
+
 void Tukey::print(const std::string &s="") const {
   std::cout << s << ": Tukey (" << c_ << ")" << std::endl;
 }
@@ -812,6 +830,10 @@ Tukey::shared_ptr Tukey::Create(double c, const ReweightScheme reweight) {
 /* ************************************************************************* */
 Welsh::Welsh(double c, const ReweightScheme reweight) : Base(reweight), c_(c), csquared_(c * c) {}
 
+Vector Welsh::weight(const Vector& error) const {
+  return (-error.array().square() / csquared_).exp().matrix();
+}
+
 void Welsh::print(const std::string &s="") const {
   std::cout << s << ": Welsh (" << c_ << ")" << std::endl;
 }
@@ -840,6 +862,11 @@ double GemanMcClure::weight(double error) const {
   return c4/(c2error*c2error);
 }
 
+Vector GemanMcClure::weight(const Vector& error) const {
+  const double c2 = c_*c_;
+  return (c2*c2 / (c2 + error.array().square()).square()).matrix();
+}
+
 void GemanMcClure::print(const std::string &s="") const {
   std::cout << s << ": Geman-McClure (" << c_ << ")" << std::endl;
 }
@@ -872,6 +899,11 @@ double DCS::weight(double error) const {
   return 1.0;
 }
 
+Vector DCS::weight(const Vector& error) const {
+  // 2c/(c+e^2) >= 1 exactly when e^2 <= c
+  return (2.0*c_ / (c_ + error.array().square())).min(1.0).square().matrix();
+}
+
 void DCS::print(const std::string &s="") const {
   std::cout << s << ": DCS (" << c_ << ")" << std::endl;
 }
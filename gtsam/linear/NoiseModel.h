@@ -694,9 +694,14 @@ namespace gtsam {
           return std::sqrt(weight(error));
         }
 
+        /// How the rows are weighted
+        ReweightScheme reweightScheme() const { return reweight_; }
+
         /** produce a weight vector according to an error vector and the implemented
-        * robust function */
-        Vector weight(const Vector &error) const;
+        * robust function. Derived classes override this with array expressions so
+        * that many errors, e.g., the error norms of all factors in a graph, are
+        * weighted in one vectorized pass. */
+        virtual Vector weight(const Vector &error) const;
 
         /** square root version of the weight function */
         Vector sqrtWeight(const Vector &error) const {
@@ -727,6 +732,7 @@ namespace gtsam {
         Null(const ReweightScheme reweight = Block) : Base(reweight) {}
         virtual ~Null() {}
         virtual double weight(double /*error*/) const { return 1.0; }
+        virtual Vector weight(const Vector& error) const { return Vector::Ones(error.size()); }
         virtual void print(const std::string &s) const;
         virtual bool equals(const Base& /*expected*/, double /*tol*/) const { return true; }
         static shared_ptr Create() ;
@@ -752,9 +758,11 @@ namespace gtsam {
         double weight(double error) const {
           return 1.0 / (1.0 + fabs(error) / c_);
         }
+        Vector weight(const Vector& error) const;
         void print(const std::string &s) const;
         bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double c, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return c_; }
 
       private:
         /** Serialization function */
@@ -778,9 +786,11 @@ namespace gtsam {
         double weight(double error) const {
           return (error < k_) ? (1.0) : (k_ / fabs(error));
         }
+        Vector weight(const Vector& error) const;
         void print(const std::string &s) const;
         bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return k_; }
 
       private:
         /** Serialization function */
@@ -808,9 +818,11 @@ namespace gtsam {
         double weight(double error) const {
           return ksquared_ / (ksquared_ + error*error);
         }
+        Vector weight(const Vector& error) const;
         void print(const std::string &s) const;
         bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return k_; }
 
       private:
         /** Serialization function */
@@ -838,9 +850,11 @@ namespace gtsam {
           }
           return 0.0;
         }
+        Vector weight(const Vector& error) const;
         void print(const std::string &s) const;
         bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return c_; }
 
       private:
         /** Serialization function */
@@ -865,9 +879,11 @@ namespace gtsam {
           double xc2 = (error*error)/csquared_;
           return std::exp(-xc2);
         }
+        Vector weight(const Vector& error) const;
         void print(const std::string &s) const;
         bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return c_; }
 
       private:
         /** Serialization function */
@@ -892,9 +908,11 @@ namespace gtsam {
         GemanMcClure(double c = 1.0, const ReweightScheme reweight = Block);
         virtual ~GemanMcClure() {}
         virtual double weight(double error) const;
+        virtual Vector weight(const Vector& error) const;
         virtual void print(const std::string &s) const;
         virtual bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return c_; }
 
       protected:
         double c_;
@@ -921,9 +939,11 @@ namespace gtsam {
         DCS(double c = 1.0, const ReweightScheme reweight = Block);
         virtual ~DCS() {}
         virtual double weight(double error) const;
+        virtual Vector weight(const Vector& error) const;
         virtual void print(const std::string &s) const;
         virtual bool equals(const Base& expected, double tol=1e-8) const;
         static shared_ptr Create(double k, const ReweightScheme reweight = Block) ;
+        double modelParameter() const { return c_; }
 
       protected:
         double c_;
@@ -966,6 +986,7 @@ namespace gtsam {
           void print(const std::string &s) const;
           bool equals(const Base& expected, double tol=1e-8) const;
           static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+          double modelParameter() const { return k_; }
 
       private:
           /** Serialization function */
@@ -0,0 +1,58 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseEigenSolver.cpp
+ * @brief   Solve sparse normal equations assembled directly as triplets, using Eigen
+ */
+
+#include <gtsam/linear/SparseEigenSolver.h>
+#include <gtsam/base/timing.h>
+
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+Matrix SparseEigenSolver::SolveNormalEquations(size_t n,
+    const Triplets& triplets, const Matrix& B, Type type, const Matrix& guess,
+    double tolerance) {
+  gttic(SparseEigenSolver_SolveNormalEquations);
+
+  Eigen::SparseMatrix<double> H(n, n);
+  H.setFromTriplets(triplets.begin(), triplets.end());
+
+  Matrix X;
+  if (type == CHOLESKY) {
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt(H);
+    if (ldlt.info() != Eigen::Success)
+      throw runtime_error("SparseEigenSolver: factorization failed, the system is singular");
+    X = ldlt.solve(B);
+  } else {
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>,
+        Eigen::Lower | Eigen::Upper> cg(H);
+    cg.setTolerance(tolerance);
+    X = guess.size() > 0 ? Matrix(cg.solveWithGuess(B, guess)) : Matrix(cg.solve(B));
+    if (cg.info() != Eigen::Success)
+      throw runtime_error("SparseEigenSolver: conjugate gradients did not converge");
+  }
+
+  if (!X.allFinite())
+    throw runtime_error("SparseEigenSolver: the system is singular");
+  return X;
+}
+
+} // namespace gtsam
@@ -0,0 +1,61 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseEigenSolver.h
+ * @brief   Solve sparse normal equations assembled directly as triplets, using Eigen
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+
+#include <Eigen/SparseCore>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solver for large, sparse, symmetric positive definite systems H*X=B that are
+ * assembled directly as (row, column, value) triplets instead of through a
+ * GaussianFactorGraph, e.g., the linear relaxations used to initialize pose
+ * graphs. Because there are no factors or keys, assembling the triplets can
+ * easily be done in parallel by the caller.
+ */
+class GTSAM_EXPORT SparseEigenSolver {
+public:
+
+  typedef Eigen::Triplet<double> Triplet;
+  typedef std::vector<Triplet> Triplets;
+
+  /// Linear solver to use
+  enum Type {
+    CHOLESKY, ///< Sparse LDL' factorization with an AMD ordering
+    CONJUGATE_GRADIENT ///< Jacobi-preconditioned conjugate gradients, warm-started from a guess
+  };
+
+  /**
+   * Solve H*X=B
+   * @param n dimension of H
+   * @param triplets entries of H, both triangles must be given and duplicates are summed
+   * @param B right-hand sides, one per column
+   * @param type linear solver
+   * @param guess initial estimate of X for CONJUGATE_GRADIENT, if not empty
+   * @param tolerance relative residual at which CONJUGATE_GRADIENT stops
+   * @return X, throws std::runtime_error if the system is singular or CG does not converge
+   */
+  static Matrix SolveNormalEquations(size_t n, const Triplets& triplets,
+      const Matrix& B, Type type = CHOLESKY, const Matrix& guess = Matrix(),
+      double tolerance = 1e-10);
+};
+
+} // namespace gtsam
@@ -18,10 +18,13 @@
  */
 
 #include <gtsam/linear/KalmanFilter.h>
+#include <gtsam/linear/FixedKalmanFilter.h>
 #include <gtsam/linear/NoiseModel.h>
 #include <gtsam/base/Testable.h>
 #include <CppUnitLite/TestHarness.h>
 
+#include <boost/scoped_ptr.hpp>
+
 using namespace std;
 using namespace gtsam;
 
@@ -286,6 +289,118 @@ TEST( KalmanFilter, QRvsCholesky ) {
   EXPECT(assert_equal(expected2, pb3->covariance(), 1e-7));
 }
 
+/* ************************************************************************* */
+TEST( FixedKalmanFilter, linear1 ) {
+
+  // Same example as linear1, with a fixed-size filter and the factor-graph filter
+  Matrix2 F = I_2x2, B = I_2x2, H = I_2x2;
+  Vector2 u(1.0, 0.0);
+  SharedDiagonal modelQ = noiseModel::Isotropic::Sigma(2, 0.1);
+  SharedDiagonal modelR = noiseModel::Isotropic::Sigma(2, 0.1);
+  SharedDiagonal P0 = noiseModel::Isotropic::Sigma(2, 0.1);
+
+  KalmanFilter kf(2);
+  KalmanFilter::State p = kf.init(Vector2(0.0, 0.0), P0);
+  FixedKalmanFilter<2> fkf;
+  fkf.init(Vector2(0.0, 0.0), P0);
+  EXPECT(assert_equal(p->mean(), Vector(fkf.mean())));
+  EXPECT(assert_equal(p->covariance(), Matrix(fkf.covariance())));
+
+  for (size_t k = 1; k <= 3; ++k) {
+    const Vector2 z(k, 0.0);
+    p = kf.predict(p, F, B, u, modelQ);
+    fkf.predict(F, B, u, modelQ);
+    EXPECT(assert_equal(p->mean(), Vector(fkf.mean()), 1e-9));
+    EXPECT(assert_equal(p->information(), Matrix(fkf.information()), 1e-6));
+
+    p = kf.update(p, H, z, modelR);
+    fkf.update<2>(H, z, modelR);
+    EXPECT(assert_equal(p->mean(), Vector(fkf.mean()), 1e-9));
+    EXPECT(assert_equal(p->covariance(), Matrix(fkf.covariance()), 1e-9));
+  }
+  EXPECT_LONGS_EQUAL(KalmanFilter::step(p), fkf.step());
+  EXPECT(assert_equal(Vector(Vector2(3.0, 0.0)), Vector(fkf.mean()), 1e-9));
+
+  // Round trip through the KalmanFilter state
+  KalmanFilter::State state = fkf.state();
+  EXPECT(assert_equal(p->mean(), state->mean(), 1e-9));
+  EXPECT(assert_equal(p->covariance(), state->covariance(), 1e-9));
+  FixedKalmanFilter<2> fkf2;
+  fkf2.setState(kf.predict(p, F, B, u, modelQ));
+  fkf.predict(F, B, u, modelQ);
+  EXPECT(assert_equal(Vector(fkf.mean()), Vector(fkf2.mean()), 1e-9));
+  EXPECT(assert_equal(Matrix(fkf.covariance()), Matrix(fkf2.covariance()), 1e-9));
+  EXPECT_LONGS_EQUAL(fkf.step(), fkf2.step());
+
+  // Constrained models are not supported
+  CHECK_EXCEPTION(fkf.predict(F, B, u, noiseModel::Constrained::All(2)), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST( FixedKalmanFilter, fullCovariances ) {
+
+  // A 9-dimensional state with full covariances, against the factor-graph filter
+  typedef FixedKalmanFilter<9>::VectorN Vector9;
+  typedef FixedKalmanFilter<9>::MatrixN Matrix9;
+  Vector9 mean = Vector9::Ones();
+  Matrix9 covariance = 1e-6 * Matrix9::Identity();
+  covariance.diagonal() << 15.0, 21.9, 100.0, 23.4, 87.9, 61.1, 625.0, 625.0, 625.0;
+  covariance(0, 1) = covariance(1, 0) = -6.2e-6;
+  covariance(0, 7) = covariance(7, 0) = 63.8e-6;
+  covariance(3, 4) = covariance(4, 3) = 24.5e-6;
+
+  Matrix9 F = Matrix9::Identity();
+  F(0, 3) = -0.0192; F(0, 4) = 0.0006;
+  F(1, 3) = 0.0006; F(1, 4) = 0.0192; F(1, 5) = 0.0002;
+  F(2, 4) = -0.0002; F(2, 5) = 0.0192;
+  Matrix B = Matrix::Zero(9, 1);
+  Vector u = Z_1x1;
+  Matrix9 Q = 1e-6 * Matrix9::Identity();
+  Q.diagonal() << 33.7, 126.4, 88.0, 0.2, 0.2, 0.2, 22.2, 22.2, 22.2;
+  Q(0, 1) = Q(1, 0) = 3.1e-6;
+
+  Eigen::Matrix<double, 3, 9> H = Eigen::Matrix<double, 3, 9>::Zero();
+  H.block<3, 3>(0, 0) << 0.0, 9.7959, 0.0836, -9.7959, 0.0, -0.0052, -0.0836, 0.0052, 0.0;
+  H.block<3, 3>(0, 6) = I_3x3;
+  Vector3 z(0.2599, 1.3327, 0.2007);
+  Vector3 sigmas(0.3323, 0.2470, 0.1904);
+  Matrix3 R = sigmas.array().square().matrix().asDiagonal();
+
+  KalmanFilter kf(9);
+  KalmanFilter::State p = kf.init(mean, covariance);
+  FixedKalmanFilter<9> fkf;
+  fkf.init(mean, covariance);
+  EXPECT(assert_equal(p->information(), Matrix(fkf.information()), 1e-3));
+
+  p = kf.predictQ(p, F, B, u, Q);
+  fkf.predictQ(F, B, u, Q);
+  EXPECT(assert_equal(p->mean(), Vector(fkf.mean()), 1e-9));
+  EXPECT(assert_equal(p->covariance(), Matrix(fkf.covariance()), 1e-9));
+
+  KalmanFilter::State p1 = kf.update(p, H, z, noiseModel::Diagonal::Sigmas(sigmas));
+  KalmanFilter::State p2 = kf.updateQ(p, H, z, R);
+  FixedKalmanFilter<9> fkf2 = fkf;
+  fkf.update<3>(H, z, noiseModel::Diagonal::Sigmas(sigmas));
+  fkf2.updateQ<3>(H, z, R);
+  EXPECT(assert_equal(p1->mean(), Vector(fkf.mean()), 1e-9));
+  EXPECT(assert_equal(p1->covariance(), Matrix(fkf.covariance()), 1e-9));
+  EXPECT(assert_equal(Matrix(fkf.covariance()), Matrix(fkf2.covariance()), 1e-9));
+
+  // KalmanFilter::updateQ inverts R, which costs a few digits on this problem
+  EXPECT(assert_equal(p2->mean(), Vector(fkf2.mean()), 1e-6));
+  EXPECT(assert_equal(p2->covariance(), Matrix(fkf2.covariance()), 1e-4));
+}
+
+/* ************************************************************************* */
+TEST( FixedKalmanFilter, heapAllocated ) {
+  // A filter on the heap is aligned for its fixed-size members
+  boost::scoped_ptr<FixedKalmanFilter<4> > fkf(new FixedKalmanFilter<4>());
+  EXPECT_LONGS_EQUAL(0, reinterpret_cast<size_t>(fkf.get()) % 16);
+  fkf->init(Vector4(1, 2, 3, 4), noiseModel::Isotropic::Sigma(4, 0.5));
+  EXPECT(assert_equal(Vector(Vector4(1, 2, 3, 4)), Vector(fkf->mean()), 1e-9));
+  EXPECT(assert_equal(Matrix(Matrix4::Identity() * 0.25), Matrix(fkf->covariance()), 1e-9));
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
@@ -507,6 +507,23 @@ TEST(NoiseModel, robustFunctionL2WithDeadZone)
   DOUBLES_EQUAL(40.5,    lsdz->residual(e5), 1e-8);
 }
 
+/* ************************************************************************* */
+TEST(NoiseModel, robustFunctionVectorized)
+{
+  // The vectorized weights agree with the scalar ones, on both sides of the thresholds
+  const Vector errors = (Vector(8) << -10.0, -1.0, 0.0, 0.5, 1.0, 1.345, 4.0, 10.0).finished();
+  const vector<mEstimator::Base::shared_ptr> estimators = {
+      mEstimator::Null::Create(), mEstimator::Fair::Create(1.3998),
+      mEstimator::Huber::Create(1.345), mEstimator::Cauchy::Create(0.1),
+      mEstimator::Tukey::Create(4.6851), mEstimator::Welsh::Create(2.9846),
+      mEstimator::GemanMcClure::Create(1.0), mEstimator::DCS::Create(1.0)};
+  for (const mEstimator::Base::shared_ptr& estimator : estimators) {
+    const Vector actual = estimator->weight(errors);
+    for (size_t i = 0; i < 8; ++i)
+      DOUBLES_EQUAL(estimator->weight(errors(i)), actual(i), 1e-12);
+  }
+}
+
 /* ************************************************************************* */
 TEST(NoiseModel, robustNoiseHuber)
 {
@@ -31,6 +31,8 @@ class DoglegOptimizer;
  */
 class GTSAM_EXPORT DoglegParams : public NonlinearOptimizerParams {
 public:
+  typedef DoglegOptimizer OptimizerType; ///< The optimizer these parameters are for
+
   /** See DoglegParams::dlVerbosity */
   enum VerbosityDL {
     SILENT,
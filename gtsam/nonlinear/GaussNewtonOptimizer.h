@@ -28,6 +28,8 @@ class GaussNewtonOptimizer;
  * NonlinearOptimizationParams.
  */
 class GTSAM_EXPORT GaussNewtonParams : public NonlinearOptimizerParams {
+public:
+  typedef GaussNewtonOptimizer OptimizerType; ///< The optimizer these parameters are for
 };
 
 /**
@@ -0,0 +1,62 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GncOptimizer.cpp
+ * @brief   Graduated non-convexity around any nonlinear optimizer
+ */
+
+#include <gtsam/nonlinear/GncOptimizer.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+void GncWeightedFactor::print(const string& s, const KeyFormatter& keyFormatter) const {
+  cout << s << "GncWeightedFactor, weight = " << weight() << endl;
+  factor_->print("", keyFormatter);
+}
+
+/* ************************************************************************* */
+bool GncWeightedFactor::equals(const NonlinearFactor& f, double tol) const {
+  const GncWeightedFactor* e = dynamic_cast<const GncWeightedFactor*>(&f);
+  return e && factor_->equals(*e->factor_, tol) && fabs(weight() - e->weight()) < tol;
+}
+
+/* ************************************************************************* */
+boost::shared_ptr<GaussianFactor> GncWeightedFactor::linearize(const Values& values) const {
+  boost::shared_ptr<GaussianFactor> linear = factor_->linearize(values);
+  const double w = weight();
+  if (!linear || w == 1.0) return linear;
+
+  // The linearization is a fresh copy, so it can be scaled in place
+  if (JacobianFactor* jacobian = dynamic_cast<JacobianFactor*>(linear.get())) {
+    // Scaling would leave the hard constraint rows unchanged but not error()
+    if (jacobian->isConstrained())
+      throw invalid_argument("GncWeightedFactor: constrained factors cannot be weighted");
+    const double sqrtWeight = sqrt(w);
+    jacobian->getA() *= sqrtWeight;
+    jacobian->getb() *= sqrtWeight;
+  } else if (HessianFactor* hessian = dynamic_cast<HessianFactor*>(linear.get())) {
+    const Matrix augmentedInformation = hessian->info().selfadjointView();
+    hessian->info().setFullMatrix(w * augmentedInformation);
+  } else {
+    throw invalid_argument("GncWeightedFactor: can only weigh Jacobian and Hessian factors");
+  }
+  return linear;
+}
+
+} // namespace gtsam
@@ -0,0 +1,275 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GncOptimizer.h
+ * @brief   Graduated non-convexity around any nonlinear optimizer
+ *
+ * See H. Yang, P. Antonante, V. Tzoumas, L. Carlone, "Graduated Non-Convexity
+ * for Robust Spatial Perception: From Non-Minimal Solvers to Global Outlier
+ * Rejection", IEEE RA-L, 2020.
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/linear/NoiseModel.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace gtsam {
+
+/**
+ * A factor whose error is that of another factor times a weight, which is read
+ * from a vector shared with the GncOptimizer. Changing the weights therefore
+ * changes the cost without rebuilding the graph, so its structure (and the
+ * elimination ordering) stays the same across continuation steps.
+ */
+class GTSAM_EXPORT GncWeightedFactor : public NonlinearFactor {
+public:
+  typedef boost::shared_ptr<GncWeightedFactor> shared_ptr;
+
+  /// Weigh factor with (*weights)(index)
+  GncWeightedFactor(const NonlinearFactor::shared_ptr& factor,
+      const boost::shared_ptr<const Vector>& weights, size_t index) :
+      NonlinearFactor(factor->keys()), factor_(factor), weights_(weights), index_(index) {}
+
+  virtual ~GncWeightedFactor() {}
+
+  /// The current weight
+  double weight() const { return (*weights_)(index_); }
+
+  /// The factor that is weighted
+  const NonlinearFactor::shared_ptr& factor() const { return factor_; }
+
+  virtual void print(const std::string& s = "",
+      const KeyFormatter& keyFormatter = DefaultKeyFormatter) const;
+  virtual bool equals(const NonlinearFactor& f, double tol = 1e-9) const;
+
+  /// Weighted error
+  virtual double error(const Values& values) const { return weight() * factor_->error(values); }
+
+  virtual size_t dim() const { return factor_->dim(); }
+  virtual bool active(const Values& values) const { return factor_->active(values); }
+
+  /// Linearize the factor and scale the Jacobian by the square root of the
+  /// weight, which has to be one for a constrained factor
+  virtual boost::shared_ptr<GaussianFactor> linearize(const Values& values) const;
+
+private:
+  NonlinearFactor::shared_ptr factor_;
+  boost::shared_ptr<const Vector> weights_;
+  size_t index_;
+};
+
+/// Parameters for GncOptimizer, wrapping the parameters of the inner optimizer
+template <class BaseOptimizerParameters>
+class GncParams {
+public:
+  /// The inner optimizer, e.g., LevenbergMarquardtOptimizer for LevenbergMarquardtParams
+  typedef typename BaseOptimizerParameters::OptimizerType OptimizerType;
+
+  /// Robust loss whose shape parameter is annealed
+  enum LossType {
+    GM, ///< Geman-McClure, annealed from convex to the actual loss by decreasing mu
+    TLS ///< Truncated least squares, annealed by increasing mu
+  };
+
+  /// Verbosity levels
+  enum Verbosity {
+    SILENT, SUMMARY, VALUES
+  };
+
+  BaseOptimizerParameters baseOptimizerParams; ///< Parameters of the inner optimizer
+  LossType lossType; ///< Loss to anneal (default: GM)
+  size_t maxIterations; ///< Maximum number of continuation steps (default: 100)
+  double barcSq; ///< Squared whitened residual above which a measurement is an outlier (default: 1.0)
+  double muStep; ///< Multiplicative factor by which mu changes every step (default: 1.4)
+  double relativeCostTol; ///< Stop when the weighted cost changes less than this (default: 1e-5)
+  double weightsTol; ///< Stop when no weight changes more than this (default: 1e-4)
+  Verbosity verbosity; ///< Verbosity (default: SILENT)
+  FastVector<size_t> knownInliers; ///< Factor slots that are never down-weighted, e.g., priors. Factors with a constrained noise model are always inliers.
+
+  GncParams(const BaseOptimizerParameters& baseOptimizerParams = BaseOptimizerParameters()) :
+      baseOptimizerParams(baseOptimizerParams), lossType(GM), maxIterations(100),
+      barcSq(1.0), muStep(1.4), relativeCostTol(1e-5), weightsTol(1e-4),
+      verbosity(SILENT) {}
+
+  void setLossType(LossType type) { lossType = type; }
+  void setMaxIterations(size_t maxIter) { maxIterations = maxIter; }
+  void setInlierCostThreshold(double inlierThreshold) { barcSq = inlierThreshold; }
+  void setMuStep(double step) { muStep = step; }
+  void setRelativeCostTol(double value) { relativeCostTol = value; }
+  void setWeightsTol(double value) { weightsTol = value; }
+  void setVerbosityGNC(Verbosity value) { verbosity = value; }
+  void setKnownInliers(const FastVector<size_t>& inliers) { knownInliers = inliers; }
+};
+
+/**
+ * Graduated non-convexity: optimize a graph whose measurements may contain
+ * outliers by minimizing a sequence of surrogate costs that go from convex to
+ * the robust loss, solving each with the inner optimizer. Every factor gets a
+ * weight, computed from its whitened residual and the current shape parameter
+ * mu; GM weights come from noiseModel::mEstimator::GemanMcClure with
+ * c = sqrt(mu * barcSq), evaluated for all factors at once.
+ *
+ * The graph is wrapped once in GncWeightedFactors that share a weight vector,
+ * so annealing only overwrites the weights, and the elimination ordering is
+ * computed once and passed to the inner optimizer. Continuation stops when mu
+ * reaches the actual loss, or earlier when the weights or the cost converge.
+ */
+template <class GncParameters>
+class GncOptimizer {
+public:
+  typedef typename GncParameters::OptimizerType BaseOptimizer;
+
+  GncOptimizer(const NonlinearFactorGraph& graph, const Values& initialValues,
+      const GncParameters& params = GncParameters()) :
+      nfg_(graph), state_(initialValues), params_(params),
+      weights_(boost::make_shared<Vector>(Vector::Ones(graph.size()))),
+      isInlier_(graph.size(), false), iterations_(0) {
+    for (size_t i : params_.knownInliers)
+      isInlier_.at(i) = true;
+    for (size_t i = 0; i < nfg_.size(); ++i) {
+      // Hard constraints keep their weight of one, so they are never relaxed
+      const NoiseModelFactor::shared_ptr noiseModelFactor =
+          boost::dynamic_pointer_cast<NoiseModelFactor>(nfg_[i]);
+      if (noiseModelFactor && noiseModelFactor->noiseModel() &&
+          noiseModelFactor->noiseModel()->isConstrained())
+        isInlier_[i] = true;
+      if (nfg_[i])
+        weightedGraph_.push_back(boost::make_shared<GncWeightedFactor>(nfg_[i], weights_, i));
+      else
+        weightedGraph_.push_back(NonlinearFactor::shared_ptr());
+    }
+    // The structure never changes, so order once
+    if (!params_.baseOptimizerParams.ordering)
+      params_.baseOptimizerParams.setOrdering(weightedGraph_.orderingCOLAMD());
+  }
+
+  /// Run graduated non-convexity and return the estimate
+  Values optimize() {
+    *weights_ = Vector::Ones(nfg_.size());
+    Values result = BaseOptimizer(weightedGraph_, state_, params_.baseOptimizerParams).optimize();
+    iterations_ = 0;
+
+    double mu = initializeMu(result);
+    if (mu <= 0) { // all residuals are below the threshold, nothing to reject
+      if (params_.verbosity >= GncParameters::SUMMARY)
+        std::cout << "GNC: all measurements are inliers" << std::endl;
+      return result;
+    }
+
+    double prevCost = weightedGraph_.error(result);
+    for (iterations_ = 0; iterations_ < params_.maxIterations; ++iterations_) {
+      const Vector prevWeights = *weights_;
+      *weights_ = calculateWeights(result, mu);
+      result = BaseOptimizer(weightedGraph_, result, params_.baseOptimizerParams).optimize();
+      const double cost = weightedGraph_.error(result);
+
+      if (params_.verbosity >= GncParameters::SUMMARY)
+        std::cout << "GNC iteration " << iterations_ << ": mu = " << mu
+                  << ", cost = " << cost << std::endl;
+      if (params_.verbosity >= GncParameters::VALUES)
+        result.print("GNC values: ");
+
+      const bool converged = checkMuConvergence(mu)
+          || (*weights_ - prevWeights).lpNorm<Eigen::Infinity>() < params_.weightsTol
+          || std::fabs(cost - prevCost) <= params_.relativeCostTol * std::max(cost, 1e-9);
+      if (converged) {
+        ++iterations_;
+        break;
+      }
+      mu = updateMu(mu);
+      prevCost = cost;
+    }
+    state_ = result;
+    return result;
+  }
+
+  /// Initial shape parameter, so that the surrogate is convex at the largest residual
+  double initializeMu(const Values& values) const {
+    double rmaxSq = 0.0;
+    for (size_t i = 0; i < nfg_.size(); ++i)
+      if (nfg_[i] && !isInlier_[i])
+        rmaxSq = std::max(rmaxSq, 2.0 * nfg_[i]->error(values));
+    if (params_.lossType == GncParameters::GM)
+      return 2.0 * rmaxSq / params_.barcSq;
+    // TLS: a non-positive mu signals that all residuals are inliers
+    return (2.0 * rmaxSq - params_.barcSq) > 0 ? params_.barcSq / (2.0 * rmaxSq - params_.barcSq) : -1.0;
+  }
+
+  /// Move the surrogate one step towards the actual loss
+  double updateMu(double mu) const {
+    return params_.lossType == GncParameters::GM ? std::max(1.0, mu / params_.muStep)
+                                                 : mu * params_.muStep;
+  }
+
+  /// Whether mu has reached the actual loss (GM only, TLS relies on the weights)
+  bool checkMuConvergence(double mu) const {
+    return params_.lossType == GncParameters::GM && mu <= 1.0;
+  }
+
+  /// Weights of all factors at the given values and shape parameter
+  Vector calculateWeights(const Values& values, double mu) const {
+    Vector residualsSq = Vector::Zero(nfg_.size());
+    for (size_t i = 0; i < nfg_.size(); ++i)
+      if (nfg_[i] && !isInlier_[i])
+        residualsSq(i) = 2.0 * nfg_[i]->error(values);
+
+    Vector weights;
+    if (params_.lossType == GncParameters::GM) {
+      const noiseModel::mEstimator::GemanMcClure gm(std::sqrt(mu * params_.barcSq));
+      weights = gm.weight(Vector(residualsSq.cwiseSqrt()));
+    } else {
+      const double upper = (mu + 1) / mu * params_.barcSq, lower = mu / (mu + 1) * params_.barcSq;
+      weights.resize(nfg_.size());
+      for (size_t i = 0; i < nfg_.size(); ++i) {
+        const double u2 = residualsSq(i);
+        if (u2 >= upper)
+          weights(i) = 0.0;
+        else if (u2 <= lower)
+          weights(i) = 1.0;
+        else
+          weights(i) = std::sqrt(params_.barcSq * mu * (mu + 1) / u2) - mu;
+      }
+    }
+    for (size_t i = 0; i < nfg_.size(); ++i)
+      if (isInlier_[i]) weights(i) = 1.0;
+    return weights;
+  }
+
+  /// Weights after the last call to optimize
+  const Vector& getWeights() const { return *weights_; }
+
+  /// Number of continuation steps taken by the last call to optimize
+  size_t iterations() const { return iterations_; }
+
+  const NonlinearFactorGraph& getFactors() const { return nfg_; }
+  const Values& getState() const { return state_; }
+  const GncParameters& getParams() const { return params_; }
+
+private:
+  NonlinearFactorGraph nfg_; ///< Original graph
+  NonlinearFactorGraph weightedGraph_; ///< nfg_ wrapped in GncWeightedFactors
+  Values state_;
+  GncParameters params_;
+  boost::shared_ptr<Vector> weights_; ///< Shared with the factors in weightedGraph_
+  std::vector<bool> isInlier_;
+  size_t iterations_;
+};
+
+} // namespace gtsam
@@ -22,7 +22,11 @@
 #include <gtsam/inference/Symbol.h>  // for selective linearization thresholds
 #include <gtsam/nonlinear/ISAM2-impl.h>
 
+#include <gtsam/base/treeTraversal-inst.h>
+
 #include <boost/range/adaptors.hpp>
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <string>
@@ -31,6 +35,11 @@ using namespace std;
 
 namespace gtsam {
 
+#ifdef GTSAM_USE_TBB
+// Fraction of the variables that must be replaced for parallel wildfire
+static const double kParallelWildfireFraction = 0.1;
+#endif
+
 /* ************************************************************************* */
 void ISAM2::Impl::AddFactorsStep1(const NonlinearFactorGraph& newFactors,
                                   bool useUnusedSlots,
@@ -72,15 +81,15 @@ void ISAM2::Impl::AddFactorsStep1(const NonlinearFactorGraph& newFactors,
 }
 
 /* ************************************************************************* */
-KeySet ISAM2::Impl::CheckRelinearizationFull(
+KeyVector ISAM2::Impl::CheckRelinearizationFull(
     const VectorValues& delta,
     const ISAM2Params::RelinearizationThreshold& relinearizeThreshold) {
-  KeySet relinKeys;
+  KeyVector relinKeys;
 
   if (const double* threshold = boost::get<double>(&relinearizeThreshold)) {
     for (const VectorValues::KeyValuePair& key_delta : delta) {
       double maxDelta = key_delta.second.lpNorm<Eigen::Infinity>();
-      if (maxDelta >= *threshold) relinKeys.insert(key_delta.first);
+      if (maxDelta >= *threshold) relinKeys.push_back(key_delta.first);
     }
   } else if (const FastMap<char, Vector>* thresholds =
                  boost::get<FastMap<char, Vector> >(&relinearizeThreshold)) {
@@ -94,7 +103,7 @@ KeySet ISAM2::Impl::CheckRelinearizationFull(
             "' passed into iSAM2 parameters does not match actual variable "
             "dimensionality.");
       if ((key_delta.second.array().abs() > threshold.array()).any())
-        relinKeys.insert(key_delta.first);
+        relinKeys.push_back(key_delta.first);
     }
   }
 
@@ -104,13 +113,15 @@ KeySet ISAM2::Impl::CheckRelinearizationFull(
 /* ************************************************************************* */
 static void CheckRelinearizationRecursiveDouble(
     double threshold, const VectorValues& delta,
-    const ISAM2::sharedClique& clique, KeySet* relinKeys) {
-  // Check the current clique for relinearization
+    const ISAM2::sharedClique& clique, KeyVector* relinKeys) {
+  // Check the current clique for relinearization. Separator keys are frontal
+  // in an ancestor, where they were already collected.
+  const ISAM2::sharedConditional& conditional = clique->conditional();
   bool relinearize = false;
-  for (Key var : *clique->conditional()) {
-    double maxDelta = delta[var].lpNorm<Eigen::Infinity>();
+  for (auto it = conditional->begin(); it != conditional->end(); ++it) {
+    double maxDelta = delta[*it].lpNorm<Eigen::Infinity>();
     if (maxDelta >= threshold) {
-      relinKeys->insert(var);
+      if (it < conditional->endFrontals()) relinKeys->push_back(*it);
       relinearize = true;
     }
   }
@@ -126,10 +137,12 @@ static void CheckRelinearizationRecursiveDouble(
 /* ************************************************************************* */
 static void CheckRelinearizationRecursiveMap(
     const FastMap<char, Vector>& thresholds, const VectorValues& delta,
-    const ISAM2::sharedClique& clique, KeySet* relinKeys) {
-  // Check the current clique for relinearization
+    const ISAM2::sharedClique& clique, KeyVector* relinKeys) {
+  // Check the current clique for relinearization, as above
+  const ISAM2::sharedConditional& conditional = clique->conditional();
   bool relinearize = false;
-  for (Key var : *clique->conditional()) {
+  for (auto it = conditional->begin(); it != conditional->end(); ++it) {
+    const Key var = *it;
     // Find the threshold for this variable type
     const Vector& threshold = thresholds.find(Symbol(var).chr())->second;
 
@@ -145,7 +158,7 @@ static void CheckRelinearizationRecursiveMap(
 
     // Check for relinearization
     if ((deltaVar.array().abs() > threshold.array()).any()) {
-      relinKeys->insert(var);
+      if (it < conditional->endFrontals()) relinKeys->push_back(var);
       relinearize = true;
     }
   }
@@ -159,10 +172,10 @@ static void CheckRelinearizationRecursiveMap(
 }
 
 /* ************************************************************************* */
-KeySet ISAM2::Impl::CheckRelinearizationPartial(
+KeyVector ISAM2::Impl::CheckRelinearizationPartial(
     const ISAM2::Roots& roots, const VectorValues& delta,
     const ISAM2Params::RelinearizationThreshold& relinearizeThreshold) {
-  KeySet relinKeys;
+  KeyVector relinKeys;
   for (const ISAM2::sharedClique& root : roots) {
     if (relinearizeThreshold.type() == typeid(double))
       CheckRelinearizationRecursiveDouble(
@@ -176,16 +189,104 @@ KeySet ISAM2::Impl::CheckRelinearizationPartial(
 }
 
 /* ************************************************************************* */
-namespace internal {
-inline static void optimizeInPlace(const ISAM2::sharedClique& clique,
-                                   VectorValues* result) {
-  // parents are assumed to already be solved and available in result
-  result->update(clique->conditional()->solve(*result));
-
-  // starting from the root, call optimize on each conditional
-  for (const ISAM2::sharedClique& child : clique->children)
-    optimizeInPlace(child, result);
+Ordering ISAM2::Impl::KeepTopOrdering(const GaussianBayesNet& affectedBayesNet,
+                                      const KeyVector& observedKeys,
+                                      const VariableIndex& variableIndex) {
+  assert(std::is_sorted(observedKeys.begin(), observedKeys.end()));
+  auto isObserved = [&observedKeys](Key key) {
+    return std::binary_search(observedKeys.begin(), observedKeys.end(), key);
+  };
+
+  // Walking the removed top backwards visits the cliques in elimination order.
+  // Unused variables are not in the variable index of the affected factors.
+  Ordering ordering;
+  KeyVector last;
+  for (auto conditional = affectedBayesNet.end();
+       conditional != affectedBayesNet.begin();) {
+    --conditional;
+    for (auto key = (*conditional)->beginFrontals();
+         key != (*conditional)->endFrontals(); ++key) {
+      if (isObserved(*key))
+        last.push_back(*key);
+      else if (variableIndex.find(*key) != variableIndex.end())
+        ordering.push_back(*key);
+    }
+  }
+
+  // New variables are observed, but were not in the tree
+  KeyVector inTop(last);
+  std::sort(inTop.begin(), inTop.end());
+  for (Key key : observedKeys)
+    if (!std::binary_search(inTop.begin(), inTop.end(), key) &&
+        variableIndex.find(key) != variableIndex.end())
+      last.push_back(key);
+  ordering.insert(ordering.end(), last.begin(), last.end());
+
+  if (ordering.size() != variableIndex.size()) return Ordering();
+  return ordering;
 }
+
+/* ************************************************************************* */
+namespace internal {
+/// A forest made of the roots of an ISAM2 Bayes tree, for treeTraversal
+struct ISAM2Forest {
+  typedef ISAM2Clique Node;
+  typedef FastVector<ISAM2::sharedClique> Roots;
+  const Roots& roots_;
+  explicit ISAM2Forest(const Roots& roots) : roots_(roots) {}
+  const Roots& roots() const { return roots_; }
+};
+
+/// Pre-order visitor for full back-substitution, writes into existing entries
+/// of delta only, so subtrees can be solved concurrently
+struct BackSubstituteClique {
+  VectorValues* delta;
+  explicit BackSubstituteClique(VectorValues* delta) : delta(delta) {}
+  int operator()(const ISAM2::sharedClique& clique, int) {
+    delta->update(clique->conditional()->solve(*delta));
+    return 0;
+  }
+};
+
+/// Wildfire traversal data: the variables of a clique whose delta changed
+/// significantly, sorted. The separator of a child is a subset of the
+/// variables of its parent, so this is all a child needs to decide if it is
+/// dirty, and cliques below a clean clique receive an empty set.
+struct WildfireData {
+  FastVector<Key> changed;
+};
+
+/// Pre-order visitor for wildfire back-substitution
+struct WildfireClique {
+  const KeySet& replaced;
+  const double threshold;
+  VectorValues* delta;
+  std::atomic<size_t> count;
+
+  WildfireClique(const KeySet& replaced, double threshold, VectorValues* delta)
+      : replaced(replaced), threshold(threshold), delta(delta), count(0) {}
+
+  WildfireData operator()(const ISAM2::sharedClique& clique,
+                          const WildfireData& parentData) {
+    // Changed separator variables, as seen from the parent
+    KeySet changed;
+    for (Key parent : clique->conditional()->parents())
+      if (std::binary_search(parentData.changed.begin(),
+                             parentData.changed.end(), parent))
+        changed.insert(parent);
+
+    WildfireData myData;
+    if (changed.empty() && !replaced.exists(clique->conditional()->front()))
+      return myData;  // Clean, and so is the subtree below
+
+    size_t myCount = 0;
+    clique->optimizeWildfireNode(replaced, threshold, &changed, delta,
+                                 &myCount);
+    count += myCount;
+    myData.changed.assign(changed.begin(), changed.end());
+    return myData;
+  }
+};
 }  // namespace internal
 
 /* ************************************************************************* */
@@ -194,19 +295,40 @@ size_t ISAM2::Impl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
                                            double wildfireThreshold,
                                            VectorValues* delta) {
   size_t lastBacksubVariableCount;
+  const internal::ISAM2Forest forest(roots);
 
   if (wildfireThreshold <= 0.0) {
-    // Threshold is zero or less, so do a full recalculation
-    for (const ISAM2::sharedClique& root : roots)
-      internal::optimizeInPlace(root, delta);
+    // Threshold is zero or less, so do a full recalculation, solving
+    // independent subtrees in parallel
+    int rootData = 0;
+    internal::BackSubstituteClique visitorPre(delta);
+    treeTraversal::no_op visitorPost;
+    treeTraversal::DepthFirstForestParallel(forest, rootData, visitorPre,
+                                            visitorPost);
     lastBacksubVariableCount = delta->size();
 
   } else {
     // Optimize with wildfire
     lastBacksubVariableCount = 0;
-    for (const ISAM2::sharedClique& root : roots)
-      lastBacksubVariableCount += optimizeWildfireNonRecursive(
-          root, wildfireThreshold, replacedKeys, delta);  // modifies delta
+#ifdef GTSAM_USE_TBB
+    // The parallel traversal visits every clique, even if only to find it
+    // clean, so it only pays off once the replaced top is a sizable part of
+    // the tree, e.g., after a loop closure.
+    if (replacedKeys.size() >= kParallelWildfireFraction * delta->size()) {
+      internal::WildfireData rootData;
+      internal::WildfireClique visitorPre(replacedKeys, wildfireThreshold,
+                                          delta);
+      treeTraversal::no_op visitorPost;
+      treeTraversal::DepthFirstForestParallel(forest, rootData, visitorPre,
+                                              visitorPost);
+      lastBacksubVariableCount = visitorPre.count;
+    } else
+#endif
+    {
+      for (const ISAM2::sharedClique& root : roots)
+        lastBacksubVariableCount += optimizeWildfireNonRecursive(
+            root, wildfireThreshold, replacedKeys, delta);  // modifies delta
+    }
 
 #if !defined(NDEBUG) && defined(GTSAM_EXTRA_CONSISTENCY_CHECKS)
     for (VectorValues::const_iterator key_delta = delta->begin();
@@ -46,10 +46,10 @@ struct GTSAM_EXPORT ISAM2::Impl {
    * or equal to relinearizeThreshold are returned.
    * @param delta The linear delta to check against the threshold
    * @param keyFormatter Formatter for printing nonlinear keys during debugging
-   * @return The set of variable indices in delta whose magnitude is greater than or
+   * @return The sorted variable indices in delta whose magnitude is greater than or
    * equal to relinearizeThreshold
    */
-  static KeySet CheckRelinearizationFull(const VectorValues& delta,
+  static KeyVector CheckRelinearizationFull(const VectorValues& delta,
       const ISAM2Params::RelinearizationThreshold& relinearizeThreshold);
 
   /**
@@ -60,12 +60,26 @@ struct GTSAM_EXPORT ISAM2::Impl {
    * to save time at the expense of accuracy.
    * @param delta The linear delta to check against the threshold
    * @param keyFormatter Formatter for printing nonlinear keys during debugging
-   * @return The set of variable indices in delta whose magnitude is greater than or
-   * equal to relinearizeThreshold
+   * @return The variable indices in delta whose magnitude is greater than or
+   * equal to relinearizeThreshold, each once but in tree order
    */
-  static KeySet CheckRelinearizationPartial(const ISAM2::Roots& roots,
+  static KeyVector CheckRelinearizationPartial(const ISAM2::Roots& roots,
     const VectorValues& delta, const ISAM2Params::RelinearizationThreshold& relinearizeThreshold);
 
+  /**
+   * Order the variables of the affected factors by their elimination order in
+   * the top removed from the Bayes tree, and the observed keys last, which is
+   * what constrained COLAMD does, without recomputing the rest.
+   * @param affectedBayesNet The conditionals removed by removeTop, each after
+   * those of its ancestors
+   * @param observedKeys The sorted keys of new and removed factors
+   * @param variableIndex The variable index of the affected factors
+   * @return The ordering, or an empty one if a variable of the affected factors
+   * was neither in the removed top nor observed
+   */
+  static Ordering KeepTopOrdering(const GaussianBayesNet& affectedBayesNet,
+    const KeyVector& observedKeys, const VariableIndex& variableIndex);
+
   /**
    * Update the Newton's method step point, using wildfire
    */
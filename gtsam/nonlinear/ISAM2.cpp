@@ -126,30 +126,41 @@ FactorIndexSet ISAM2::getAffectedFactors(const KeyList& keys) const {
 // (note that the remaining stuff is summarized in the cached factors)
 
 GaussianFactorGraph::shared_ptr ISAM2::relinearizeAffectedFactors(
-    const FastList<Key>& affectedKeys, const KeySet& relinKeys) const {
+    const FastList<Key>& affectedKeys, const KeyVector& relinKeys) {
   gttic(getAffectedFactors);
-  KeySet candidates = getAffectedFactors(affectedKeys);
+  // Count the affected keys of the factors of the affected keys, by factor
+  // index. A factor only contains affected keys if all of them were counted.
+  KeyVector keys(affectedKeys.begin(), affectedKeys.end());
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  FactorIndices candidates;
+  affectedCounts_.clear();
+  for (const Key key : keys)
+    for (const FactorIndex idx : variableIndex_[key])
+      if (affectedCounts_.increment(idx) == 1) candidates.push_back(idx);
+  // In increasing order, as getAffectedFactors
+  std::sort(candidates.begin(), candidates.end());
   gttoc(getAffectedFactors);
 
-  gttic(affectedKeysSet);
-  // for fast lookup below
-  KeySet affectedKeysSet;
-  affectedKeysSet.insert(affectedKeys.begin(), affectedKeys.end());
-  gttoc(affectedKeysSet);
+  gttic(relinearizedFactors);
+  // Factors with a relinearized key cannot use their cached linearization
+  relinCounts_.clear();
+  if (params_.cacheLinearizedFactors) {
+    for (const Key key : relinKeys) {
+      const auto factors = variableIndex_.find(key);
+      if (factors == variableIndex_.end()) continue;
+      for (const FactorIndex idx : factors->second) relinCounts_.increment(idx);
+    }
+  }
+  gttoc(relinearizedFactors);
 
   gttic(check_candidates_and_linearize);
   auto linearized = boost::make_shared<GaussianFactorGraph>();
-  for (Key idx : candidates) {
-    bool inside = true;
-    bool useCachedLinear = params_.cacheLinearizedFactors;
-    for (Key key : nonlinearFactors_[idx]->keys()) {
-      if (affectedKeysSet.find(key) == affectedKeysSet.end()) {
-        inside = false;
-        break;
-      }
-      if (useCachedLinear && relinKeys.find(key) != relinKeys.end())
-        useCachedLinear = false;
-    }
+  for (const FactorIndex idx : candidates) {
+    const bool inside =
+        affectedCounts_.count(idx) == nonlinearFactors_[idx]->size();
+    const bool useCachedLinear =
+        params_.cacheLinearizedFactors && relinCounts_.count(idx) == 0;
     if (inside) {
       if (useCachedLinear) {
 #ifdef GTSAM_EXTRA_CONSISTENCY_CHECKS
@@ -174,6 +185,51 @@ GaussianFactorGraph::shared_ptr ISAM2::relinearizeAffectedFactors(
   return linearized;
 }
 
+/* ************************************************************************* */
+KeyVector ISAM2::findInvolvedKeys(const KeyVector& relinKeys) const {
+  // Sorted, to look up separator keys without hashing
+  KeyVector sortedRelinKeys(relinKeys);
+  std::sort(sortedRelinKeys.begin(), sortedRelinKeys.end());
+  auto isRelin = [&sortedRelinKeys](Key key) {
+    return std::binary_search(sortedRelinKeys.begin(), sortedRelinKeys.end(),
+                              key);
+  };
+  auto separatorInvolved = [&isRelin](const sharedClique& clique) {
+    const auto& parents = clique->conditional()->parents();
+    return std::any_of(parents.begin(), parents.end(), isRelin);
+  };
+
+  // By the running intersection property, a clique with key j in its separator
+  // is reached from the clique of j through cliques that all have j in their
+  // separator, so there is no need to visit the whole tree as findAll does.
+  // Walks start at the cliques of relinKeys that are not reached that way, once
+  // per clique, so that no clique is visited twice.
+  std::vector<sharedClique> stack;
+  for (Key key : sortedRelinKeys) {
+    const auto it = nodes_.find(key);
+    if (it == nodes_.end()) continue;
+    const sharedClique& clique = it->second;
+    const sharedConditional& conditional = clique->conditional();
+    if (*std::find_if(conditional->beginFrontals(), conditional->endFrontals(),
+                      isRelin) == key &&
+        !separatorInvolved(clique))
+      stack.push_back(clique);
+  }
+  KeyVector keys;
+  while (!stack.empty()) {
+    const sharedClique clique = stack.back();
+    stack.pop_back();
+    for (const sharedClique& child : clique->children) {
+      if (separatorInvolved(child)) {
+        keys.insert(keys.end(), child->conditional()->beginFrontals(),
+                    child->conditional()->endFrontals());
+        stack.push_back(child);
+      }
+    }
+  }
+  return keys;
+}
+
 /* ************************************************************************* */
 // find intermediate (linearized) factors from cache that are passed into the
 // affected area
@@ -191,7 +247,7 @@ GaussianFactorGraph ISAM2::getCachedBoundaryFactors(const Cliques& orphans) {
 
 /* ************************************************************************* */
 boost::shared_ptr<KeySet> ISAM2::recalculate(
-    const KeySet& markedKeys, const KeySet& relinKeys,
+    const KeyVector& markedKeys, const KeyVector& relinKeys,
     const KeyVector& observedKeys, const KeySet& unusedIndices,
     const boost::optional<FastMap<Key, int> >& constrainKeys,
     ISAM2Result* result) {
@@ -240,8 +296,7 @@ boost::shared_ptr<KeySet> ISAM2::recalculate(
   gttic(removetop);
   Cliques orphans;
   GaussianBayesNet affectedBayesNet;
-  this->removeTop(KeyVector(markedKeys.begin(), markedKeys.end()),
-                  affectedBayesNet, orphans);
+  this->removeTop(markedKeys, affectedBayesNet, orphans);
   gttoc(removetop);
 
   //    FactorGraph<GaussianFactor> factors(affectedBayesNet);
@@ -420,36 +475,40 @@ boost::shared_ptr<KeySet> ISAM2::recalculate(
 
     VariableIndex affectedFactorsVarIndex(factors);
 
-    gttic(ordering_constraints);
-    // Create ordering constraints
-    FastMap<Key, int> constraintGroups;
-    if (constrainKeys) {
-      constraintGroups = *constrainKeys;
-    } else {
-      constraintGroups = FastMap<Key, int>();
-      const int group =
-          observedKeys.size() < affectedFactorsVarIndex.size() ? 1 : 0;
-      for (Key var : observedKeys)
-        constraintGroups.insert(make_pair(var, group));
+    // Generate ordering, keeping the order of the removed top if requested
+    Ordering ordering;
+    if (params_.incrementalReordering && !constrainKeys) {
+      gttic(KeepTopOrdering);
+      ordering = Impl::KeepTopOrdering(affectedBayesNet, observedKeys,
+                                       affectedFactorsVarIndex);
+      gttoc(KeepTopOrdering);
     }
+    if (ordering.empty()) {
+      gttic(ordering_constraints);
+      // Create ordering constraints
+      FastMap<Key, int> constraintGroups;
+      if (constrainKeys) {
+        // Only the affected keys are ordered, so look them up rather than
+        // copying constraints that may cover every variable
+        for (Key var : *affectedKeysSet) {
+          const auto group = constrainKeys->find(var);
+          if (group != constrainKeys->end() && !unusedIndices.exists(var))
+            constraintGroups.emplace_hint(constraintGroups.end(), *group);
+        }
+      } else {
+        const int group =
+            observedKeys.size() < affectedFactorsVarIndex.size() ? 1 : 0;
+        for (Key var : observedKeys)
+          if (affectedKeysSet->exists(var) && !unusedIndices.exists(var))
+            constraintGroups.insert(make_pair(var, group));
+      }
+      gttoc(ordering_constraints);
 
-    // Remove unaffected keys from the constraints
-    for (FastMap<Key, int>::iterator iter = constraintGroups.begin();
-         iter != constraintGroups.end();
-         /*Incremented in loop ++iter*/) {
-      if (unusedIndices.exists(iter->first) ||
-          !affectedKeysSet->exists(iter->first))
-        constraintGroups.erase(iter++);
-      else
-        ++iter;
+      gttic(Ordering);
+      ordering = Ordering::ColamdConstrained(affectedFactorsVarIndex,
+                                             constraintGroups);
+      gttoc(Ordering);
     }
-    gttoc(ordering_constraints);
-
-    // Generate ordering
-    gttic(Ordering);
-    Ordering ordering =
-        Ordering::ColamdConstrained(affectedFactorsVarIndex, constraintGroups);
-    gttoc(Ordering);
 
     ISAM2BayesTree::shared_ptr bayesTree =
         ISAM2JunctionTree(
@@ -507,32 +566,22 @@ void ISAM2::removeVariables(const KeySet& unusedKeys) {
 }
 
 /* ************************************************************************* */
-void ISAM2::expmapMasked(const KeySet& mask) {
+void ISAM2::expmapMasked(const KeyVector& mask) {
   assert(theta_.size() == delta_.size());
-  Values::iterator key_value;
-  VectorValues::const_iterator key_delta;
-#ifdef GTSAM_USE_TBB
-  for (key_value = theta_.begin(); key_value != theta_.end(); ++key_value) {
-    key_delta = delta_.find(key_value->key);
-#else
-  for (key_value = theta_.begin(), key_delta = delta_.begin();
-       key_value != theta_.end(); ++key_value, ++key_delta) {
-    assert(key_value->key == key_delta->first);
-#endif
-    Key var = key_value->key;
-    assert(static_cast<size_t>(delta_[var].size()) == key_value->value.dim());
-    assert(delta_[var].allFinite());
-    if (mask.exists(var)) {
-      Value* retracted = key_value->value.retract_(delta_[var]);
-      key_value->value = *retracted;
-      retracted->deallocate_();
+  for (Key var : mask) {
+    const Values::iterator key_value = theta_.find(var);
+    assert(key_value != theta_.end());
+    Vector& delta = delta_.at(var);
+    assert(static_cast<size_t>(delta.size()) == key_value->value.dim());
+    assert(delta.allFinite());
+    Value* retracted = key_value->value.retract_(delta);
+    key_value->value = *retracted;
+    retracted->deallocate_();
 #ifndef NDEBUG
-      // If debugging, invalidate delta_ entries to Inf, to trigger assertions
-      // if we try to re-use them.
-      delta_[var] = Vector::Constant(delta_[var].rows(),
-                                     numeric_limits<double>::infinity());
+    // If debugging, invalidate delta_ entries to Inf, to trigger assertions
+    // if we try to re-use them.
+    delta = Vector::Constant(delta.rows(), numeric_limits<double>::infinity());
 #endif
-    }
   }
 }
 
@@ -582,6 +631,9 @@ ISAM2Result ISAM2::update(
   if (debug || verbose) newFactors.print("The new factors are: ");
   Impl::AddFactorsStep1(newFactors, params_.findUnusedFactorSlots,
                         &nonlinearFactors_, &result.newFactorsIndices);
+  if (params_.findUnusedFactorSlots)
+    for (const auto index : result.newFactorsIndices)
+      emptyFactorSlots_.erase(index);
 
   // Remove the removed factors
   NonlinearFactorGraph removeFactors;
@@ -591,6 +643,9 @@ ISAM2Result ISAM2::update(
     nonlinearFactors_.remove(index);
     if (params_.cacheLinearizedFactors) linearFactors_.remove(index);
   }
+  if (tracksEmptyFactorSlots())
+    emptyFactorSlots_.insert(removeFactorIndices.begin(),
+                             removeFactorIndices.end());
 
   // Remove removed factors from the variable index so we do not attempt to
   // relinearize them
@@ -639,21 +694,26 @@ ISAM2Result ISAM2::update(
 
   gttic(gather_involved_keys);
   // 3. Mark linear update
-  KeySet markedKeys = newFactors.keys();  // Get keys from new factors
+  // Duplicates are removed by sorting the marked keys once they are gathered
+  KeyVector markedKeys;
+  auto mark = [&markedKeys](Key key) { markedKeys.push_back(key); };
+  auto sortMarked = [&markedKeys]() {
+    std::sort(markedKeys.begin(), markedKeys.end());
+    markedKeys.erase(std::unique(markedKeys.begin(), markedKeys.end()),
+                     markedKeys.end());
+  };
+  for (const auto& factor : newFactors)  // Keys from new factors
+    if (factor)
+      for (Key key : factor->keys()) mark(key);
   // Also mark keys involved in removed factors
-  {
-    KeySet markedRemoveKeys =
-        removeFactors.keys();  // Get keys involved in removed factors
-    markedKeys.insert(
-        markedRemoveKeys.begin(),
-        markedRemoveKeys.end());  // Add to the overall set of marked keys
-  }
+  for (const auto& factor : removeFactors)
+    if (factor)
+      for (Key key : factor->keys()) mark(key);
   // Also mark any provided extra re-eliminate keys
   if (extraReelimKeys) {
-    for (Key key : *extraReelimKeys) {
-      markedKeys.insert(key);
-    }
+    for (Key key : *extraReelimKeys) mark(key);
   }
+  sortMarked();
 
   // Observed keys for detailed results
   if (params_.enableDetailedResults) {
@@ -676,30 +736,29 @@ ISAM2Result ISAM2::update(
 
   // Check relinearization if we're at the nth step, or we are using a looser
   // loop relin threshold
-  KeySet relinKeys;
+  KeyVector relinKeys;
   if (relinearizeThisStep) {
     gttic(gather_relinearize_keys);
     // 4. Mark keys in \Delta above threshold \beta:
     // J=\{\Delta_{j}\in\Delta|\Delta_{j}\geq\beta\}.
+    KeyVector aboveThreshold;
     if (params_.enablePartialRelinearizationCheck)
-      relinKeys = Impl::CheckRelinearizationPartial(
+      aboveThreshold = Impl::CheckRelinearizationPartial(
           roots_, delta_, params_.relinearizeThreshold);
     else
-      relinKeys =
+      aboveThreshold =
           Impl::CheckRelinearizationFull(delta_, params_.relinearizeThreshold);
     if (kDisableReordering)
-      relinKeys = Impl::CheckRelinearizationFull(
+      aboveThreshold = Impl::CheckRelinearizationFull(
           delta_, 0.0);  // This is used for debugging
 
-    // Remove from relinKeys any keys whose linearization points are fixed
-    for (Key key : fixedVariables_) {
-      relinKeys.erase(key);
-    }
-    if (noRelinKeys) {
-      for (Key key : *noRelinKeys) {
-        relinKeys.erase(key);
-      }
-    }
+    // Leave out any keys whose linearization points are fixed
+    KeySet noRelin;
+    if (noRelinKeys) noRelin.insert(noRelinKeys->begin(), noRelinKeys->end());
+    relinKeys.reserve(aboveThreshold.size());
+    for (Key key : aboveThreshold)
+      if (!fixedVariables_.exists(key) && !noRelin.exists(key))
+        relinKeys.push_back(key);
 
     // Above relin threshold keys for detailed results
     if (params_.enableDetailedResults) {
@@ -710,24 +769,19 @@ ISAM2Result ISAM2::update(
     }
 
     // Add the variables being relinearized to the marked keys
-    KeySet markedRelinMask;
-    for (const Key key : relinKeys) markedRelinMask.insert(key);
-    markedKeys.insert(relinKeys.begin(), relinKeys.end());
+    for (Key key : relinKeys) mark(key);
     gttoc(gather_relinearize_keys);
 
     gttic(fluid_find_all);
     // 5. Mark all cliques that involve marked variables \Theta_{J} and all
     // their ancestors.
     if (!relinKeys.empty()) {
-      for (const sharedClique& root : roots_)
-        // add other cliques that have the marked ones in the separator
-        root->findAll(markedRelinMask, &markedKeys);
+      // add other cliques that have the marked ones in the separator
+      const KeyVector involvedRelinKeys = findInvolvedKeys(relinKeys);
+      for (Key key : involvedRelinKeys) mark(key);
 
       // Relin involved keys for detailed results
       if (params_.enableDetailedResults) {
-        KeySet involvedRelinKeys;
-        for (const sharedClique& root : roots_)
-          root->findAll(markedRelinMask, &involvedRelinKeys);
         for (Key key : involvedRelinKeys) {
           if (!result.detail->variableStatus[key].isAboveRelinThreshold) {
             result.detail->variableStatus[key].isRelinearizeInvolved = true;
@@ -741,9 +795,10 @@ ISAM2Result ISAM2::update(
     gttic(expmap);
     // 6. Update linearization point for marked variables:
     // \Theta_{J}:=\Theta_{J}+\Delta_{J}.
-    if (!relinKeys.empty()) expmapMasked(markedRelinMask);
+    if (!relinKeys.empty()) expmapMasked(relinKeys);
     gttoc(expmap);
 
+    sortMarked();
     result.variablesRelinearized = markedKeys.size();
   } else {
     result.variablesRelinearized = 0;
@@ -795,6 +850,15 @@ ISAM2Result ISAM2::update(
   }
   result.cliques = this->nodes().size();
 
+  // Fill the slots of removed factors, a bounded number per update
+  if (params_.maxFactorSlotMoves > 0) {
+    result.movedFactors = compactFactorSlots(params_.maxFactorSlotMoves);
+    for (auto& index : result.newFactorsIndices) {
+      const auto moved = result.movedFactors.find(index);
+      if (moved != result.movedFactors.end()) index = moved->second;
+    }
+  }
+
   gttic(evaluate_error_after);
   if (params_.evaluateNonlinearError)
     result.errorAfter.reset(nonlinearFactors_.error(calculateEstimate()));
@@ -986,24 +1050,44 @@ void ISAM2::marginalizeLeaves(
   // At this point we have updated the BayesTree, now update the remaining iSAM2
   // data structures
 
-  // Gather factors to add - the new marginal factors
+  // Gather factors to add - the new marginal factors. With findUnusedFactorSlots
+  // they fill the slots that were empty before this call, so that they never
+  // take the index of a factor deleted below.
   GaussianFactorGraph factorsToAdd;
+  FactorIndices factorsToAddIndices;
   for (const auto& key_factors : marginalFactors) {
     for (const auto& factor : key_factors.second) {
       if (factor) {
+        // Skip recorded slots that have been filled or dropped since
+        FactorIndex index = nonlinearFactors_.size();
+        while (params_.findUnusedFactorSlots && !emptyFactorSlots_.empty()) {
+          const FactorIndex slot = *emptyFactorSlots_.begin();
+          emptyFactorSlots_.erase(emptyFactorSlots_.begin());
+          if (slot < nonlinearFactors_.size() && !nonlinearFactors_[slot]) {
+            index = slot;
+            break;
+          }
+        }
         factorsToAdd.push_back(factor);
-        if (marginalFactorsIndices)
-          marginalFactorsIndices->push_back(nonlinearFactors_.size());
-        nonlinearFactors_.push_back(
-            boost::make_shared<LinearContainerFactor>(factor));
-        if (params_.cacheLinearizedFactors) linearFactors_.push_back(factor);
+        factorsToAddIndices.push_back(index);
+        if (marginalFactorsIndices) marginalFactorsIndices->push_back(index);
+        const auto marginal = boost::make_shared<LinearContainerFactor>(factor);
+        if (index == nonlinearFactors_.size())
+          nonlinearFactors_.push_back(marginal);
+        else
+          nonlinearFactors_.replace(index, marginal);
+        if (params_.cacheLinearizedFactors) {
+          if (index >= linearFactors_.size()) linearFactors_.resize(index + 1);
+          linearFactors_.replace(index, factor);
+        }
         for (Key factorKey : *factor) {
           fixedVariables_.insert(factorKey);
         }
       }
     }
   }
-  variableIndex_.augment(factorsToAdd);  // Augment the variable index
+  // Augment the variable index
+  variableIndex_.augment(factorsToAdd, factorsToAddIndices);
 
   // Remove the factors to remove that have been summarized in the newly-added
   // marginal factors
@@ -1015,6 +1099,9 @@ void ISAM2::marginalizeLeaves(
   }
   variableIndex_.remove(factorIndicesToRemove.begin(),
                         factorIndicesToRemove.end(), removedFactors);
+  if (tracksEmptyFactorSlots())
+    emptyFactorSlots_.insert(factorIndicesToRemove.begin(),
+                             factorIndicesToRemove.end());
 
   if (deletedFactorsIndices)
     deletedFactorsIndices->assign(factorIndicesToRemove.begin(),
@@ -1024,6 +1111,43 @@ void ISAM2::marginalizeLeaves(
   removeVariables(KeySet(leafKeys.begin(), leafKeys.end()));
 }
 
+/* ************************************************************************* */
+FastMap<FactorIndex, FactorIndex> ISAM2::compactFactorSlots(size_t maxMoves) {
+  gttic(ISAM2_compactFactorSlots);
+  const bool cached = params_.cacheLinearizedFactors;
+
+  // Drop the empty slots at the end, so that the last slot holds a factor
+  auto dropEmptyTail = [&]() {
+    while (!nonlinearFactors_.empty() && !nonlinearFactors_.back()) {
+      emptyFactorSlots_.erase(nonlinearFactors_.size() - 1);
+      nonlinearFactors_.resize(nonlinearFactors_.size() - 1);
+      if (cached) linearFactors_.resize(nonlinearFactors_.size());
+    }
+  };
+
+  FastMap<FactorIndex, FactorIndex> moved;
+  dropEmptyTail();
+  while (moved.size() < maxMoves && !emptyFactorSlots_.empty()) {
+    const FactorIndex to = *emptyFactorSlots_.begin();
+    emptyFactorSlots_.erase(emptyFactorSlots_.begin());
+    if (to >= nonlinearFactors_.size() || nonlinearFactors_[to]) continue;
+
+    // Move the last factor into the lowest empty slot
+    const FactorIndex from = nonlinearFactors_.size() - 1;
+    variableIndex_.renumberFactor(from, to, nonlinearFactors_[from]->keys());
+    nonlinearFactors_[to] = nonlinearFactors_[from];
+    nonlinearFactors_.remove(from);
+    if (cached) {
+      linearFactors_[to] = linearFactors_[from];
+      linearFactors_.remove(from);
+    }
+    moved[from] = to;
+    dropEmptyTail();
+  }
+  variableIndex_.truncateFactors(nonlinearFactors_.size());
+  return moved;
+}
+
 /* ************************************************************************* */
 void ISAM2::updateDelta(bool forceFullSolve) const {
   gttic(updateDelta);
@@ -1118,6 +1242,40 @@ const VectorValues& ISAM2::getDelta() const {
   return delta_;
 }
 
+/* ************************************************************************* */
+ISAM2::CachedState ISAM2::getCachedState() const {
+  CachedState state;
+  state.linearFactors = linearFactors_;
+  state.delta = delta_;
+  state.deltaNewton = deltaNewton_;
+  state.RgProd = RgProd_;
+  state.deltaReplacedMask = deltaReplacedMask_;
+  state.fixedVariables = fixedVariables_;
+  state.doglegDelta = doglegDelta_;
+  state.update_count = update_count_;
+  return state;
+}
+
+/* ************************************************************************* */
+void ISAM2::restoreState(NonlinearFactorGraph nonlinearFactors, Values theta,
+                         CachedState state) {
+  variableIndex_ = VariableIndex(nonlinearFactors);
+  emptyFactorSlots_.clear();
+  if (tracksEmptyFactorSlots())
+    for (size_t i = 0; i < nonlinearFactors.size(); i++)
+      if (!nonlinearFactors[i]) emptyFactorSlots_.insert(i);
+  nonlinearFactors_ = std::move(nonlinearFactors);
+  theta_.swap(theta);
+  linearFactors_ = std::move(state.linearFactors);
+  delta_.swap(state.delta);
+  deltaNewton_.swap(state.deltaNewton);
+  RgProd_.swap(state.RgProd);
+  deltaReplacedMask_.swap(state.deltaReplacedMask);
+  fixedVariables_.swap(state.fixedVariables);
+  doglegDelta_ = state.doglegDelta;
+  update_count_ = state.update_count;
+}
+
 /* ************************************************************************* */
 double ISAM2::error(const VectorValues& x) const {
   return GaussianFactorGraph(*this).error(x);
@@ -25,6 +25,7 @@
 #include <gtsam/nonlinear/ISAM2Clique.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/inference/SlotCounts.h>
 
 #include <vector>
 
@@ -95,6 +96,16 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   int update_count_;  ///< Counter incremented every update(), used to determine
                       ///< periodic relinearization
 
+  /** Scratch counts of the affected and relinearized keys of every factor,
+   * indexed by factor index and reused by every update. The methods using
+   * them are not const, as they cannot run concurrently. */
+  SlotCounts affectedCounts_, relinCounts_;
+
+  /** Slots of removed and marginalized factors, which compactFactorSlots fills
+   * from the end of the factor graph. Only recorded if slots are reused or
+   * compacted, see tracksEmptyFactorSlots(). */
+  FactorIndexSet emptyFactorSlots_;
+
  public:
   typedef ISAM2 This;                       ///< This class
   typedef BayesTree<ISAM2Clique> Base;      ///< The BayesTree base class
@@ -172,12 +183,28 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
    * If provided, 'deletedFactorsIndices' will be augmented with the factor
    * graph indices of any factor that was removed during the 'marginalizeLeaves'
    * call
+   *
+   * With ISAM2Params::findUnusedFactorSlots, the marginal factors are placed in
+   * slots that were empty before the call, and never in the slots it deletes.
    */
   void marginalizeLeaves(
       const FastList<Key>& leafKeys,
       boost::optional<FactorIndices&> marginalFactorsIndices = boost::none,
       boost::optional<FactorIndices&> deletedFactorsIndices = boost::none);
 
+  /** Move up to \c maxMoves factors from the end of the factor graph into the
+   * slots of removed or marginalized factors, lowest slots first, and drop the
+   * empty slots at the end. The variable index and the cached linear factors
+   * are renumbered in place, in time linear in \c maxMoves and the number of
+   * factors of the moved factors' variables. update() calls this when
+   * ISAM2Params::maxFactorSlotMoves is positive. Empty slots are only recorded
+   * while that or ISAM2Params::findUnusedFactorSlots is set.
+   *
+   * @return The moved factors, from their old to their new index. Factor
+   * indices kept by the caller have to be renumbered accordingly.
+   */
+  FastMap<FactorIndex, FactorIndex> compactFactorSlots(size_t maxMoves);
+
   /// Access the current linearization point
   const Values& getLinearizationPoint() const { return theta_; }
 
@@ -245,6 +272,26 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   /** Access the nonlinear variable index */
   const KeySet& getFixedVariables() const { return fixedVariables_; }
 
+  /** The cached linearization and solution state that update() maintains
+   * besides the factors, the linearization point and the Bayes tree, e.g., to
+   * checkpoint and restore an ISAM2 instance */
+  struct CachedState {
+    GaussianFactorGraph linearFactors;  ///< one per nonlinear factor slot
+    VectorValues delta, deltaNewton, RgProd;
+    KeySet deltaReplacedMask, fixedVariables;
+    boost::optional<double> doglegDelta;
+    int update_count;
+  };
+
+  /** Copy of the cached state */
+  CachedState getCachedState() const;
+
+  /** Replace the factors, linearization point and cached state, after the
+   * Bayes tree has been rebuilt with clear() and addClique(). The variable
+   * index and the empty factor slots are recomputed from the factors. */
+  void restoreState(NonlinearFactorGraph nonlinearFactors, Values theta,
+                    CachedState state);
+
   size_t lastAffectedVariableCount;
   size_t lastAffectedFactorCount;
   size_t lastAffectedCliqueCount;
@@ -290,15 +337,28 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
    * \c mask.  Values are expmapped in-place.
    * \param mask Mask on linear indices, only \c true entries are expmapped
    */
-  void expmapMasked(const KeySet& mask);
+  void expmapMasked(const KeyVector& mask);
+
+  /**
+   * Return the frontal keys of all cliques that have a key of \c relinKeys in
+   * their separator, each once. Only the subtrees below the cliques of
+   * \c relinKeys are visited.
+   */
+  KeyVector findInvolvedKeys(const KeyVector& relinKeys) const;
+
+  /// Whether the slots of removed factors are reused or compacted, and hence
+  /// have to be recorded in emptyFactorSlots_
+  bool tracksEmptyFactorSlots() const {
+    return params_.findUnusedFactorSlots || params_.maxFactorSlotMoves > 0;
+  }
 
   FactorIndexSet getAffectedFactors(const FastList<Key>& keys) const;
   GaussianFactorGraph::shared_ptr relinearizeAffectedFactors(
-      const FastList<Key>& affectedKeys, const KeySet& relinKeys) const;
+      const FastList<Key>& affectedKeys, const KeyVector& relinKeys);
   GaussianFactorGraph getCachedBoundaryFactors(const Cliques& orphans);
 
   virtual boost::shared_ptr<KeySet> recalculate(
-      const KeySet& markedKeys, const KeySet& relinKeys,
+      const KeyVector& markedKeys, const KeyVector& relinKeys,
       const KeyVector& observedKeys, const KeySet& unusedIndices,
       const boost::optional<FastMap<Key, int> >& constrainKeys,
       ISAM2Result* result);
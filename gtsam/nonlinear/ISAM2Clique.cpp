@@ -19,6 +19,7 @@
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/linear/linearAlgorithms-inst.h>
 #include <gtsam/nonlinear/ISAM2Clique.h>
+#include <algorithm>
 #include <stack>
 
 using namespace std;
@@ -206,7 +207,7 @@ void ISAM2Clique::optimizeWildfire(const KeySet& replaced, double threshold,
 
     // Back-substitute
     fastBackSubstitute(delta);
-    count += conditional_->nrFrontals();
+    *count += conditional_->nrFrontals();
 
     if (valuesChanged(replaced, originalValues, *delta, threshold)) {
       markFrontalsAsChanged(changed);
@@ -243,7 +244,7 @@ bool ISAM2Clique::optimizeWildfireNode(const KeySet& replaced, double threshold,
 
     // Back-substitute
     fastBackSubstitute(delta);
-    count += conditional_->nrFrontals();
+    *count += conditional_->nrFrontals();
 
     if (valuesChanged(replaced, originalValues, *delta, threshold)) {
       markFrontalsAsChanged(changed);
@@ -321,5 +322,18 @@ void ISAM2Clique::findAll(const KeySet& markedMask, KeySet* keys) const {
   }
 }
 
+/* ************************************************************************* */
+void ISAM2Clique::findAllWithParent(Key key, KeySet* keys) const {
+  for (const auto& child : children) {
+    // If the key is not in the separator, none of the cliques below have it
+    const GaussianConditional& conditional = *child->conditional();
+    if (std::find(conditional.beginParents(), conditional.endParents(), key) !=
+        conditional.endParents()) {
+      keys->insert(conditional.beginFrontals(), conditional.endFrontals());
+      child->findAllWithParent(key, keys);
+    }
+  }
+}
+
 /* ************************************************************************* */
 }  // namespace gtsam
@@ -116,6 +116,14 @@ class GTSAM_EXPORT ISAM2Clique
    */
   void findAll(const KeySet& markedMask, KeySet* keys) const;
 
+  /**
+   * Add the frontal keys of the cliques below this one that have \c key in
+   * their separator to the set \c keys. Re-eliminating these together with
+   * the frontal keys of this clique, with \c key constrained first, makes
+   * \c key a leaf, e.g., to marginalize it.
+   */
+  void findAllWithParent(Key key, KeySet* keys) const;
+
  private:
   /**
    * Check if clique was replaced, or if any parents were changed above the
@@ -223,6 +223,23 @@ struct GTSAM_EXPORT ISAM2Params {
   /// cost of having to search for slots every time a factor is added.
   bool findUnusedFactorSlots;
 
+  /// Move up to this many factors per update() from the end of the factor
+  /// graph into the slots of removed or marginalized factors, and drop the
+  /// empty slots at the end. This keeps the factor graph, the variable index
+  /// and the cached linear factors from growing with the number of removed
+  /// factors. The moves are reported in ISAM2Result::movedFactors
+  /// (default: 0, no compaction).
+  size_t maxFactorSlotMoves;
+
+  /** Order the affected top of the Bayes tree by the elimination order it had
+   * before the update, with the variables of new factors last, instead of by
+   * constrained COLAMD (default: false). This saves the ordering time of large
+   * affected tops, but the order does not adapt to new structure such as loop
+   * closures, so fill-in can grow until a batch step reorders all variables.
+   * Constrained keys passed to update() always use constrained COLAMD.
+   */
+  bool incrementalReordering;
+
   /**
    * Specify parameters as constructor arguments
    * See the documentation of member variables above.
@@ -246,7 +263,9 @@ struct GTSAM_EXPORT ISAM2Params {
         keyFormatter(_keyFormatter),
         enableDetailedResults(false),
         enablePartialRelinearizationCheck(false),
-        findUnusedFactorSlots(false) {}
+        findUnusedFactorSlots(false),
+        maxFactorSlotMoves(0),
+        incrementalReordering(false) {}
 
   /// print iSAM2 parameters
   void print(const std::string& str = "") const {
@@ -288,6 +307,10 @@ struct GTSAM_EXPORT ISAM2Params {
          << enablePartialRelinearizationCheck << "\n";
     cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots
          << "\n";
+    cout << "maxFactorSlotMoves:                " << maxFactorSlotMoves
+         << "\n";
+    cout << "incrementalReordering:             " << incrementalReordering
+         << "\n";
     cout.flush();
   }
 
@@ -312,6 +335,8 @@ struct GTSAM_EXPORT ISAM2Params {
   bool isEnablePartialRelinearizationCheck() const {
     return enablePartialRelinearizationCheck;
   }
+  size_t getMaxFactorSlotMoves() const { return maxFactorSlotMoves; }
+  bool isIncrementalReordering() const { return incrementalReordering; }
 
   void setOptimizationParams(OptimizationParams optimizationParams) {
     this->optimizationParams = optimizationParams;
@@ -344,6 +369,12 @@ struct GTSAM_EXPORT ISAM2Params {
       bool enablePartialRelinearizationCheck) {
     this->enablePartialRelinearizationCheck = enablePartialRelinearizationCheck;
   }
+  void setMaxFactorSlotMoves(size_t maxFactorSlotMoves) {
+    this->maxFactorSlotMoves = maxFactorSlotMoves;
+  }
+  void setIncrementalReordering(bool incrementalReordering) {
+    this->incrementalReordering = incrementalReordering;
+  }
 
   GaussianFactorGraph::Eliminate getEliminationFunction() const {
     return factorization == CHOLESKY
@@ -96,6 +96,13 @@ struct GTSAM_EXPORT ISAM2Result {
    */
   FactorIndices newFactorsIndices;
 
+  /** The factors moved to another slot when compacting the factor graph, see
+   * ISAM2Params::maxFactorSlotMoves, from their old to their new index. Factor
+   * indices kept from earlier updates have to be renumbered accordingly. The
+   * entries of newFactorsIndices are already the new indices.
+   */
+  FastMap<FactorIndex, FactorIndex> movedFactors;
+
   /** A struct holding detailed results, which must be enabled with
    * ISAM2Params::enableDetailedResults.
    */
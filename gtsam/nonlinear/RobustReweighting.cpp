@@ -0,0 +1,159 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    RobustReweighting.cpp
+ * @brief   Linearize a graph with robust noise models, reweighting all factors at once
+ */
+
+#include <gtsam/nonlinear/RobustReweighting.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/base/timing.h>
+
+#include <typeinfo>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+// Return the robust model of a factor if it can be reweighted in batch
+const noiseModel::Robust* batchedRobustModel(const NonlinearFactor::shared_ptr& factor) {
+  const NoiseModelFactor* noiseModelFactor = dynamic_cast<const NoiseModelFactor*>(factor.get());
+  if (!noiseModelFactor) return nullptr;
+  const noiseModel::Robust* robust =
+      dynamic_cast<const noiseModel::Robust*>(noiseModelFactor->noiseModel().get());
+  if (!robust || robust->robust()->reweightScheme() != noiseModel::mEstimator::Base::Block)
+    return nullptr;
+  return robust;
+}
+}
+
+/* ************************************************************************* */
+RobustReweighting::RobustReweighting(const NonlinearFactorGraph& graph) :
+    graph_(graph), slots_(graph.size(), graph.size()), weights_(Vector::Ones(graph.size())) {
+
+  // Group the robust factors by M-estimator, estimators that are equal share a group
+  vector<vector<size_t> > members;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    const noiseModel::Robust* robust = batchedRobustModel(graph[i]);
+    if (!robust) continue;
+    const noiseModel::mEstimator::Base::shared_ptr& estimator = robust->robust();
+    size_t g = 0;
+    for (; g < groups_.size(); ++g) {
+      const noiseModel::mEstimator::Base::shared_ptr& other = groups_[g].estimator;
+      if (other == estimator || (typeid(*other) == typeid(*estimator)
+          && other->equals(*estimator, 1e-14)))
+        break;
+    }
+    if (g == groups_.size()) {
+      Group group = { estimator, 0, 0 };
+      groups_.push_back(group);
+      members.push_back(vector<size_t>());
+    }
+    members[g].push_back(i);
+  }
+
+  // Lay out the slots contiguously per group
+  for (size_t g = 0; g < groups_.size(); ++g) {
+    groups_[g].begin = factors_.size();
+    for (size_t i : members[g]) {
+      slots_[i] = factors_.size();
+      factors_.push_back(i);
+    }
+    groups_[g].end = factors_.size();
+  }
+  norms_ = Vector::Zero(factors_.size());
+}
+
+/* ************************************************************************* */
+void RobustReweighting::updateWeights() {
+  gttic(RobustReweighting_updateWeights);
+  for (const Group& group : groups_) {
+    const size_t n = group.end - group.begin;
+    const Vector w = group.estimator->weight(Vector(norms_.segment(group.begin, n)));
+    for (size_t k = 0; k < n; ++k)
+      weights_(factors_[group.begin + k]) = w(k);
+  }
+}
+
+/* ************************************************************************* */
+GaussianFactorGraph::shared_ptr RobustReweighting::linearize(const Values& values) {
+  gttic(RobustReweighting_linearize);
+  const size_t n = graph_.size(), nrSlots = factors_.size();
+  GaussianFactorGraph::shared_ptr linearFG = boost::make_shared<GaussianFactorGraph>();
+  linearFG->resize(n);
+
+  // First pass: linearize all factors, robust ones are only whitened by their noise model
+  vector<vector<Matrix> > A(nrSlots);
+  vector<Vector> b(nrSlots);
+  vector<char> active(nrSlots, 0);
+  parallelFor(n, [&](size_t i) {
+    const NonlinearFactor::shared_ptr& factor = graph_[i];
+    const size_t slot = slots_[i];
+    if (slot == n) {
+      if (factor) (*linearFG)[i] = factor->linearize(values);
+      return;
+    }
+    const NoiseModelFactor& noiseModelFactor = static_cast<const NoiseModelFactor&>(*factor);
+    if (!noiseModelFactor.active(values)) {
+      norms_(slot) = 0.0;
+      return;
+    }
+    active[slot] = 1;
+    A[slot].resize(noiseModelFactor.size());
+    b[slot] = -noiseModelFactor.unwhitenedError(values, A[slot]);
+    static_cast<const noiseModel::Robust&>(*noiseModelFactor.noiseModel()).noise()->WhitenSystem(
+        A[slot], b[slot]);
+    norms_(slot) = b[slot].norm();
+  });
+
+  // Second pass: all weights at once
+  updateWeights();
+
+  // Third pass: scale the whitened systems in place and create the Jacobian factors
+  parallelFor(nrSlots, [&](size_t slot) {
+    if (!active[slot]) return;
+    const size_t i = factors_[slot];
+    const double sqrtWeight = std::sqrt(weights_(i));
+    const KeyVector& keys = graph_[i]->keys();
+    vector<pair<Key, Matrix> > terms(keys.size());
+    for (size_t j = 0; j < keys.size(); ++j) {
+      A[slot][j] *= sqrtWeight;
+      terms[j].first = keys[j];
+      terms[j].second.swap(A[slot][j]);
+    }
+    b[slot] *= sqrtWeight;
+    (*linearFG)[i] = boost::make_shared<JacobianFactor>(terms, b[slot]);
+  });
+
+  return linearFG;
+}
+
+/* ************************************************************************* */
+const Vector& RobustReweighting::computeWeights(const Values& values) {
+  gttic(RobustReweighting_computeWeights);
+  parallelFor(factors_.size(), [&](size_t slot) {
+    const NoiseModelFactor& factor = static_cast<const NoiseModelFactor&>(*graph_[factors_[slot]]);
+    if (factor.active(values)) {
+      Vector e = factor.unwhitenedError(values);
+      static_cast<const noiseModel::Robust&>(*factor.noiseModel()).noise()->whitenInPlace(e);
+      norms_(slot) = e.norm();
+    } else {
+      norms_(slot) = 0.0;
+    }
+  });
+  updateWeights();
+  return weights_;
+}
+
+} // namespace gtsam
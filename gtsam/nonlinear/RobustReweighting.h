@@ -0,0 +1,81 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    RobustReweighting.h
+ * @brief   Linearize a graph with robust noise models, reweighting all factors at once
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/NoiseModel.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Graph-level robust reweighting. Linearizing a NoiseModelFactor with a
+ * noiseModel::Robust calls its M-estimator once per factor, and IRLS-style
+ * schemes then need the same weights again. This class instead groups the
+ * robust factors by (equal) M-estimator, whitens all of them with their
+ * underlying noise model in a first pass, stores the whitened error norms
+ * contiguously, evaluates every group's weights with a single vectorized
+ * mEstimator::Base::weight(const Vector&) call, and finally scales the
+ * Jacobians and right-hand sides in place.
+ *
+ * The result of linearize is the same as NonlinearFactorGraph::linearize.
+ * Only robust models with the (default) Block reweight scheme are batched,
+ * all other factors are linearized as usual and have weight 1.
+ */
+class GTSAM_EXPORT RobustReweighting {
+public:
+
+  /// Analyze the graph, grouping the robust factors by M-estimator
+  explicit RobustReweighting(const NonlinearFactorGraph& graph);
+
+  /// Linearize the whole graph, reweighting the robust factors in one batch
+  GaussianFactorGraph::shared_ptr linearize(const Values& values);
+
+  /// Only compute the weights at the given values, without Jacobians
+  const Vector& computeWeights(const Values& values);
+
+  /// Weights from the last call to linearize or computeWeights, one per factor
+  const Vector& weights() const { return weights_; }
+
+  /// Number of factors that are reweighted in batch
+  size_t nrRobustFactors() const { return factors_.size(); }
+
+  /// Number of distinct M-estimators
+  size_t nrGroups() const { return groups_.size(); }
+
+private:
+
+  /// Robust factors sharing an M-estimator, stored contiguously in factors_
+  struct Group {
+    noiseModel::mEstimator::Base::shared_ptr estimator;
+    size_t begin, end;
+  };
+
+  NonlinearFactorGraph graph_;
+  std::vector<Group> groups_;
+  std::vector<size_t> factors_; ///< factor index for every batch slot
+  std::vector<size_t> slots_; ///< batch slot for every factor, or graph size if not batched
+  Vector norms_; ///< whitened error norm for every slot
+  Vector weights_; ///< weight for every factor
+
+  /// Evaluate the M-estimators on norms_ and scatter into weights_
+  void updateWeights();
+};
+
+} // namespace gtsam
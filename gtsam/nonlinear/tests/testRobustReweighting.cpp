@@ -0,0 +1,81 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testRobustReweighting.cpp
+ * @brief Unit tests for graph-level robust reweighting
+ */
+
+#include <gtsam/nonlinear/RobustReweighting.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/Testable.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+using namespace std;
+
+/* ************************************************************************* */
+TEST( RobustReweighting, linearize )
+{
+  // A loop with an outlier, two Huber models that are equal and one Cauchy model
+  const SharedNoiseModel sigmas = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+  const SharedNoiseModel huber1 = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345), sigmas);
+  const SharedNoiseModel huber2 = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345), sigmas);
+  const SharedNoiseModel cauchy = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Cauchy::Create(0.5), sigmas);
+  const SharedNoiseModel scalar = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345, noiseModel::mEstimator::Base::Scalar), sigmas);
+
+  NonlinearFactorGraph graph;
+  graph.add(PriorFactor<Pose2>(0, Pose2(), sigmas));
+  graph.add(BetweenFactor<Pose2>(0, 1, Pose2(1, 0, 0), huber1));
+  graph.add(BetweenFactor<Pose2>(1, 2, Pose2(1, 0, M_PI_2), huber2));
+  graph.add(BetweenFactor<Pose2>(2, 3, Pose2(1, 0, M_PI_2), cauchy));
+  graph.add(BetweenFactor<Pose2>(3, 0, Pose2(5, 3, 1), huber1)); // outlier
+  graph.add(BetweenFactor<Pose2>(1, 3, Pose2(1, 1, M_PI), scalar));
+
+  Values values;
+  values.insert(0, Pose2(0.1, -0.1, 0.05));
+  values.insert(1, Pose2(1.1, 0.2, 0.1));
+  values.insert(2, Pose2(2.0, 1.1, 1.6));
+  values.insert(3, Pose2(1.1, 1.9, 3.0));
+
+  RobustReweighting reweighting(graph);
+  LONGS_EQUAL(4, (long)reweighting.nrRobustFactors());
+  LONGS_EQUAL(2, (long)reweighting.nrGroups());
+
+  // Same linear system as linearizing factor by factor
+  GaussianFactorGraph::shared_ptr expected = graph.linearize(values);
+  GaussianFactorGraph::shared_ptr actual = reweighting.linearize(values);
+  EXPECT(assert_equal(*expected, *actual, 1e-9));
+
+  // Weights are those of the M-estimators on the whitened errors
+  const Vector& weights = reweighting.computeWeights(values);
+  LONGS_EQUAL(6, (long)weights.size());
+  EXPECT_DOUBLES_EQUAL(1.0, weights(0), 1e-12);
+  EXPECT_DOUBLES_EQUAL(1.0, weights(5), 1e-12);
+  for (size_t i = 1; i < 5; ++i) {
+    const NoiseModelFactor& factor = static_cast<const NoiseModelFactor&>(*graph[i]);
+    const noiseModel::Robust& robust = static_cast<const noiseModel::Robust&>(*factor.noiseModel());
+    const double norm = robust.noise()->whiten(factor.unwhitenedError(values)).norm();
+    EXPECT_DOUBLES_EQUAL(robust.robust()->weight(norm), weights(i), 1e-12);
+  }
+  EXPECT(weights(4) < 0.1);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
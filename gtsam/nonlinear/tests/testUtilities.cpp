@@ -0,0 +1,85 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testUtilities.cpp
+ * @brief Unit tests for the bulk accessors used by the wrappers
+ */
+
+#include <gtsam/nonlinear/utilities.h>
+#include <gtsam/base/Testable.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(Utilities, Pose3s) {
+  const KeyVector keys{Symbol('x', 3), Symbol('x', 1)};
+  Values values;
+  values.insert(keys[0], Pose3(Rot3::Ypr(0.1, 0.2, 0.3), Point3(1, 2, 3)));
+  values.insert(keys[1], Pose3(Rot3::Rz(-0.4), Point3(4, 5, 6)));
+  values.insert(Symbol('l', 1), Point3(7, 8, 9));
+
+  const Matrix poses = utilities::extractPose3(values, keys);
+  EXPECT_LONGS_EQUAL(2, poses.rows());
+  EXPECT(assert_equal(Vector3(1, 2, 3), Vector(poses.block<1, 3>(0, 9).transpose())));
+
+  Values actual;
+  utilities::insertPose3s(actual, keys, poses);
+  EXPECT(assert_equal(values.at<Pose3>(keys[0]), actual.at<Pose3>(keys[0]), 1e-12));
+  EXPECT(assert_equal(values.at<Pose3>(keys[1]), actual.at<Pose3>(keys[1]), 1e-12));
+  CHECK_EXCEPTION(utilities::insertPose3s(actual, keys, Matrix(2, 3)), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(Utilities, Pose2sAndPoints) {
+  const KeyVector keys{5, 7};
+  const Matrix poses = (Matrix(2, 3) << 1, 2, 0.3, 4, 5, -0.6).finished();
+  Values values;
+  utilities::insertPose2s(values, keys, poses);
+  EXPECT(assert_equal(Pose2(4, 5, -0.6), values.at<Pose2>(7)));
+  EXPECT(assert_equal(poses, utilities::extractPose2(values, keys)));
+
+  const Matrix points = poses.leftCols(2);
+  const KeyVector pointKeys{8, 9};
+  utilities::insertPoint2s(values, pointKeys, points);
+  EXPECT(assert_equal(points, utilities::extractPoint2(values, pointKeys)));
+  EXPECT(assert_equal(points, utilities::extractPoint2(values)));
+}
+
+/* ************************************************************************* */
+TEST(Utilities, Vectors) {
+  const KeyVector keys{0, 1};
+  const Matrix vectors = (Matrix(2, 3) << 1, 2, 3, 4, 5, 6).finished();
+  VectorValues x;
+  utilities::insertVectors(x, keys, vectors);
+  EXPECT(assert_equal(Vector3(4, 5, 6), x.at(1)));
+  EXPECT(assert_equal(vectors, utilities::extractVectors(x, keys)));
+
+  x.insert(2, Vector2(1, 2));
+  CHECK_EXCEPTION(utilities::extractVectors(x, KeyVector{0, 2}), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(Utilities, JacobianBlock) {
+  const Matrix A1 = (Matrix(2, 2) << 1, 2, 3, 4).finished();
+  const Matrix A2 = (Matrix(2, 3) << 5, 6, 7, 8, 9, 10).finished();
+  const JacobianFactor factor(0, A1, 1, A2, Vector2::Zero());
+  EXPECT(assert_equal(A2, utilities::extractJacobianBlock(factor, 1)));
+  CHECK_EXCEPTION(utilities::extractJacobianBlock(factor, 2), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -20,6 +20,8 @@
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/slam/ProjectionFactor.h>
 #include <gtsam/linear/Sampler.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/VectorValues.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 #include <gtsam/nonlinear/Values.h>
@@ -137,6 +139,115 @@ Matrix extractPose3(const Values& values) {
   return result;
 }
 
+/// Extract the Point2 values of keys, in that order, into a single matrix [x y]
+Matrix extractPoint2(const Values& values, const KeyVector& keys) {
+  Matrix result(keys.size(), 2);
+  for (size_t j = 0; j < keys.size(); j++)
+    result.row(j) = values.at<Point2>(keys[j]);
+  return result;
+}
+
+/// Extract the Point3 values of keys, in that order, into a single matrix [x y z]
+Matrix extractPoint3(const Values& values, const KeyVector& keys) {
+  Matrix result(keys.size(), 3);
+  for (size_t j = 0; j < keys.size(); j++)
+    result.row(j) = values.at<Point3>(keys[j]);
+  return result;
+}
+
+/// Extract the Pose2 values of keys, in that order, into a single matrix [x y theta]
+Matrix extractPose2(const Values& values, const KeyVector& keys) {
+  Matrix result(keys.size(), 3);
+  for (size_t j = 0; j < keys.size(); j++) {
+    const Pose2& pose = values.at<Pose2>(keys[j]);
+    result.row(j) << pose.x(), pose.y(), pose.theta();
+  }
+  return result;
+}
+
+/// Extract the Pose3 values of keys, in that order, into a single matrix
+/// [r11 r12 r13 r21 r22 r23 r31 r32 r33 x y z]
+Matrix extractPose3(const Values& values, const KeyVector& keys) {
+  Matrix result(keys.size(), 12);
+  for (size_t j = 0; j < keys.size(); j++) {
+    const Pose3& pose = values.at<Pose3>(keys[j]);
+    const Matrix3 R = pose.rotation().matrix();
+    result.row(j).segment(0, 3) = R.row(0);
+    result.row(j).segment(3, 3) = R.row(1);
+    result.row(j).segment(6, 3) = R.row(2);
+    result.row(j).tail(3) = pose.translation();
+  }
+  return result;
+}
+
+/// Extract the vectors of keys, which must have the same dimension, into a single matrix
+Matrix extractVectors(const VectorValues& x, const KeyVector& keys) {
+  const Eigen::Index n = keys.empty() ? 0 : x.at(keys.front()).size();
+  Matrix result(keys.size(), n);
+  for (size_t j = 0; j < keys.size(); j++) {
+    const Vector& v = x.at(keys[j]);
+    if (v.size() != n)
+      throw std::invalid_argument("extractVectors: vectors have different dimensions");
+    result.row(j) = v;
+  }
+  return result;
+}
+
+/// Block i of the Jacobian of a factor, without copying the other blocks
+Matrix extractJacobianBlock(const JacobianFactor& factor, size_t i) {
+  if (i >= factor.size())
+    throw std::invalid_argument("extractJacobianBlock: no such block");
+  return factor.getA(factor.begin() + i);
+}
+
+/// Check the arguments of the insert functions below
+void checkInsertArguments(const KeyVector& keys, const Matrix& M, int cols,
+    const std::string& function) {
+  if (M.cols() != cols)
+    throw std::invalid_argument(function + ": matrix has the wrong number of columns");
+  if (static_cast<size_t>(M.rows()) != keys.size())
+    throw std::invalid_argument(function + ": keys and matrix rows must have same number of entries");
+}
+
+/// Insert Point2 values from the rows [x y] of a matrix, as given by extractPoint2
+void insertPoint2s(Values& values, const KeyVector& keys, const Matrix& points) {
+  checkInsertArguments(keys, points, 2, "insertPoint2s");
+  for (size_t j = 0; j < keys.size(); j++)
+    values.insert(keys[j], Point2(points(j, 0), points(j, 1)));
+}
+
+/// Insert Point3 values from the rows [x y z] of a matrix, as given by extractPoint3
+void insertPoint3s(Values& values, const KeyVector& keys, const Matrix& points) {
+  checkInsertArguments(keys, points, 3, "insertPoint3s");
+  for (size_t j = 0; j < keys.size(); j++)
+    values.insert(keys[j], Point3(points(j, 0), points(j, 1), points(j, 2)));
+}
+
+/// Insert Pose2 values from the rows [x y theta] of a matrix, as given by extractPose2
+void insertPose2s(Values& values, const KeyVector& keys, const Matrix& poses) {
+  checkInsertArguments(keys, poses, 3, "insertPose2s");
+  for (size_t j = 0; j < keys.size(); j++)
+    values.insert(keys[j], Pose2(poses(j, 0), poses(j, 1), poses(j, 2)));
+}
+
+/// Insert Pose3 values from the rows [r11 r12 r13 r21 r22 r23 r31 r32 r33 x y z]
+/// of a matrix, as given by extractPose3
+void insertPose3s(Values& values, const KeyVector& keys, const Matrix& poses) {
+  checkInsertArguments(keys, poses, 12, "insertPose3s");
+  for (size_t j = 0; j < keys.size(); j++) {
+    Matrix3 R;
+    R << poses.block<1, 3>(j, 0), poses.block<1, 3>(j, 3), poses.block<1, 3>(j, 6);
+    values.insert(keys[j], Pose3(Rot3(R), Point3(poses.block<1, 3>(j, 9).transpose())));
+  }
+}
+
+/// Insert vectors from the rows of a matrix, as given by extractVectors
+void insertVectors(VectorValues& x, const KeyVector& keys, const Matrix& vectors) {
+  checkInsertArguments(keys, vectors, vectors.cols(), "insertVectors");
+  for (size_t j = 0; j < keys.size(); j++)
+    x.insert(keys[j], vectors.row(j).transpose());
+}
+
 /// Perturb all Point2 values using normally distributed noise
 void perturbPoint2(Values& values, double sigma, int32_t seed = 42u) {
   noiseModel::Isotropic::shared_ptr model = noiseModel::Isotropic::Sigma(2,
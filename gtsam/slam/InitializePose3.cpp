@@ -22,10 +22,13 @@
 #include <gtsam/nonlinear/GaussNewtonOptimizer.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/parallelFor.h>
 #include <gtsam/base/timing.h>
 
 #include <boost/math/special_functions.hpp>
 
+#include <atomic>
+
 using namespace std;
 
 namespace gtsam {
@@ -125,16 +128,70 @@ NonlinearFactorGraph InitializePose3::buildPose3graph(const NonlinearFactorGraph
 
 /* ************************************************************************* */
 Values InitializePose3::computeOrientationsChordal(
-    const NonlinearFactorGraph& pose3Graph) {
+    const NonlinearFactorGraph& pose3Graph, SparseEigenSolver::Type solver) {
   gttic(InitializePose3_computeOrientationsChordal);
 
-  // regularize measurements and plug everything in a factor graph
-  GaussianFactorGraph relaxedGraph = buildLinearOrientationGraph(pose3Graph);
-
-  // Solve the LFG
-  VectorValues relaxedRot3 = relaxedGraph.optimize();
+  // Index the variables, the anchor always has a prior
+  KeySet keys = pose3Graph.keys();
+  keys.insert(kAnchorKey);
+  FastMap<Key, size_t> index;
+  for (Key key : keys)
+    index.insert(make_pair(key, index.size()));
+
+  // Each factor -x1 + Rij*x2 on a column of the rotations adds w*[I -Rij; -Rij' I]
+  // to the normal equations, written to a fixed slot of 24 triplets per factor
+  const size_t nrFactors = pose3Graph.size();
+  SparseEigenSolver::Triplets triplets(24 * nrFactors + 3);
+  // Factors that are not Pose3 between factors are skipped, and reported once
+  // after the loop rather than from every task
+  std::atomic<bool> skipped(false);
+  auto assemble = [&](size_t f) {
+    SparseEigenSolver::Triplet* t = &triplets[24 * f];
+    auto pose3Between = boost::dynamic_pointer_cast<BetweenFactor<Pose3> >(pose3Graph[f]);
+    if (!pose3Between) {
+      skipped = true;
+      for (size_t k = 0; k < 24; k++)
+        t[k] = SparseEigenSolver::Triplet(0, 0, 0.0);
+      return;
+    }
+    const Matrix3 Rij = pose3Between->measured().rotation().matrix();
+    Vector precisions = Vector::Zero(6);
+    precisions[0] = 1.0;
+    pose3Between->noiseModel()->whitenInPlace(precisions);
+    const double w = precisions[0]; // same weighting as buildLinearOrientationGraph
+    const size_t i1 = 3 * index.at(pose3Between->key1());
+    const size_t i2 = 3 * index.at(pose3Between->key2());
+    for (size_t r = 0; r < 3; r++) {
+      *t++ = SparseEigenSolver::Triplet(i1 + r, i1 + r, w);
+      *t++ = SparseEigenSolver::Triplet(i2 + r, i2 + r, w);
+      for (size_t c = 0; c < 3; c++) {
+        *t++ = SparseEigenSolver::Triplet(i1 + r, i2 + c, -w * Rij(r, c));
+        *t++ = SparseEigenSolver::Triplet(i2 + c, i1 + r, -w * Rij(r, c));
+      }
+    }
+  };
+  parallelFor(nrFactors, assemble);
+  if (skipped)
+    cout << "Error in buildLinearOrientationGraph" << endl;
+
+  // prior on the anchor orientation, the identity
+  const size_t anchor = 3 * index.at(kAnchorKey);
+  for (size_t r = 0; r < 3; r++)
+    triplets[24 * nrFactors + r] = SparseEigenSolver::Triplet(anchor + r, anchor + r, 1.0);
+  Matrix B = Matrix::Zero(3 * keys.size(), 3);
+  B.block<3, 3>(anchor, 0) = I_3x3;
+
+  // Solve for all three columns at once
+  const Matrix X = SparseEigenSolver::SolveNormalEquations(3 * keys.size(),
+      triplets, B, solver);
 
   // normalize and compute Rot3
+  VectorValues relaxedRot3;
+  for (const auto& key_index : index) {
+    Eigen::Matrix<double, 9, 1> vectorized;
+    Eigen::Map<Matrix3>(vectorized.data()) = X.block<3, 3>(3 * key_index.second, 0);
+    relaxedRot3.insert(key_index.first, vectorized);
+  }
   return normalizeRelaxedRotations(relaxedRot3);
 }
 
@@ -348,7 +405,7 @@ Values InitializePose3::computePoses(NonlinearFactorGraph& pose3graph,  Values&
 
 /* ************************************************************************* */
 Values InitializePose3::initialize(const NonlinearFactorGraph& graph, const Values& givenGuess,
-                  bool useGradient) {
+                  bool useGradient, SparseEigenSolver::Type solver) {
   gttic(InitializePose3_initialize);
   Values initialValues;
 
@@ -361,7 +418,7 @@ Values InitializePose3::initialize(const NonlinearFactorGraph& graph, const Valu
   if (useGradient)
     orientations = computeOrientationsGradient(pose3Graph, givenGuess);
   else
-    orientations = computeOrientationsChordal(pose3Graph);
+    orientations = computeOrientationsChordal(pose3Graph, solver);
 
   // Compute the full poses (1 GN iteration on full poses)
   return computePoses(pose3Graph, orientations);
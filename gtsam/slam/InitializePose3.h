@@ -23,6 +23,7 @@
 #include <gtsam/geometry/Rot3.h>
 #include <gtsam/inference/graph.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/SparseEigenSolver.h>
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
@@ -38,10 +39,15 @@ struct GTSAM_EXPORT InitializePose3 {
   static Values normalizeRelaxedRotations(const VectorValues& relaxedRot3);
 
   /**
-   * Return the orientations of a graph including only BetweenFactors<Pose3>
+   * Return the orientations of a graph including only BetweenFactors<Pose3>.
+   * The 9-dimensional relaxation decouples into three 3-dimensional problems
+   * with the same normal equations, one per column of the rotation, so this
+   * assembles a single sparse 3n*3n system in parallel and solves it for three
+   * right-hand sides, without building buildLinearOrientationGraph.
    */
   static Values computeOrientationsChordal(
-      const NonlinearFactorGraph& pose3Graph);
+      const NonlinearFactorGraph& pose3Graph,
+      SparseEigenSolver::Type solver = SparseEigenSolver::CHOLESKY);
 
   /**
    * Return the orientations of a graph including only BetweenFactors<Pose3>
@@ -79,7 +85,8 @@ struct GTSAM_EXPORT InitializePose3 {
    * method), and finish up with 1 GN iteration on full poses.
    */
   static Values initialize(const NonlinearFactorGraph& graph,
-                           const Values& givenGuess, bool useGradient = false);
+                           const Values& givenGuess, bool useGradient = false,
+                           SparseEigenSolver::Type solver = SparseEigenSolver::CHOLESKY);
 
   /// Calls initialize above using Chordal method.
   static Values initialize(const NonlinearFactorGraph& graph);
@@ -21,10 +21,13 @@
 #include <gtsam/slam/BetweenFactor.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/parallelFor.h>
 #include <gtsam/base/timing.h>
 
 #include <boost/math/special_functions.hpp>
 
+#include <limits>
+
 using namespace std;
 
 namespace gtsam {
@@ -245,10 +248,93 @@ static PredecessorMap<Key> findOdometricPath(
   return tree;
 }
 
+/* ************************************************************************* */
+// Solve the same problem as buildLinearOrientationGraph, but assemble the normal
+// equations directly: every measurement -theta1 + theta2 = deltaTheta with weight
+// w = 1/sigma^2 adds w*[1 -1; -1 1] to the Laplacian. The anchor is fixed to zero.
+static VectorValues solveLinearOrientationGraph(
+    const vector<size_t>& spanningTreeIds, const vector<size_t>& chordsIds,
+    const NonlinearFactorGraph& g, const key2doubleMap& orientationsToRoot,
+    SparseEigenSolver::Type solver) {
+  gttic(lago_solveLinearOrientationGraph);
+
+  // Index all nodes except the anchor. The root of a minimum spanning tree need
+  // not be the anchor and then has no entry in orientationsToRoot.
+  vector<size_t> factorIds(spanningTreeIds);
+  factorIds.insert(factorIds.end(), chordsIds.begin(), chordsIds.end());
+  const size_t nrEdges = factorIds.size();
+  FastMap<Key, size_t> index;
+  for (size_t factorId : factorIds)
+    for (Key key : g[factorId]->keys())
+      if (key != keyAnchor && !index.count(key))
+        index.insert(make_pair(key, index.size()));
+  static const size_t kAnchor = numeric_limits<size_t>::max();
+  auto indexOf = [&](Key key) {
+    return key == keyAnchor ? kAnchor : index.at(key);
+  };
+
+  // Regularize the measurements and compute the weights, every edge independently
+  vector<double> deltas(nrEdges), weights(nrEdges);
+  SparseEigenSolver::Triplets triplets(4 * nrEdges);
+  auto assemble = [&](size_t e) {
+    const NonlinearFactor::shared_ptr& factor = g[factorIds[e]];
+    Vector deltaTheta;
+    noiseModel::Diagonal::shared_ptr model_deltaTheta;
+    getDeltaThetaAndNoise(factor, deltaTheta, model_deltaTheta);
+    const Key key1 = factor->keys()[0], key2 = factor->keys()[1];
+    double delta = deltaTheta(0);
+    if (e >= spanningTreeIds.size()) { // chord: remove the 2*k*pi along the cycle
+      double k2pi_noise = delta + orientationsToRoot.at(key1)
+          - orientationsToRoot.at(key2);
+      delta -= 2 * boost::math::round(k2pi_noise / (2 * M_PI)) * M_PI;
+    }
+    const double w = 1.0 / (model_deltaTheta->sigma(0) * model_deltaTheta->sigma(0));
+    deltas[e] = delta;
+    weights[e] = w;
+
+    // Entries touching the anchor are dropped, they are zeros in the triplet list
+    const size_t i1 = indexOf(key1), i2 = indexOf(key2);
+    SparseEigenSolver::Triplet* t = &triplets[4 * e];
+    const bool free1 = i1 != kAnchor, free2 = i2 != kAnchor;
+    t[0] = free1 ? SparseEigenSolver::Triplet(i1, i1, w) : SparseEigenSolver::Triplet(0, 0, 0.0);
+    t[1] = free2 ? SparseEigenSolver::Triplet(i2, i2, w) : SparseEigenSolver::Triplet(0, 0, 0.0);
+    t[2] = free1 && free2 ? SparseEigenSolver::Triplet(i1, i2, -w) : SparseEigenSolver::Triplet(0, 0, 0.0);
+    t[3] = free1 && free2 ? SparseEigenSolver::Triplet(i2, i1, -w) : SparseEigenSolver::Triplet(0, 0, 0.0);
+  };
+  parallelFor(nrEdges, assemble);
+
+  // The right-hand side has colliding writes, so it is accumulated afterwards
+  Matrix b = Matrix::Zero(index.size(), 1);
+  for (size_t e = 0; e < nrEdges; ++e) {
+    const KeyVector& keys = g[factorIds[e]]->keys();
+    const size_t i1 = indexOf(keys[0]), i2 = indexOf(keys[1]);
+    if (i1 != kAnchor) b(i1, 0) -= weights[e] * deltas[e];
+    if (i2 != kAnchor) b(i2, 0) += weights[e] * deltas[e];
+  }
+
+  // Warm start iterative solvers from the orientations along the spanning tree
+  Matrix guess;
+  if (solver == SparseEigenSolver::CONJUGATE_GRADIENT) {
+    guess.resize(index.size(), 1);
+    for (const auto& key_index : index) {
+      const key2doubleMap::const_iterator it = orientationsToRoot.find(key_index.first);
+      guess(key_index.second, 0) = it == orientationsToRoot.end() ? 0.0 : it->second;
+    }
+  }
+  const Matrix theta = SparseEigenSolver::SolveNormalEquations(index.size(),
+      triplets, b, solver, guess);
+
+  VectorValues orientations;
+  orientations.insert(keyAnchor, Vector::Zero(1));
+  for (const auto& key_index : index)
+    orientations.insert(key_index.first, theta.row(key_index.second).transpose());
+  return orientations;
+}
+
 /* ************************************************************************* */
 // Return the orientations of a graph including only BetweenFactors<Pose2>
 static VectorValues computeOrientations(const NonlinearFactorGraph& pose2Graph,
-    bool useOdometricPath) {
+    bool useOdometricPath, SparseEigenSolver::Type solver) {
   gttic(lago_computeOrientations);
 
   // Find a minimum spanning tree
@@ -268,26 +354,21 @@ static VectorValues computeOrientations(const NonlinearFactorGraph& pose2Graph,
   // temporary structure to correct wraparounds along loops
   key2doubleMap orientationsToRoot = computeThetasToRoot(deltaThetaMap, tree);
 
-  // regularize measurements and plug everything in a factor graph
-  GaussianFactorGraph lagoGraph = buildLinearOrientationGraph(spanningTreeIds,
-      chordsIds, pose2Graph, orientationsToRoot, tree);
-
-  // Solve the LFG
-  VectorValues orientationsLago = lagoGraph.optimize();
-
-  return orientationsLago;
+  // regularize measurements and solve the sparse linear system
+  return solveLinearOrientationGraph(spanningTreeIds, chordsIds, pose2Graph,
+      orientationsToRoot, solver);
 }
 
 /* ************************************************************************* */
 VectorValues initializeOrientations(const NonlinearFactorGraph& graph,
-    bool useOdometricPath) {
+    bool useOdometricPath, SparseEigenSolver::Type solver) {
 
   // We "extract" the Pose2 subgraph of the original graph: this
   // is done to properly model priors and avoiding operating on a larger graph
   NonlinearFactorGraph pose2Graph = buildPose2graph(graph);
 
   // Get orientations from relative orientation measurements
-  return computeOrientations(pose2Graph, useOdometricPath);
+  return computeOrientations(pose2Graph, useOdometricPath, solver);
 }
 
 /* ************************************************************************* */
@@ -359,7 +440,8 @@ Values computePoses(const NonlinearFactorGraph& pose2graph,
 }
 
 /* ************************************************************************* */
-Values initialize(const NonlinearFactorGraph& graph, bool useOdometricPath) {
+Values initialize(const NonlinearFactorGraph& graph, bool useOdometricPath,
+    SparseEigenSolver::Type solver) {
   gttic(lago_initialize);
 
   // We "extract" the Pose2 subgraph of the original graph: this
@@ -368,7 +450,7 @@ Values initialize(const NonlinearFactorGraph& graph, bool useOdometricPath) {
 
   // Get orientations from relative orientation measurements
   VectorValues orientationsLago = computeOrientations(pose2Graph,
-      useOdometricPath);
+      useOdometricPath, solver);
 
   // Compute the full poses
   return computePoses(pose2Graph, orientationsLago);
@@ -36,6 +36,7 @@
 
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/SparseEigenSolver.h>
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/inference/graph.h>
 
@@ -70,13 +71,20 @@ GTSAM_EXPORT GaussianFactorGraph buildLinearOrientationGraph(
     const std::vector<size_t>& chordsIds, const NonlinearFactorGraph& g,
     const key2doubleMap& orientationsToRoot, const PredecessorMap<Key>& tree);
 
-/** LAGO: Return the orientations of the Pose2 in a generic factor graph */
+/**
+ * LAGO: Return the orientations of the Pose2 in a generic factor graph.
+ * The regularized orientation measurements are assembled directly into a sparse
+ * (graph Laplacian) system, in parallel when TBB is enabled, and solved with the
+ * given sparse solver; conjugate gradients is warm-started from the spanning tree.
+ */
 GTSAM_EXPORT VectorValues initializeOrientations(
-    const NonlinearFactorGraph& graph, bool useOdometricPath = true);
+    const NonlinearFactorGraph& graph, bool useOdometricPath = true,
+    SparseEigenSolver::Type solver = SparseEigenSolver::CHOLESKY);
 
 /** Return the values for the Pose2 in a generic factor graph */
 GTSAM_EXPORT Values initialize(const NonlinearFactorGraph& graph,
-    bool useOdometricPath = true);
+    bool useOdometricPath = true,
+    SparseEigenSolver::Type solver = SparseEigenSolver::CHOLESKY);
 
 /** Only correct the orientation part in initialGuess */
 GTSAM_EXPORT Values initialize(const NonlinearFactorGraph& graph,
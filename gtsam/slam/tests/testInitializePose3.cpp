@@ -115,6 +115,21 @@ TEST( InitializePose3, orientationsPrecisions ) {
   EXPECT(assert_equal(simple::R3, initial.at<Rot3>(x3), 1e-6));
 }
 
+/* *************************************************************************** */
+TEST( InitializePose3, orientationsSparseSolvers ) {
+  NonlinearFactorGraph pose3Graph = InitializePose3::buildPose3graph(simple::graph());
+
+  // Reference: solve the linear orientation graph by elimination
+  Values expected = InitializePose3::normalizeRelaxedRotations(
+      InitializePose3::buildLinearOrientationGraph(pose3Graph).optimize());
+
+  Values cholesky = InitializePose3::computeOrientationsChordal(pose3Graph);
+  Values cg = InitializePose3::computeOrientationsChordal(pose3Graph,
+      SparseEigenSolver::CONJUGATE_GRADIENT);
+  EXPECT(assert_equal(expected, cholesky, 1e-6));
+  EXPECT(assert_equal(expected, cg, 1e-6));
+}
+
 /* *************************************************************************** */
 TEST( InitializePose3, orientationsGradientSymbolicGraph ) {
   NonlinearFactorGraph pose3Graph = InitializePose3::buildPose3graph(simple::graph());
@@ -291,6 +291,40 @@ TEST( Lago, largeGraphNoisy_orientations ) {
   }
 }
 
+/* *************************************************************************** */
+TEST( Lago, sparseSolvers ) {
+
+  string inputFile = findExampleDataFile("noisyToyGraph");
+  NonlinearFactorGraph::shared_ptr g;
+  Values::shared_ptr initial;
+  boost::tie(g, initial) = readG2o(inputFile);
+  NonlinearFactorGraph graphWithPrior = *g;
+  noiseModel::Diagonal::shared_ptr priorModel = noiseModel::Diagonal::Variances(Vector3(1e-2, 1e-2, 1e-4));
+  graphWithPrior.add(PriorFactor<Pose2>(0, Pose2(), priorModel));
+
+  // Reference: solve the linear orientation graph by elimination
+  NonlinearFactorGraph pose2Graph;
+  for (const auto& factor : graphWithPrior)
+    if (boost::dynamic_pointer_cast<BetweenFactor<Pose2> >(factor))
+      pose2Graph.add(factor);
+    else
+      pose2Graph.add(BetweenFactor<Pose2>(symbol('Z',9999999), 0, Pose2(), priorModel));
+  PredecessorMap<Key> tree = findMinimumSpanningTree<NonlinearFactorGraph, Key,
+      BetweenFactor<Pose2> >(pose2Graph);
+  lago::key2doubleMap deltaThetaMap;
+  vector<size_t> spanningTreeIds, chordsIds;
+  lago::getSymbolicGraph(spanningTreeIds, chordsIds, deltaThetaMap, tree, pose2Graph);
+  lago::key2doubleMap orientationsToRoot = lago::computeThetasToRoot(deltaThetaMap, tree);
+  VectorValues expected = lago::buildLinearOrientationGraph(spanningTreeIds,
+      chordsIds, pose2Graph, orientationsToRoot, tree).optimize();
+
+  VectorValues cholesky = lago::initializeOrientations(graphWithPrior, false);
+  VectorValues cg = lago::initializeOrientations(graphWithPrior, false,
+      SparseEigenSolver::CONJUGATE_GRADIENT);
+  EXPECT(assert_equal(expected, cholesky, 1e-6));
+  EXPECT(assert_equal(expected, cg, 1e-6));
+}
+
 /* *************************************************************************** */
 TEST( Lago, largeGraphNoisy ) {
 
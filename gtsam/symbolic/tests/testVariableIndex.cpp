@@ -143,6 +143,28 @@ TEST(VariableIndex, deep_copy) {
   EXPECT(assert_equal(expectedRemoved, clone));
 }
 
+/* ************************************************************************* */
+TEST(VariableIndex, renumberFactor) {
+
+  // Remove factor 1 and move factor 3 into its slot
+  SymbolicFactorGraph fg1 = testGraph1();
+  VariableIndex actual(fg1);
+  vector<size_t> indices; indices.push_back(1);
+  SymbolicFactorGraph removed; removed.push_back(fg1[1]);
+  actual.remove(indices.begin(), indices.end(), removed);
+  actual.renumberFactor(3, 1, fg1[3]->keys());
+  actual.truncateFactors(3);
+
+  SymbolicFactorGraph compacted;
+  compacted.push_back(fg1[0]);
+  compacted.push_back(fg1[3]);
+  compacted.push_back(fg1[2]);
+  EXPECT(assert_equal(VariableIndex(compacted), actual));
+
+  // The factor is no longer at index 3
+  CHECK_EXCEPTION(actual.renumberFactor(3, 4, fg1[3]->keys()), std::invalid_argument);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
@@ -18,6 +18,12 @@
  */
 
 #include <gtsam_unstable/linear/InfeasibleInitialValues.h>
+#include <gtsam/linear/GaussianEliminationTree.h>
+#include <gtsam/linear/GaussianJunctionTree.h>
+#include <gtsam/linear/HessianFactor.h>
+
+#include <limits>
+#include <stdexcept>
 
 /******************************************************************************/
 // Convenient macros to reduce syntactic noise. undef later.
@@ -28,6 +34,101 @@
 
 namespace gtsam {
 
+//******************************************************************************
+Template This::ActiveSetSolver(const PROBLEM& problem) : problem_(problem) {
+  equalityVariableIndex_ = VariableIndex(problem_.equalities);
+  inequalityVariableIndex_ = VariableIndex(problem_.inequalities);
+  constrainedKeys_ = problem_.equalities.keys();
+  constrainedKeys_.merge(problem_.inequalities.keys());
+  structure_ = computeStructure(structureGraph());
+}
+
+//******************************************************************************
+Template This::ActiveSetSolver(const PROBLEM& problem,
+                               const This& sameStructure)
+    : problem_(problem), structure_(sameStructure.structure_) {
+  equalityVariableIndex_ = VariableIndex(problem_.equalities);
+  inequalityVariableIndex_ = VariableIndex(problem_.inequalities);
+  constrainedKeys_ = problem_.equalities.keys();
+  constrainedKeys_.merge(problem_.inequalities.keys());
+  const GaussianFactorGraph graph = structureGraph();
+  bool same = graph.size() == structure_->slotKeys.size();
+  for (size_t i = 0; same && i < graph.size(); ++i)
+    same = graph[i]->keys() == structure_->slotKeys[i];
+  if (!same)
+    throw std::invalid_argument(
+        "ActiveSetSolver: the problems do not have the same structure");
+}
+
+//******************************************************************************
+Template GaussianFactorGraph This::structureGraph() const {
+  // The cost of an LP depends on the current solution, but its structure does
+  // not, so build it at zero
+  GaussianFactorGraph all;
+  all.push_back(problem_.cost);
+  all.push_back(problem_.equalities);
+  all.push_back(problem_.inequalities);
+  VectorValues zero;
+  for (const auto& keyDim : all.getKeyDimMap())
+    zero.insert(keyDim.first, Vector::Zero(keyDim.second));
+
+  GaussianFactorGraph graph = POLICY::buildCostFunction(problem_, zero);
+  graph.push_back(problem_.equalities);
+  graph.push_back(problem_.inequalities);
+  return graph;
+}
+
+//******************************************************************************
+Template boost::shared_ptr<const typename This::Structure>
+This::computeStructure(const GaussianFactorGraph& graph) const {
+  boost::shared_ptr<Structure> structure = boost::make_shared<Structure>();
+  const size_t nrFixedSlots = graph.size() - problem_.inequalities.size();
+  structure->nrCostSlots = nrFixedSlots - problem_.equalities.size();
+  for (const GaussianFactor::shared_ptr& factor : graph)
+    structure->slotKeys.push_back(factor->keys());
+  const VariableIndex variableIndex(graph);
+  structure->ordering = Ordering::Colamd(variableIndex);
+
+  // Without an inequality, a working graph has to keep every variable
+  KeySet fixedKeys;
+  for (size_t i = 0; i < nrFixedSlots; ++i)
+    fixedKeys.insert(graph[i]->begin(), graph[i]->end());
+  if (fixedKeys.size() < variableIndex.size()) return structure;
+
+  // Flatten the junction tree. Reversing a pre-order puts children before
+  // their parents, without recursing down the deep trees of long chains.
+  const GaussianEliminationTree eliminationTree(graph, variableIndex,
+                                                structure->ordering);
+  const GaussianJunctionTree junctionTree(eliminationTree);
+  static const size_t none = std::numeric_limits<size_t>::max();
+  typedef GaussianJunctionTree::sharedNode sharedCluster;
+  std::vector<std::pair<sharedCluster, size_t> > preOrder, stack;
+  for (const sharedCluster& root : junctionTree.roots())
+    stack.push_back(std::make_pair(root, none));
+  while (!stack.empty()) {
+    const std::pair<sharedCluster, size_t> cluster = stack.back();
+    stack.pop_back();
+    for (const sharedCluster& child : cluster.first->children)
+      stack.push_back(std::make_pair(child, preOrder.size()));
+    preOrder.push_back(cluster);
+  }
+
+  FastMap<const GaussianFactor*, size_t> slotOf;
+  for (size_t i = 0; i < graph.size(); ++i) slotOf[graph[i].get()] = i;
+  const size_t n = preOrder.size();
+  structure->clusters.resize(n);
+  for (size_t k = 0; k < n; ++k) {
+    typename Structure::Cluster& cluster = structure->clusters[n - 1 - k];
+    cluster.frontals = Ordering(preOrder[k].first->orderedFrontalKeys);
+    for (const GaussianFactor::shared_ptr& factor : preOrder[k].first->factors)
+      cluster.slots.push_back(slotOf.at(factor.get()));
+    if (preOrder[k].second != none)
+      structure->clusters[n - 1 - preOrder[k].second].children.push_back(
+          n - 1 - k);
+  }
+  return structure;
+}
+
 /* We have to make sure the new solution with alpha satisfies all INACTIVE inequality constraints
  * If some inactive inequality constraints complain about the full step (alpha = 1),
  * we have to adjust alpha to stay within the inequality constraints' feasible regions.
@@ -189,15 +290,93 @@ This::buildWorkingGraph(const InequalityFactorGraph& workingSet,
   return workingGraph;
 }
 
+//******************************************************************************
+Template Ordering This::workingOrdering(
+    const GaussianFactorGraph& workingGraph) const {
+  const KeySet keys = workingGraph.keys();
+  Ordering ordering;
+  for (Key key : structure_->ordering)
+    if (keys.exists(key)) ordering.push_back(key);
+  return ordering;
+}
+
+//******************************************************************************
+Template VectorValues This::solveWorkingGraph(
+    const State& state, Factorization& factorization) const {
+  const std::vector<typename Structure::Cluster>& clusters =
+      structure_->clusters;
+  if (clusters.empty() ||
+      state.workingSet.size() != problem_.inequalities.size()) {
+    GaussianFactorGraph workingGraph =
+        buildWorkingGraph(state.workingSet, state.values);
+    const Ordering ordering = workingOrdering(workingGraph);
+    return workingGraph.optimize(ordering);
+  }
+
+  // Fill the slots, keeping the previous cost factors if they did not change
+  const Factorization& previous = state.factorization;
+  const size_t nrSlots = structure_->slotKeys.size();
+  const bool fresh = previous.slots.size() != nrSlots;
+  std::vector<GaussianFactor::shared_ptr>& slots = factorization.slots;
+  slots.reserve(nrSlots);
+  const GaussianFactorGraph cost =
+      POLICY::buildCostFunction(problem_, state.values);
+  assert(cost.size() == structure_->nrCostSlots);
+  for (size_t i = 0; i < cost.size(); ++i) {
+    if (!fresh && previous.slots[i]->equals(*cost[i], 0.0))
+      slots.push_back(previous.slots[i]);
+    else
+      slots.push_back(cost[i]);
+  }
+  for (const LinearEquality::shared_ptr& factor : problem_.equalities)
+    slots.push_back(factor);
+  for (const LinearInequality::shared_ptr& factor : state.workingSet)
+    slots.push_back(factor->active() ? factor : LinearInequality::shared_ptr());
+
+  // Re-eliminate the clusters whose slots changed and their ancestors, reusing
+  // the conditionals and marginals of the others
+  const size_t n = clusters.size();
+  factorization.conditionals.resize(n);
+  factorization.marginals.resize(n);
+  std::vector<bool> changed(n, fresh);
+  for (size_t k = 0; k < n; ++k) {
+    const typename Structure::Cluster& cluster = clusters[k];
+    for (size_t i : cluster.slots)
+      if (!changed[k] && slots[i] != previous.slots[i]) changed[k] = true;
+    for (size_t child : cluster.children)
+      if (changed[child]) changed[k] = true;
+    if (!changed[k]) {
+      factorization.conditionals[k] = previous.conditionals[k];
+      factorization.marginals[k] = previous.marginals[k];
+      continue;
+    }
+    GaussianFactorGraph factors;
+    for (size_t i : cluster.slots)
+      if (slots[i]) factors.push_back(slots[i]);
+    for (size_t child : cluster.children) {
+      const GaussianFactor::shared_ptr& marginal =
+          factorization.marginals[child];
+      if (marginal && !marginal->empty()) factors.push_back(marginal);
+    }
+    boost::tie(factorization.conditionals[k], factorization.marginals[k]) =
+        EliminatePreferCholesky(factors, cluster.frontals);
+  }
+
+  // Back-substitute from the roots
+  VectorValues values;
+  for (size_t k = n; k-- > 0;)
+    values.insert(factorization.conditionals[k]->solve(values));
+  return values;
+}
+
 //******************************************************************************
 Template typename This::State This::iterate(
     const typename This::State& state) const {
   // Algorithm 16.3 from Nocedal06book.
   // Solve with the current working set eqn 16.39, but instead of solving for p
   // solve for x
-  GaussianFactorGraph workingGraph =
-      buildWorkingGraph(state.workingSet, state.values);
-  VectorValues newValues = workingGraph.optimize();
+  Factorization factorization;
+  VectorValues newValues = solveWorkingGraph(state, factorization);
   // If we CAN'T move further
   // if p_k = 0 is the original condition, modified by Duy to say that the state
   // update is zero.
@@ -210,13 +389,13 @@ Template typename This::State This::iterate(
     // If all inequality constraints are satisfied: We have the solution!!
     if (leavingFactor < 0) {
       return State(newValues, duals, state.workingSet, true,
-          state.iterations + 1);
+          state.iterations + 1, std::move(factorization));
     } else {
       // Inactivate the leaving constraint
       InequalityFactorGraph newWorkingSet = state.workingSet;
       newWorkingSet.at(leavingFactor)->inactivate();
       return State(newValues, duals, newWorkingSet, false,
-          state.iterations + 1);
+          state.iterations + 1, std::move(factorization));
     }
   } else {
     // If we CAN make some progress, i.e. p_k != 0
@@ -233,7 +412,7 @@ Template typename This::State This::iterate(
     // step!
     newValues = state.values + alpha * p;
     return State(newValues, state.duals, newWorkingSet, false,
-        state.iterations + 1);
+        state.iterations + 1, std::move(factorization));
   }
 }
 
@@ -250,9 +429,11 @@ Template InequalityFactorGraph This::identifyActiveConstraints(
       else workingFactor->inactivate();
     } else {
       double error = workingFactor->error(initialValues);
-      // Safety guard. This should not happen unless users provide a bad init
-      if (error > 0) throw InfeasibleInitialValues();
-      if (fabs(error) < 1e-7)
+      // Safety guard. This should not happen unless users provide a bad init.
+      // Errors within the tolerance of isFeasible, such as the round-off of a
+      // previous optimum on its active constraints, count as tight.
+      if (error > 1e-7) throw InfeasibleInitialValues();
+      if (fabs(error) <= 1e-7)
         workingFactor->activate();
       else
         workingFactor->inactivate();
@@ -277,6 +458,51 @@ Template std::pair<VectorValues, VectorValues> This::optimize(
   return std::make_pair(state.values, state.duals);
 }
 
+//******************************************************************************
+Template bool This::isFeasible(const VectorValues& values) const {
+  for (const LinearEquality::shared_ptr& factor : problem_.equalities) {
+    for (Key key : factor->keys())
+      if (!values.exists(key)) return false;
+    if (factor->error_vector(values).lpNorm<Eigen::Infinity>() > 1e-7)
+      return false;
+  }
+  for (const LinearInequality::shared_ptr& factor : problem_.inequalities) {
+    for (Key key : factor->keys())
+      if (!values.exists(key)) return false;
+    if (factor->error(values) > 1e-7) return false;
+  }
+  return true;
+}
+
+//******************************************************************************
+Template std::pair<VectorValues, VectorValues> This::optimizeWarmStart(
+    const VectorValues& previousValues,
+    const VectorValues& previousDuals) const {
+  // Only keep the variables of this problem, so convergence checks compare the
+  // same set of variables
+  VectorValues initialValues;
+  for (Key key : structure_->ordering) {
+    if (!previousValues.exists(key)) return optimize();
+    initialValues.insert(key, previousValues.at(key));
+  }
+  if (!isFeasible(initialValues)) return optimize();
+
+  // Start from the tight constraints that were active in the previous solution
+  InequalityFactorGraph workingSet =
+      identifyActiveConstraints(problem_.inequalities, initialValues);
+  if (previousDuals.size() > 0) {
+    for (const LinearInequality::shared_ptr& factor : workingSet)
+      if (factor->active() && !previousDuals.exists(factor->dualKey()))
+        factor->inactivate();
+  }
+  State state(initialValues, VectorValues(), workingSet, false, 0);
+
+  /// main loop of the solver
+  while (!state.converged) state = iterate(state);
+
+  return std::make_pair(state.values, state.duals);
+}
+
 //******************************************************************************
 Template std::pair<VectorValues, VectorValues> This::optimize() const {
   INITSOLVER initSolver(problem_);
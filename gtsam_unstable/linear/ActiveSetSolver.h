@@ -19,9 +19,13 @@
 #pragma once
 
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianConditional.h>
+#include <gtsam/inference/Ordering.h>
 #include <gtsam_unstable/linear/InequalityFactorGraph.h>
 #include <boost/range/adaptor/map.hpp>
 
+#include <vector>
+
 namespace gtsam {
 
 /**
@@ -36,6 +40,20 @@ namespace gtsam {
 template <class PROBLEM, class POLICY, class INITSOLVER>
 class ActiveSetSolver {
 public:
+  /**
+   * Elimination of the working graph of an iteration, with one conditional and
+   * one marginal factor per cluster of the junction tree of the problem. The
+   * next iteration only re-eliminates the clusters whose factors changed, i.e.
+   * those of the constraints that joined or left the working set, and their
+   * ancestors.
+   */
+  struct Factorization {
+    std::vector<GaussianFactor::shared_ptr> slots; /*!< factors that were
+                               eliminated, null for inactive inequalities */
+    std::vector<GaussianConditional::shared_ptr> conditionals; //!< per cluster
+    std::vector<GaussianFactor::shared_ptr> marginals;         //!< per cluster
+  };
+
   /// This struct contains the state information for a single iteration
   struct State {
     VectorValues values;  //!< current best values at each step
@@ -45,6 +63,8 @@ public:
     bool converged;     //!< True if the algorithm has converged to a solution
     size_t iterations;  /*!< Number of iterations. Incremented at the end of
                         each iteration. */
+    Factorization factorization; /*!< elimination of the last working graph,
+                                      empty to eliminate the next one fully */
 
     /// Default constructor
     State()
@@ -53,12 +73,13 @@ public:
     /// Constructor with initial values
     State(const VectorValues& initialValues, const VectorValues& initialDuals,
           const InequalityFactorGraph& initialWorkingSet, bool _converged,
-          size_t _iterations)
+          size_t _iterations, Factorization _factorization = Factorization())
         : values(initialValues),
           duals(initialDuals),
           workingSet(initialWorkingSet),
           converged(_converged),
-          iterations(_iterations) {}
+          iterations(_iterations),
+          factorization(std::move(_factorization)) {}
   };
 
 protected:
@@ -69,17 +90,44 @@ protected:
   KeySet constrainedKeys_;  /*!< all constrained keys, will become factors in
                                  dual graphs */
 
+  /**
+   * Symbolic elimination of the working graphs. A working graph has a slot for
+   * every factor of the cost, every equality and every inequality, in this
+   * order, of which those of inactive inequalities are empty. The junction tree
+   * of the graph with all slots filled is valid for any working graph, as long
+   * as every variable is in the cost or an equality, so it is computed once and
+   * shared by solvers of problems with the same structure.
+   */
+  struct Structure {
+    /// A cluster of the junction tree
+    struct Cluster {
+      Ordering frontals;             //!< variables eliminated in this cluster
+      std::vector<size_t> slots;     //!< slots of the factors it eliminates
+      std::vector<size_t> children;  //!< child clusters
+    };
+    Ordering ordering;  //!< COLAMD ordering of all variables of the problem
+    size_t nrCostSlots; //!< number of slots of the cost
+    std::vector<KeyVector> slotKeys;  //!< variables of the factor in each slot
+    std::vector<Cluster> clusters;    /*!< children before their parents, empty
+                                           if a variable is only constrained by
+                                           inequalities */
+  };
+  boost::shared_ptr<const Structure> structure_;  //!< symbolic elimination
+
   /// Vector of key matrix pairs. Matrices are usually the A term for a factor.
   typedef std::vector<std::pair<Key, Matrix> > TermsContainer;
 
 public:
   /// Constructor
-  ActiveSetSolver(const PROBLEM& problem) :  problem_(problem) {
-    equalityVariableIndex_ = VariableIndex(problem_.equalities);
-    inequalityVariableIndex_ = VariableIndex(problem_.inequalities);
-    constrainedKeys_ = problem_.equalities.keys();
-    constrainedKeys_.merge(problem_.inequalities.keys());
-  }
+  ActiveSetSolver(const PROBLEM& problem);
+
+  /**
+   * Constructor that reuses the symbolic elimination of another solver, whose
+   * problem has the same factors on the same variables, in the same order, as
+   * between two steps of a model predictive control loop.
+   * @throw std::invalid_argument if the structures of the problems differ
+   */
+  ActiveSetSolver(const PROBLEM& problem, const ActiveSetSolver& sameStructure);
 
   /**
    * Optimize with provided initial values
@@ -98,7 +146,42 @@ public:
    */
   std::pair<VectorValues, VectorValues> optimize() const;
 
+  /**
+   * Warm-start from the solution of a previous, structurally identical problem,
+   * e.g. the previous step of a model predictive control loop. If the previous
+   * solution is still feasible, the working set is initialized with the
+   * constraints that are tight at it, restricted to those that were active at
+   * the previous solution if its duals are given, and the initial feasibility
+   * pass of optimize() is skipped. Otherwise, this falls back to optimize().
+   * @param previousValues primal solution of the previous solve
+   * @param previousDuals dual solution of the previous solve, may be empty
+   * @return a pair of <primal, dual> solutions
+   */
+  std::pair<VectorValues, VectorValues> optimizeWarmStart(
+      const VectorValues& previousValues,
+      const VectorValues& previousDuals = VectorValues()) const;
+
 protected:
+  /// The working graph with all slots filled, see Structure
+  GaussianFactorGraph structureGraph() const;
+
+  /// Compute the symbolic elimination of the working graphs
+  boost::shared_ptr<const Structure> computeStructure(
+      const GaussianFactorGraph& graph) const;
+
+  /// Elimination ordering for a working graph, from the ordering of the problem
+  Ordering workingOrdering(const GaussianFactorGraph& workingGraph) const;
+
+  /**
+   * Solve the working graph of a state, re-eliminating only the clusters that
+   * changed since the factorization of the state, which is updated.
+   */
+  VectorValues solveWorkingGraph(const State& state,
+                                 Factorization& factorization) const;
+
+  /// Check whether values satisfy all equality and inequality constraints
+  bool isFeasible(const VectorValues& values) const;
+
   /**
    * Compute minimum step size alpha to move from the current point @p xk to the
    * next feasible point along a direction @p p:  x' = xk + alpha*p,
@@ -15,507 +15,393 @@
  * @date     3/5/16
  */
 
-#define BOOST_SPIRIT_USE_PHOENIX_V3 1
-
 #include <gtsam/base/Matrix.h>
+#include <gtsam/base/SymmetricBlockMatrix.h>
 #include <gtsam/inference/Key.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam_unstable/linear/QP.h>
 #include <gtsam_unstable/linear/QPSParser.h>
 #include <gtsam_unstable/linear/QPSParserException.h>
 
-#include <boost/fusion/include/vector.hpp>
-#include <boost/fusion/sequence.hpp>
-#include <boost/lambda/lambda.hpp>
-#include <boost/phoenix/bind.hpp>
-#include <boost/spirit/include/classic.hpp>
-#include <boost/spirit/include/qi.hpp>
+#if defined(__unix__) || defined(__APPLE__)
+#  define GTSAM_QPS_USE_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #include <algorithm>
-#include <iostream>
-#include <map>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-using boost::fusion::at_c;
 using namespace std;
 
-namespace bf = boost::fusion;
-namespace qi = boost::spirit::qi;
-
-using Chars = std::vector<char>;
-
-// Get a string from a fusion vector of Chars
-template <size_t I, class FusionVector>
-static string fromChars(const FusionVector &vars) {
-  const Chars &chars = at_c<I>(vars);
-  return string(chars.begin(), chars.end());
-}
-
 namespace gtsam {
 
-/**
- * As the parser reads a file, it call functions in this visitor. This visitor
- * in turn stores what the parser has read in a way that can be later used to
- * build the full QP problem in the file.
- */
-class QPSVisitor {
- private:
-  typedef std::unordered_map<Key, Matrix11> coefficient_v;
-  typedef std::unordered_map<std::string, coefficient_v> constraint_v;
-
-  std::unordered_map<std::string, constraint_v *>
-      row_to_constraint_v;  // Maps QPS ROWS to Variable-Matrix pairs
-  constraint_v E;           // Equalities
-  constraint_v IG;          // Inequalities >=
-  constraint_v IL;          // Inequalities <=
-  unsigned int numVariables;
-  std::unordered_map<std::string, double>
-      b;  // maps from constraint name to b value for Ax = b equality
-          // constraints
-  std::unordered_map<std::string, double>
-      ranges;  // Inequalities can be specified as ranges on a variable
-  std::unordered_map<Key, Vector1> g;  // linear term of quadratic cost
-  std::unordered_map<std::string, Key>
-      varname_to_key;  // Variable QPS string name to key
-  std::unordered_map<Key, std::unordered_map<Key, Matrix11>>
-      H;                 // H from hessian
-  double f;              // Constant term of quadratic cost
-  std::string obj_name;  // the objective function has a name in the QPS
-  std::string name_;     // the quadratic program has a name in the QPS
-  std::unordered_map<Key, double>
-      up;  // Upper Bound constraints on variable where X < MAX
-  std::unordered_map<Key, double>
-      lo;  // Lower Bound constraints on variable where MIN < X
-  std::unordered_map<Key, double>
-      fx;          // Equalities specified as FX in BOUNDS part of QPS
-  KeyVector free;  // Variables can be specified as free (to which no
-                   // constraints apply)
-  const bool debug = false;
+namespace {
 
+/// The contents of a file, memory-mapped if possible and read otherwise
+class FileBuffer {
  public:
-  QPSVisitor() : numVariables(1) {}
-
-  void setName(boost::fusion::vector<Chars, Chars, Chars> const &name) {
-    name_ = fromChars<1>(name);
-    if (debug) {
-      cout << "Parsing file: " << name_ << endl;
+  explicit FileBuffer(const string& fileName) : mapped_(0), size_(0) {
+#ifdef GTSAM_QPS_USE_MMAP
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      struct stat status;
+      if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+        void* data = ::mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+          mapped_ = static_cast<const char*>(data);
+          size_ = status.st_size;
+        }
+      }
+      ::close(fd);
+      if (mapped_) return;
     }
+#endif
+    ifstream stream(fileName.c_str(), ios::binary);
+    if (!stream) throw QPSParserException("Cannot open QPS file " + fileName);
+    contents_.assign(istreambuf_iterator<char>(stream),
+                     istreambuf_iterator<char>());
   }
 
-  void addColumn(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                       double, Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    Matrix11 coefficient = at_c<5>(vars) * I_1x1;
-    if (debug) {
-      cout << "Added Column for Var: " << var_ << " Row: " << row_
-           << " Coefficient: " << coefficient << endl;
-    }
-    if (!varname_to_key.count(var_))
-      varname_to_key[var_] = Symbol('X', numVariables++);
-    if (row_ == obj_name) {
-      g[varname_to_key[var_]] = coefficient;
-      return;
-    }
-    (*row_to_constraint_v[row_])[row_][varname_to_key[var_]] = coefficient;
+  ~FileBuffer() {
+#ifdef GTSAM_QPS_USE_MMAP
+    if (mapped_) ::munmap(const_cast<char*>(mapped_), size_);
+#endif
   }
 
-  void addColumnDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, double, Chars, Chars,
-                            Chars, double> const &vars) {
-    string var_ = fromChars<0>(vars);
-    string row1_ = fromChars<2>(vars);
-    string row2_ = fromChars<6>(vars);
-    Matrix11 coefficient1 = at_c<4>(vars) * I_1x1;
-    Matrix11 coefficient2 = at_c<8>(vars) * I_1x1;
-    if (!varname_to_key.count(var_))
-      varname_to_key.insert({var_, Symbol('X', numVariables++)});
-    if (row1_ == obj_name)
-      g[varname_to_key[var_]] = coefficient1;
-    else
-      (*row_to_constraint_v[row1_])[row1_][varname_to_key[var_]] = coefficient1;
-    if (row2_ == obj_name)
-      g[varname_to_key[var_]] = coefficient2;
-    else
-      (*row_to_constraint_v[row2_])[row2_][varname_to_key[var_]] = coefficient2;
+  const char* begin() const {
+    return mapped_ ? mapped_ : contents_.data();
+  }
+  const char* end() const {
+    return mapped_ ? mapped_ + size_ : contents_.data() + contents_.size();
   }
 
-  void addRangeSingle(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                            double, Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    double range = at_c<5>(vars);
-    ranges[row_] = range;
-    if (debug) {
-      cout << "SINGLE RANGE ADDED" << endl;
-      cout << "VAR:" << var_ << " ROW: " << row_ << " RANGE: " << range << endl;
-    }
+ private:
+  FileBuffer(const FileBuffer&);
+  FileBuffer& operator=(const FileBuffer&);
+
+  const char* mapped_;
+  size_t size_;
+  vector<char> contents_;
+};
+
+/// A whitespace-delimited field of a line, pointing into the input buffer
+struct Token {
+  const char* begin;
+  size_t size;
+
+  string str() const { return string(begin, size); }
+  bool operator==(const char* s) const {
+    return strlen(s) == size && strncmp(begin, s, size) == 0;
   }
-  void addRangeDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double, Chars,
-                            Chars, Chars, double> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row1_ = fromChars<3>(vars);
-    string row2_ = fromChars<7>(vars);
-    double range1 = at_c<5>(vars);
-    double range2 = at_c<9>(vars);
-    ranges[row1_] = range1;
-    ranges[row2_] = range2;
-    if (debug) {
-      cout << "DOUBLE RANGE ADDED" << endl;
-      cout << "VAR: " << var_ << " ROW1: " << row1_ << " RANGE1: " << range1
-           << " ROW2: " << row2_ << " RANGE2: " << range2 << endl;
+};
+
+/// A constraint row, with its coefficients collected from the COLUMNS section
+struct Row {
+  char type;  // 'E', 'G', 'L' or 'N'
+  vector<pair<Key, double> > terms;
+  double rhs;
+  bool hasRange;
+  double range;
+};
+
+/// Per-variable data: linear cost coefficient and bounds
+struct Variable {
+  Key key;
+  double g;
+  bool hasUpper, hasLower, hasFixed, free;
+  double upper, lower, fixed;
+};
+
+/// One-pass reader that collects rows and variables, then builds the QP
+class QPSReader {
+ public:
+  QPSReader() : objective_(-1), f_(0.0), line_(0) {}
+
+  void parse(const char* begin, const char* end) {
+    enum Section { NONE, ROWS, COLUMNS, RHS, RANGES, BOUNDS, QUADOBJ, DONE };
+    Section section = NONE;
+    Token tokens[7];
+    const char* p = begin;
+    while (p < end && section != DONE) {
+      const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+      if (!eol) eol = end;
+      ++line_;
+      const bool indented = (*p == ' ' || *p == '\t');
+
+      // Split the line into tokens
+      size_t n = 0;
+      for (const char* q = p; q < eol;) {
+        while (q < eol && isspace(static_cast<unsigned char>(*q))) ++q;
+        if (q == eol) break;
+        const char* start = q;
+        while (q < eol && !isspace(static_cast<unsigned char>(*q))) ++q;
+        if (n == 7) fail("too many fields");
+        Token token = {start, static_cast<size_t>(q - start)};
+        tokens[n++] = token;
+      }
+      p = eol + 1;
+      if (n == 0 || *tokens[0].begin == '*') continue;  // blank or comment
+
+      if (!indented) {
+        if (tokens[0] == "NAME") section = NONE;
+        else if (tokens[0] == "ROWS") section = ROWS;
+        else if (tokens[0] == "COLUMNS") section = COLUMNS;
+        else if (tokens[0] == "RHS") section = RHS;
+        else if (tokens[0] == "RANGES") section = RANGES;
+        else if (tokens[0] == "BOUNDS") section = BOUNDS;
+        else if (tokens[0] == "QUADOBJ" || tokens[0] == "QMATRIX") section = QUADOBJ;
+        else if (tokens[0] == "ENDATA") section = DONE;
+        else fail("unknown section " + tokens[0].str());
+        continue;
+      }
+
+      switch (section) {
+        case ROWS: addRow(tokens, n); break;
+        case COLUMNS: addColumn(tokens, n); break;
+        case RHS: addRhs(tokens, n, false); break;
+        case RANGES: addRhs(tokens, n, true); break;
+        case BOUNDS: addBound(tokens, n); break;
+        case QUADOBJ: addQuadTerm(tokens, n); break;
+        default: fail("data outside of a section");
+      }
     }
+    if (section != DONE) fail("missing ENDATA");
+    if (objective_ < 0) fail("no objective row");
   }
 
-  void addRHS(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                    Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    double coefficient = at_c<5>(vars);
-    if (row_ == obj_name)
-      f = -coefficient;
-    else
-      b[row_] = coefficient;
-
-    if (debug) {
-      cout << "Added RHS for Var: " << var_ << " Row: " << row_
-           << " Coefficient: " << coefficient << endl;
+  QP makeQP() const {
+    // Variables were created in order of appearance, so their keys are sorted
+    const size_t nrVariables = variables_.size();
+    KeyVector keys;
+    keys.reserve(nrVariables);
+    for (const Variable& variable : variables_) keys.push_back(variable.key);
+
+    // Augmented information matrix [G -c; -c' 2f] of the quadratic cost
+    Matrix augmented = Matrix::Zero(nrVariables + 1, nrVariables + 1);
+    for (const pair<pair<size_t, size_t>, double>& entry : hessian_)
+      augmented(entry.first.first, entry.first.second) = entry.second;
+    for (size_t i = 0; i < nrVariables; ++i)
+      augmented(i, nrVariables) = -variables_[i].g;
+    augmented(nrVariables, nrVariables) = 2 * f_;
+
+    QP madeQP;
+    madeQP.cost.push_back(HessianFactor(
+        keys, SymmetricBlockMatrix(vector<size_t>(nrVariables, 1), augmented, true)));
+
+    // Equalities first, then >= and <= rows, each in file order
+    Key dualKey = nrVariables + 1;
+    for (char type : {'E', 'G', 'L'}) {
+      for (const Row& row : rows_) {
+        if (row.type != type || row.terms.empty()) continue;
+        vector<pair<Key, Matrix> > terms = sortedTerms(row, 1.0);
+        vector<pair<Key, Matrix> > negated = sortedTerms(row, -1.0);
+        double lower = row.rhs, upper = row.rhs;
+        if (row.hasRange) {
+          if (type == 'E') {
+            if (row.range > 0) upper += row.range;
+            else lower += row.range;
+          } else if (type == 'G') {
+            upper += fabs(row.range);
+          } else {
+            lower -= fabs(row.range);
+          }
+        }
+        if (type == 'E' && lower == upper) {
+          madeQP.equalities.push_back(
+              LinearEquality(terms, row.rhs * I_1x1, dualKey++));
+          continue;
+        }
+        // a*x >= lower becomes -a*x <= -lower
+        if (type != 'L' || row.hasRange)
+          madeQP.inequalities.push_back(
+              LinearInequality(negated, -lower, dualKey++));
+        if (type != 'G' || row.hasRange)
+          madeQP.inequalities.push_back(LinearInequality(terms, upper, dualKey++));
+      }
     }
-  }
 
-  void addRHSDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double, Chars,
-                            Chars, Chars, double> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row1_ = fromChars<3>(vars);
-    string row2_ = fromChars<7>(vars);
-    double coefficient1 = at_c<5>(vars);
-    double coefficient2 = at_c<9>(vars);
-    if (row1_ == obj_name)
-      f = -coefficient1;
-    else
-      b[row1_] = coefficient1;
-
-    if (row2_ == obj_name)
-      f = -coefficient2;
-    else
-      b[row2_] = coefficient2;
-
-    if (debug) {
-      cout << "Added RHS for Var: " << var_ << " Row: " << row1_
-           << " Coefficient: " << coefficient1 << endl;
-      cout << "                      "
-           << "Row: " << row2_ << " Coefficient: " << coefficient2 << endl;
+    // Bounds, variables are non-negative unless stated otherwise
+    for (const Variable& variable : variables_) {
+      if (variable.free) continue;
+      const Key k = variable.key;
+      if (variable.hasFixed)
+        madeQP.equalities.push_back(
+            LinearEquality(k, I_1x1, variable.fixed * I_1x1, dualKey++));
+      if (variable.hasUpper)
+        madeQP.inequalities.push_back(
+            LinearInequality(k, I_1x1, variable.upper, dualKey++));
+      if (variable.hasLower)
+        madeQP.inequalities.push_back(
+            LinearInequality(k, -I_1x1, -variable.lower, dualKey++));
     }
+    return madeQP;
   }
 
-  void addRow(
-      boost::fusion::vector<Chars, char, Chars, Chars, Chars> const &vars) {
-    string name_ = fromChars<3>(vars);
-    char type = at_c<1>(vars);
-    switch (type) {
-      case 'N':
-        obj_name = name_;
-        break;
-      case 'L':
-        row_to_constraint_v[name_] = &IL;
-        break;
-      case 'G':
-        row_to_constraint_v[name_] = &IG;
-        break;
-      case 'E':
-        row_to_constraint_v[name_] = &E;
-        break;
-      default:
-        cout << "invalid type: " << type << endl;
-        break;
-    }
-    if (debug) {
-      cout << "Added Row Type: " << type << " Name: " << name_ << endl;
-    }
+ private:
+  unordered_map<string, size_t> rowIndex_;
+  vector<Row> rows_;
+  unordered_map<string, size_t> variableIndex_;
+  vector<Variable> variables_;
+  vector<pair<pair<size_t, size_t>, double> > hessian_;  // upper triangle
+  int objective_;  // index of the objective row
+  double f_;       // constant term of the cost
+  size_t line_;
+
+  void fail(const string& what) const {
+    throw QPSParserException("QPS parse error on line " + to_string(line_) +
+                             ": " + what);
   }
 
-  void addBound(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, Chars,
-                                      Chars, double> const &vars) {
-    string type_ = fromChars<1>(vars);
-    string var_ = fromChars<5>(vars);
-    double number = at_c<7>(vars);
-    if (type_.compare(string("UP")) == 0)
-      up[varname_to_key[var_]] = number;
-    else if (type_.compare(string("LO")) == 0)
-      lo[varname_to_key[var_]] = number;
-    else if (type_.compare(string("FX")) == 0)
-      fx[varname_to_key[var_]] = number;
-    else
-      cout << "Invalid Bound Type: " << type_ << endl;
-
-    if (debug) {
-      cout << "Added Bound Type: " << type_ << " Var: " << var_
-           << " Amount: " << number << endl;
-    }
+  double number(const Token& token) const {
+    char buffer[64];
+    if (token.size >= sizeof(buffer)) fail("number too long");
+    memcpy(buffer, token.begin, token.size);
+    buffer[token.size] = '\0';
+    char* last;
+    const double value = strtod(buffer, &last);
+    if (last != buffer + token.size) fail("invalid number " + token.str());
+    return value;
   }
 
-  void addFreeBound(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                          Chars, Chars> const &vars) {
-    string type_ = fromChars<1>(vars);
-    string var_ = fromChars<5>(vars);
-    free.push_back(varname_to_key[var_]);
-    if (debug) {
-      cout << "Added Free Bound Type: " << type_ << " Var: " << var_
-           << " Amount: " << endl;
-    }
+  size_t row(const Token& token) const {
+    unordered_map<string, size_t>::const_iterator it =
+        rowIndex_.find(token.str());
+    if (it == rowIndex_.end()) fail("unknown row " + token.str());
+    return it->second;
   }
 
-  void addQuadTerm(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                         double, Chars> const &vars) {
-    string var1_ = fromChars<1>(vars);
-    string var2_ = fromChars<3>(vars);
-    Matrix11 coefficient = at_c<5>(vars) * I_1x1;
-
-    H[varname_to_key[var1_]][varname_to_key[var2_]] = coefficient;
-    H[varname_to_key[var2_]][varname_to_key[var1_]] = coefficient;
-    if (debug) {
-      cout << "Added QuadTerm for Var: " << var1_ << " Row: " << var2_
-           << " Coefficient: " << coefficient << endl;
-    }
+  size_t variable(const Token& token) const {
+    unordered_map<string, size_t>::const_iterator it =
+        variableIndex_.find(token.str());
+    if (it == variableIndex_.end()) fail("unknown column " + token.str());
+    return it->second;
   }
 
-  QP makeQP() {
-    // Create the keys from the variable names
-    KeyVector keys;
-    for (auto kv : varname_to_key) {
-      keys.push_back(kv.second);
-    }
+  void addRow(const Token* tokens, size_t n) {
+    if (n != 2 || tokens[0].size != 1) fail("invalid row");
+    const char type = *tokens[0].begin;
+    if (type != 'N' && type != 'E' && type != 'G' && type != 'L')
+      fail(string("invalid row type ") + type);
+    if (type == 'N' && objective_ < 0) objective_ = rows_.size();
+    rowIndex_[tokens[1].str()] = rows_.size();
+    Row row = {type, vector<pair<Key, double> >(), 0.0, false, 0.0};
+    rows_.push_back(row);
+  }
 
-    // Fill the G matrices and g vectors from
-    vector<Matrix> Gs;
-    vector<Vector> gs;
-    sort(keys.begin(), keys.end());
-    for (size_t i = 0; i < keys.size(); ++i) {
-      for (size_t j = i; j < keys.size(); ++j) {
-        if (H.count(keys[i]) > 0 && H[keys[i]].count(keys[j]) > 0) {
-          Gs.emplace_back(H[keys[i]][keys[j]]);
-        } else {
-          Gs.emplace_back(Z_1x1);
-        }
-      }
+  void addColumn(const Token* tokens, size_t n) {
+    if (n >= 3 && tokens[1] == "'MARKER'") fail("integer variables are not supported");
+    if (n != 3 && n != 5) fail("invalid column");
+    pair<unordered_map<string, size_t>::iterator, bool> inserted =
+        variableIndex_.insert(make_pair(tokens[0].str(), variables_.size()));
+    if (inserted.second) {
+      Variable variable = {Symbol('X', variables_.size() + 1), 0.0, false,
+                           true, false, false, 0.0, 0.0, 0.0};
+      variables_.push_back(variable);
     }
-    for (Key key1 : keys) {
-      if (g.count(key1) > 0) {
-        gs.emplace_back(-g[key1]);
-      } else {
-        gs.emplace_back(Z_1x1);
-      }
+    Variable& variable = variables_[inserted.first->second];
+    for (size_t i = 1; i < n; i += 2) {
+      const size_t r = row(tokens[i]);
+      const double coefficient = number(tokens[i + 1]);
+      if (r == size_t(objective_))
+        variable.g = coefficient;
+      else if (rows_[r].type != 'N')
+        rows_[r].terms.push_back(make_pair(variable.key, coefficient));
     }
+  }
 
-    // Construct the quadratic program
-    QP madeQP;
-    auto obj = HessianFactor(keys, Gs, gs, 2 * f);
-    madeQP.cost.push_back(obj);
-
-    // Add equality and inequality constraints into the QP
-    size_t dual_key_num = keys.size() + 1;
-    for (auto kv : E) {
-      map<Key, Matrix11> keyMatrixMapPos;
-      map<Key, Matrix11> keyMatrixMapNeg;
-      if (ranges.count(kv.first) == 1) {
-        for (auto km : kv.second) {
-          keyMatrixMapPos.insert(km);
-          km.second = -km.second;
-          keyMatrixMapNeg.insert(km);
-        }
-        if (ranges[kv.first] > 0) {
-          madeQP.inequalities.push_back(
-              LinearInequality(keyMatrixMapNeg, -b[kv.first], dual_key_num++));
-          madeQP.inequalities.push_back(LinearInequality(
-              keyMatrixMapPos, b[kv.first] + ranges[kv.first], dual_key_num++));
-        } else if (ranges[kv.first] < 0) {
-          madeQP.inequalities.push_back(
-              LinearInequality(keyMatrixMapPos, b[kv.first], dual_key_num++));
-          madeQP.inequalities.push_back(LinearInequality(
-              keyMatrixMapNeg, ranges[kv.first] - b[kv.first], dual_key_num++));
-        } else {
-          cerr << "ERROR: CANNOT ADD A RANGE OF ZERO" << endl;
-          throw;
-        }
-        continue;
-      }
-      map<Key, Matrix11> keyMatrixMap;
-      for (auto km : kv.second) {
-        keyMatrixMap.insert(km);
+  void addRhs(const Token* tokens, size_t n, bool range) {
+    // The name of the RHS or RANGES vector is optional
+    size_t first = (n % 2 == 1) ? 1 : 0;
+    if (n < 2 || n > 5) fail("invalid RHS or RANGES entry");
+    for (size_t i = first; i < n; i += 2) {
+      const size_t r = row(tokens[i]);
+      const double value = number(tokens[i + 1]);
+      if (range) {
+        rows_[r].hasRange = true;
+        rows_[r].range = value;
+      } else if (r == size_t(objective_)) {
+        f_ = -value;
+      } else {
+        rows_[r].rhs = value;
       }
-      madeQP.equalities.push_back(
-          LinearEquality(keyMatrixMap, b[kv.first] * I_1x1, dual_key_num++));
     }
+  }
 
-    for (auto kv : IG) {
-      map<Key, Matrix11> keyMatrixMapNeg;
-      map<Key, Matrix11> keyMatrixMapPos;
-      for (auto km : kv.second) {
-        keyMatrixMapPos.insert(km);
-        km.second = -km.second;
-        keyMatrixMapNeg.insert(km);
-      }
-      madeQP.inequalities.push_back(
-          LinearInequality(keyMatrixMapNeg, -b[kv.first], dual_key_num++));
-      if (ranges.count(kv.first) == 1) {
-        madeQP.inequalities.push_back(LinearInequality(
-            keyMatrixMapPos, b[kv.first] + ranges[kv.first], dual_key_num++));
-      }
+  void addBound(const Token* tokens, size_t n) {
+    const Token& type = tokens[0];
+    const bool hasValue = (type == "UP" || type == "LO" || type == "FX");
+    // The name of the bound vector is optional
+    const size_t expected = hasValue ? 4 : 3;
+    if (n != expected && n != expected - 1) fail("invalid bound");
+    Variable& v = variables_[variable(tokens[n == expected ? 2 : 1])];
+    if (type == "UP") {
+      v.hasUpper = true;
+      v.upper = number(tokens[n - 1]);
+    } else if (type == "LO") {
+      v.lower = number(tokens[n - 1]);
+    } else if (type == "FX") {
+      v.hasFixed = true;
+      v.fixed = number(tokens[n - 1]);
+    } else if (type == "FR") {
+      v.free = true;
+    } else if (type == "MI") {
+      v.hasLower = false;
+    } else if (!(type == "PL")) {
+      fail("unsupported bound type " + type.str());
     }
+  }
 
-    for (auto kv : IL) {
-      map<Key, Matrix11> keyMatrixMapPos;
-      map<Key, Matrix11> keyMatrixMapNeg;
-      for (auto km : kv.second) {
-        keyMatrixMapPos.insert(km);
-        km.second = -km.second;
-        keyMatrixMapNeg.insert(km);
-      }
-      madeQP.inequalities.push_back(
-          LinearInequality(keyMatrixMapPos, b[kv.first], dual_key_num++));
-      if (ranges.count(kv.first) == 1) {
-        madeQP.inequalities.push_back(LinearInequality(
-            keyMatrixMapNeg, ranges[kv.first] - b[kv.first], dual_key_num++));
-      }
-    }
+  void addQuadTerm(const Token* tokens, size_t n) {
+    if (n != 3) fail("invalid quadratic term");
+    size_t i = variable(tokens[0]), j = variable(tokens[1]);
+    if (i > j) swap(i, j);
+    hessian_.push_back(make_pair(make_pair(i, j), number(tokens[2])));
+  }
 
-    for (Key k : keys) {
-      if (find(free.begin(), free.end(), k) != free.end()) continue;
-      if (fx.count(k) == 1)
-        madeQP.equalities.push_back(
-            LinearEquality(k, I_1x1, fx[k] * I_1x1, dual_key_num++));
-      if (up.count(k) == 1)
-        madeQP.inequalities.push_back(
-            LinearInequality(k, I_1x1, up[k], dual_key_num++));
-      if (lo.count(k) == 1)
-        madeQP.inequalities.push_back(
-            LinearInequality(k, -I_1x1, -lo[k], dual_key_num++));
+  static vector<pair<Key, Matrix> > sortedTerms(const Row& row, double sign) {
+    vector<pair<Key, double> > sorted = row.terms;
+    stable_sort(sorted.begin(), sorted.end(),
+                [](const pair<Key, double>& a, const pair<Key, double>& b) {
+                  return a.first < b.first;
+                });
+    vector<pair<Key, Matrix> > terms;
+    terms.reserve(sorted.size());
+    for (const pair<Key, double>& term : sorted) {
+      // A coefficient given twice overrides the earlier one
+      if (!terms.empty() && terms.back().first == term.first)
+        terms.back().second(0, 0) = sign * term.second;
       else
-        madeQP.inequalities.push_back(
-            LinearInequality(k, -I_1x1, 0, dual_key_num++));
+        terms.push_back(make_pair(term.first, sign * term.second * I_1x1));
     }
-    return madeQP;
+    return terms;
   }
 };
 
-typedef qi::grammar<boost::spirit::basic_istream_iterator<char>> base_grammar;
-
-struct QPSParser::MPSGrammar : base_grammar {
-  typedef std::vector<char> Chars;
-  QPSVisitor *rqp_;
-  boost::function<void(bf::vector<Chars, Chars, Chars> const &)> setName;
-  boost::function<void(bf::vector<Chars, char, Chars, Chars, Chars> const &)>
-      addRow;
-  boost::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      rhsSingle;
-  boost::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                  Chars, Chars, Chars, double>)>
-      rhsDouble;
-  boost::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      rangeSingle;
-  boost::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                  Chars, Chars, Chars, double>)>
-      rangeDouble;
-  boost::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars>)>
-      colSingle;
-  boost::function<void(bf::vector<Chars, Chars, Chars, Chars, double, Chars,
-                                  Chars, Chars, double> const &)>
-      colDouble;
-  boost::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      addQuadTerm;
-  boost::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, Chars,
-                                  Chars, double> const &)>
-      addBound;
-  boost::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, Chars, Chars> const &)>
-      addFreeBound;
-  MPSGrammar(QPSVisitor *rqp)
-      : base_grammar(start),
-        rqp_(rqp),
-        setName(boost::bind(&QPSVisitor::setName, rqp, ::_1)),
-        addRow(boost::bind(&QPSVisitor::addRow, rqp, ::_1)),
-        rhsSingle(boost::bind(&QPSVisitor::addRHS, rqp, ::_1)),
-        rhsDouble(boost::bind(&QPSVisitor::addRHSDouble, rqp, ::_1)),
-        rangeSingle(boost::bind(&QPSVisitor::addRangeSingle, rqp, ::_1)),
-        rangeDouble(boost::bind(&QPSVisitor::addRangeDouble, rqp, ::_1)),
-        colSingle(boost::bind(&QPSVisitor::addColumn, rqp, ::_1)),
-        colDouble(boost::bind(&QPSVisitor::addColumnDouble, rqp, ::_1)),
-        addQuadTerm(boost::bind(&QPSVisitor::addQuadTerm, rqp, ::_1)),
-        addBound(boost::bind(&QPSVisitor::addBound, rqp, ::_1)),
-        addFreeBound(boost::bind(&QPSVisitor::addFreeBound, rqp, ::_1)) {
-    using namespace boost::spirit;
-    using namespace boost::spirit::qi;
-    character = lexeme[alnum | '_' | '-' | '.'];
-    title = lexeme[character >> *(blank | character)];
-    word = lexeme[+character];
-    name = lexeme[lit("NAME") >> *blank >> title >> +space][setName];
-    row = lexeme[*blank >> character >> +blank >> word >> *blank][addRow];
-    rhs_single = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                        *blank][rhsSingle];
-    rhs_double =
-        lexeme[(*blank >> word >> +blank >> word >> +blank >> double_ >>
-                +blank >> word >> +blank >> double_)[rhsDouble] >>
-               *blank];
-    range_single = lexeme[*blank >> word >> +blank >> word >> +blank >>
-                          double_ >> *blank][rangeSingle];
-    range_double =
-        lexeme[(*blank >> word >> +blank >> word >> +blank >> double_ >>
-                +blank >> word >> +blank >> double_)[rangeDouble] >>
-               *blank];
-    col_single = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                        *blank][colSingle];
-    col_double =
-        lexeme[*blank >> (word >> +blank >> word >> +blank >> double_ >>
-                          +blank >> word >> +blank >> double_)[colDouble] >>
-               *blank];
-    quad_l = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                    *blank][addQuadTerm];
-    bound = lexeme[(*blank >> word >> +blank >> word >> +blank >> word >>
-                    +blank >> double_)[addBound] >>
-                   *blank];
-    bound_fr = lexeme[*blank >> word >> +blank >> word >> +blank >> word >>
-                      *blank][addFreeBound];
-    rows = lexeme[lit("ROWS") >> *blank >> eol >> +(row >> eol)];
-    rhs = lexeme[lit("RHS") >> *blank >> eol >>
-                 +((rhs_double | rhs_single) >> eol)];
-    cols = lexeme[lit("COLUMNS") >> *blank >> eol >>
-                  +((col_double | col_single) >> eol)];
-    quad = lexeme[lit("QUADOBJ") >> *blank >> eol >> +(quad_l >> eol)];
-    bounds = lexeme[lit("BOUNDS") >> +space >> *((bound | bound_fr) >> eol)];
-    ranges = lexeme[lit("RANGES") >> +space >>
-                    *((range_double | range_single) >> eol)];
-    end = lexeme[lit("ENDATA") >> *space];
-    start =
-        lexeme[name >> rows >> cols >> rhs >> -ranges >> bounds >> quad >> end];
-  }
+}  // namespace
 
-  qi::rule<boost::spirit::basic_istream_iterator<char>, char()> character;
-  qi::rule<boost::spirit::basic_istream_iterator<char>, Chars()> word, title;
-  qi::rule<boost::spirit::basic_istream_iterator<char>> row, end, col_single,
-      col_double, rhs_single, rhs_double, range_single, range_double, ranges,
-      bound, bound_fr, bounds, quad, quad_l, rows, cols, rhs, name, start;
-};
+/* ************************************************************************* */
+QP QPSParser::ParseBuffer(const char* begin, const char* end) {
+  QPSReader reader;
+  reader.parse(begin, end);
+  return reader.makeQP();
+}
 
+/* ************************************************************************* */
 QP QPSParser::Parse() {
-  QPSVisitor rawData;
-  std::fstream stream(fileName_.c_str());
-  stream.unsetf(std::ios::skipws);
-  boost::spirit::basic_istream_iterator<char> begin(stream);
-  boost::spirit::basic_istream_iterator<char> last;
-
-  if (!parse(begin, last, MPSGrammar(&rawData)) || begin != last) {
-    throw QPSParserException();
-  }
-
-  return rawData.makeQP();
+  FileBuffer buffer(fileName_);
+  return ParseBuffer(buffer.begin(), buffer.end());
 }
 
 }  // namespace gtsam
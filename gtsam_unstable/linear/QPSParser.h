@@ -19,22 +19,34 @@
 #pragma once
 
 #include <gtsam_unstable/linear/QP.h>
-#include <fstream>
+
+#include <string>
 
 namespace gtsam {
 
+/**
+ * Reader for quadratic programs in the free QPS format, i.e., MPS with a
+ * QUADOBJ (or QMATRIX) section. The file is read in a single buffered pass,
+ * memory-mapped where the platform supports it, and the factors of the QP are
+ * built directly from the collected rows without intermediate per-variable maps.
+ * Variables are named Symbol('X', i) in order of their first appearance in the
+ * COLUMNS section.
+ */
 class QPSParser {
 
 private:
   std::string fileName_;
-  struct MPSGrammar;
+
 public:
 
   QPSParser(const std::string& fileName) :
       fileName_(findExampleDataFile(fileName)) {
   }
 
+  /// Parse the file, throws QPSParserException on malformed input
   QP Parse();
+
+  /// Parse a QPS problem held in memory in [begin, end)
+  static QP ParseBuffer(const char* begin, const char* end);
 };
 }
-
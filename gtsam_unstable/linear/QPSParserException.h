@@ -25,6 +25,10 @@ public:
   QPSParserException() {
   }
 
+  QPSParserException(const std::string& description) :
+      description_(description) {
+  }
+
   virtual ~QPSParserException() throw () {
   }
 
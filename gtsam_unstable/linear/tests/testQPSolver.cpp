@@ -21,6 +21,7 @@
 #include <gtsam/inference/Symbol.h>
 #include <gtsam_unstable/linear/QPSolver.h>
 #include <gtsam_unstable/linear/QPSParser.h>
+#include <gtsam_unstable/linear/QPSParserException.h>
 #include <CppUnitLite/TestHarness.h>
 
 using namespace std;
@@ -256,6 +257,40 @@ TEST(QPSolver, ParserSemanticTest) {
   CHECK(assert_equal(actualSolution, expectedSolution, 1e-7));
 }
 
+TEST(QPSolver, ParserBuffer) {
+  const string qps =
+      "NAME          QP example\n"
+      "ROWS\n"
+      "    N  obj\n"
+      "    G  r1\n"
+      "    L  r2\n"
+      "COLUMNS\n"
+      "    c1        r1                 2.0   r2                -1.0\n"
+      "    c1        obj                1.5\n"
+      "    c2        r1                 1.0   r2                 2.0\n"
+      "    c2        obj               -2.0\n"
+      "RHS\n"
+      "    rhs1      obj               -4.0\n"
+      "    rhs1      r1                 2.0   r2                 6.0\n"
+      "BOUNDS\n"
+      "    UP BOUNDS      c1                20.0\n"
+      "QUADOBJ\n"
+      "    c1        c1                 8.0\n"
+      "    c1        c2                 2.0\n"
+      "    c2        c2                10.0\n"
+      "ENDATA\n";
+  QP expected = QPSParser("QPExample.QPS").Parse();
+  QP actual = QPSParser::ParseBuffer(qps.data(), qps.data() + qps.size());
+  CHECK(assert_equal(expected.cost, actual.cost, 1e-9));
+  CHECK(assert_equal(expected.equalities, actual.equalities, 1e-9));
+  CHECK(assert_equal(expected.inequalities, actual.inequalities, 1e-9));
+
+  // A coefficient for an undeclared row is an error
+  const string bad = "NAME bad\nROWS\n N obj\nCOLUMNS\n c1 r1 1.0\nENDATA\n";
+  CHECK_EXCEPTION(QPSParser::ParseBuffer(bad.data(), bad.data() + bad.size()),
+                  QPSParserException);
+}
+
 TEST(QPSolver, QPExampleTest){
   QP problem = QPSParser("QPExample.QPS").Parse();
   VectorValues actualSolution;
@@ -418,6 +453,116 @@ TEST(QPSolver, optimizeNocedal06bookEx16_4) {
   CHECK(assert_equal(expectedSolution, solution, 1e-7));
 }
 
+/* ************************************************************************* */
+TEST(QPSolver, optimizeWarmStart) {
+  QP qp = createTestNocedal06bookEx16_4();
+  QPSolver solver(qp);
+  VectorValues solution, duals;
+  boost::tie(solution, duals) = solver.optimize();
+
+  // Re-solving from the previous solution and active set reproduces it
+  VectorValues warmSolution;
+  boost::tie(warmSolution, boost::tuples::ignore) =
+      solver.optimizeWarmStart(solution, duals);
+  CHECK(assert_equal(solution, warmSolution, 1e-7));
+
+  // A previous solution pushed by round-off just past its active constraint
+  // x1 - 2 x2 >= -2 still warm-starts
+  VectorValues roundedOff = solution;
+  roundedOff.at(X(2))(0) += 1e-10;
+  double maxError = 0.0;
+  for (const LinearInequality::shared_ptr& factor : qp.inequalities)
+    maxError = std::max(maxError, factor->error(roundedOff));
+  CHECK(maxError > 0.0);
+  boost::tie(warmSolution, boost::tuples::ignore) =
+      solver.optimizeWarmStart(roundedOff, duals);
+  CHECK(assert_equal(solution, warmSolution, 1e-7));
+
+  // Move the unconstrained minimum, as between two steps of an MPC loop, and
+  // reuse the symbolic elimination of the previous step
+  QP shifted = qp;
+  shifted.cost = GaussianFactorGraph();
+  shifted.cost.push_back(JacobianFactor(X(1), I_1x1, 1.2 * I_1x1));
+  shifted.cost.push_back(JacobianFactor(X(2), I_1x1, 2.0 * I_1x1));
+  QPSolver coldSolver(shifted), shiftedSolver(shifted, solver);
+  VectorValues expected;
+  boost::tie(expected, boost::tuples::ignore) = coldSolver.optimize();
+  boost::tie(warmSolution, boost::tuples::ignore) =
+      shiftedSolver.optimizeWarmStart(solution, duals);
+  CHECK(assert_equal(expected, warmSolution, 1e-7));
+
+  // An infeasible previous solution falls back to a cold start
+  VectorValues infeasible;
+  infeasible.insert(X(1), (Vector(1) << -1.0).finished());
+  infeasible.insert(X(2), (Vector(1) << 5.0).finished());
+  boost::tie(warmSolution, boost::tuples::ignore) =
+      shiftedSolver.optimizeWarmStart(infeasible);
+  CHECK(assert_equal(expected, warmSolution, 1e-7));
+
+  // The symbolic elimination is only shared by problems of the same structure
+  QP other = createTestCase();
+  CHECK_EXCEPTION(QPSolver(other, solver), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+// A smoothed chain pulled towards 2 in its first half and towards 0 in its
+// second, with x_i + x_{i+1} <= 3 on every edge
+QP createChain(size_t n) {
+  QP qp;
+  for (size_t i = 0; i < n; ++i) {
+    qp.cost.push_back(JacobianFactor(X(i), I_1x1, (i < n / 2 ? 2.0 : 0.0) * kOne));
+    if (i + 1 < n) {
+      qp.cost.push_back(JacobianFactor(X(i), I_1x1, X(i + 1), -I_1x1, kZero));
+      qp.inequalities.push_back(
+          LinearInequality(X(i), I_1x1, X(i + 1), I_1x1, 3.0, i));
+    }
+  }
+  return qp;
+}
+
+TEST(QPSolver, incrementalIterate) {
+  const size_t n = 20;
+  QP qp = createChain(n);
+  QPSolver solver(qp);
+
+  // Start with every constraint tight, so that those of the second half leave
+  VectorValues initialValues;
+  for (size_t i = 0; i < n; ++i)
+    initialValues.insert(X(i), (Vector(1) << 1.5).finished());
+  QPSolver::State incremental(initialValues, VectorValues(),
+      solver.identifyActiveConstraints(qp.inequalities, initialValues), false,
+      0);
+  QPSolver::State full(initialValues, VectorValues(),
+      solver.identifyActiveConstraints(qp.inequalities, initialValues), false,
+      0);
+
+  // Every iteration matches eliminating the whole working graph
+  while (!incremental.converged) {
+    incremental = solver.iterate(incremental);
+    full = solver.iterate(QPSolver::State(full.values, full.duals,
+        full.workingSet, false, full.iterations));
+    CHECK(assert_equal(full.values, incremental.values, 1e-9));
+    EXPECT(full.converged == incremental.converged);
+    for (size_t j = 0; j < qp.inequalities.size(); ++j)
+      EXPECT(full.workingSet[j]->active() == incremental.workingSet[j]->active());
+  }
+
+  size_t nrActive = 0;
+  for (const LinearInequality::shared_ptr& factor : incremental.workingSet)
+    if (factor->active()) nrActive++;
+  EXPECT(nrActive > 0 && nrActive < qp.inequalities.size());
+
+  // and the solution is that of a cold solve from another feasible point
+  VectorValues zero;
+  for (size_t i = 0; i < n; ++i) zero.insert(X(i), kZero);
+  VectorValues expected;
+  boost::tie(expected, boost::tuples::ignore) = solver.optimize(zero);
+  CHECK(assert_equal(expected, incremental.values, 1e-7));
+  CHECK(assert_equal(
+      solver.buildWorkingGraph(incremental.workingSet).optimize(),
+      incremental.values, 1e-9));
+}
+
 /* ************************************************************************* */
 TEST(QPSolver, failedSubproblem) {
   QP qp;
@@ -0,0 +1,311 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BoundedISAM2.cpp
+ * @brief   ISAM2 that marginalizes its oldest variables to stay within a budget
+ */
+
+#include <gtsam_unstable/nonlinear/BoundedISAM2.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/base/timing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+
+// Rough cost of the containers holding a variable (the Values, VectorValues,
+// VariableIndex and Bayes tree entries) and a factor (the object, its keys and
+// noise model, and the graph and index entries), on top of their dense blocks
+const size_t kBytesPerVariable = 512;
+const size_t kBytesPerFactor = 256;
+
+// Number of doubles in the dense blocks of a linear factor
+size_t denseSize(const GaussianFactor::shared_ptr& factor) {
+  if (const JacobianFactor* jacobian = dynamic_cast<const JacobianFactor*>(factor.get()))
+    return jacobian->matrixObject().rows() * jacobian->matrixObject().cols();
+  if (const HessianFactor* hessian = dynamic_cast<const HessianFactor*>(factor.get()))
+    return hessian->info().rows() * hessian->info().rows();
+  return 0;
+}
+
+// Same for the factor in slot index, if the linearized factors are cached
+size_t denseSize(const GaussianFactorGraph& factors, FactorIndex index) {
+  return index < factors.size() ? denseSize(factors[index]) : 0;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+void BoundedISAM2Params::print(const std::string& s) const {
+  cout << s << "\n";
+  cout << "maxVariables:     " << maxVariables << "\n";
+  cout << "maxBytes:         " << maxBytes << "\n";
+  cout << "lowWaterMark:     " << lowWaterMark << "\n";
+  cout << "isMarginalizable: " << (isMarginalizable ? "{predicate}" : "{all}") << "\n";
+  cout.flush();
+}
+
+/* ************************************************************************* */
+static ISAM2Params reuseFactorSlots(ISAM2Params params) {
+  params.findUnusedFactorSlots = true;
+  return params;
+}
+
+/* ************************************************************************* */
+BoundedISAM2::BoundedISAM2(const BoundedISAM2Params& bounds, const ISAM2Params& params) :
+    ISAM2(reuseFactorSlots(params)), bounds_(bounds), groups_(FastMap<Key, int>()),
+    nrVariables_(0), nrFactors_(0), variableDoubles_(0), factorDoubles_(0),
+    cliqueDoubles_(0) {
+  if (!(bounds_.lowWaterMark > 0.0 && bounds_.lowWaterMark <= 1.0))
+    throw invalid_argument("BoundedISAM2: lowWaterMark has to be in (0, 1]");
+}
+
+/* ************************************************************************* */
+ISAM2Result BoundedISAM2::update(const NonlinearFactorGraph& newFactors,
+    const Values& newTheta, const FactorIndices& removeFactorIndices,
+    const boost::optional<FastMap<Key, int> >& constrainedKeys,
+    const boost::optional<FastList<Key> >& noRelinKeys,
+    const boost::optional<FastList<Key> >& extraReelimKeys,
+    bool force_relinearize) {
+  gttic(BoundedISAM2_update);
+
+  // Catch up with variables marginalized or removed through ISAM2 directly
+  if (theta_.size() != nrVariables_)
+    recount();
+
+  // The new variables are the youngest
+  for (const Values::ConstKeyValuePair& key_value : newTheta) {
+    if (!bounds_.isMarginalizable || bounds_.isMarginalizable(key_value.key))
+      keysByAge_.push_back(key_value.key);
+    groups_->emplace(key_value.key, 1);
+  }
+
+  const KeySet observedKeys = newFactors.keys();
+  marginalizedKeys_ = selectMarginalizableKeys(newTheta, observedKeys);
+  marginalFactorsIndices_.clear();
+  deletedFactorsIndices_.clear();
+
+  for (FactorIndex index : removeFactorIndices) {
+    if (index < nonlinearFactors_.size() && nonlinearFactors_[index]) {
+      --nrFactors_;
+      factorDoubles_ -= denseSize(linearFactors_, index);
+    }
+  }
+
+  ISAM2Result result;
+  if (marginalizedKeys_.empty()) {
+    result = ISAM2::update(newFactors, newTheta, removeFactorIndices,
+        constrainedKeys, noRelinKeys, extraReelimKeys, force_relinearize);
+  } else {
+    // Eliminate the marginalized variables first. The other groups are shifted
+    // by one and, as in ISAM2, the observed variables go last by default. Only
+    // the groups changed here are reset after the update.
+    KeyVector shiftedKeys;
+    if (constrainedKeys) {
+      for (const FastMap<Key, int>::value_type& key_group : *constrainedKeys) {
+        (*groups_)[key_group.first] = key_group.second + 1;
+        shiftedKeys.push_back(key_group.first);
+      }
+    } else {
+      for (Key key : observedKeys)
+        (*groups_)[key] = 2;
+      shiftedKeys.assign(observedKeys.begin(), observedKeys.end());
+    }
+    for (Key key : marginalizedKeys_)
+      (*groups_)[key] = 0;
+
+    // Re-eliminate the marginalized variables and the cliques below them, so
+    // that they end up as leaves
+    KeySet additionalKeys(marginalizedKeys_.begin(), marginalizedKeys_.end());
+    for (Key key : marginalizedKeys_)
+      (*this)[key]->findAllWithParent(key, &additionalKeys);
+    FastList<Key> reelimKeys(additionalKeys.begin(), additionalKeys.end());
+    if (extraReelimKeys)
+      reelimKeys.insert(reelimKeys.end(), extraReelimKeys->begin(), extraReelimKeys->end());
+
+    result = ISAM2::update(newFactors, newTheta, removeFactorIndices, groups_,
+        noRelinKeys, reelimKeys, force_relinearize);
+
+    for (Key key : shiftedKeys) {
+      if (theta_.exists(key))
+        (*groups_)[key] = 1;
+      else
+        groups_->erase(key);
+    }
+  }
+
+  // Count the new variables and factors, and the cliques that were replaced
+  nrVariables_ += newTheta.size();
+  for (const Values::ConstKeyValuePair& key_value : newTheta)
+    variableDoubles_ += 4 * key_value.value.dim();
+  for (FactorIndex index : result.newFactorsIndices) {
+    if (nonlinearFactors_[index]) {
+      ++nrFactors_;
+      factorDoubles_ += denseSize(linearFactors_, index);
+    }
+  }
+  for (const sharedClique& root : roots())
+    countNewCliques(root);
+  // Variables left without factors were removed
+  if (theta_.size() != nrVariables_)
+    recount();
+
+  if (marginalizedKeys_.empty())
+    return result;
+
+  gttic(marginalize);
+  // Stop counting the marginalized variables, their factors and their cliques.
+  // The cliques that keep some of their variables are counted again after.
+  FactorIndexSet factorIndices;
+  vector<sharedClique> cliques;
+  for (Key key : marginalizedKeys_) {
+    variableDoubles_ -= 4 * delta_.at(key).size();
+    const VariableIndex::Factors& involved = variableIndex_[key];
+    factorIndices.insert(involved.begin(), involved.end());
+    const sharedClique& clique = (*this)[key];
+    if (clique->conditional()->front() == key) {
+      uncountClique(key);
+      cliques.push_back(clique);
+    }
+  }
+  for (FactorIndex index : factorIndices) {
+    if (nonlinearFactors_[index]) {
+      --nrFactors_;
+      factorDoubles_ -= denseSize(linearFactors_, index);
+    }
+  }
+
+  const FastList<Key> leafKeys(marginalizedKeys_.begin(), marginalizedKeys_.end());
+  marginalizeLeaves(leafKeys, marginalFactorsIndices_, deletedFactorsIndices_);
+
+  nrVariables_ -= marginalizedKeys_.size();
+  for (Key key : marginalizedKeys_)
+    groups_->erase(key);
+  for (FactorIndex index : marginalFactorsIndices_) {
+    ++nrFactors_;
+    factorDoubles_ += denseSize(linearFactors_, index);
+  }
+  for (const sharedClique& clique : cliques) {
+    const Nodes::const_iterator node = nodes().find(clique->conditional()->front());
+    if (node != nodes().end() && node->second == clique)
+      countNewCliques(clique);
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+KeyVector BoundedISAM2::selectMarginalizableKeys(const Values& newTheta,
+    const KeySet& observedKeys) {
+  const size_t nrVariables = theta_.size() + newTheta.size();
+  size_t excess = 0;
+  if (bounds_.maxVariables > 0 && nrVariables > bounds_.maxVariables)
+    excess = nrVariables - size_t(bounds_.lowWaterMark * bounds_.maxVariables);
+  if (bounds_.maxBytes > 0 && !theta_.empty()) {
+    // The new variables are assumed to be as large as the average one
+    const double bytesPerVariable = double(estimateBytes()) / theta_.size();
+    const double bytes = bytesPerVariable * nrVariables;
+    if (bytes > bounds_.maxBytes)
+      excess = std::max(excess, size_t(ceil(
+          (bytes - bounds_.lowWaterMark * bounds_.maxBytes) / bytesPerVariable)));
+  }
+
+  KeyVector keys;
+  list<Key>::iterator it = keysByAge_.begin();
+  while (it != keysByAge_.end() && keys.size() < excess) {
+    if (!theta_.exists(*it)) {
+      if (newTheta.exists(*it))
+        break; // only the new variables are left
+      it = keysByAge_.erase(it); // marginalized by a direct call to marginalizeLeaves
+    } else if (observedKeys.exists(*it)) {
+      ++it;
+    } else {
+      keys.push_back(*it);
+      it = keysByAge_.erase(it);
+    }
+  }
+  return keys;
+}
+
+/* ************************************************************************* */
+size_t BoundedISAM2::estimateBytes() const {
+  // Linearization point, delta, deltaNewton and RgProd, conditionals and cached
+  // factors, and cached linearized factors
+  const size_t doubles = variableDoubles_ + cliqueDoubles_ + factorDoubles_;
+  return doubles * sizeof(double) + nrVariables_ * kBytesPerVariable
+      + nrFactors_ * kBytesPerFactor
+      + nonlinearFactors_.size() * sizeof(NonlinearFactor::shared_ptr);
+}
+
+/* ************************************************************************* */
+void BoundedISAM2::recount() {
+  gttic(recount);
+  nrVariables_ = theta_.size();
+  variableDoubles_ = 0;
+  for (const VectorValues::KeyValuePair& key_value : delta_)
+    variableDoubles_ += 4 * key_value.second.size();
+
+  nrFactors_ = nonlinearFactors_.nrFactors();
+  factorDoubles_ = 0;
+  for (const GaussianFactor::shared_ptr& factor : linearFactors_)
+    factorDoubles_ += denseSize(factor);
+
+  cliqueSizes_.clear();
+  cliqueDoubles_ = 0;
+  for (const sharedClique& root : roots())
+    countNewCliques(root);
+
+  groups_->clear();
+  for (const Values::ConstKeyValuePair& key_value : theta_)
+    groups_->emplace_hint(groups_->end(), key_value.key, 1);
+}
+
+/* ************************************************************************* */
+void BoundedISAM2::countNewCliques(const sharedClique& clique) {
+  // ISAM2 only replaces the top of the tree, so the cliques below a counted
+  // one are counted as well
+  const GaussianConditional& conditional = *clique->conditional();
+  const Key front = conditional.front();
+  const auto counted = cliqueSizes_.find(front);
+  if (counted != cliqueSizes_.end() && counted->second.first.lock() == clique)
+    return;
+
+  // The cliques this one replaced had their first variable among its frontals
+  for (Key key : conditional.frontals())
+    uncountClique(key);
+  const VerticalBlockMatrix& Ab = conditional.matrixObject();
+  const size_t size = Ab.rows() * Ab.cols() + denseSize(clique->cachedFactor_);
+  cliqueSizes_[front] = make_pair(boost::weak_ptr<ISAM2Clique>(clique), size);
+  cliqueDoubles_ += size;
+
+  for (const sharedClique& child : clique->children)
+    countNewCliques(child);
+}
+
+/* ************************************************************************* */
+void BoundedISAM2::uncountClique(Key key) {
+  const auto counted = cliqueSizes_.find(key);
+  if (counted != cliqueSizes_.end()) {
+    cliqueDoubles_ -= counted->second.second;
+    cliqueSizes_.erase(counted);
+  }
+}
+
+}  // namespace gtsam
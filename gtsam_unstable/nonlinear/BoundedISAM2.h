@@ -0,0 +1,138 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BoundedISAM2.h
+ * @brief   ISAM2 that marginalizes its oldest variables to stay within a budget
+ */
+
+#pragma once
+
+#include <gtsam_unstable/base/dllexport.h>
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <functional>
+#include <list>
+#include <utility>
+
+namespace gtsam {
+
+/// Budget of a BoundedISAM2, zero limits are disabled
+struct GTSAM_UNSTABLE_EXPORT BoundedISAM2Params {
+  /// Decides, when a variable is added, whether it may ever be marginalized
+  typedef std::function<bool(Key)> KeyPredicate;
+
+  size_t maxVariables; ///< Marginalize the oldest variables beyond this many (default: 0, no limit)
+  size_t maxBytes; ///< Marginalize the oldest variables while estimateBytes() is above this (default: 0, no limit)
+  double lowWaterMark; ///< Once over budget, marginalize down to this fraction of it (default: 1.0)
+  KeyPredicate isMarginalizable; ///< Variables that may be marginalized (default: all)
+
+  BoundedISAM2Params(size_t maxVariables = 0, size_t maxBytes = 0) :
+      maxVariables(maxVariables), maxBytes(maxBytes), lowWaterMark(1.0) {}
+
+  void print(const std::string& s = "") const;
+};
+
+/**
+ * An ISAM2 whose memory stays bounded on arbitrarily long runs. Variables are
+ * remembered in the order they are added; when an update would take the
+ * number of variables (or the estimated size in bytes) over budget, the
+ * oldest marginalizable ones are picked, constrained to be eliminated first
+ * in that update, and marginalized with marginalizeLeaves right after it.
+ * The Bayes tree below them is re-eliminated as in the
+ * IncrementalFixedLagSmoother, so they are always leaves.
+ *
+ * Variables touched by the new factors of an update are not marginalized in
+ * that update. Once a variable is marginalized it may not appear in later
+ * factors, so landmarks that can be re-observed should be excluded with
+ * BoundedISAM2Params::isMarginalizable. Marginalization fixes the
+ * linearization point of the variables next to the marginalized ones.
+ *
+ * Unused factor slots are always reused, and with
+ * ISAM2Params::maxFactorSlotMoves the factor graph is compacted as well, so
+ * the factor indices do not grow either.
+ */
+class GTSAM_UNSTABLE_EXPORT BoundedISAM2 : public ISAM2 {
+public:
+  typedef boost::shared_ptr<BoundedISAM2> shared_ptr;
+
+  BoundedISAM2(const BoundedISAM2Params& bounds = BoundedISAM2Params(),
+      const ISAM2Params& params = ISAM2Params());
+
+  virtual ~BoundedISAM2() {}
+
+  /**
+   * ISAM2::update, then marginalize the oldest variables if over budget.
+   * constrainedKeys, if given, keeps its meaning for the variables that are
+   * not marginalized.
+   */
+  virtual ISAM2Result update(
+      const NonlinearFactorGraph& newFactors = NonlinearFactorGraph(),
+      const Values& newTheta = Values(),
+      const FactorIndices& removeFactorIndices = FactorIndices(),
+      const boost::optional<FastMap<Key, int> >& constrainedKeys = boost::none,
+      const boost::optional<FastList<Key> >& noRelinKeys = boost::none,
+      const boost::optional<FastList<Key> >& extraReelimKeys = boost::none,
+      bool force_relinearize = false) override;
+
+  /**
+   * Rough size in bytes of the linearization point, the deltas, the Bayes
+   * tree and the factors. Dense blocks are counted exactly, the containers
+   * holding them with a fixed overhead per variable and per factor. This is a
+   * running total kept by update() in time proportional to the size of each
+   * update; variables marginalized or removed through ISAM2 directly are
+   * accounted for at the next update.
+   */
+  size_t estimateBytes() const;
+
+  /// The budget
+  const BoundedISAM2Params& bounds() const { return bounds_; }
+
+  /// Variables marginalized by the last update
+  const KeyVector& marginalizedKeys() const { return marginalizedKeys_; }
+
+  /// Indices of the marginal factors added by the last update
+  const FactorIndices& marginalFactorsIndices() const { return marginalFactorsIndices_; }
+
+  /// Indices of the factors removed by the marginalization in the last update
+  const FactorIndices& deletedFactorsIndices() const { return deletedFactorsIndices_; }
+
+protected:
+  BoundedISAM2Params bounds_;
+  std::list<Key> keysByAge_; ///< Marginalizable variables, oldest first
+  KeyVector marginalizedKeys_;
+  FactorIndices marginalFactorsIndices_, deletedFactorsIndices_;
+
+  /// Ordering group of every variable, 1 except while an update marginalizes
+  boost::optional<FastMap<Key, int> > groups_;
+
+  // Running totals behind estimateBytes()
+  size_t nrVariables_, nrFactors_;
+  size_t variableDoubles_, factorDoubles_, cliqueDoubles_;
+  /// Every clique and its dense size, by its first frontal variable
+  FastMap<Key, std::pair<boost::weak_ptr<ISAM2Clique>, size_t> > cliqueSizes_;
+
+  /// Oldest variables to marginalize so that the budget holds after adding newTheta
+  KeyVector selectMarginalizableKeys(const Values& newTheta, const KeySet& observedKeys);
+
+  /// Recompute the running totals and the ordering groups from scratch
+  void recount();
+
+  /// Count clique and the cliques below it that are not counted yet
+  void countNewCliques(const sharedClique& clique);
+
+  /// Stop counting the clique whose first frontal variable is key, if any
+  void uncountClique(Key key);
+};
+
+}  // namespace gtsam
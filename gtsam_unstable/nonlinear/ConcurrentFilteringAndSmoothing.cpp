@@ -22,6 +22,8 @@
 #include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothing.h>
 #include <gtsam/nonlinear/LinearContainerFactor.h>
 
+#include <stdexcept>
+
 namespace gtsam {
 
 /* ************************************************************************* */
@@ -48,6 +50,93 @@ void synchronize(ConcurrentFilter& filter, ConcurrentSmoother& smoother) {
   smoother.postsync();
 }
 
+/* ************************************************************************* */
+ConcurrentSynchronizationQueue::ConcurrentSynchronizationQueue(size_t capacity) :
+    slots_(capacity + 1), head_(0), tail_(0) {
+  if(capacity == 0)
+    throw std::invalid_argument("ConcurrentSynchronizationQueue: capacity must be at least 1");
+}
+
+/* ************************************************************************* */
+bool ConcurrentSynchronizationQueue::push(const Packet::shared_ptr& packet) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t next = (tail + 1) % slots_.size();
+  if(next == head_.load(std::memory_order_acquire))
+    return false;
+  slots_[tail] = packet;
+  tail_.store(next, std::memory_order_release);
+  return true;
+}
+
+/* ************************************************************************* */
+ConcurrentSynchronizationQueue::Packet::shared_ptr ConcurrentSynchronizationQueue::pop() {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if(head == tail_.load(std::memory_order_acquire))
+    return Packet::shared_ptr();
+  Packet::shared_ptr packet;
+  packet.swap(slots_[head]);
+  head_.store((head + 1) % slots_.size(), std::memory_order_release);
+  return packet;
+}
+
+/* ************************************************************************* */
+bool ConcurrentSynchronizationQueue::empty() const {
+  return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+/* ************************************************************************* */
+bool ConcurrentSynchronizer::filterSynchronize(ConcurrentFilter& filter) {
+
+  // Nothing to do until the smoother has published its summarization
+  ConcurrentSynchronizationPacket::shared_ptr smootherPacket = smootherToFilter_.pop();
+  if(!smootherPacket)
+    return false;
+
+  ConcurrentSynchronizationPacket::shared_ptr filterPacket = boost::make_shared<ConcurrentSynchronizationPacket>();
+  filterPacket->version = smootherPacket->version;
+
+  // Apply the smoother updates to the filter, and collect the filter updates for the smoother
+  filter.presync();
+  filter.synchronize(smootherPacket->summarizedFactors, smootherPacket->separatorValues);
+  filter.getSmootherFactors(filterPacket->smootherFactors, filterPacket->smootherValues);
+  filter.getSummarizedFactors(filterPacket->summarizedFactors, filterPacket->separatorValues);
+  filter.postsync();
+
+  // The smoother never has more than one packet in flight, so this cannot fail
+  if(!filterToSmoother_.push(filterPacket))
+    throw std::runtime_error("ConcurrentSynchronizer: filter packet queue overflow");
+
+  return true;
+}
+
+/* ************************************************************************* */
+bool ConcurrentSynchronizer::smootherSynchronize(ConcurrentSmoother& smoother) {
+
+  // Publish the smoother summarization if the filter is not already working on one
+  if(!awaitingFilter_) {
+    ConcurrentSynchronizationPacket::shared_ptr smootherPacket = boost::make_shared<ConcurrentSynchronizationPacket>();
+    smootherPacket->version = version_ + 1;
+    smoother.presync();
+    smoother.getSummarizedFactors(smootherPacket->summarizedFactors, smootherPacket->separatorValues);
+    smootherToFilter_.push(smootherPacket);
+    awaitingFilter_ = true;
+  }
+
+  // Apply the filter updates if they are available
+  ConcurrentSynchronizationPacket::shared_ptr filterPacket = filterToSmoother_.pop();
+  if(!filterPacket)
+    return false;
+
+  assert(filterPacket->version == version_ + 1);
+  smoother.synchronize(filterPacket->smootherFactors, filterPacket->smootherValues,
+      filterPacket->summarizedFactors, filterPacket->separatorValues);
+  smoother.postsync();
+
+  awaitingFilter_ = false;
+  ++version_;
+  return true;
+}
+
 namespace internal {
 
 /* ************************************************************************* */
@@ -25,6 +25,9 @@
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 
+#include <atomic>
+#include <vector>
+
 namespace gtsam {
 
 // Forward declare the Filter and Smoother classes for the 'synchronize' function
@@ -147,6 +150,102 @@ public:
 
 }; // ConcurrentSmoother
 
+/**
+ * A single batch of synchronization data passed between the filter and the smoother. Packets
+ * travelling from the smoother to the filter only carry the smoother summarization
+ * (summarizedFactors/separatorValues); packets travelling from the filter to the smoother carry
+ * the new smoother factors as well as the updated filter summarization.
+ */
+struct GTSAM_UNSTABLE_EXPORT ConcurrentSynchronizationPacket {
+  typedef boost::shared_ptr<ConcurrentSynchronizationPacket> shared_ptr;
+
+  size_t version; ///< The synchronization round this packet belongs to
+  NonlinearFactorGraph smootherFactors; ///< New factors sent from the filter to the smoother
+  Values smootherValues; ///< Linearization points of any new smoother variables
+  NonlinearFactorGraph summarizedFactors; ///< The filter or smoother branch summarization
+  Values separatorValues; ///< Linearization points of the separator variables
+
+  /** Default constructor */
+  ConcurrentSynchronizationPacket() : version(0) {}
+};
+
+/**
+ * A bounded, lock-free, single-producer/single-consumer queue of synchronization packets.
+ * Exactly one thread may call push() and exactly one (other) thread may call pop().
+ */
+class GTSAM_UNSTABLE_EXPORT ConcurrentSynchronizationQueue {
+public:
+  typedef ConcurrentSynchronizationPacket Packet;
+
+  /** Construct a queue able to hold up to 'capacity' packets */
+  explicit ConcurrentSynchronizationQueue(size_t capacity = 2);
+
+  /** Append a packet to the queue. Returns false, without blocking, if the queue is full. */
+  bool push(const Packet::shared_ptr& packet);
+
+  /** Remove the oldest packet from the queue. Returns a null pointer, without blocking, if the queue is empty. */
+  Packet::shared_ptr pop();
+
+  /** Check if the queue currently holds no packets */
+  bool empty() const;
+
+  /** The maximum number of packets held by the queue */
+  size_t capacity() const { return slots_.size() - 1; }
+
+private:
+  std::vector<Packet::shared_ptr> slots_; ///< Ring buffer storage, with one slot always kept free
+  std::atomic<size_t> head_; ///< Index of the next packet to pop, only written by the consumer
+  std::atomic<size_t> tail_; ///< Index of the next free slot, only written by the producer
+
+  // Non-copyable
+  ConcurrentSynchronizationQueue(const ConcurrentSynchronizationQueue&);
+  ConcurrentSynchronizationQueue& operator=(const ConcurrentSynchronizationQueue&);
+};
+
+/**
+ * An asynchronous replacement for the 'synchronize' function, for use when the filter and the
+ * smoother run in separate threads. The synchronization is split into a filter half and a
+ * smoother half that exchange packets through two lock-free queues, so neither side ever waits
+ * on the other. The filter thread calls filterSynchronize() between its updates, and the
+ * smoother thread calls smootherSynchronize() after each of its updates. The order of the
+ * filter and smoother calls is identical to that of 'synchronize', so the resulting estimates
+ * are the same as those of a blocking synchronization at the same points.
+ */
+class GTSAM_UNSTABLE_EXPORT ConcurrentSynchronizer {
+public:
+  typedef boost::shared_ptr<ConcurrentSynchronizer> shared_ptr;
+
+  /** Default constructor */
+  ConcurrentSynchronizer() : smootherToFilter_(1), filterToSmoother_(1), version_(0), awaitingFilter_(false) {}
+
+  /**
+   * Filter half of the synchronization, to be called from the filter thread only. If the smoother
+   * has published its summarization, apply it to the filter and send the filter updates back to
+   * the smoother. Never blocks.
+   *
+   * @return true if a smoother packet was consumed
+   */
+  bool filterSynchronize(ConcurrentFilter& filter);
+
+  /**
+   * Smoother half of the synchronization, to be called from the smoother thread only. Publishes
+   * the current smoother summarization if none is in flight, and applies the filter updates once
+   * the filter has answered. Never blocks.
+   *
+   * @return true if a full synchronization round was completed by this call
+   */
+  bool smootherSynchronize(ConcurrentSmoother& smoother);
+
+  /** The number of completed synchronization rounds, as seen by the smoother thread */
+  size_t version() const { return version_; }
+
+private:
+  ConcurrentSynchronizationQueue smootherToFilter_; ///< Smoother summarization packets
+  ConcurrentSynchronizationQueue filterToSmoother_; ///< New smoother factors and filter summarization packets
+  size_t version_; ///< Completed rounds, only accessed by the smoother thread
+  bool awaitingFilter_; ///< Whether a smoother packet is in flight, only accessed by the smoother thread
+};
+
 namespace internal {
 
   /** Calculate the marginal on the specified keys, returning a set of LinearContainerFactors.
@@ -91,7 +91,7 @@ ConcurrentIncrementalFilter::Result ConcurrentIncrementalFilter::update(const No
   // Mark additional keys between the 'keys to move' and the leaves
   boost::optional<FastList<Key> > additionalKeys = boost::none;
   if(keysToMove && keysToMove->size() > 0) {
-    std::set<Key> markedKeys;
+    KeySet markedKeys;
     for(Key key: *keysToMove) {
       if(isam2_.getLinearizationPoint().exists(key)) {
         ISAM2Clique::shared_ptr clique = isam2_[key];
@@ -100,9 +100,7 @@ ConcurrentIncrementalFilter::Result ConcurrentIncrementalFilter::update(const No
           markedKeys.insert(*key_iter);
           ++key_iter;
         }
-        for(const ISAM2Clique::shared_ptr& child: clique->children) {
-          RecursiveMarkAffectedKeys(key, child, markedKeys);
-        }
+        clique->findAllWithParent(key, &markedKeys);
       }
     }
     additionalKeys = FastList<Key>(markedKeys.begin(), markedKeys.end());
@@ -264,26 +262,6 @@ void ConcurrentIncrementalFilter::postsync() {
 }
 
 
-/* ************************************************************************* */
-void ConcurrentIncrementalFilter::RecursiveMarkAffectedKeys(const Key& key, const ISAM2Clique::shared_ptr& clique, std::set<Key>& additionalKeys) {
-
-  // Check if the separator keys of the current clique contain the specified key
-  if(std::find(clique->conditional()->beginParents(), clique->conditional()->endParents(), key) != clique->conditional()->endParents()) {
-
-    // Mark the frontal keys of the current clique
-    for(Key idx: clique->conditional()->frontals()) {
-      additionalKeys.insert(idx);
-    }
-
-    // Recursively mark all of the children
-    for(const ISAM2Clique::shared_ptr& child: clique->children) {
-      RecursiveMarkAffectedKeys(key, child, additionalKeys);
-    }
-  }
-  // If the key was not found in the separator/parents, then none of its children can have it either
-
-}
-
 /* ************************************************************************* */
 FactorIndices ConcurrentIncrementalFilter::FindAdjacentFactors(const ISAM2& isam2, const FastList<Key>& keys, const FactorIndices& factorsToIgnore) {
 
@@ -0,0 +1,229 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    DistributedOptimizer.cpp
+ * @brief   Optimize a multi-robot graph with one agent per robot that exchange separator marginals
+ */
+
+#include <gtsam_unstable/nonlinear/DistributedOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/LinearContainerFactor.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+DistributedAgent::DistributedAgent(size_t id, const NonlinearFactorGraph& factors,
+    const Values& initial, const KeySet& ownedKeys, const Separators& separators) :
+    id_(id), factors_(factors), ownedKeys_(ownedKeys), separators_(separators) {
+  KeySet keys = factors_.keys();
+  keys.insert(ownedKeys_.begin(), ownedKeys_.end());
+  for (const Separators::value_type& neighbor_keys : separators_)
+    keys.insert(neighbor_keys.second.begin(), neighbor_keys.second.end());
+  for (Key key : keys)
+    estimate_.insert(key, initial.at(key));
+}
+
+/* ************************************************************************* */
+Values DistributedAgent::ownedEstimate() const {
+  Values owned;
+  for (Key key : ownedKeys_)
+    owned.insert(key, estimate_.at(key));
+  return owned;
+}
+
+/* ************************************************************************* */
+void DistributedAgent::sendMessages(DistributedTransport& transport, size_t round) const {
+  gttic(DistributedAgent_sendMessages);
+  const GaussianFactorGraph::shared_ptr local = factors_.linearize(estimate_);
+  for (const Separators::value_type& neighbor_keys : separators_) {
+    const size_t neighbor = neighbor_keys.first;
+
+    // Local factors and what the other neighbors said, not what this one said
+    GaussianFactorGraph graph = *local;
+    for (const pair<const size_t, DistributedMessage>& from_message : received_)
+      if (from_message.first != neighbor)
+        graph.push_back(*from_message.second.marginal.linearize(estimate_));
+
+    // Marginalize out everything but the shared variables
+    const KeySet separator(neighbor_keys.second.begin(), neighbor_keys.second.end());
+    KeyVector interior;
+    for (Key key : graph.keys())
+      if (!separator.exists(key))
+        interior.push_back(key);
+    const GaussianFactorGraph marginal = interior.empty() ? graph
+        : *graph.eliminatePartialSequential(interior).second;
+
+    Values linearizationPoint;
+    for (Key key : separator)
+      linearizationPoint.insert(key, estimate_.at(key));
+    DistributedMessage message(id_, neighbor, round);
+    for (const GaussianFactor::shared_ptr& factor : marginal)
+      if (factor && !factor->empty())
+        message.marginal.push_back(
+            boost::make_shared<LinearContainerFactor>(factor, linearizationPoint));
+    transport.send(message);
+  }
+}
+
+/* ************************************************************************* */
+void DistributedAgent::receiveMessages(DistributedTransport& transport) {
+  for (const DistributedMessage& message : transport.receive(id_)) {
+    const map<size_t, DistributedMessage>::iterator previous = received_.find(message.from);
+    if (previous == received_.end())
+      received_.insert(make_pair(message.from, message));
+    else if (previous->second.round <= message.round)
+      previous->second = message;
+  }
+}
+
+/* ************************************************************************* */
+double DistributedAgent::solve(const LevenbergMarquardtParams& params) {
+  gttic(DistributedAgent_solve);
+  NonlinearFactorGraph graph = factors_;
+  for (const pair<const size_t, DistributedMessage>& from_message : received_)
+    graph.push_back(from_message.second.marginal);
+
+  // Variables without any factor yet stay where they are
+  Values initial;
+  for (Key key : graph.keys())
+    initial.insert(key, estimate_.at(key));
+  if (initial.empty())
+    return 0.0;
+
+  const Values result = LevenbergMarquardtOptimizer(graph, initial, params).optimize();
+  double change = 0.0;
+  for (const VectorValues::KeyValuePair& key_delta : initial.localCoordinates(result))
+    change = std::max(change, key_delta.second.lpNorm<Eigen::Infinity>());
+  estimate_.update(result);
+  return change;
+}
+
+/* ************************************************************************* */
+DistributedOptimizer::DistributedOptimizer(const NonlinearFactorGraph& graph,
+    const Values& initial, const DistributedOptimizerParams& params,
+    const DistributedTransport::shared_ptr& transport) :
+    params_(params), transport_(transport), diameter_(0), iterations_(0) {
+  if (!transport_)
+    transport_ = boost::make_shared<InProcessTransport>();
+
+  // Number the agents in the order of their labels
+  map<Key, size_t> agentOfLabel;
+  for (const Values::ConstKeyValuePair& key_value : initial)
+    agentOfLabel.insert(make_pair(params_.partition(key_value.key), 0));
+  for (map<Key, size_t>::value_type& label_agent : agentOfLabel) {
+    label_agent.second = labels_.size();
+    labels_.push_back(label_agent.first);
+  }
+  const size_t nrAgents = labels_.size();
+  auto ownerOf = [&](Key key) {
+    if (!initial.exists(key))
+      throw invalid_argument("DistributedOptimizer: a factor involves a variable without initial value");
+    return agentOfLabel.at(params_.partition(key));
+  };
+
+  // Every factor goes to the agent with the smallest label among its variables
+  vector<NonlinearFactorGraph> factors(nrAgents);
+  vector<KeySet> ownedKeys(nrAgents);
+  vector<DistributedAgent::Separators> separators(nrAgents);
+  for (const Values::ConstKeyValuePair& key_value : initial)
+    ownedKeys[ownerOf(key_value.key)].insert(key_value.key);
+  vector<KeySet> copies(nrAgents);
+  for (const NonlinearFactor::shared_ptr& factor : graph) {
+    if (!factor) continue;
+    size_t holder = nrAgents;
+    for (Key key : factor->keys())
+      holder = std::min(holder, ownerOf(key));
+    if (holder == nrAgents) continue; // a factor without variables
+    factors[holder].push_back(factor);
+    for (Key key : factor->keys())
+      if (ownerOf(key) != holder)
+        copies[holder].insert(key);
+  }
+
+  // A copy is shared with the owner of the variable only
+  for (size_t agent = 0; agent < nrAgents; agent++) {
+    for (Key key : copies[agent]) {
+      const size_t owner = ownerOf(key);
+      separators[agent][owner].push_back(key);
+      separators[owner][agent].push_back(key);
+    }
+  }
+
+  agents_.reserve(nrAgents);
+  for (size_t agent = 0; agent < nrAgents; agent++)
+    agents_.push_back(DistributedAgent(agent, factors[agent], initial,
+        ownedKeys[agent], separators[agent]));
+
+  // Longest shortest path between two agents, within their connected component
+  for (size_t source = 0; source < nrAgents; source++) {
+    vector<size_t> distance(nrAgents, nrAgents);
+    deque<size_t> queue(1, source);
+    distance[source] = 0;
+    while (!queue.empty()) {
+      const size_t agent = queue.front();
+      queue.pop_front();
+      diameter_ = std::max(diameter_, distance[agent]);
+      for (const DistributedAgent::Separators::value_type& neighbor_keys : separators[agent]) {
+        if (distance[neighbor_keys.first] == nrAgents) {
+          distance[neighbor_keys.first] = distance[agent] + 1;
+          queue.push_back(neighbor_keys.first);
+        }
+      }
+    }
+  }
+}
+
+/* ************************************************************************* */
+double DistributedOptimizer::iterate() {
+  gttic(DistributedOptimizer_iterate);
+  const size_t round = iterations_;
+  DistributedTransport& transport = *transport_;
+  parallelFor(agents_.size(), [&](size_t i) {
+    agents_[i].sendMessages(transport, round);
+  });
+  parallelFor(agents_.size(), [&](size_t i) {
+    agents_[i].receiveMessages(transport);
+  });
+  vector<double> changes(agents_.size(), 0.0);
+  parallelFor(agents_.size(), [&](size_t i) {
+    changes[i] = agents_[i].solve(params_.localParams);
+  });
+  ++iterations_;
+  return changes.empty() ? 0.0 : *max_element(changes.begin(), changes.end());
+}
+
+/* ************************************************************************* */
+Values DistributedOptimizer::optimize() {
+  gttic(DistributedOptimizer_optimize);
+  while (iterations_ < params_.maxIterations) {
+    const double change = iterate();
+    if (change < params_.tolerance && iterations_ > diameter_)
+      break;
+  }
+  Values result;
+  for (const DistributedAgent& agent : agents_)
+    result.insert(agent.ownedEstimate());
+  return result;
+}
+
+}  // namespace gtsam
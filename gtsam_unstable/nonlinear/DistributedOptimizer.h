@@ -0,0 +1,171 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    DistributedOptimizer.h
+ * @brief   Optimize a multi-robot graph with one agent per robot that exchange separator marginals
+ */
+
+#pragma once
+
+#include <gtsam_unstable/nonlinear/DistributedTransport.h>
+#include <gtsam/nonlinear/LevenbergMarquardtParams.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/inference/LabeledSymbol.h>
+#include <gtsam/inference/Symbol.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace gtsam {
+
+/// Parameters for DistributedOptimizer
+struct GTSAM_UNSTABLE_EXPORT DistributedOptimizerParams {
+  /// Label of the agent that owns a variable, e.g., the robot in its key
+  typedef std::function<Key(Key)> Partition;
+
+  Partition partition; ///< Which agent owns which variable (default: SymbolChr)
+  LevenbergMarquardtParams localParams; ///< Parameters of the local solves
+  size_t maxIterations; ///< Maximum number of rounds (default: 100)
+  double tolerance; ///< Stop when no estimate moves more than this in a round, in local coordinates (default: 1e-6)
+
+  DistributedOptimizerParams() :
+      partition(&SymbolChr), maxIterations(100), tolerance(1e-6) {}
+
+  /// One agent per Symbol character, for keys like Symbol('a', j), Symbol('b', j)
+  static Key SymbolChr(Key key) { return Symbol(key).chr(); }
+
+  /// One agent per LabeledSymbol label, for keys like LabeledSymbol('x', 'A', j)
+  static Key LabeledSymbolLabel(Key key) { return LabeledSymbol(key).label(); }
+};
+
+/**
+ * One partition of a DistributedOptimizer, e.g., a robot. An agent holds the
+ * factors on its own variables and some of the factors that connect it to
+ * other agents, and an estimate of all the variables they involve.
+ *
+ * Every variable is shared between its owner and the agents that hold a copy
+ * of it, and only along these edges, so that the information about a variable
+ * never goes around a loop of agents. A round consists of sendMessages(),
+ * receiveMessages() and solve(). An agent only talks to its neighbors through
+ * a DistributedTransport, so agents can just as well live in separate
+ * processes.
+ */
+class GTSAM_UNSTABLE_EXPORT DistributedAgent {
+public:
+  /// The variables an agent shares with each neighbor
+  typedef std::map<size_t, KeyVector> Separators;
+
+  /**
+   * @param id index of this agent, used to address messages
+   * @param factors factors held by this agent
+   * @param initial initial estimate of all variables involved in factors
+   * @param ownedKeys variables whose estimate this agent is responsible for
+   * @param separators for every neighbor, the variables shared with it
+   */
+  DistributedAgent(size_t id, const NonlinearFactorGraph& factors,
+      const Values& initial, const KeySet& ownedKeys, const Separators& separators);
+
+  size_t id() const { return id_; }
+  const NonlinearFactorGraph& factors() const { return factors_; }
+  const Separators& separators() const { return separators_; }
+
+  /// Current estimate of all variables of this agent, including the copies
+  const Values& estimate() const { return estimate_; }
+
+  /// Current estimate of the variables this agent owns
+  Values ownedEstimate() const;
+
+  /**
+   * Send every neighbor the marginal, on the variables shared with it, of the
+   * local factors and of the last messages received from the other neighbors,
+   * linearized at the current estimate. Throws IndeterminantLinearSystemException
+   * if a part of the local graph is not constrained by a prior or a neighbor.
+   */
+  void sendMessages(DistributedTransport& transport, size_t round) const;
+
+  /// Keep the latest message received from every neighbor
+  void receiveMessages(DistributedTransport& transport);
+
+  /**
+   * Optimize the local factors together with the received marginals, starting
+   * from the current estimate.
+   * @return the largest change of a variable, in local coordinates
+   */
+  double solve(const LevenbergMarquardtParams& params);
+
+private:
+  size_t id_;
+  NonlinearFactorGraph factors_;
+  Values estimate_;
+  KeySet ownedKeys_;
+  Separators separators_;
+  std::map<size_t, DistributedMessage> received_; ///< Latest message from every neighbor
+};
+
+/**
+ * Distributed optimization of a multi-robot factor graph, in the spirit of
+ * DDF-SAM: the graph is partitioned into one DistributedAgent per robot, the
+ * agents solve their own part in parallel, and only exchange the Gaussian
+ * marginals of their information on the variables they share, as
+ * LinearContainerFactors, until the estimates stop moving.
+ *
+ * Variables are assigned to agents by DistributedOptimizerParams::partition,
+ * and every factor between agents is held by the one with the smallest label,
+ * which then keeps a copy of the other variables. The exchange is Gaussian
+ * belief propagation between the agents, relinearized in every round. When the
+ * agents form a tree and the factors are linear, the result is the centralized
+ * solution once the messages have crossed the tree; otherwise it is iterative.
+ *
+ * Every part of a robot's graph has to be connected to a prior or to another
+ * robot. The local solves run in parallel when GTSAM is built with TBB.
+ */
+class GTSAM_UNSTABLE_EXPORT DistributedOptimizer {
+public:
+  /**
+   * Partition graph among agents.
+   * @param transport how the agents exchange messages, an InProcessTransport if null
+   */
+  DistributedOptimizer(const NonlinearFactorGraph& graph, const Values& initial,
+      const DistributedOptimizerParams& params = DistributedOptimizerParams(),
+      const DistributedTransport::shared_ptr& transport = DistributedTransport::shared_ptr());
+
+  /**
+   * Run rounds until the estimates stop moving, but at least until every agent
+   * has heard from all others, and return the owners' estimates of all variables.
+   */
+  Values optimize();
+
+  /// Run a single round, returns the largest change of an estimate of any agent
+  double iterate();
+
+  /// The agents, ordered by their label
+  const std::vector<DistributedAgent>& agents() const { return agents_; }
+
+  /// The label of every agent
+  const KeyVector& labels() const { return labels_; }
+
+  /// Number of rounds run so far
+  size_t iterations() const { return iterations_; }
+
+  const DistributedOptimizerParams& params() const { return params_; }
+
+private:
+  DistributedOptimizerParams params_;
+  DistributedTransport::shared_ptr transport_;
+  KeyVector labels_;
+  std::vector<DistributedAgent> agents_;
+  size_t diameter_; ///< Rounds after which every agent has heard from all others
+  size_t iterations_;
+};
+
+}  // namespace gtsam
@@ -0,0 +1,46 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    DistributedTransport.cpp
+ * @brief   Messages between the agents of a DistributedOptimizer, and how they travel
+ */
+
+#include <gtsam_unstable/nonlinear/DistributedTransport.h>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+void InProcessTransport::send(const DistributedMessage& message) {
+  lock_guard<mutex> lock(mutex_);
+  mailboxes_[message.to].push_back(message);
+  ++nrSent_;
+}
+
+/* ************************************************************************* */
+vector<DistributedMessage> InProcessTransport::receive(size_t agent) {
+  vector<DistributedMessage> messages;
+  lock_guard<mutex> lock(mutex_);
+  const map<size_t, vector<DistributedMessage> >::iterator mailbox = mailboxes_.find(agent);
+  if (mailbox != mailboxes_.end())
+    messages.swap(mailbox->second);
+  return messages;
+}
+
+/* ************************************************************************* */
+size_t InProcessTransport::nrSent() const {
+  lock_guard<mutex> lock(mutex_);
+  return nrSent_;
+}
+
+}  // namespace gtsam
@@ -0,0 +1,82 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    DistributedTransport.h
+ * @brief   Messages between the agents of a DistributedOptimizer, and how they travel
+ */
+
+#pragma once
+
+#include <gtsam_unstable/base/dllexport.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * The summary that one agent sends to a neighbor: the marginal of everything it
+ * knows, except what it heard from that neighbor, on the variables they share.
+ * The factors are LinearContainerFactors that carry their linearization point.
+ */
+struct GTSAM_UNSTABLE_EXPORT DistributedMessage {
+  size_t from; ///< Sending agent
+  size_t to; ///< Receiving agent
+  size_t round; ///< Round of the optimization in which it was sent
+  NonlinearFactorGraph marginal; ///< Marginal on the shared variables
+
+  DistributedMessage(size_t from = 0, size_t to = 0, size_t round = 0,
+      const NonlinearFactorGraph& marginal = NonlinearFactorGraph()) :
+      from(from), to(to), round(round), marginal(marginal) {}
+};
+
+/**
+ * How messages travel between agents. Agents call send() and receive() from
+ * their own threads, so implementations have to be thread-safe. A transport
+ * between processes or machines can serialize the marginal with
+ * gtsam/base/serialization.h, LinearContainerFactor supports it.
+ */
+class GTSAM_UNSTABLE_EXPORT DistributedTransport {
+public:
+  typedef boost::shared_ptr<DistributedTransport> shared_ptr;
+
+  virtual ~DistributedTransport() {}
+
+  /// Deliver a message to agent message.to
+  virtual void send(const DistributedMessage& message) = 0;
+
+  /// The messages delivered to an agent since its last call, in the order they were sent
+  virtual std::vector<DistributedMessage> receive(size_t agent) = 0;
+};
+
+/// Transport between agents in the same process, through mailboxes guarded by a mutex
+class GTSAM_UNSTABLE_EXPORT InProcessTransport : public DistributedTransport {
+public:
+  typedef boost::shared_ptr<InProcessTransport> shared_ptr;
+
+  InProcessTransport() : nrSent_(0) {}
+
+  virtual void send(const DistributedMessage& message) override;
+  virtual std::vector<DistributedMessage> receive(size_t agent) override;
+
+  /// Total number of messages sent
+  size_t nrSent() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::map<size_t, std::vector<DistributedMessage> > mailboxes_;
+  size_t nrSent_;
+};
+
+}  // namespace gtsam
@@ -0,0 +1,276 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ISAM2Checkpoint.cpp
+ * @brief Binary checkpoint of the complete state of an ISAM2 instance
+ */
+
+#include <gtsam_unstable/nonlinear/ISAM2Checkpoint.h>
+#include <gtsam/linear/HessianFactor.h>
+
+#include <utility>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+
+const char kMagic[4] = {'G', 'T', 'S', 'C'};
+const uint8_t kVersion = 1;
+const uint32_t kNone = 0xffffffff; // no parent clique
+
+// Tags of the linear factors
+enum FactorTag { kEmpty, kJacobian, kHessian };
+
+/* ************************************************************************* */
+void writeDims(const GaussianFactor& factor, BinaryWriter& w) {
+  w.writeKeys(factor.keys());
+  for (GaussianFactor::const_iterator it = factor.begin(); it != factor.end(); ++it)
+    w.write<uint32_t>(factor.getDim(it));
+}
+
+/* ************************************************************************* */
+pair<KeyVector, vector<size_t> > readDims(BinaryReader& r) {
+  pair<KeyVector, vector<size_t> > result;
+  result.first = r.readKeys();
+  result.second.resize(result.first.size());
+  for (size_t& dim : result.second) dim = r.read<uint32_t>();
+  return result;
+}
+
+/* ************************************************************************* */
+SharedDiagonal readDiagonal(BinaryReader& r) {
+  const SharedNoiseModel model = r.readNoiseModel();
+  const SharedDiagonal diagonal = boost::dynamic_pointer_cast<noiseModel::Diagonal>(model);
+  if (model && !diagonal)
+    throw runtime_error("ISAM2Checkpoint: linear factor with a non-diagonal noise model");
+  return diagonal;
+}
+
+/* ************************************************************************* */
+void writeFactor(const GaussianFactor::shared_ptr& factor, BinaryWriter& w) {
+  if (!factor) {
+    w.write<uint8_t>(kEmpty);
+  } else if (typeid(*factor) == typeid(JacobianFactor)) {
+    const JacobianFactor& jacobian = static_cast<const JacobianFactor&>(*factor);
+    w.write<uint8_t>(kJacobian);
+    writeDims(jacobian, w);
+    w.writeMatrix(jacobian.matrixObject().full());
+    w.writeNoiseModel(jacobian.get_model());
+  } else if (typeid(*factor) == typeid(HessianFactor)) {
+    const HessianFactor& hessian = static_cast<const HessianFactor&>(*factor);
+    w.write<uint8_t>(kHessian);
+    writeDims(hessian, w);
+    w.writeMatrix(Matrix(hessian.info().selfadjointView()));
+  } else {
+    throw invalid_argument(string("ISAM2Checkpoint: unsupported linear factor type ") +
+        typeid(*factor).name());
+  }
+}
+
+/* ************************************************************************* */
+GaussianFactor::shared_ptr readFactor(BinaryReader& r) {
+  const uint8_t tag = r.read<uint8_t>();
+  if (tag == kEmpty) return GaussianFactor::shared_ptr();
+  if (tag != kJacobian && tag != kHessian)
+    throw runtime_error("ISAM2Checkpoint: unknown linear factor type");
+  const pair<KeyVector, vector<size_t> > dims = readDims(r);
+  const Matrix matrix = r.readMatrix();
+  try {
+    if (tag == kJacobian) {
+      const VerticalBlockMatrix Ab(dims.second, matrix, true);
+      return boost::make_shared<JacobianFactor>(dims.first, Ab, readDiagonal(r));
+    } else {
+      const SymmetricBlockMatrix info(dims.second, matrix, true);
+      return boost::make_shared<HessianFactor>(dims.first, info);
+    }
+  } catch (const invalid_argument& e) {
+    throw runtime_error(string("ISAM2Checkpoint: invalid linear factor: ") + e.what());
+  }
+}
+
+/* ************************************************************************* */
+void writeConditional(const GaussianConditional& conditional, BinaryWriter& w) {
+  writeDims(conditional, w);
+  w.write<uint32_t>(conditional.nrFrontals());
+  w.writeMatrix(conditional.matrixObject().full());
+  w.writeNoiseModel(conditional.get_model());
+}
+
+/* ************************************************************************* */
+GaussianConditional::shared_ptr readConditional(BinaryReader& r) {
+  const pair<KeyVector, vector<size_t> > dims = readDims(r);
+  const uint32_t nrFrontals = r.read<uint32_t>();
+  const Matrix matrix = r.readMatrix();
+  if (nrFrontals == 0 || nrFrontals > dims.first.size())
+    throw runtime_error("ISAM2Checkpoint: invalid conditional");
+  try {
+    const VerticalBlockMatrix Ab(dims.second, matrix, true);
+    return boost::make_shared<GaussianConditional>(dims.first, nrFrontals, Ab,
+        readDiagonal(r));
+  } catch (const invalid_argument& e) {
+    throw runtime_error(string("ISAM2Checkpoint: invalid conditional: ") + e.what());
+  }
+}
+
+/* ************************************************************************* */
+void writeVectorValues(const VectorValues& x, BinaryWriter& w) {
+  w.write<uint64_t>(x.size());
+  for (const VectorValues::value_type& key_value : x) {
+    w.write<Key>(key_value.first);
+    w.writeMatrix(key_value.second);
+  }
+}
+
+/* ************************************************************************* */
+VectorValues readVectorValues(BinaryReader& r) {
+  VectorValues x;
+  const uint64_t n = r.read<uint64_t>();
+  for (uint64_t k = 0; k < n; k++) {
+    const Key key = r.read<Key>();
+    x.insert(key, r.readVector());
+  }
+  return x;
+}
+
+/* ************************************************************************* */
+void writeKeySet(const KeySet& keys, BinaryWriter& w) {
+  w.writeKeys(KeyVector(keys.begin(), keys.end()));
+}
+
+/* ************************************************************************* */
+KeySet readKeySet(BinaryReader& r) {
+  const KeyVector keys = r.readKeys();
+  return KeySet(keys.begin(), keys.end());
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+string ISAM2Checkpoint::Save(const ISAM2& isam) {
+  gttic(ISAM2Checkpoint_Save);
+  BinarySnapshotTables tables;
+  string body;
+  BinaryWriter w(body, tables);
+
+  // Nonlinear factors and linearization point, with their own type tables
+  const string snapshot = serializeBinarySnapshot(isam.getFactorsUnsafe(),
+      isam.getLinearizationPoint());
+  w.write<uint64_t>(snapshot.size());
+  w.writeBytes(snapshot.data(), snapshot.size());
+
+  // Cached linear factors, one per nonlinear factor slot
+  const ISAM2::CachedState state = isam.getCachedState();
+  w.write<uint64_t>(state.linearFactors.size());
+  for (const GaussianFactor::shared_ptr& factor : state.linearFactors)
+    writeFactor(factor, w);
+
+  // Cliques in pre-order, so that a parent is always read before its children
+  typedef ISAM2::sharedClique sharedClique;
+  vector<pair<sharedClique, uint32_t> > cliques, stack;
+  for (auto root = isam.roots().rbegin(); root != isam.roots().rend(); ++root)
+    stack.emplace_back(*root, kNone);
+  while (!stack.empty()) {
+    const sharedClique clique = stack.back().first;
+    cliques.push_back(stack.back());
+    stack.pop_back();
+    for (auto child = clique->children.rbegin(); child != clique->children.rend(); ++child)
+      stack.emplace_back(*child, cliques.size() - 1);
+  }
+  w.write<uint64_t>(cliques.size());
+  for (const pair<sharedClique, uint32_t>& clique_parent : cliques) {
+    w.write<uint32_t>(clique_parent.second);
+    writeConditional(*clique_parent.first->conditional(), w);
+    writeFactor(clique_parent.first->cachedFactor_, w);
+  }
+
+  // Solution and relinearization bookkeeping
+  writeVectorValues(state.delta, w);
+  writeVectorValues(state.deltaNewton, w);
+  writeVectorValues(state.RgProd, w);
+  writeKeySet(state.deltaReplacedMask, w);
+  writeKeySet(state.fixedVariables, w);
+  w.write<uint8_t>(bool(state.doglegDelta));
+  w.write<double>(state.doglegDelta ? *state.doglegDelta : 0.0);
+  w.write<int32_t>(state.update_count);
+
+  // Header and noise model table, then the records
+  string out;
+  BinaryWriter h(out, tables);
+  h.writeBytes(kMagic, sizeof(kMagic));
+  h.write<uint8_t>(kVersion);
+  tables.write(h);
+  out += body;
+  return out;
+}
+
+/* ************************************************************************* */
+void ISAM2Checkpoint::Restore(const string& checkpoint, ISAM2& isam) {
+  gttic(ISAM2Checkpoint_Restore);
+  BinarySnapshotTables tables;
+  BinaryReader r(checkpoint, tables);
+
+  char magic[sizeof(kMagic)];
+  r.readBytes(magic, sizeof(magic));
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    throw runtime_error("ISAM2Checkpoint: not an ISAM2 checkpoint");
+  if (r.read<uint8_t>() != kVersion)
+    throw runtime_error("ISAM2Checkpoint: unsupported checkpoint version");
+  tables.read(r);
+
+  // Read everything before touching isam, so that a malformed checkpoint leaves it as it was.
+  // Counts are checked against the bytes left before anything is allocated.
+  string snapshot(r.readCount<uint64_t>(1), '\0');
+  r.readBytes(&snapshot[0], snapshot.size());
+  NonlinearFactorGraph nonlinearFactors;
+  Values theta;
+  deserializeBinarySnapshot(snapshot, nonlinearFactors, theta);
+
+  ISAM2::CachedState state;
+  state.linearFactors.resize(r.readCount<uint64_t>(sizeof(uint8_t)));
+  for (GaussianFactor::shared_ptr& factor : state.linearFactors)
+    factor = readFactor(r);
+
+  typedef ISAM2::sharedClique sharedClique;
+  vector<sharedClique> cliques(r.readCount<uint64_t>(sizeof(uint32_t)));
+  vector<uint32_t> parents(cliques.size());
+  for (size_t i = 0; i < cliques.size(); i++) {
+    parents[i] = r.read<uint32_t>();
+    if (parents[i] != kNone && parents[i] >= i)
+      throw runtime_error("ISAM2Checkpoint: invalid clique parent");
+    const GaussianConditional::shared_ptr conditional = readConditional(r);
+    cliques[i] = boost::make_shared<ISAM2Clique>();
+    cliques[i]->setEliminationResult(make_pair(conditional, readFactor(r)));
+  }
+
+  state.delta = readVectorValues(r);
+  state.deltaNewton = readVectorValues(r);
+  state.RgProd = readVectorValues(r);
+  state.deltaReplacedMask = readKeySet(r);
+  state.fixedVariables = readKeySet(r);
+  const bool hasDoglegDelta = r.read<uint8_t>();
+  const double doglegDelta = r.read<double>();
+  if (hasDoglegDelta)
+    state.doglegDelta = doglegDelta;
+  state.update_count = r.read<int32_t>();
+  if (!r.atEnd())
+    throw runtime_error("ISAM2Checkpoint: unexpected data after the checkpoint");
+
+  // Rebuild the Bayes tree, then swap in the rest
+  isam.clear();
+  for (size_t i = 0; i < cliques.size(); i++)
+    isam.addClique(cliques[i], parents[i] == kNone ? sharedClique() : cliques[parents[i]]);
+  isam.restoreState(std::move(nonlinearFactors), std::move(theta), std::move(state));
+}
+
+}  // namespace gtsam
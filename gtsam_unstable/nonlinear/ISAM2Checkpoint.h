@@ -0,0 +1,49 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ISAM2Checkpoint.h
+ * @brief Binary checkpoint of the complete state of an ISAM2 instance
+ */
+
+#pragma once
+
+#include <gtsam_unstable/base/dllexport.h>
+#include <gtsam_unstable/slam/BinarySnapshot.h>
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <string>
+
+namespace gtsam {
+
+/**
+ * Checkpoint of an ISAM2 instance, to restart after a crash without
+ * relinearizing and re-eliminating. Besides the factors and linearization
+ * point, written with the BinarySnapshot codecs, a checkpoint holds the Bayes
+ * tree with the cached factors of its cliques, the cached linear factors, the
+ * deltas and the bookkeeping of the relinearization, so restoring it takes
+ * time linear in its size. The VariableIndex and the gradient contributions of
+ * the cliques are recomputed from the stored factors, which is cheap.
+ *
+ * The parameters are not stored: restore into an ISAM2 constructed with the
+ * same ISAM2Params. Only JacobianFactor and HessianFactor linear factors are
+ * supported, which is what the linearization of the registered factors gives.
+ */
+class GTSAM_UNSTABLE_EXPORT ISAM2Checkpoint {
+public:
+  /// Binary checkpoint of isam, throws std::invalid_argument if it holds an unsupported type
+  static std::string Save(const ISAM2& isam);
+
+  /// Replace the state of isam with a checkpoint, throws std::runtime_error if it is malformed
+  static void Restore(const std::string& checkpoint, ISAM2& isam);
+};
+
+}  // namespace gtsam
@@ -0,0 +1,191 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testBoundedISAM2.cpp
+ * @brief   Unit tests for the ISAM2 with a bounded number of variables
+ */
+
+#include <gtsam_unstable/nonlinear/BoundedISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Point2.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+namespace {
+
+const SharedDiagonal odometryNoise = noiseModel::Isotropic::Sigma(2, 0.1);
+
+// Factors and initial value of step i of a linear chain with short loop closures,
+// and observations of a landmark if withLandmark is set
+void addStep(size_t i, bool withLandmark, NonlinearFactorGraph& factors, Values& values) {
+  values.insert(X(i), Point2(i + 0.1, -0.2));
+  if (i == 0) {
+    factors.add(PriorFactor<Point2>(X(0), Point2(0, 0), odometryNoise));
+    if (withLandmark) values.insert(L(0), Point2(2.0, 5.2));
+  } else {
+    factors.add(BetweenFactor<Point2>(X(i - 1), X(i), Point2(1.0, 0.02), odometryNoise));
+  }
+  if (i >= 3 && i % 2 == 1)
+    factors.add(BetweenFactor<Point2>(X(i - 3), X(i), Point2(3.1, 0.0), odometryNoise));
+  if (withLandmark)
+    factors.add(BetweenFactor<Point2>(X(i), L(0), Point2(2.0 - i, 5.0), odometryNoise));
+}
+
+// The chain is linear, so marginalization is exact and the estimate of key
+// has to agree with a batch solution of all factors
+bool agreesWithBatch(const NonlinearFactorGraph& graph, const Values& initial,
+    const BoundedISAM2& isam, Key key) {
+  const VectorValues delta = graph.linearize(initial)->optimize();
+  const Values expected = initial.retract(delta);
+  return assert_equal(expected.at<Point2>(key),
+      isam.calculateBestEstimate().at<Point2>(key), 1e-6);
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(BoundedISAM2, maxVariables) {
+  BoundedISAM2 isam(BoundedISAM2Params(10));
+  NonlinearFactorGraph graph;
+  Values initial;
+  for (size_t i = 0; i < 40; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, false, factors, values);
+    graph.add(factors);
+    initial.insert(values);
+    isam.update(factors, values);
+
+    EXPECT_LONGS_EQUAL(min<size_t>(i + 1, 10), isam.getLinearizationPoint().size());
+    EXPECT(agreesWithBatch(graph, initial, isam, X(i)));
+  }
+
+  // The oldest variable went last, and the factor slots are reused
+  EXPECT_LONGS_EQUAL(1, isam.marginalizedKeys().size());
+  EXPECT(X(29) == isam.marginalizedKeys().front());
+  EXPECT(!isam.valueExists(X(29)));
+  EXPECT(isam.valueExists(X(30)));
+  EXPECT(isam.getFactorsUnsafe().size() < 25);
+}
+
+/* ************************************************************************* */
+TEST(BoundedISAM2, lowWaterMark) {
+  BoundedISAM2Params bounds(10);
+  bounds.lowWaterMark = 0.5;
+  BoundedISAM2 isam(bounds);
+  size_t nrMarginalizations = 0;
+  for (size_t i = 0; i < 40; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, false, factors, values);
+    isam.update(factors, values);
+    if (!isam.marginalizedKeys().empty()) {
+      EXPECT_LONGS_EQUAL(6, isam.marginalizedKeys().size());
+      EXPECT_LONGS_EQUAL(5, isam.getLinearizationPoint().size());
+      nrMarginalizations++;
+    }
+  }
+  EXPECT_LONGS_EQUAL(5, nrMarginalizations);
+
+  bounds.lowWaterMark = 0.0;
+  CHECK_EXCEPTION(BoundedISAM2 invalid(bounds), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(BoundedISAM2, isMarginalizable) {
+  // The landmark is observed from every pose and has to stay
+  BoundedISAM2Params bounds(5);
+  bounds.isMarginalizable = [](Key key) { return Symbol(key).chr() == 'x'; };
+  BoundedISAM2 isam(bounds);
+  NonlinearFactorGraph graph;
+  Values initial;
+  for (size_t i = 0; i < 20; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, true, factors, values);
+    graph.add(factors);
+    initial.insert(values);
+    isam.update(factors, values);
+    EXPECT(isam.getLinearizationPoint().size() <= 5);
+  }
+  EXPECT(isam.valueExists(L(0)));
+  EXPECT(agreesWithBatch(graph, initial, isam, L(0)));
+  EXPECT(agreesWithBatch(graph, initial, isam, X(19)));
+}
+
+/* ************************************************************************* */
+TEST(BoundedISAM2, maxBytes) {
+  // Measure the size of 10 variables, then keep the chain within it
+  BoundedISAM2 unbounded;
+  for (size_t i = 0; i < 10; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, false, factors, values);
+    unbounded.update(factors, values);
+  }
+  const size_t budget = unbounded.estimateBytes();
+
+  BoundedISAM2 isam(BoundedISAM2Params(0, budget));
+  for (size_t i = 0; i < 60; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, false, factors, values);
+    isam.update(factors, values);
+    EXPECT(isam.getLinearizationPoint().size() <= 12);
+    EXPECT(isam.estimateBytes() < 1.2 * budget);
+  }
+  EXPECT(!isam.valueExists(X(40)));
+  EXPECT(isam.getFactorsUnsafe().size() < 25);
+}
+
+/* ************************************************************************* */
+namespace {
+// Counts the bytes from scratch as well
+class RecountedBoundedISAM2 : public BoundedISAM2 {
+public:
+  using BoundedISAM2::BoundedISAM2;
+  size_t recountedBytes() { recount(); return estimateBytes(); }
+};
+}
+
+TEST(BoundedISAM2, runningByteCount) {
+  // Marginalize, relinearize and remove loop closures along the way
+  ISAM2Params params;
+  params.relinearizeSkip = 1;
+  params.relinearizeThreshold = 0.01;
+  RecountedBoundedISAM2 isam(BoundedISAM2Params(8), params);
+  FactorIndices loopClosure;
+  for (size_t i = 0; i < 40; i++) {
+    NonlinearFactorGraph factors;
+    Values values;
+    addStep(i, false, factors, values);
+    const ISAM2Result result = isam.update(factors, values, loopClosure);
+    loopClosure.clear();
+    if (i % 4 == 3) loopClosure.push_back(result.newFactorsIndices.back());
+
+    const size_t running = isam.estimateBytes();
+    EXPECT_LONGS_EQUAL(isam.recountedBytes(), running);
+  }
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
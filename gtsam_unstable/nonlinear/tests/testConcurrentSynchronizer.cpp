@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testConcurrentSynchronizer.cpp
+ * @brief   Unit tests for the lock-free filter/smoother synchronization
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentBatchFilter.h>
+#include <gtsam_unstable/nonlinear/ConcurrentBatchSmoother.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+// Set up initial pose, odometry difference, loop closure difference, and initialization errors
+const Pose3 poseInitial;
+const Pose3 poseOdometry( Rot3::RzRyRx(Vector3(0.05, 0.10, -0.75)), Point3(1.0, -0.25, 0.10) );
+const Pose3 poseError( Rot3::RzRyRx(Vector3(0.01, 0.02, -0.1)), Point3(0.05, -0.05, 0.02) );
+
+// Set up noise models for the factors
+const SharedDiagonal noisePrior = noiseModel::Isotropic::Sigma(6, 0.10);
+const SharedDiagonal noiseOdometery = noiseModel::Diagonal::Sigmas((Vector(6) << 0.1, 0.1, 0.1, 0.5, 0.5, 0.5).finished());
+
+/* ************************************************************************* */
+// Add pose 'key' to the filter, marginalizing out the pose added three steps before
+void FilterStep(ConcurrentBatchFilter& filter, Key key, Pose3& pose) {
+  NonlinearFactorGraph newFactors;
+  Values newValues;
+  if(key == 1) {
+    newFactors.push_back(PriorFactor<Pose3>(1, poseInitial, noisePrior));
+    pose = poseInitial.compose(poseError);
+  } else {
+    newFactors.push_back(BetweenFactor<Pose3>(key - 1, key, poseOdometry, noiseOdometery));
+    pose = pose.compose(poseOdometry).compose(poseError);
+  }
+  newValues.insert(key, pose);
+
+  FastList<Key> keysToMove;
+  if(key > 3)
+    keysToMove.push_back(key - 3);
+  filter.update(newFactors, newValues, keysToMove);
+}
+
+} // end namespace
+
+/* ************************************************************************* */
+TEST( ConcurrentSynchronizationQueue, pushPop )
+{
+  ConcurrentSynchronizationQueue queue(2);
+  EXPECT_LONGS_EQUAL(2, queue.capacity());
+  EXPECT(queue.empty());
+  EXPECT(!queue.pop());
+
+  ConcurrentSynchronizationPacket::shared_ptr packet1 = boost::make_shared<ConcurrentSynchronizationPacket>();
+  ConcurrentSynchronizationPacket::shared_ptr packet2 = boost::make_shared<ConcurrentSynchronizationPacket>();
+  ConcurrentSynchronizationPacket::shared_ptr packet3 = boost::make_shared<ConcurrentSynchronizationPacket>();
+  packet1->version = 1;
+  packet2->version = 2;
+  packet3->version = 3;
+
+  // Fill the queue, the third push must be rejected
+  EXPECT(queue.push(packet1));
+  EXPECT(queue.push(packet2));
+  EXPECT(!queue.push(packet3));
+  EXPECT(!queue.empty());
+
+  // Packets come out in order, and the freed slot can be reused
+  EXPECT_LONGS_EQUAL(1, queue.pop()->version);
+  EXPECT(queue.push(packet3));
+  EXPECT_LONGS_EQUAL(2, queue.pop()->version);
+  EXPECT_LONGS_EQUAL(3, queue.pop()->version);
+  EXPECT(queue.empty());
+  EXPECT(!queue.pop());
+}
+
+/* ************************************************************************* */
+TEST( ConcurrentSynchronizer, matchesSynchronize )
+{
+  LevenbergMarquardtParams parameters;
+
+  // Blocking synchronization
+  ConcurrentBatchFilter expectedFilter(parameters);
+  ConcurrentBatchSmoother expectedSmoother(parameters);
+
+  // Lock-free synchronization, interleaved on a single thread
+  ConcurrentBatchFilter actualFilter(parameters);
+  ConcurrentBatchSmoother actualSmoother(parameters);
+  ConcurrentSynchronizer synchronizer;
+
+  Pose3 expectedPose, actualPose;
+  for(Key key = 1; key <= 10; ++key) {
+    FilterStep(expectedFilter, key, expectedPose);
+    FilterStep(actualFilter, key, actualPose);
+
+    synchronize(expectedFilter, expectedSmoother);
+    expectedSmoother.update();
+
+    // The smoother publishes first and has to wait for the filter to answer
+    EXPECT(!synchronizer.filterSynchronize(actualFilter));
+    EXPECT(!synchronizer.smootherSynchronize(actualSmoother));
+    EXPECT(synchronizer.filterSynchronize(actualFilter));
+    EXPECT(!synchronizer.filterSynchronize(actualFilter));
+    EXPECT(synchronizer.smootherSynchronize(actualSmoother));
+    actualSmoother.update();
+  }
+
+  EXPECT_LONGS_EQUAL(10, synchronizer.version());
+  EXPECT(assert_equal(expectedFilter.calculateEstimate(), actualFilter.calculateEstimate(), 1e-9));
+  EXPECT(assert_equal(expectedSmoother.calculateEstimate(), actualSmoother.calculateEstimate(), 1e-9));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -0,0 +1,202 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testDistributedOptimizer.cpp
+ * @brief   Unit tests for the distributed multi-robot optimizer
+ */
+
+#include <gtsam_unstable/nonlinear/DistributedOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Point2.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/inference/LabeledSymbol.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+const SharedDiagonal pointNoise = noiseModel::Isotropic::Sigma(2, 0.1);
+const SharedDiagonal poseNoise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+
+// Odometry chain of robot r, with a perturbed initial estimate
+void addPointChain(unsigned char r, size_t n, NonlinearFactorGraph& graph, Values& initial) {
+  for (size_t j = 0; j < n; j++) {
+    initial.insert(Symbol(r, j), Point2(j + 0.2, 0.1 * j - 0.3));
+    if (j > 0)
+      graph.add(BetweenFactor<Point2>(Symbol(r, j - 1), Symbol(r, j), Point2(1.0, 0.05), pointNoise));
+  }
+}
+
+// Three robots in a row, only the first one has a prior
+void createPointChains(NonlinearFactorGraph& graph, Values& initial) {
+  addPointChain('a', 6, graph, initial);
+  addPointChain('b', 6, graph, initial);
+  addPointChain('c', 6, graph, initial);
+  graph.add(PriorFactor<Point2>(Symbol('a', 0), Point2(0, 0), pointNoise));
+  graph.add(BetweenFactor<Point2>(Symbol('a', 5), Symbol('b', 0), Point2(0.9, 1.0), pointNoise));
+  graph.add(BetweenFactor<Point2>(Symbol('a', 3), Symbol('b', 2), Point2(-1.1, 1.1), pointNoise));
+  graph.add(BetweenFactor<Point2>(Symbol('b', 5), Symbol('c', 0), Point2(1.0, -2.0), pointNoise));
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(DistributedOptimizer, partition) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createPointChains(graph, initial);
+  DistributedOptimizer optimizer(graph, initial);
+
+  // One agent per robot, and every factor is held by exactly one of them
+  EXPECT(assert_container_equality(KeyVector{'a', 'b', 'c'}, optimizer.labels()));
+  const vector<DistributedAgent>& agents = optimizer.agents();
+  LONGS_EQUAL(3, agents.size());
+  LONGS_EQUAL(5 + 1 + 2, agents[0].factors().size());
+  LONGS_EQUAL(5 + 1, agents[1].factors().size());
+  LONGS_EQUAL(5, agents[2].factors().size());
+
+  // The factors between robots are held by the first, who keeps a copy of the others' variables
+  const KeyVector separatorAB{Symbol('b', 0), Symbol('b', 2)};
+  const KeyVector separatorBC{Symbol('c', 0)};
+  LONGS_EQUAL(1, agents[0].separators().size());
+  EXPECT(assert_container_equality(separatorAB, agents[0].separators().at(1)));
+  LONGS_EQUAL(2, agents[1].separators().size());
+  EXPECT(assert_container_equality(separatorAB, agents[1].separators().at(0)));
+  EXPECT(assert_container_equality(separatorBC, agents[1].separators().at(2)));
+  LONGS_EQUAL(1, agents[2].separators().size());
+  EXPECT(assert_container_equality(separatorBC, agents[2].separators().at(1)));
+  LONGS_EQUAL(6 + 2, agents[0].estimate().size());
+  LONGS_EQUAL(6, agents[0].ownedEstimate().size());
+}
+
+/* ************************************************************************* */
+TEST(DistributedOptimizer, linear) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createPointChains(graph, initial);
+  const Values expected = initial.retract(graph.linearize(initial)->optimize());
+
+  InProcessTransport::shared_ptr transport = boost::make_shared<InProcessTransport>();
+  DistributedOptimizer optimizer(graph, initial, DistributedOptimizerParams(), transport);
+  const Values actual = optimizer.optimize();
+
+  // The agents form a chain and the factors are linear, so the messages are
+  // exact once they have crossed it
+  EXPECT(assert_equal(expected, actual, 1e-6));
+  EXPECT(optimizer.iterations() > 2);
+  EXPECT(optimizer.iterations() < 10);
+  LONGS_EQUAL(4 * optimizer.iterations(), transport->nrSent());
+}
+
+/* ************************************************************************* */
+TEST(DistributedOptimizer, nonlinear) {
+  // Two robots driving around a square, seeing each other at two places
+  NonlinearFactorGraph graph;
+  Values initial;
+  const Pose2 odometry(1.0, 0.0, M_PI / 2);
+  for (unsigned char r : {'a', 'b'}) {
+    const Pose2 start = r == 'a' ? Pose2() : Pose2(0.5, 0.5, 0.0);
+    Pose2 pose = start;
+    for (size_t j = 0; j < 4; j++) {
+      initial.insert(Symbol(r, j), pose.retract(Vector3(0.1, -0.1, 0.05 * j)));
+      if (j > 0)
+        graph.add(BetweenFactor<Pose2>(Symbol(r, j - 1), Symbol(r, j), odometry, poseNoise));
+      pose = pose.compose(odometry);
+    }
+  }
+  graph.add(PriorFactor<Pose2>(Symbol('a', 0), Pose2(), poseNoise));
+  graph.add(BetweenFactor<Pose2>(Symbol('a', 0), Symbol('b', 0), Pose2(0.5, 0.5, 0.0), poseNoise));
+  graph.add(BetweenFactor<Pose2>(Symbol('a', 2), Symbol('b', 2), Pose2(-0.5, -0.5, 0.0), poseNoise));
+
+  LevenbergMarquardtParams lmParams;
+  lmParams.relativeErrorTol = 1e-10;
+  lmParams.absoluteErrorTol = 1e-10;
+  const Values expected = LevenbergMarquardtOptimizer(graph, initial, lmParams).optimize();
+
+  DistributedOptimizerParams params;
+  params.localParams = lmParams;
+  DistributedOptimizer optimizer(graph, initial, params);
+  const Values actual = optimizer.optimize();
+  EXPECT(optimizer.iterations() < params.maxIterations);
+  EXPECT(assert_equal(expected, actual, 1e-4));
+}
+
+/* ************************************************************************* */
+TEST(DistributedOptimizer, labeledSymbols) {
+  // Robots A and B, with poses x and landmarks l that belong to their robot.
+  // A holds the observations of its landmark by B and keeps a copy of B's poses.
+  NonlinearFactorGraph graph;
+  Values initial;
+  const LabeledSymbol xA0('x', 'A', 0), xA1('x', 'A', 1), lA0('l', 'A', 0);
+  const LabeledSymbol xB0('x', 'B', 0), xB1('x', 'B', 1);
+  graph.add(PriorFactor<Point2>(xA0, Point2(0, 0), pointNoise));
+  graph.add(BetweenFactor<Point2>(xA0, xA1, Point2(1, 0), pointNoise));
+  graph.add(BetweenFactor<Point2>(xA1, lA0, Point2(0, 1), pointNoise));
+  graph.add(BetweenFactor<Point2>(xB0, xB1, Point2(1, 0), pointNoise));
+  graph.add(BetweenFactor<Point2>(xB1, lA0, Point2(-1, 1), pointNoise));
+  graph.add(BetweenFactor<Point2>(xB0, lA0, Point2(0, 1), pointNoise));
+  initial.insert(xA0, Point2(0.1, 0.1));
+  initial.insert(xA1, Point2(1.1, -0.1));
+  initial.insert(lA0, Point2(1.0, 1.2));
+  initial.insert(xB0, Point2(0.9, 0.1));
+  initial.insert(xB1, Point2(2.1, 0.2));
+  const Values expected = initial.retract(graph.linearize(initial)->optimize());
+
+  DistributedOptimizerParams params;
+  params.partition = &DistributedOptimizerParams::LabeledSymbolLabel;
+  DistributedOptimizer optimizer(graph, initial, params);
+  EXPECT(assert_container_equality(KeyVector{'A', 'B'}, optimizer.labels()));
+  EXPECT(assert_container_equality(KeyVector{xB0, xB1}, optimizer.agents()[0].separators().at(1)));
+  EXPECT(assert_equal(expected, optimizer.optimize(), 1e-6));
+}
+
+/* ************************************************************************* */
+TEST(DistributedOptimizer, missingInitial) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createPointChains(graph, initial);
+  initial.erase(Symbol('b', 3));
+  CHECK_EXCEPTION(DistributedOptimizer(graph, initial), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(InProcessTransport, sendReceive) {
+  InProcessTransport transport;
+  transport.send(DistributedMessage(0, 1, 0));
+  transport.send(DistributedMessage(2, 1, 0));
+  transport.send(DistributedMessage(1, 0, 0));
+  LONGS_EQUAL(3, transport.nrSent());
+
+  // Messages arrive in the order they were sent, and only once
+  const vector<DistributedMessage> messages = transport.receive(1);
+  LONGS_EQUAL(2, messages.size());
+  LONGS_EQUAL(0, messages[0].from);
+  LONGS_EQUAL(2, messages[1].from);
+  LONGS_EQUAL(0, transport.receive(1).size());
+  LONGS_EQUAL(1, transport.receive(0).size());
+  LONGS_EQUAL(0, transport.receive(5).size());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
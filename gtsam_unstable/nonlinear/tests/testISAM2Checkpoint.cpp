@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testISAM2Checkpoint.cpp
+ * @brief Unit tests for checkpoints of ISAM2
+ */
+
+#include <gtsam_unstable/nonlinear/ISAM2Checkpoint.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/Testable.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+const SharedNoiseModel odometry = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+
+/// Add pose i of a square trajectory with a loop closure every 4 poses
+void addPose(size_t i, NonlinearFactorGraph& graph, Values& values) {
+  const Pose2 step(1.0, 0.0, M_PI / 2);
+  if (i == 0) {
+    graph.add(PriorFactor<Pose2>(0, Pose2(), noiseModel::Isotropic::Sigma(3, 0.01)));
+    values.insert(0, Pose2(0.01, -0.01, 0.01));
+    return;
+  }
+  graph.add(BetweenFactor<Pose2>(i - 1, i, step, odometry));
+  if (i >= 4) graph.add(BetweenFactor<Pose2>(i - 4, i, Pose2(), odometry));
+  values.insert(i, Pose2(0.1 * i, 0.05 * i, 0.02 * i));
+}
+
+/// Add poses first..last-1, one update each
+void addPoses(ISAM2& isam, size_t first, size_t last) {
+  for (size_t i = first; i < last; i++) {
+    NonlinearFactorGraph graph;
+    Values values;
+    addPose(i, graph, values);
+    isam.update(graph, values);
+  }
+}
+
+ISAM2 restore(const ISAM2& isam, const ISAM2Params& params) {
+  ISAM2 restored(params);
+  ISAM2Checkpoint::Restore(ISAM2Checkpoint::Save(isam), restored);
+  return restored;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, GaussNewton) {
+  ISAM2Params params;
+  params.relinearizeThreshold = 0.01;
+  params.relinearizeSkip = 1;
+  ISAM2 isam(params);
+  addPoses(isam, 0, 20);
+
+  ISAM2 restored = restore(isam, params);
+  EXPECT(assert_equal(isam, restored, 1e-12));
+  EXPECT(assert_equal(isam.getDelta(), restored.getDelta(), 1e-12));
+  EXPECT(assert_equal(isam.calculateEstimate(), restored.calculateEstimate(), 1e-12));
+
+  // The restored instance continues exactly as the original
+  addPoses(isam, 20, 30);
+  addPoses(restored, 20, 30);
+  EXPECT(assert_equal(isam, restored, 1e-9));
+  EXPECT(assert_equal(isam.calculateEstimate(), restored.calculateEstimate(), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, DoglegCholesky) {
+  ISAM2Params params(ISAM2DoglegParams(1.0));
+  params.relinearizeThreshold = 0.01;
+  params.relinearizeSkip = 1;
+  params.factorization = ISAM2Params::CHOLESKY;
+  ISAM2 isam(params);
+  addPoses(isam, 0, 20);
+
+  ISAM2 restored = restore(isam, params);
+  EXPECT(assert_equal(isam, restored, 1e-12));
+  EXPECT(assert_equal(isam.getDelta(), restored.getDelta(), 1e-12));
+  EXPECT(assert_equal(isam.calculateEstimate(), restored.calculateEstimate(), 1e-12));
+
+  // The restored instance continues exactly as the original
+  addPoses(isam, 20, 30);
+  addPoses(restored, 20, 30);
+  EXPECT(assert_equal(isam, restored, 1e-9));
+  EXPECT(assert_equal(isam.calculateEstimate(), restored.calculateEstimate(), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, empty) {
+  ISAM2 isam, restored;
+  ISAM2Checkpoint::Restore(ISAM2Checkpoint::Save(isam), restored);
+  EXPECT(assert_equal(isam, restored));
+  EXPECT_LONGS_EQUAL(0, restored.size());
+}
+
+/* ************************************************************************* */
+TEST(ISAM2Checkpoint, errors) {
+  ISAM2 isam;
+  addPoses(isam, 0, 8);
+  const string checkpoint = ISAM2Checkpoint::Save(isam);
+  ISAM2 restored;
+  CHECK_EXCEPTION(ISAM2Checkpoint::Restore(checkpoint.substr(0, checkpoint.size() - 1), restored),
+      std::runtime_error);
+  CHECK_EXCEPTION(ISAM2Checkpoint::Restore("not a checkpoint", restored), std::runtime_error);
+
+  // Corrupt counts of the snapshot bytes, linear factors and cliques, which
+  // follow each other in the checkpoint of an empty instance
+  const string empty = ISAM2Checkpoint::Save(ISAM2());
+  const string snapshot = serializeBinarySnapshot(NonlinearFactorGraph(), Values());
+  const size_t snapshotStart = empty.find(snapshot);
+  for (size_t offset : {snapshotStart - 8, snapshotStart + snapshot.size(),
+                        snapshotStart + snapshot.size() + 8}) {
+    string corrupt = empty;
+    corrupt.replace(offset, 8, 8, '\xff');
+    CHECK_EXCEPTION(ISAM2Checkpoint::Restore(corrupt, restored), std::runtime_error);
+  }
+
+  // A malformed checkpoint leaves the instance as it was
+  EXPECT_LONGS_EQUAL(0, restored.size());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -0,0 +1,482 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file BinarySnapshot.cpp
+ * @brief Compact binary snapshots of a NonlinearFactorGraph and Values, without Boost archives
+ */
+
+#include <gtsam_unstable/slam/BinarySnapshot.h>
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace {
+
+const char kMagic[4] = {'G', 'T', 'S', 'B'};
+const uint8_t kVersion = 1;
+const uint32_t kNone = 0xffffffff; // no noise model, or an empty factor slot
+
+#ifdef GTSAM_USE_QUATERNIONS
+const uint8_t kQuaternions = 1;
+#else
+const uint8_t kQuaternions = 0;
+#endif
+
+// Tags of the noise models and robust error functions
+enum ModelTag {
+  kUnit, kIsotropic, kDiagonal, kConstrained, kGaussian, kRobust
+};
+enum EstimatorTag {
+  kNull, kFair, kHuber, kCauchy, kTukey, kWelsh, kGemanMcClure, kDCS, kL2WithDeadZone
+};
+
+/* ************************************************************************* */
+// Types can be registered while other threads write or read snapshots, so the
+// maps are guarded by a mutex. Entries are never changed or freed once added,
+// registering a type again adds a new entry, so the references returned by the
+// Find functions stay valid without holding the lock.
+struct Registry {
+  mutex m;
+  deque<BinarySnapshot::ValueEntry> valueEntries;
+  deque<BinarySnapshot::FactorEntry> factorEntries;
+  unordered_map<type_index, const BinarySnapshot::ValueEntry*> values;
+  unordered_map<type_index, const BinarySnapshot::FactorEntry*> factors;
+  unordered_map<string, const BinarySnapshot::ValueEntry*> valuesByName;
+  unordered_map<string, const BinarySnapshot::FactorEntry*> factorsByName;
+
+  // The built-in types are registered when the registry is first used, which
+  // the compiler makes thread-safe
+  Registry() {
+    add(typeid(GenericValue<double>), BinarySnapshot::MakeValueEntry<double>("double"));
+    add(typeid(GenericValue<Vector>), BinarySnapshot::MakeValueEntry<Vector>("Vector"));
+    addWithFactors<Point2>("Point2");
+    addWithFactors<Point3>("Point3");
+    addWithFactors<Rot2>("Rot2");
+    addWithFactors<Rot3>("Rot3");
+    addWithFactors<Pose2>("Pose2");
+    addWithFactors<Pose3>("Pose3");
+  }
+
+  void add(const type_index& type, const BinarySnapshot::ValueEntry& entry) {
+    lock_guard<mutex> lock(m);
+    valueEntries.push_back(entry);
+    values[type] = valuesByName[entry.name] = &valueEntries.back();
+  }
+
+  void add(const type_index& type, const BinarySnapshot::FactorEntry& entry) {
+    lock_guard<mutex> lock(m);
+    factorEntries.push_back(entry);
+    factors[type] = factorsByName[entry.name] = &factorEntries.back();
+  }
+
+  template <class T>
+  void addWithFactors(const string& name) {
+    add(typeid(GenericValue<T>), BinarySnapshot::MakeValueEntry<T>(name));
+    add(typeid(PriorFactor<T>), BinarySnapshot::MakeFactorEntry<PriorFactor<T> >("PriorFactor" + name));
+    add(typeid(BetweenFactor<T>), BinarySnapshot::MakeFactorEntry<BetweenFactor<T> >("BetweenFactor" + name));
+  }
+
+  // Entry in one of the maps, or nullptr
+  template <class MAP, class KEY>
+  typename MAP::mapped_type find(const MAP& map, const KEY& key) {
+    lock_guard<mutex> lock(m);
+    const auto it = map.find(key);
+    return it == map.end() ? nullptr : it->second;
+  }
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+/* ************************************************************************* */
+void writeEstimator(const noiseModel::mEstimator::Base& robust, BinaryWriter& w) {
+  namespace m = noiseModel::mEstimator;
+  uint8_t tag;
+  double parameter = 0;
+  if (dynamic_cast<const m::Null*>(&robust)) {
+    tag = kNull;
+  } else if (const m::Fair* e = dynamic_cast<const m::Fair*>(&robust)) {
+    tag = kFair, parameter = e->modelParameter();
+  } else if (const m::Huber* e = dynamic_cast<const m::Huber*>(&robust)) {
+    tag = kHuber, parameter = e->modelParameter();
+  } else if (const m::Cauchy* e = dynamic_cast<const m::Cauchy*>(&robust)) {
+    tag = kCauchy, parameter = e->modelParameter();
+  } else if (const m::Tukey* e = dynamic_cast<const m::Tukey*>(&robust)) {
+    tag = kTukey, parameter = e->modelParameter();
+  } else if (const m::Welsh* e = dynamic_cast<const m::Welsh*>(&robust)) {
+    tag = kWelsh, parameter = e->modelParameter();
+  } else if (const m::GemanMcClure* e = dynamic_cast<const m::GemanMcClure*>(&robust)) {
+    tag = kGemanMcClure, parameter = e->modelParameter();
+  } else if (const m::DCS* e = dynamic_cast<const m::DCS*>(&robust)) {
+    tag = kDCS, parameter = e->modelParameter();
+  } else if (const m::L2WithDeadZone* e = dynamic_cast<const m::L2WithDeadZone*>(&robust)) {
+    tag = kL2WithDeadZone, parameter = e->modelParameter();
+  } else {
+    throw invalid_argument("BinarySnapshot: unsupported robust error function");
+  }
+  w.write<uint8_t>(tag);
+  w.write<uint8_t>(robust.reweightScheme());
+  w.write(parameter);
+}
+
+/* ************************************************************************* */
+noiseModel::mEstimator::Base::shared_ptr readEstimator(BinaryReader& r) {
+  namespace m = noiseModel::mEstimator;
+  const uint8_t tag = r.read<uint8_t>();
+  const m::Base::ReweightScheme reweight =
+      static_cast<m::Base::ReweightScheme>(r.read<uint8_t>());
+  const double parameter = r.read<double>();
+  switch (tag) {
+    case kNull: return boost::make_shared<m::Null>(reweight);
+    case kFair: return m::Fair::Create(parameter, reweight);
+    case kHuber: return m::Huber::Create(parameter, reweight);
+    case kCauchy: return m::Cauchy::Create(parameter, reweight);
+    case kTukey: return m::Tukey::Create(parameter, reweight);
+    case kWelsh: return m::Welsh::Create(parameter, reweight);
+    case kGemanMcClure: return m::GemanMcClure::Create(parameter, reweight);
+    case kDCS: return m::DCS::Create(parameter, reweight);
+    case kL2WithDeadZone: return m::L2WithDeadZone::Create(parameter, reweight);
+    default: throw runtime_error("BinarySnapshot: unknown robust error function");
+  }
+}
+
+/* ************************************************************************* */
+void writeModel(const SharedNoiseModel& model, BinaryWriter& w) {
+  using namespace noiseModel;
+  if (const Robust* robust = dynamic_cast<const Robust*>(model.get())) {
+    w.write<uint8_t>(kRobust);
+    writeEstimator(*robust->robust(), w);
+    w.writeNoiseModel(robust->noise()); // already in the table
+  } else if (dynamic_cast<const Unit*>(model.get())) {
+    w.write<uint8_t>(kUnit);
+    w.write<uint32_t>(model->dim());
+  } else if (const Isotropic* isotropic = dynamic_cast<const Isotropic*>(model.get())) {
+    w.write<uint8_t>(kIsotropic);
+    w.write<uint32_t>(model->dim());
+    w.write(isotropic->sigma());
+  } else if (const Constrained* constrained = dynamic_cast<const Constrained*>(model.get())) {
+    w.write<uint8_t>(kConstrained);
+    w.writeMatrix(constrained->mu());
+    w.writeMatrix(constrained->sigmas());
+  } else if (const Diagonal* diagonal = dynamic_cast<const Diagonal*>(model.get())) {
+    w.write<uint8_t>(kDiagonal);
+    w.writeMatrix(diagonal->sigmas());
+  } else if (const Gaussian* gaussian = dynamic_cast<const Gaussian*>(model.get())) {
+    w.write<uint8_t>(kGaussian);
+    w.writeMatrix(gaussian->R());
+  } else {
+    throw invalid_argument("BinarySnapshot: unsupported noise model");
+  }
+}
+
+/* ************************************************************************* */
+SharedNoiseModel readModel(BinaryReader& r) {
+  using namespace noiseModel;
+  switch (r.read<uint8_t>()) {
+    case kRobust: {
+      const mEstimator::Base::shared_ptr robust = readEstimator(r);
+      const SharedNoiseModel noise = r.readNoiseModel();
+      if (!noise) throw runtime_error("BinarySnapshot: robust noise model without base model");
+      return Robust::Create(robust, noise);
+    }
+    case kUnit:
+      return Unit::Create(r.read<uint32_t>());
+    case kIsotropic: {
+      const uint32_t dim = r.read<uint32_t>();
+      return Isotropic::Sigma(dim, r.read<double>(), false);
+    }
+    case kConstrained: {
+      const Vector mu = r.readVector();
+      return Constrained::MixedSigmas(mu, r.readVector());
+    }
+    case kDiagonal:
+      return Diagonal::Sigmas(r.readVector(), false);
+    case kGaussian:
+      return Gaussian::SqrtInformation(r.readMatrix(), false);
+    default:
+      throw runtime_error("BinarySnapshot: unknown noise model");
+  }
+}
+
+} // namespace
+
+/* ************************************************************************* */
+uint32_t BinarySnapshotTables::typeId(const string& name) {
+  const auto it = typeIds_.find(name);
+  if (it != typeIds_.end()) return it->second;
+  const uint32_t id = types_.size();
+  types_.push_back(name);
+  typeIds_.emplace(name, id);
+  return id;
+}
+
+/* ************************************************************************* */
+uint32_t BinarySnapshotTables::modelId(const SharedNoiseModel& model) {
+  if (!model) return kNone;
+  const auto it = modelIds_.find(model.get());
+  if (it != modelIds_.end()) return it->second;
+  // A robust model refers to its base model, which has to be read first
+  if (const noiseModel::Robust* robust = dynamic_cast<const noiseModel::Robust*>(model.get()))
+    modelId(robust->noise());
+  const uint32_t id = models_.size();
+  models_.push_back(model);
+  modelIds_.emplace(model.get(), id);
+  return id;
+}
+
+/* ************************************************************************* */
+void BinarySnapshotTables::write(BinaryWriter& w) const {
+  w.write<uint32_t>(types_.size());
+  for (const string& name : types_) {
+    w.write<uint32_t>(name.size());
+    w.writeBytes(name.data(), name.size());
+  }
+  w.write<uint32_t>(models_.size());
+  for (const SharedNoiseModel& model : models_)
+    writeModel(model, w);
+}
+
+/* ************************************************************************* */
+void BinarySnapshotTables::read(BinaryReader& r) {
+  types_.resize(r.readCount(sizeof(uint32_t)));
+  for (string& name : types_) {
+    name.resize(r.readCount(1));
+    r.readBytes(&name[0], name.size());
+  }
+  models_.clear();
+  const uint32_t nrModels = r.read<uint32_t>();
+  for (uint32_t i = 0; i < nrModels; i++)
+    models_.push_back(readModel(r));
+}
+
+/* ************************************************************************* */
+SharedNoiseModel BinaryReader::readNoiseModel() {
+  const uint32_t id = read<uint32_t>();
+  if (id == kNone) return SharedNoiseModel();
+  if (id >= tables_.models().size())
+    throw runtime_error("BinaryReader: invalid noise model id");
+  return tables_.models()[id];
+}
+
+/* ************************************************************************* */
+void BinarySnapshot::AddValue(const type_index& type, const ValueEntry& entry) {
+  registry().add(type, entry);
+}
+
+/* ************************************************************************* */
+void BinarySnapshot::AddFactor(const type_index& type, const FactorEntry& entry) {
+  registry().add(type, entry);
+}
+
+/* ************************************************************************* */
+const BinarySnapshot::ValueEntry& BinarySnapshot::Find(const Value& value) {
+  Registry& r = registry();
+  const ValueEntry* entry = r.find(r.values, type_index(typeid(value)));
+  if (!entry)
+    throw invalid_argument(string("BinarySnapshot: value type is not registered: ") + typeid(value).name());
+  return *entry;
+}
+
+/* ************************************************************************* */
+const BinarySnapshot::FactorEntry& BinarySnapshot::Find(const NonlinearFactor& factor) {
+  Registry& r = registry();
+  const FactorEntry* entry = r.find(r.factors, type_index(typeid(factor)));
+  if (!entry)
+    throw invalid_argument(string("BinarySnapshot: factor type is not registered: ") + typeid(factor).name());
+  return *entry;
+}
+
+/* ************************************************************************* */
+const BinarySnapshot::ValueEntry& BinarySnapshot::FindValue(const string& name) {
+  Registry& r = registry();
+  const ValueEntry* entry = r.find(r.valuesByName, name);
+  if (!entry)
+    throw runtime_error("BinarySnapshot: unknown value type " + name);
+  return *entry;
+}
+
+/* ************************************************************************* */
+const BinarySnapshot::FactorEntry& BinarySnapshot::FindFactor(const string& name) {
+  Registry& r = registry();
+  const FactorEntry* entry = r.find(r.factorsByName, name);
+  if (!entry)
+    throw runtime_error("BinarySnapshot: unknown factor type " + name);
+  return *entry;
+}
+
+/* ************************************************************************* */
+string BinarySnapshotWriter::write(const NonlinearFactorGraph& graph,
+    const Values& values, bool delta) {
+  BinarySnapshotTables tables;
+  string body;
+  BinaryWriter w(body, tables);
+
+  // Factor slots, empty or holding another factor than in the previous snapshot
+  vector<size_t> slots;
+  for (size_t i = 0; i < graph.size(); i++)
+    if (!delta || i >= factors_.size() || graph[i] != factors_[i])
+      slots.push_back(i);
+  w.write<uint64_t>(graph.size());
+  w.write<uint64_t>(slots.size());
+  for (size_t i : slots) {
+    w.write<uint64_t>(i);
+    if (!graph[i]) {
+      w.write<uint32_t>(kNone);
+    } else {
+      const BinarySnapshot::FactorEntry& entry = BinarySnapshot::Find(*graph[i]);
+      w.write<uint32_t>(tables.typeId(entry.name));
+      entry.write(*graph[i], w);
+    }
+  }
+
+  // Keys removed since the previous snapshot
+  KeyVector erased;
+  if (delta) {
+    for (const auto& key_encoded : values_)
+      if (!values.exists(key_encoded.first))
+        erased.push_back(key_encoded.first);
+  }
+
+  // Values whose type or encoding changed, compared as type name and payload.
+  // The baseline is only updated once everything is encoded, so that it stays
+  // valid if an unregistered type throws.
+  string records, encoded;
+  BinaryWriter r(records, tables), v(encoded, tables);
+  vector<pair<Key, string> > changed;
+  for (const auto& key_value : values) {
+    const BinarySnapshot::ValueEntry& entry = BinarySnapshot::Find(key_value.value);
+    encoded.assign(entry.name.c_str(), entry.name.size() + 1);
+    entry.write(key_value.value, v);
+    if (delta) {
+      const auto previous = values_.find(key_value.key);
+      if (previous != values_.end() && previous->second == encoded) continue;
+    }
+    r.write<Key>(key_value.key);
+    r.write<uint32_t>(tables.typeId(entry.name));
+    records.append(encoded, entry.name.size() + 1, string::npos);
+    changed.emplace_back(key_value.key, encoded);
+  }
+  w.write<uint64_t>(changed.size());
+  body += records;
+  w.write<uint64_t>(erased.size());
+  for (Key key : erased) w.write<Key>(key);
+
+  // Header, type table and noise model table, then the records
+  string out;
+  BinaryWriter h(out, tables);
+  out.append(kMagic, sizeof(kMagic));
+  h.write<uint8_t>(kVersion);
+  h.write<uint8_t>(delta);
+  h.write<uint8_t>(kQuaternions);
+  tables.write(h);
+  out += body;
+
+  // The snapshot is complete, it becomes the baseline of the next delta
+  factors_.assign(graph.begin(), graph.end());
+  if (!delta) values_.clear();
+  for (Key key : erased) values_.erase(key);
+  for (pair<Key, string>& key_encoded : changed)
+    values_[key_encoded.first].swap(key_encoded.second);
+  return out;
+}
+
+/* ************************************************************************* */
+void BinarySnapshotReader::apply(const string& snapshot) {
+  BinarySnapshotTables tables;
+  BinaryReader r(snapshot, tables);
+
+  char magic[sizeof(kMagic)];
+  r.readBytes(magic, sizeof(magic));
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    throw runtime_error("BinarySnapshotReader: not a binary snapshot");
+  if (r.read<uint8_t>() != kVersion)
+    throw runtime_error("BinarySnapshotReader: unsupported snapshot version");
+  const bool delta = r.read<uint8_t>();
+  if (r.read<uint8_t>() != kQuaternions)
+    throw runtime_error("BinarySnapshotReader: snapshot was written with another GTSAM_USE_QUATERNIONS");
+
+  tables.read(r);
+  const vector<string>& types = tables.types();
+
+  // Decode everything before touching the current state, so that a truncated
+  // or corrupt snapshot leaves it unchanged
+  NonlinearFactorGraph graph;
+  if (delta) graph = graph_;
+  // A factor record holds at least a slot and a type id, and every slot past
+  // the end of the previous snapshot has a record
+  const uint64_t nrSlots = r.read<uint64_t>();
+  const size_t nrFactors = r.readCount<uint64_t>(sizeof(uint64_t) + sizeof(uint32_t));
+  if (nrFactors > nrSlots || nrSlots > graph.size() + nrFactors)
+    throw runtime_error("BinarySnapshotReader: invalid number of factor slots");
+  graph.resize(nrSlots);
+  for (uint64_t k = 0; k < nrFactors; k++) {
+    const uint64_t slot = r.read<uint64_t>();
+    const uint32_t id = r.read<uint32_t>();
+    if (slot >= nrSlots || (id != kNone && id >= types.size()))
+      throw runtime_error("BinarySnapshotReader: invalid factor record");
+    if (id == kNone)
+      graph[slot].reset();
+    else
+      graph[slot] = BinarySnapshot::FindFactor(types[id]).read(r);
+  }
+
+  Values changed;
+  const uint64_t nrValues = r.read<uint64_t>();
+  for (uint64_t k = 0; k < nrValues; k++) {
+    const Key key = r.read<Key>();
+    const uint32_t id = r.read<uint32_t>();
+    if (id >= types.size() || changed.exists(key))
+      throw runtime_error("BinarySnapshotReader: invalid value record");
+    BinarySnapshot::FindValue(types[id]).read(key, r, changed);
+  }
+
+  KeyVector erased;
+  const uint64_t nrErased = r.read<uint64_t>();
+  for (uint64_t k = 0; k < nrErased; k++)
+    erased.push_back(r.read<Key>());
+
+  if (!r.atEnd())
+    throw runtime_error("BinarySnapshotReader: unexpected data after the snapshot");
+
+  // Replace the graph, and apply the values, which cannot fail anymore
+  graph_ = graph;
+  if (!delta) values_.clear();
+  for (const auto& key_value : changed) {
+    if (values_.exists(key_value.key)) values_.erase(key_value.key);
+    values_.insert(key_value.key, key_value.value);
+  }
+  for (Key key : erased)
+    if (values_.exists(key)) values_.erase(key);
+}
+
+/* ************************************************************************* */
+string serializeBinarySnapshot(const NonlinearFactorGraph& graph, const Values& values) {
+  return BinarySnapshotWriter().full(graph, values);
+}
+
+/* ************************************************************************* */
+void deserializeBinarySnapshot(const string& snapshot, NonlinearFactorGraph& graph,
+    Values& values) {
+  BinarySnapshotReader reader;
+  reader.apply(snapshot);
+  graph = reader.graph();
+  values = reader.values();
+}
+
+} // \namespace gtsam
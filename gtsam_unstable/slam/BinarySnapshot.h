@@ -0,0 +1,429 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file BinarySnapshot.h
+ * @brief Compact binary snapshots of a NonlinearFactorGraph and Values, without Boost archives
+ */
+
+#pragma once
+
+#include <gtsam_unstable/base/dllexport.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/FastMap.h>
+
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Encoding and decoding of one type in a binary snapshot. Specialize it for
+ * every value and factor type to be snapshotted, and register the type with
+ * BinarySnapshot::RegisterValue or BinarySnapshot::RegisterFactor. A value
+ * codec provides
+ *   static void Write(const T& x, BinaryWriter& w);
+ *   static T Read(BinaryReader& r);
+ * and a factor codec the same, with Read returning a shared pointer.
+ */
+template <class T>
+struct BinaryCodec;
+
+class BinaryWriter;
+class BinaryReader;
+
+/// Noise models and type names referenced by the records of one snapshot
+class GTSAM_UNSTABLE_EXPORT BinarySnapshotTables {
+  std::vector<std::string> types_;
+  std::map<std::string, uint32_t> typeIds_;
+  std::vector<SharedNoiseModel> models_;
+  std::map<const noiseModel::Base*, uint32_t> modelIds_;
+
+public:
+  /// Id of a type name, adding it if needed
+  uint32_t typeId(const std::string& name);
+
+  /// Id of a noise model, adding it and the models it refers to if needed
+  uint32_t modelId(const SharedNoiseModel& model);
+
+  const std::vector<std::string>& types() const { return types_; }
+  const std::vector<SharedNoiseModel>& models() const { return models_; }
+
+  /// Write both tables, once all records referring to them are written
+  void write(BinaryWriter& w) const;
+
+  /// Read the tables written by write, with a reader of these tables since a
+  /// robust model refers to its base model. Throws std::runtime_error if malformed.
+  void read(BinaryReader& r);
+};
+
+/// Appends plain data, raw Eigen buffers and noise model ids to a snapshot
+class GTSAM_UNSTABLE_EXPORT BinaryWriter {
+  std::string& out_;
+  BinarySnapshotTables& tables_;
+
+public:
+  BinaryWriter(std::string& out, BinarySnapshotTables& tables) :
+      out_(out), tables_(tables) {}
+
+  /// Write raw bytes
+  void writeBytes(const void* data, size_t size) {
+    out_.append(reinterpret_cast<const char*>(data), size);
+  }
+
+  /// Write a number as its raw bytes
+  template <typename T>
+  void write(T x) {
+    static_assert(std::is_arithmetic<T>::value, "BinaryWriter::write: T must be arithmetic");
+    out_.append(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+
+  /// Write the coefficients of a matrix of fixed size, without dimensions
+  template <class DERIVED>
+  void writeFixed(const Eigen::MatrixBase<DERIVED>& m) {
+    const typename DERIVED::PlainObject plain(m);
+    out_.append(reinterpret_cast<const char*>(plain.data()), plain.size() * sizeof(double));
+  }
+
+  /// Write a matrix of any size, with its dimensions
+  template <class DERIVED>
+  void writeMatrix(const Eigen::MatrixBase<DERIVED>& m) {
+    write<uint32_t>(m.rows());
+    write<uint32_t>(m.cols());
+    writeFixed(m);
+  }
+
+  /// Write a noise model as an id in the snapshot's deduplicated table
+  void writeNoiseModel(const SharedNoiseModel& model) {
+    write<uint32_t>(tables_.modelId(model));
+  }
+
+  /// Write the keys of a factor
+  void writeKeys(const KeyVector& keys) {
+    write<uint32_t>(keys.size());
+    out_.append(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(Key));
+  }
+};
+
+/// Reads what a BinaryWriter wrote, throws std::runtime_error if the snapshot is truncated
+class GTSAM_UNSTABLE_EXPORT BinaryReader {
+  const char* pos_;
+  const char* end_;
+  const BinarySnapshotTables& tables_;
+
+public:
+  BinaryReader(const std::string& in, const BinarySnapshotTables& tables) :
+      pos_(in.data()), end_(in.data() + in.size()), tables_(tables) {}
+
+  /// Copy size bytes to out
+  void readBytes(void* out, size_t size) {
+    if (size > static_cast<size_t>(end_ - pos_))
+      throw std::runtime_error("BinaryReader: snapshot is truncated");
+    std::memcpy(out, pos_, size);
+    pos_ += size;
+  }
+
+  template <typename T>
+  T read() {
+    static_assert(std::is_arithmetic<T>::value, "BinaryReader::read: T must be arithmetic");
+    T x;
+    readBytes(&x, sizeof(T));
+    return x;
+  }
+
+  /// Read a matrix of fixed size written with writeFixed
+  template <class MATRIX>
+  MATRIX readFixed() {
+    MATRIX m;
+    readBytes(m.data(), m.size() * sizeof(double));
+    return m;
+  }
+
+  /// Read a count of items of at least itemSize bytes each, checking that they
+  /// fit in what is left, before anything is allocated for them. COUNT is the
+  /// type the count was written as.
+  template <typename COUNT = uint32_t>
+  size_t readCount(size_t itemSize) {
+    const COUNT count = read<COUNT>();
+    if (itemSize > 0 && count > remaining() / itemSize)
+      throw std::runtime_error("BinaryReader: snapshot is truncated");
+    return count;
+  }
+
+  /// Read a matrix written with writeMatrix
+  Matrix readMatrix() {
+    const uint32_t rows = read<uint32_t>(), cols = read<uint32_t>();
+    if (rows > 0 && cols > remaining() / sizeof(double) / rows)
+      throw std::runtime_error("BinaryReader: snapshot is truncated");
+    Matrix m(rows, cols);
+    readBytes(m.data(), m.size() * sizeof(double));
+    return m;
+  }
+
+  /// Read a vector written with writeMatrix
+  Vector readVector() {
+    const Matrix m = readMatrix();
+    if (m.cols() != 1 && m.size() != 0)
+      throw std::runtime_error("BinaryReader: expected a vector");
+    return Vector(Eigen::Map<const Vector>(m.data(), m.size()));
+  }
+
+  SharedNoiseModel readNoiseModel();
+
+  KeyVector readKeys() {
+    KeyVector keys(readCount(sizeof(Key)));
+    readBytes(keys.data(), keys.size() * sizeof(Key));
+    return keys;
+  }
+
+  const BinarySnapshotTables& tables() const { return tables_; }
+
+  /// Number of bytes left to read
+  size_t remaining() const { return end_ - pos_; }
+
+  bool atEnd() const { return pos_ == end_; }
+};
+
+/**
+ * Registry of the types that can appear in a binary snapshot. Every type is
+ * stored under its name, which a snapshot lists once in its type table, so the
+ * records only carry a small integer id. The common geometry values and their
+ * PriorFactor and BetweenFactor are registered by default. Types can be
+ * registered while other threads write or read snapshots.
+ */
+class GTSAM_UNSTABLE_EXPORT BinarySnapshot {
+public:
+  typedef boost::function<void(const Value&, BinaryWriter&)> ValueWriter;
+  typedef boost::function<void(Key, BinaryReader&, Values&)> ValueReader;
+  typedef boost::function<void(const NonlinearFactor&, BinaryWriter&)> FactorWriter;
+  typedef boost::function<NonlinearFactor::shared_ptr(BinaryReader&)> FactorReader;
+
+  struct ValueEntry { std::string name; ValueWriter write; ValueReader read; };
+  struct FactorEntry { std::string name; FactorWriter write; FactorReader read; };
+
+  /// Entry of a value type, with the codec BinaryCodec<T>
+  template <class T>
+  static ValueEntry MakeValueEntry(const std::string& name) {
+    ValueEntry entry;
+    entry.name = name;
+    entry.write = [](const Value& value, BinaryWriter& w) {
+      BinaryCodec<T>::Write(static_cast<const GenericValue<T>&>(value).value(), w);
+    };
+    entry.read = [](Key key, BinaryReader& r, Values& values) {
+      values.insert(key, BinaryCodec<T>::Read(r));
+    };
+    return entry;
+  }
+
+  /// Entry of a factor type, with the codec BinaryCodec<FACTOR>
+  template <class FACTOR>
+  static FactorEntry MakeFactorEntry(const std::string& name) {
+    FactorEntry entry;
+    entry.name = name;
+    entry.write = [](const NonlinearFactor& factor, BinaryWriter& w) {
+      BinaryCodec<FACTOR>::Write(static_cast<const FACTOR&>(factor), w);
+    };
+    entry.read = [](BinaryReader& r) -> NonlinearFactor::shared_ptr {
+      return BinaryCodec<FACTOR>::Read(r);
+    };
+    return entry;
+  }
+
+  /// Register a value type, with the codec BinaryCodec<T>
+  template <class T>
+  static void RegisterValue(const std::string& name) {
+    AddValue(typeid(GenericValue<T>), MakeValueEntry<T>(name));
+  }
+
+  /// Register a factor type, with the codec BinaryCodec<FACTOR>
+  template <class FACTOR>
+  static void RegisterFactor(const std::string& name) {
+    AddFactor(typeid(FACTOR), MakeFactorEntry<FACTOR>(name));
+  }
+
+  /// Entry of a registered value, throws std::invalid_argument if not registered
+  static const ValueEntry& Find(const Value& value);
+
+  /// Entry of a registered factor, throws std::invalid_argument if not registered
+  static const FactorEntry& Find(const NonlinearFactor& factor);
+
+  /// Entries by name, throw std::runtime_error if not registered
+  static const ValueEntry& FindValue(const std::string& name);
+  static const FactorEntry& FindFactor(const std::string& name);
+
+private:
+  static void AddValue(const std::type_index& type, const ValueEntry& entry);
+  static void AddFactor(const std::type_index& type, const FactorEntry& entry);
+};
+
+/**
+ * Writes full and delta binary snapshots of a graph and its values, e.g., the
+ * state of a smoother for crash recovery. A delta snapshot only holds the
+ * factor slots whose factor changed since the previous snapshot, compared by
+ * pointer since factors are not modified in place, the values whose encoding
+ * changed, and the keys that were removed.
+ *
+ * Coefficients are stored as raw native doubles, so a snapshot is meant to be
+ * read back on the same platform and with the same GTSAM_USE_QUATERNIONS.
+ */
+class GTSAM_UNSTABLE_EXPORT BinarySnapshotWriter {
+  std::vector<NonlinearFactor::shared_ptr> factors_; ///< factors of the previous snapshot
+  FastMap<Key, std::string> values_; ///< encoded values of the previous snapshot
+
+  std::string write(const NonlinearFactorGraph& graph, const Values& values, bool delta);
+
+public:
+  /// Snapshot of everything, and the baseline of the next delta
+  std::string full(const NonlinearFactorGraph& graph, const Values& values) {
+    return write(graph, values, false);
+  }
+
+  /// Snapshot of what changed since the previous snapshot
+  std::string delta(const NonlinearFactorGraph& graph, const Values& values) {
+    return write(graph, values, true);
+  }
+};
+
+/// Rebuilds the graph and values from a full snapshot and the deltas that follow it
+class GTSAM_UNSTABLE_EXPORT BinarySnapshotReader {
+  NonlinearFactorGraph graph_;
+  Values values_;
+
+public:
+  /// Apply a full or a delta snapshot, throws std::runtime_error if it is malformed
+  void apply(const std::string& snapshot);
+
+  const NonlinearFactorGraph& graph() const { return graph_; }
+  const Values& values() const { return values_; }
+};
+
+/// Full binary snapshot of a graph and values
+GTSAM_UNSTABLE_EXPORT std::string serializeBinarySnapshot(
+    const NonlinearFactorGraph& graph, const Values& values);
+
+/// Read a full binary snapshot
+GTSAM_UNSTABLE_EXPORT void deserializeBinarySnapshot(const std::string& snapshot,
+    NonlinearFactorGraph& graph, Values& values);
+
+/* ************************************************************************* */
+// Codecs of the types registered by default
+
+template <>
+struct BinaryCodec<double> {
+  static void Write(double x, BinaryWriter& w) { w.write(x); }
+  static double Read(BinaryReader& r) { return r.read<double>(); }
+};
+
+template <>
+struct BinaryCodec<Vector> {
+  static void Write(const Vector& x, BinaryWriter& w) { w.writeMatrix(x); }
+  static Vector Read(BinaryReader& r) { return r.readVector(); }
+};
+
+template <>
+struct BinaryCodec<Point2> {
+  static void Write(const Point2& x, BinaryWriter& w) { w.writeFixed(Vector2(x)); }
+  static Point2 Read(BinaryReader& r) { return Point2(r.readFixed<Vector2>()); }
+};
+
+template <>
+struct BinaryCodec<Point3> {
+  static void Write(const Point3& x, BinaryWriter& w) { w.writeFixed(Vector3(x)); }
+  static Point3 Read(BinaryReader& r) { return Point3(r.readFixed<Vector3>()); }
+};
+
+template <>
+struct BinaryCodec<Rot2> {
+  static void Write(const Rot2& x, BinaryWriter& w) { w.write(x.c()); w.write(x.s()); }
+  static Rot2 Read(BinaryReader& r) {
+    const double c = r.read<double>();
+    return Rot2::fromCosSin(c, r.read<double>());
+  }
+};
+
+template <>
+struct BinaryCodec<Rot3> {
+#ifdef GTSAM_USE_QUATERNIONS
+  static void Write(const Rot3& x, BinaryWriter& w) { w.writeFixed(x.toQuaternion().coeffs()); }
+  static Rot3 Read(BinaryReader& r) { return Rot3(Quaternion(r.readFixed<Vector4>())); }
+#else
+  static void Write(const Rot3& x, BinaryWriter& w) { w.writeFixed(x.matrix()); }
+  static Rot3 Read(BinaryReader& r) { return Rot3(r.readFixed<Matrix3>()); }
+#endif
+};
+
+template <>
+struct BinaryCodec<Pose2> {
+  static void Write(const Pose2& x, BinaryWriter& w) {
+    BinaryCodec<Rot2>::Write(x.r(), w);
+    BinaryCodec<Point2>::Write(x.t(), w);
+  }
+  static Pose2 Read(BinaryReader& r) {
+    const Rot2 R = BinaryCodec<Rot2>::Read(r);
+    return Pose2(R, BinaryCodec<Point2>::Read(r));
+  }
+};
+
+template <>
+struct BinaryCodec<Pose3> {
+  static void Write(const Pose3& x, BinaryWriter& w) {
+    BinaryCodec<Rot3>::Write(x.rotation(), w);
+    BinaryCodec<Point3>::Write(x.translation(), w);
+  }
+  static Pose3 Read(BinaryReader& r) {
+    const Rot3 R = BinaryCodec<Rot3>::Read(r);
+    return Pose3(R, BinaryCodec<Point3>::Read(r));
+  }
+};
+
+template <class VALUE>
+struct BinaryCodec<PriorFactor<VALUE> > {
+  static void Write(const PriorFactor<VALUE>& f, BinaryWriter& w) {
+    w.write<Key>(f.key());
+    BinaryCodec<VALUE>::Write(f.prior(), w);
+    w.writeNoiseModel(f.noiseModel());
+  }
+  static boost::shared_ptr<PriorFactor<VALUE> > Read(BinaryReader& r) {
+    const Key key = r.read<Key>();
+    const VALUE prior = BinaryCodec<VALUE>::Read(r);
+    return boost::make_shared<PriorFactor<VALUE> >(key, prior, r.readNoiseModel());
+  }
+};
+
+template <class VALUE>
+struct BinaryCodec<BetweenFactor<VALUE> > {
+  static void Write(const BetweenFactor<VALUE>& f, BinaryWriter& w) {
+    w.write<Key>(f.key1());
+    w.write<Key>(f.key2());
+    BinaryCodec<VALUE>::Write(f.measured(), w);
+    w.writeNoiseModel(f.noiseModel());
+  }
+  static boost::shared_ptr<BetweenFactor<VALUE> > Read(BinaryReader& r) {
+    const Key key1 = r.read<Key>(), key2 = r.read<Key>();
+    const VALUE measured = BinaryCodec<VALUE>::Read(r);
+    return boost::make_shared<BetweenFactor<VALUE> >(key1, key2, measured, r.readNoiseModel());
+  }
+};
+
+} // \namespace gtsam
@@ -0,0 +1,185 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testBinarySnapshot.cpp
+ * @brief Unit tests for compact binary snapshots
+ */
+
+#include <gtsam_unstable/slam/BinarySnapshot.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/sam/RangeFactor.h>
+#include <gtsam/base/Testable.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+Values exampleValues() {
+  Values result;
+  result.insert(234, Rot2::fromAngle(0.1));
+  result.insert(123, Point2(1.0, 2.0));
+  result.insert(254, Pose2(1.0, 2.0, 0.3));
+  result.insert(678, Rot3::Rx(0.1));
+  result.insert(498, Point3(1.0, 2.0, 3.0));
+  result.insert(345, Pose3(Rot3::Rx(0.1), Point3(1.0, 2.0, 3.0)));
+  result.insert(999, (Vector(4) << 1, 2, 3, 4).finished());
+  result.insert(1000, 3.5);
+  return result;
+}
+
+NonlinearFactorGraph exampleGraph() {
+  SharedNoiseModel shared = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.3));
+  SharedNoiseModel robust = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345), shared);
+  NonlinearFactorGraph graph;
+  graph.add(PriorFactor<Pose2>(254, Pose2(1.0, 2.0, 0.3), shared));
+  graph.add(BetweenFactor<Pose2>(254, 255, Pose2(1.0, 0.0, 0.1), shared));
+  graph.add(BetweenFactor<Pose2>(255, 256, Pose2(1.0, 0.0, 0.1), robust));
+  graph.add(PriorFactor<Pose3>(345, Pose3(), noiseModel::Isotropic::Sigma(6, 0.5)));
+  graph.add(BetweenFactor<Point3>(498, 499, Point3(1, 0, 0), noiseModel::Unit::Create(3)));
+  graph.add(PriorFactor<Rot3>(678, Rot3::Ry(0.2), noiseModel::Constrained::All(3)));
+  graph.add(PriorFactor<Point2>(123, Point2(1, 2),
+      noiseModel::Gaussian::Covariance((Matrix2() << 2, 0.5, 0.5, 1).finished())));
+  graph.push_back(NonlinearFactor::shared_ptr()); // an empty slot, as ISAM2 leaves them
+  return graph;
+}
+}
+
+/* ************************************************************************* */
+TEST(BinarySnapshot, roundTrip) {
+  const NonlinearFactorGraph graph = exampleGraph();
+  const Values values = exampleValues();
+
+  const string snapshot = serializeBinarySnapshot(graph, values);
+  NonlinearFactorGraph actualGraph;
+  Values actualValues;
+  deserializeBinarySnapshot(snapshot, actualGraph, actualValues);
+
+  EXPECT(assert_equal(values, actualValues, 1e-15));
+  EXPECT(assert_equal(graph, actualGraph, 1e-12));
+  EXPECT(!actualGraph.back());
+
+  // The noise model shared by the first two factors is stored once
+  typedef NoiseModelFactor F;
+  EXPECT(boost::static_pointer_cast<F>(actualGraph[0])->noiseModel()
+      == boost::static_pointer_cast<F>(actualGraph[1])->noiseModel());
+}
+
+/* ************************************************************************* */
+TEST(BinarySnapshot, delta) {
+  NonlinearFactorGraph graph = exampleGraph();
+  Values values = exampleValues();
+
+  BinarySnapshotWriter writer;
+  BinarySnapshotReader reader;
+  const string full = writer.full(graph, values);
+  reader.apply(full);
+
+  // Nothing changed: the delta is only the header and counts
+  const string empty = writer.delta(graph, values);
+  EXPECT(empty.size() < 64);
+  reader.apply(empty);
+  EXPECT(assert_equal(values, reader.values(), 1e-15));
+  EXPECT(assert_equal(graph, reader.graph(), 1e-12));
+
+  // Update a value, remove another, add a factor and replace one
+  values.update(254, Pose2(1.1, 2.0, 0.3));
+  values.erase(1000);
+  values.insert(255, Pose2(2.0, 2.0, 0.4));
+  graph.add(BetweenFactor<Pose2>(255, 256, Pose2(1.0, 0.0, 0.1), noiseModel::Unit::Create(3)));
+  graph.replace(4, boost::make_shared<BetweenFactor<Point3> >(498, 499, Point3(2, 0, 0),
+      noiseModel::Unit::Create(3)));
+  graph.remove(1);
+  const string delta = writer.delta(graph, values);
+  EXPECT(delta.size() < full.size() / 2);
+  reader.apply(delta);
+  EXPECT(assert_equal(values, reader.values(), 1e-15));
+  EXPECT(assert_equal(graph, reader.graph(), 1e-12));
+
+  // A full snapshot replaces everything
+  reader.apply(writer.full(exampleGraph(), exampleValues()));
+  EXPECT(assert_equal(exampleValues(), reader.values(), 1e-15));
+  EXPECT_LONGS_EQUAL(8, reader.graph().size());
+}
+
+/* ************************************************************************* */
+TEST(BinarySnapshot, errors) {
+  // Types without a codec
+  NonlinearFactorGraph graph;
+  graph.add(RangeFactor<Pose2, Point2>(1, 2, 1.0, noiseModel::Unit::Create(1)));
+  CHECK_EXCEPTION(serializeBinarySnapshot(graph, Values()), std::invalid_argument);
+
+  // Truncated and corrupt snapshots
+  const string snapshot = serializeBinarySnapshot(exampleGraph(), exampleValues());
+  BinarySnapshotReader reader;
+  CHECK_EXCEPTION(reader.apply(snapshot.substr(0, snapshot.size() - 1)), std::runtime_error);
+  CHECK_EXCEPTION(reader.apply("not a snapshot"), std::runtime_error);
+
+  // Sizes that do not fit in the snapshot are rejected before allocating
+  const BinarySnapshotTables tables;
+  const string huge(24, '\xff');
+  BinaryReader matrixReader(huge, tables);
+  CHECK_EXCEPTION(matrixReader.readMatrix(), std::runtime_error);
+  BinaryReader keysReader(huge, tables);
+  CHECK_EXCEPTION(keysReader.readKeys(), std::runtime_error);
+
+  // Corrupt factor counts in the header, which are the first 16 of the 32
+  // bytes of counts that end an empty snapshot
+  const string empty = serializeBinarySnapshot(NonlinearFactorGraph(), Values());
+  reader.apply(empty);
+  for (size_t offset : {empty.size() - 32, empty.size() - 24}) {
+    string corrupt = empty;
+    corrupt.replace(offset, 8, 8, '\xff');
+    CHECK_EXCEPTION(reader.apply(corrupt), std::runtime_error);
+  }
+  string moreFactorsThanSlots = empty;
+  moreFactorsThanSlots[empty.size() - 24] = 1;
+  CHECK_EXCEPTION(reader.apply(moreFactorsThanSlots), std::runtime_error);
+}
+
+/* ************************************************************************* */
+TEST(BinarySnapshot, failedDelta) {
+  NonlinearFactorGraph graph = exampleGraph();
+  Values values = exampleValues();
+  BinarySnapshotWriter writer;
+  BinarySnapshotReader reader;
+  reader.apply(writer.full(graph, values));
+
+  // Change a factor and a value, and add a value that has no codec
+  graph.replace(4, boost::make_shared<BetweenFactor<Point3> >(498, 499, Point3(2, 0, 0),
+      noiseModel::Unit::Create(3)));
+  values.update(254, Pose2(1.1, 2.0, 0.3));
+  values.insert(2000, Cal3_S2());
+  CHECK_EXCEPTION(writer.delta(graph, values), std::invalid_argument);
+
+  // The writer still compares against the full snapshot
+  values.erase(2000);
+  const string delta = writer.delta(graph, values);
+
+  // A truncated delta leaves the reader as it was
+  CHECK_EXCEPTION(reader.apply(delta.substr(0, delta.size() - 1)), std::runtime_error);
+  EXPECT(assert_equal(exampleValues(), reader.values(), 1e-15));
+  EXPECT(assert_equal(exampleGraph(), reader.graph(), 1e-12));
+
+  reader.apply(delta);
+  EXPECT(assert_equal(values, reader.values(), 1e-15));
+  EXPECT(assert_equal(graph, reader.graph(), 1e-12));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
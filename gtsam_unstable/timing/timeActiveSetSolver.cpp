@@ -0,0 +1,102 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeActiveSetSolver.cpp
+ * @brief   Time the iterations of the active set solver with and without
+ *          reusing the elimination of unchanged clusters, and a model
+ *          predictive control loop solved cold, from zero, and warm-started
+ */
+
+#include <gtsam_unstable/linear/QPSolver.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+// A smoothed chain pulled towards target, with x_i + x_{i+1} <= 3 on every edge
+QP createChain(size_t n, double target) {
+  QP qp;
+  for (size_t i = 0; i < n; ++i) {
+    const double t = i < n / 2 ? target : 0.0;
+    qp.cost.push_back(JacobianFactor(X(i), I_1x1, t * I_1x1));
+    if (i + 1 < n) {
+      qp.cost.push_back(JacobianFactor(X(i), I_1x1, X(i + 1), -I_1x1, Z_1x1));
+      qp.inequalities.push_back(
+          LinearInequality(X(i), I_1x1, X(i + 1), I_1x1, 3.0, i));
+    }
+  }
+  return qp;
+}
+
+int main(int argc, char* argv[]) {
+
+  const size_t nrVariables = argc > 1 ? atoi(argv[1]) : 1000;
+  const size_t nrSteps = argc > 2 ? atoi(argv[2]) : 20;
+
+  // Iterations from every constraint tight, with and without the factorization
+  // of the previous iteration
+  const QP problem = createChain(nrVariables, 2.0);
+  const QPSolver solver(problem);
+  VectorValues initialValues;
+  for (size_t i = 0; i < nrVariables; ++i)
+    initialValues.insert(X(i), (Vector(1) << 1.5).finished());
+  size_t iterations = 0;
+  {
+    gttic_(full);
+    QPSolver::State state(initialValues, VectorValues(),
+        solver.identifyActiveConstraints(problem.inequalities, initialValues),
+        false, 0);
+    while (!state.converged)
+      state = solver.iterate(QPSolver::State(state.values, state.duals,
+          state.workingSet, false, state.iterations));
+  }
+  {
+    gttic_(incremental);
+    QPSolver::State state(initialValues, VectorValues(),
+        solver.identifyActiveConstraints(problem.inequalities, initialValues),
+        false, 0);
+    while (!state.converged) state = solver.iterate(state);
+    iterations = state.iterations;
+  }
+  cout << nrVariables << " variables, " << iterations << " iterations" << endl;
+
+  // A control loop whose target moves a little at every step
+  vector<QP> steps;
+  for (size_t t = 0; t < nrSteps; ++t)
+    steps.push_back(createChain(nrVariables, 2.0 + 0.01 * t));
+  VectorValues zero;
+  for (size_t i = 0; i < nrVariables; ++i) zero.insert(X(i), Z_1x1);
+  {
+    gttic_(cold);
+    for (size_t t = 0; t < nrSteps; ++t) QPSolver(steps[t]).optimize(zero);
+  }
+  {
+    gttic_(warm);
+    boost::shared_ptr<QPSolver> previous = boost::make_shared<QPSolver>(steps[0]);
+    VectorValues values, duals;
+    boost::tie(values, duals) = previous->optimize(zero);
+    for (size_t t = 1; t < nrSteps; ++t) {
+      boost::shared_ptr<QPSolver> current =
+          boost::make_shared<QPSolver>(steps[t], *previous);
+      boost::tie(values, duals) = current->optimizeWarmStart(values, duals);
+      previous = current;
+    }
+  }
+
+  tictoc_print_();
+  return 0;
+}
@@ -0,0 +1,88 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file timeBinarySnapshot.cpp
+ * @brief Time and size of binary snapshots of a pose graph, compared to Boost binary archives
+ */
+
+#include <gtsam_unstable/slam/BinarySnapshot.h>
+#include <gtsam/base/serialization.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/serialization/export.hpp>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal, "gtsam_noiseModel_Diagonal");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic, "gtsam_noiseModel_Isotropic");
+BOOST_CLASS_EXPORT_GUID(gtsam::SharedNoiseModel, "gtsam_SharedNoiseModel");
+BOOST_CLASS_EXPORT_GUID(gtsam::SharedDiagonal, "gtsam_SharedDiagonal");
+GTSAM_VALUE_EXPORT(gtsam::Pose3);
+BOOST_CLASS_EXPORT_GUID(gtsam::PriorFactor<gtsam::Pose3>, "gtsam::PriorFactorPose3");
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose3>, "gtsam::BetweenFactorPose3");
+
+int main() {
+  // A 3D pose chain with loop closures, as a smoother would hold it
+  const size_t n = 10000;
+  const SharedNoiseModel odometry = noiseModel::Diagonal::Sigmas(
+      (Vector(6) << 0.01, 0.01, 0.01, 0.1, 0.1, 0.1).finished());
+  NonlinearFactorGraph graph;
+  Values values;
+  graph.add(PriorFactor<Pose3>(0, Pose3(), noiseModel::Isotropic::Sigma(6, 1e-3)));
+  const Pose3 step(Rot3::Ypr(0.1, 0.01, 0.0), Point3(1, 0, 0));
+  Pose3 pose;
+  for (size_t i = 0; i < n; i++) {
+    values.insert(i, pose);
+    pose = pose * step;
+    if (i > 0) graph.add(BetweenFactor<Pose3>(i - 1, i, step, odometry));
+    if (i >= 60 && i % 10 == 0) graph.add(BetweenFactor<Pose3>(i - 60, i, Pose3(), odometry));
+  }
+
+  const size_t nrTrials = 10;
+  string boostGraph, boostValues, full, delta;
+  for (size_t trial = 0; trial < nrTrials; trial++) {
+    gttic_(boostBinary);
+    boostGraph = serializeBinary(graph);
+    boostValues = serializeBinary(values);
+    gttoc_(boostBinary);
+
+    gttic_(binarySnapshot);
+    full = serializeBinarySnapshot(graph, values);
+    gttoc_(binarySnapshot);
+    tictoc_finishedIteration_();
+  }
+
+  // Every second, the smoother adds a few poses and moves the recent ones
+  BinarySnapshotWriter writer;
+  writer.full(graph, values);
+  for (size_t trial = 0; trial < nrTrials; trial++) {
+    const size_t i = n + trial;
+    values.insert(i, pose);
+    pose = pose * step;
+    graph.add(BetweenFactor<Pose3>(i - 1, i, step, odometry));
+    for (size_t j = i - 20; j < i; j++)
+      values.update(j, values.at<Pose3>(j).retract(Vector6::Constant(1e-3)));
+    gttic_(binarySnapshotDelta);
+    delta = writer.delta(graph, values);
+    gttoc_(binarySnapshotDelta);
+    tictoc_finishedIteration_();
+  }
+
+  tictoc_print_();
+  cout << "Boost binary archive: " << boostGraph.size() + boostValues.size() << " bytes" << endl;
+  cout << "Binary snapshot:      " << full.size() << " bytes" << endl;
+  cout << "Binary delta:         " << delta.size() << " bytes" << endl;
+  return 0;
+}
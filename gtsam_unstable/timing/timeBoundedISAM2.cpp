@@ -0,0 +1,78 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file timeBoundedISAM2.cpp
+ * @brief Time the updates and size of ISAM2 with and without a variable or byte budget on a long run
+ */
+
+#include <gtsam_unstable/nonlinear/BoundedISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/timing.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+int main() {
+  const size_t n = 20000, window = 500, maxBytes = 1 << 20, reportEvery = 2000;
+  const SharedNoiseModel odometry = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01));
+  const Pose2 step(1.0, 0.0, 0.01);
+
+  ISAM2Params params;
+  params.maxFactorSlotMoves = 10;
+  BoundedISAM2 unbounded(BoundedISAM2Params(), params);
+  BoundedISAM2 bounded(BoundedISAM2Params(window), params);
+  BoundedISAM2 byteBounded(BoundedISAM2Params(0, maxBytes), params);
+
+  vector<Pose2> poses(1);
+  for (size_t i = 0; i < n; i++) {
+    // Odometry, and a loop closure to a recent pose every few steps
+    NonlinearFactorGraph factors;
+    Values values;
+    values.insert(i, poses[i]);
+    if (i == 0)
+      factors.add(PriorFactor<Pose2>(0, poses[0], odometry));
+    else
+      factors.add(BetweenFactor<Pose2>(i - 1, i, step, odometry));
+    if (i >= 20 && i % 5 == 0)
+      factors.add(BetweenFactor<Pose2>(i - 20, i, poses[i - 20].between(poses[i]), odometry));
+    poses.push_back(poses[i] * step);
+
+    gttic_(unbounded);
+    unbounded.update(factors, values);
+    gttoc_(unbounded);
+
+    gttic_(bounded);
+    bounded.update(factors, values);
+    gttoc_(bounded);
+
+    gttic_(byteBounded);
+    byteBounded.update(factors, values);
+    gttoc_(byteBounded);
+    tictoc_finishedIteration_();
+
+    if ((i + 1) % reportEvery == 0)
+      cout << i + 1 << " poses: unbounded " << unbounded.estimateBytes() / 1024
+           << " KiB, bounded " << bounded.estimateBytes() / 1024 << " KiB with "
+           << bounded.getLinearizationPoint().size() << " variables and "
+           << bounded.getFactorsUnsafe().size() << " factor slots, byte bounded "
+           << byteBounded.estimateBytes() / 1024 << " KiB with "
+           << byteBounded.getLinearizationPoint().size() << " variables" << endl;
+  }
+
+  tictoc_print_();
+  return 0;
+}
@@ -0,0 +1,153 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeConcurrentSynchronization.cpp
+ * @brief   Time the filter latency jitter of blocking versus lock-free filter/smoother synchronization
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentBatchFilter.h>
+#include <gtsam_unstable/nonlinear/ConcurrentBatchSmoother.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose3.h>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+using boost::format;
+
+namespace {
+
+const Pose3 poseOdometry(Rot3::RzRyRx(Vector3(0.05, 0.10, -0.75)), Point3(1.0, -0.25, 0.10));
+const SharedDiagonal noisePrior = noiseModel::Isotropic::Sigma(6, 0.10);
+const SharedDiagonal noiseOdometry = noiseModel::Diagonal::Sigmas((Vector(6) << 0.1, 0.1, 0.1, 0.5, 0.5, 0.5).finished());
+const size_t lag = 5;
+
+typedef chrono::steady_clock Clock;
+
+/* ************************************************************************* */
+void filterStep(ConcurrentBatchFilter& filter, Key key, Pose3& pose) {
+  NonlinearFactorGraph newFactors;
+  Values newValues;
+  if(key == 0) {
+    newFactors.push_back(PriorFactor<Pose3>(key, pose, noisePrior));
+  } else {
+    newFactors.push_back(BetweenFactor<Pose3>(key - 1, key, poseOdometry, noiseOdometry));
+    pose = pose.compose(poseOdometry);
+  }
+  newValues.insert(key, pose);
+  FastList<Key> keysToMove;
+  if(key >= lag)
+    keysToMove.push_back(key - lag);
+  filter.update(newFactors, newValues, keysToMove);
+}
+
+/* ************************************************************************* */
+void report(const string& name, const vector<double>& latencies) {
+  double mean = 0.0, maxLatency = 0.0;
+  for(double latency: latencies) {
+    mean += latency;
+    maxLatency = max(maxLatency, latency);
+  }
+  mean /= latencies.size();
+  double variance = 0.0;
+  for(double latency: latencies)
+    variance += (latency - mean) * (latency - mean);
+  const double stddev = sqrt(variance / latencies.size());
+  cout << format("%1%: mean %2% ms, stddev %3% ms, max %4% ms\n") % name % (1e3 * mean) % (1e3 * stddev) % (1e3 * maxLatency);
+}
+
+/* ************************************************************************* */
+// The filter and smoother share a mutex, the filter pauses while 'synchronize' runs
+vector<double> timeBlocking(size_t steps) {
+  ConcurrentBatchFilter filter;
+  ConcurrentBatchSmoother smoother;
+  mutex filterMutex;
+  atomic<bool> done(false);
+
+  thread smootherThread([&]() {
+    while(!done) {
+      {
+        lock_guard<mutex> lock(filterMutex);
+        synchronize(filter, smoother);
+      }
+      smoother.update();
+    }
+  });
+
+  vector<double> latencies;
+  latencies.reserve(steps);
+  Pose3 pose;
+  for(size_t step = 0; step < steps; ++step) {
+    Clock::time_point start = Clock::now();
+    {
+      lock_guard<mutex> lock(filterMutex);
+      filterStep(filter, step, pose);
+    }
+    latencies.push_back(chrono::duration<double>(Clock::now() - start).count());
+  }
+  done = true;
+  smootherThread.join();
+  return latencies;
+}
+
+/* ************************************************************************* */
+// The filter only ever consumes packets the smoother has already published
+vector<double> timeLockFree(size_t steps) {
+  ConcurrentBatchFilter filter;
+  ConcurrentBatchSmoother smoother;
+  ConcurrentSynchronizer synchronizer;
+  atomic<bool> done(false);
+
+  thread smootherThread([&]() {
+    while(!done) {
+      if(synchronizer.smootherSynchronize(smoother))
+        smoother.update();
+      else
+        this_thread::yield();
+    }
+  });
+
+  vector<double> latencies;
+  latencies.reserve(steps);
+  Pose3 pose;
+  for(size_t step = 0; step < steps; ++step) {
+    Clock::time_point start = Clock::now();
+    filterStep(filter, step, pose);
+    synchronizer.filterSynchronize(filter);
+    latencies.push_back(chrono::duration<double>(Clock::now() - start).count());
+  }
+  done = true;
+  smootherThread.join();
+  return latencies;
+}
+
+} // end namespace
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  const size_t steps = argc > 1 ? atoi(argv[1]) : 500;
+  cout << format("Filter latency over %1% steps\n") % steps;
+  report("Blocking synchronize", timeBlocking(steps));
+  report("Lock-free synchronizer", timeLockFree(steps));
+  return 0;
+}
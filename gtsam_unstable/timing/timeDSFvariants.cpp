@@ -19,12 +19,19 @@
 #include <gtsam/base/DSFVector.h>
 #include <gtsam_unstable/base/DSF.h>
 #include <gtsam/base/DSFMap.h>
+#include <gtsam/base/ConcurrentDSFVector.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_scheduler_init.h>
+#endif
 
 #include <boost/random.hpp>
-#include <boost/timer.hpp>
 #include <boost/format.hpp>
 #include <boost/assign/std/vector.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -33,14 +40,33 @@
 using namespace std;
 using namespace gtsam;
 using namespace boost::assign;
-using boost::timer;
 using boost::format;
 
+// Wall-clock time, since the parallel runs would be charged the CPU time of
+// all threads by boost::timer
+class timer {
+  chrono::steady_clock::time_point start_;
+public:
+  timer() : start_(chrono::steady_clock::now()) {}
+  double elapsed() const {
+    return chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+  }
+};
+
 int main(int argc, char* argv[]) {
 
   // Create CSV file for results
   ofstream os("dsf-timing.csv");
-  os << "images,points,matches,Base,Map,BTree" << endl;
+  os << "images,points,matches,Base,Map";
+#ifdef GTSAM_USE_TBB
+  vector<int> threadCounts;
+  threadCounts += 1, 2, 4, 8;
+  for(int nrThreads: threadCounts)
+    os << ",Concurrent" << nrThreads;
+#else
+  os << ",Concurrent";
+#endif
+  os << endl;
 
   // loop over number of images
   vector<size_t> ms;
@@ -85,10 +111,38 @@ int main(int argc, char* argv[]) {
       DSFMap<size_t> dsf;
       for(const Match& m: matches)
         dsf.merge(m.first, m.second);
-      os << tim.elapsed() << endl;
+      os << tim.elapsed();
       cout << format("DSFMap: %1% s") % tim.elapsed() << endl;
     }
 
+#ifdef GTSAM_USE_TBB
+    for(int nrThreads: threadCounts) {
+      // ConcurrentDSFVector version, merges and set extraction in parallel
+      tbb::task_scheduler_init init(nrThreads);
+      timer tim;
+      ConcurrentDSFVector dsf(N);
+      parallelFor(matches.size(), [&](size_t k) {
+        dsf.merge(matches[k].first, matches[k].second);
+      });
+      dsf.labels();
+      os << "," << tim.elapsed();
+      cout << format("ConcurrentDSFVector, %1% threads: %2% s") % nrThreads
+          % tim.elapsed() << endl;
+    }
+#else
+    {
+      // ConcurrentDSFVector version, single-threaded
+      timer tim;
+      ConcurrentDSFVector dsf(N);
+      for(const Match& m: matches)
+        dsf.merge(m.first, m.second);
+      dsf.labels();
+      os << "," << tim.elapsed();
+      cout << format("ConcurrentDSFVector: %1% s") % tim.elapsed() << endl;
+    }
+#endif
+    os << endl;
+
     if (false) {
       // DSF version, functional
       timer tim;
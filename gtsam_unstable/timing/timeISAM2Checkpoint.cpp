@@ -0,0 +1,67 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file timeISAM2Checkpoint.cpp
+ * @brief Time restarting ISAM2 from a checkpoint, compared to a batch update with all factors
+ */
+
+#include <gtsam_unstable/nonlinear/ISAM2Checkpoint.h>
+#include <gtsam/base/timing.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+int main() {
+  // A 3D pose chain with loop closures, as a smoother would hold it
+  const size_t n = 5000;
+  const SharedNoiseModel odometry = noiseModel::Diagonal::Sigmas(
+      (Vector(6) << 0.01, 0.01, 0.01, 0.1, 0.1, 0.1).finished());
+  NonlinearFactorGraph graph;
+  Values values;
+  graph.add(PriorFactor<Pose3>(0, Pose3(), noiseModel::Isotropic::Sigma(6, 1e-3)));
+  const Pose3 step(Rot3::Ypr(0.1, 0.01, 0.0), Point3(1, 0, 0));
+  Pose3 pose;
+  for (size_t i = 0; i < n; i++) {
+    values.insert(i, pose);
+    pose = pose * step;
+    if (i > 0) graph.add(BetweenFactor<Pose3>(i - 1, i, step, odometry));
+    if (i >= 60 && i % 10 == 0) graph.add(BetweenFactor<Pose3>(i - 60, i, Pose3(), odometry));
+  }
+
+  ISAM2 isam;
+  isam.update(graph, values);
+  string checkpoint;
+
+  const size_t nrTrials = 5;
+  for (size_t trial = 0; trial < nrTrials; trial++) {
+    gttic_(batchRestart);
+    ISAM2 batch;
+    batch.update(graph, values);
+    gttoc_(batchRestart);
+
+    gttic_(save);
+    checkpoint = ISAM2Checkpoint::Save(isam);
+    gttoc_(save);
+
+    gttic_(restore);
+    ISAM2 restored;
+    ISAM2Checkpoint::Restore(checkpoint, restored);
+    gttoc_(restore);
+    tictoc_finishedIteration_();
+  }
+
+  tictoc_print_();
+  cout << "Checkpoint: " << checkpoint.size() << " bytes" << endl;
+  return 0;
+}
@@ -0,0 +1,54 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeQPSParser.cpp
+ * @brief   Time parsing the example QPS files against solving them
+ */
+
+#include <gtsam_unstable/linear/QPSParser.h>
+#include <gtsam_unstable/linear/QPSolver.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char* argv[]) {
+
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 100;
+  const string files[] = {"QPExample.QPS", "HS21.QPS", "HS35.QPS", "HS35MOD.QPS",
+                          "HS51.QPS", "HS52.QPS", "HS268.QPS", "QPTEST.QPS"};
+
+  for (const string& file : files) {
+    QPSParser parser(file);
+    QP problem;
+    for (size_t i = 0; i < nrTrials; ++i) {
+      gttic_(parse);
+      problem = parser.Parse();
+    }
+    for (size_t i = 0; i < nrTrials; ++i) {
+      gttic_(solve);
+      QPSolver(problem).optimize();
+    }
+    cout << file << ": " << problem.cost.keys().size() << " variables, "
+         << problem.equalities.size() << " equalities, "
+         << problem.inequalities.size() << " inequalities" << endl;
+    tictoc_finishedIteration_();
+    tictoc_print_();
+    tictoc_reset_();
+  }
+
+  return 0;
+}
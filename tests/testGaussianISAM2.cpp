@@ -21,8 +21,10 @@
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/base/debug.h>
+#include <gtsam/base/SlabPool.h>
 #include <gtsam/base/TestableAssertions.h>
 #include <gtsam/base/treeTraversal-inst.h>
+#include <deque>
 #include <boost/assign/list_of.hpp>
 #include <gtsam/base/deprecated/LieScalar.h>
 using namespace boost::assign;
@@ -645,6 +647,25 @@ TEST(ISAM2, slamlike_solution_partial_relinearization_check)
   CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, slamlike_solution_incremental_reordering)
+{
+  // These variables will be reused and accumulate factors and values
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.incrementalReordering = true;
+  ISAM2 isam = createSlamlikeISAM2(fullinit, fullgraph, params);
+
+  // Compare solutions
+  CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+
+  // The same estimate as with a full reordering of the affected top
+  ISAM2 expected = createSlamlikeISAM2(boost::none, boost::none,
+      ISAM2Params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false));
+  EXPECT(assert_equal(expected.calculateEstimate(), isam.calculateEstimate(), 1e-6));
+}
+
 namespace {
   bool checkMarginalizeLeaves(ISAM2& isam, const FastList<Key>& leafKeys) {
     Matrix expectedAugmentedHessian, expected3AugmentedHessian;
@@ -838,6 +859,110 @@ TEST(ISAM2, marginalCovariance)
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+namespace {
+/// Check that the variable index holds exactly the factors of the graph
+bool indexMatchesFactors(const ISAM2& isam) {
+  const NonlinearFactorGraph& factors = isam.getFactorsUnsafe();
+  const VariableIndex expected(factors);
+  const VariableIndex& actual = isam.getVariableIndex();
+  if (actual.size() != expected.size() || actual.nEntries() != expected.nEntries() ||
+      actual.nFactors() != factors.size())
+    return false;
+  for (const VariableIndex::value_type& key_factors : expected) {
+    FactorIndexSet actualFactors(actual[key_factors.first].begin(),
+                                 actual[key_factors.first].end());
+    if (actualFactors != FactorIndexSet(key_factors.second.begin(),
+                                        key_factors.second.end()))
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ISAM2, compactFactorSlots)
+{
+  // A chain of 5 poses, with a sliding window of 3 loop closures that are
+  // replaced one per update
+  const SharedDiagonal noise = noiseModel::Isotropic::Sigma(3, 0.1);
+  NonlinearFactorGraph chain;
+  Values fullinit;
+  chain += PriorFactor<Pose2>(0, Pose2(), noise);
+  fullinit.insert(0, Pose2(0.01, 0.02, 0.03));
+  for (size_t i = 1; i < 5; i++) {
+    chain += BetweenFactor<Pose2>(i - 1, i, Pose2(1, 0, 0), noise);
+    fullinit.insert(i, Pose2(i + 0.1, -0.1, 0.05));
+  }
+
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.maxFactorSlotMoves = 5;
+  ISAM2 isam(params);
+  isam.update(chain, fullinit);
+
+  deque<FactorIndex> window;
+  deque<NonlinearFactor::shared_ptr> windowFactors;
+  for (size_t step = 0; step < 12; step++) {
+    const size_t i = step % 5, j = (step + 2) % 5;
+    NonlinearFactorGraph newFactors;
+    newFactors += BetweenFactor<Pose2>(i, j, Pose2(double(j) - double(i), 0, 0), noise);
+    FactorIndices toRemove;
+    if (window.size() == 3) {
+      toRemove.push_back(window.front());
+      window.pop_front();
+      windowFactors.pop_front();
+    }
+    ISAM2Result result = isam.update(newFactors, Values(), toRemove);
+
+    // Renumber the indices we keep, then add the new one
+    for (FactorIndex& index : window) {
+      const auto moved = result.movedFactors.find(index);
+      if (moved != result.movedFactors.end()) index = moved->second;
+    }
+    window.push_back(result.newFactorsIndices[0]);
+    windowFactors.push_back(newFactors[0]);
+
+    // The graph has no empty slots and the index is consistent with it
+    EXPECT_LONGS_EQUAL(5 + window.size(), isam.getFactorsUnsafe().size());
+    EXPECT_LONGS_EQUAL(5 + window.size(), isam.getFactorsUnsafe().nrFactors());
+    EXPECT(indexMatchesFactors(isam));
+    for (size_t k = 0; k < window.size(); k++)
+      EXPECT(isam.getFactorsUnsafe()[window[k]] == windowFactors[k]);
+  }
+
+  NonlinearFactorGraph fullgraph = chain;
+  for (const auto& factor : windowFactors) fullgraph.push_back(factor);
+  EXPECT(isam_check(fullgraph, fullinit, isam, *this, result_));
+}
+
+/* ************************************************************************* */
+namespace {
+// Exposes how many empty factor slots an ISAM2 keeps track of
+struct EmptySlotsISAM2 : public ISAM2 {
+  explicit EmptySlotsISAM2(const ISAM2Params& params) : ISAM2(params) {}
+  size_t nrEmptyFactorSlots() const { return emptyFactorSlots_.size(); }
+};
+}  // namespace
+
+TEST(ISAM2, emptyFactorSlotsNotTracked)
+{
+  // Without slot reuse or compaction, removed factors leave no record behind
+  const SharedDiagonal noise = noiseModel::Isotropic::Sigma(3, 0.1);
+  EmptySlotsISAM2 isam((ISAM2Params()));
+  NonlinearFactorGraph factors;
+  Values init;
+  factors += PriorFactor<Pose2>(0, Pose2(), noise);
+  init.insert(0, Pose2());
+  isam.update(factors, init);
+  for (size_t step = 0; step < 5; step++) {
+    NonlinearFactorGraph newFactors;
+    newFactors += PriorFactor<Pose2>(0, Pose2(), noise);
+    const ISAM2Result result = isam.update(newFactors, Values(), FactorIndices{step});
+    EXPECT_LONGS_EQUAL(step + 1, result.newFactorsIndices[0]);
+  }
+  EXPECT_LONGS_EQUAL(0, isam.nrEmptyFactorSlots());
+}
+
 /* ************************************************************************* */
 TEST(ISAM2, calculate_nnz)
 {
@@ -848,6 +973,88 @@ TEST(ISAM2, calculate_nnz)
   EXPECT_LONGS_EQUAL(expected, actual);
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, wildfireAfterLoopClosure)
+{
+  // A loop closure to the first pose of a chain replaces the whole tree, so
+  // that with TBB both the wildfire (more than 10% of the keys replaced) and
+  // the full recalculation run in parallel
+  const Pose2 step(1.0, 0.0, 0.1);
+  for (double wildfireThreshold : {1e-6, 0.0}) {
+    ISAM2Params params(ISAM2GaussNewtonParams(wildfireThreshold), 0.0, 0, false);
+    params.enableDetailedResults = true;
+    ISAM2 isam(params);
+
+    NonlinearFactorGraph factors;
+    Values values;
+    factors.add(PriorFactor<Pose2>(0, Pose2(), odoNoise));
+    values.insert(0, Pose2(0.01, -0.02, 0.0));
+    isam.update(factors, values);
+    Pose2 pose;
+    for (size_t i = 1; i < 50; ++i) {
+      factors = NonlinearFactorGraph();
+      values.clear();
+      factors.add(BetweenFactor<Pose2>(i - 1, i, step, odoNoise));
+      pose = pose * step;
+      values.insert(i, pose.retract(Vector3(0.01, -0.02, 0.005)));
+      isam.update(factors, values);
+    }
+    const VectorValues before = isam.getDelta();
+
+    factors = NonlinearFactorGraph();
+    factors.add(BetweenFactor<Pose2>(0, 49, pose * Pose2(0.5, 0.2, 0.05), odoNoise));
+    const ISAM2Result result = isam.update(factors);
+    KeySet replaced;
+    for (const auto& key_status : result.detail->variableStatus)
+      if (key_status.second.isReeliminated) replaced.insert(key_status.first);
+    EXPECT(replaced.size() >= 5);
+    const VectorValues actual = isam.getDelta();
+
+    // Same as the sequential wildfire from the delta before the loop closure
+    VectorValues sequential = before;
+    for (const ISAM2::sharedClique& root : isam.roots())
+      optimizeWildfireNonRecursive(root, wildfireThreshold, replaced, &sequential);
+    EXPECT(assert_equal(sequential, actual, 1e-9));
+
+    // and as a batch solve
+    const VectorValues expected = isam.getFactorsUnsafe()
+        .linearize(isam.getLinearizationPoint())->optimize();
+    EXPECT(assert_equal(expected, actual, 1e-4));
+  }
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, slabsReleasedWithTree)
+{
+  // Cliques, conditionals and cached factors come from SlabPool, and their
+  // slabs go back to the system once the tree that holds them is gone
+  const size_t before = SlabPool::NrSlabs();
+  size_t peak;
+  {
+    ISAM2 isam;
+    NonlinearFactorGraph factors;
+    Values values;
+    factors.add(PriorFactor<Pose2>(0, Pose2(), odoNoise));
+    values.insert(0, Pose2());
+    isam.update(factors, values);
+    const Pose2 step(1.0, 0.0, 0.1);
+    for (size_t i = 1; i < 500; ++i) {
+      factors = NonlinearFactorGraph();
+      values.clear();
+      factors.add(BetweenFactor<Pose2>(i - 1, i, step, odoNoise));
+      values.insert(i, Pose2(double(i), 0.0, 0.0));
+      isam.update(factors, values);
+    }
+    peak = SlabPool::NrSlabs();
+    EXPECT(peak > before);
+  }
+
+  // Each block size keeps at most the slab new blocks are carved from
+  EXPECT(SlabPool::NrSlabs() < peak);
+  EXPECT(SlabPool::NrSlabs()
+      <= before + SlabPool::kMaxBlockSize / SlabPool::kGranularity);
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -0,0 +1,156 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGncOptimizer.cpp
+ * @brief   Unit tests for graduated non-convexity
+ */
+
+#include <gtsam/nonlinear/GncOptimizer.h>
+#include <gtsam/nonlinear/GaussNewtonOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Point2.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/Testable.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+// Three measurements of a point at the origin and one far away
+NonlinearFactorGraph pointGraph() {
+  SharedNoiseModel model = noiseModel::Isotropic::Sigma(2, 1.0);
+  NonlinearFactorGraph graph;
+  graph.add(PriorFactor<Point2>(0, Point2(0, 0), model));
+  graph.add(PriorFactor<Point2>(0, Point2(0.1, -0.1), model));
+  graph.add(PriorFactor<Point2>(0, Point2(-0.1, 0.1), model));
+  graph.add(PriorFactor<Point2>(0, Point2(10, 10), model)); // outlier
+  return graph;
+}
+}
+
+/* ************************************************************************* */
+TEST(GncOptimizer, weightedFactor) {
+  NonlinearFactorGraph graph = pointGraph();
+  Values values;
+  values.insert(0, Point2(1, 2));
+
+  boost::shared_ptr<Vector> weights = boost::make_shared<Vector>(Vector::Ones(4));
+  GncWeightedFactor factor(graph[3], weights, 3);
+  EXPECT_DOUBLES_EQUAL(graph[3]->error(values), factor.error(values), 1e-9);
+
+  // Changing the shared weight changes the error and the linearization
+  (*weights)(3) = 0.25;
+  EXPECT_DOUBLES_EQUAL(0.25 * graph[3]->error(values), factor.error(values), 1e-9);
+  EXPECT_DOUBLES_EQUAL(0.25 * graph[3]->linearize(values)->error(VectorValues::Zero(values.zeroVectors())),
+      factor.linearize(values)->error(VectorValues::Zero(values.zeroVectors())), 1e-9);
+}
+
+/* ************************************************************************* */
+TEST(GncOptimizer, gemanMcClure) {
+  NonlinearFactorGraph graph = pointGraph();
+  Values initial;
+  initial.insert(0, Point2(1, 1));
+
+  // Least squares is pulled towards the outlier
+  Values lsq = LevenbergMarquardtOptimizer(graph, initial).optimize();
+  EXPECT(assert_equal(Point2(2.5, 2.5), lsq.at<Point2>(0), 1e-6));
+
+  GncParams<LevenbergMarquardtParams> params;
+  params.setLossType(GncParams<LevenbergMarquardtParams>::GM);
+  GncOptimizer<GncParams<LevenbergMarquardtParams> > gnc(graph, initial, params);
+  Values actual = gnc.optimize();
+  EXPECT(assert_equal(Point2(0, 0), actual.at<Point2>(0), 1e-2));
+  EXPECT(gnc.getWeights()(3) < 1e-3);
+  EXPECT(gnc.getWeights()(0) > 0.9);
+  EXPECT(gnc.iterations() <= params.maxIterations);
+}
+
+/* ************************************************************************* */
+TEST(GncOptimizer, truncatedLeastSquares) {
+  NonlinearFactorGraph graph = pointGraph();
+  Values initial;
+  initial.insert(0, Point2(1, 1));
+
+  GncParams<GaussNewtonParams> params;
+  params.setLossType(GncParams<GaussNewtonParams>::TLS);
+  params.setInlierCostThreshold(4.0);
+  GncOptimizer<GncParams<GaussNewtonParams> > gnc(graph, initial, params);
+  Values actual = gnc.optimize();
+  EXPECT(assert_equal(Point2(0, 0), actual.at<Point2>(0), 1e-6));
+  EXPECT(assert_equal((Vector(4) << 1, 1, 1, 0).finished(), gnc.getWeights()));
+}
+
+/* ************************************************************************* */
+TEST(GncOptimizer, knownInliers) {
+  // A pose chain with three loop closures, one of them wrong. The prior and the
+  // odometry are known inliers, and the loop closures are the candidates: the
+  // two correct ones agree with the odometry, so the wrong one stands out.
+  SharedNoiseModel model = noiseModel::Isotropic::Sigma(3, 0.1);
+  NonlinearFactorGraph graph;
+  graph.add(PriorFactor<Pose2>(0, Pose2(), model));
+  for (size_t i = 0; i < 5; ++i)
+    graph.add(BetweenFactor<Pose2>(i, i + 1, Pose2(1, 0, 0), model));
+  graph.add(BetweenFactor<Pose2>(0, 3, Pose2(3, 0, 0), model));
+  graph.add(BetweenFactor<Pose2>(2, 5, Pose2(3, 0, 0), model));
+  graph.add(BetweenFactor<Pose2>(1, 4, Pose2(0, 2, 1), model)); // outlier
+
+  Values initial;
+  for (size_t i = 0; i < 6; ++i)
+    initial.insert(i, Pose2(i + 0.1, 0.1, 0.05));
+
+  GncParams<LevenbergMarquardtParams> params;
+  const FastVector<size_t> knownInliers{0, 1, 2, 3, 4, 5};
+  params.setKnownInliers(knownInliers);
+  GncOptimizer<GncParams<LevenbergMarquardtParams> > gnc(graph, initial, params);
+  Values actual = gnc.optimize();
+  EXPECT(assert_equal(Pose2(5, 0, 0), actual.at<Pose2>(5), 1e-2));
+
+  const Vector weights = gnc.getWeights();
+  for (size_t i : knownInliers)
+    EXPECT_DOUBLES_EQUAL(1.0, weights(i), 1e-9);
+  EXPECT(weights(6) > 0.9);
+  EXPECT(weights(7) > 0.9);
+  EXPECT(weights(8) < 1e-3);
+}
+
+/* ************************************************************************* */
+TEST(GncOptimizer, constrainedPrior) {
+  // A hard prior at (1, 1) next to the measurements of pointGraph
+  NonlinearFactorGraph graph = pointGraph();
+  graph.add(PriorFactor<Point2>(0, Point2(1, 1), noiseModel::Constrained::All(2)));
+  Values initial;
+  initial.insert(0, Point2(3, 2));
+
+  // A constrained factor cannot be down-weighted
+  boost::shared_ptr<Vector> weights = boost::make_shared<Vector>(Vector::Ones(5));
+  GncWeightedFactor factor(graph[4], weights, 4);
+  (*weights)(4) = 0.5;
+  CHECK_EXCEPTION(factor.linearize(initial), std::invalid_argument);
+
+  // so GNC keeps its weight at one, and the constraint holds
+  GncParams<GaussNewtonParams> params;
+  GncOptimizer<GncParams<GaussNewtonParams> > gnc(graph, initial, params);
+  Values actual = gnc.optimize();
+  EXPECT(assert_equal(Point2(1, 1), actual.at<Point2>(0), 1e-6));
+  EXPECT_DOUBLES_EQUAL(1.0, gnc.getWeights()(4), 1e-9);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -0,0 +1,62 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeCalibrate.cpp
+ * @brief   time undistortion of image points with Cal3DS2 and Cal3Unified
+ */
+
+#include <time.h>
+#include <iostream>
+
+#include <gtsam/geometry/Cal3DS2.h>
+#include <gtsam/geometry/Cal3Unified.h>
+#include <gtsam/geometry/UndistortionGrid.h>
+
+using namespace std;
+using namespace gtsam;
+
+#define TEST(TITLE,STATEMENT) \
+  cout << endl << TITLE << endl;\
+  timeLog = clock();\
+  for(int i = 0; i < n; i++)\
+  STATEMENT;\
+  timeLog2 = clock();\
+  seconds = (double)(timeLog2-timeLog)/CLOCKS_PER_SEC;\
+  cout << seconds << " seconds" << endl;\
+  cout << ((double)n/seconds) << " calls/second" << endl;
+
+int main()
+{
+  int n = 100; long timeLog, timeLog2; double seconds;
+
+  // A frame worth of keypoints, spread over a 640*480 image
+  const size_t m = 1000;
+  Matrix pi(2, m);
+  for (size_t j = 0; j < m; j++)
+    pi.col(j) << (j * 37) % 640 + 0.5, (j * 53) % 480 + 0.5;
+
+  const Cal3DS2 K(520, 515, 0, 320, 240, -0.3, 0.1, 1e-3, -2e-3);
+  const UndistortionGrid<Cal3DS2> gridK(K, 640, 480);
+  const Cal3Unified U(100, 105, 0.0, 320, 240, 1e-3, 2e-3, 3e-3, 4e-3, 0.1);
+  const UndistortionGrid<Cal3Unified> gridU(U, 640, 480);
+
+  Matrix29 Dcal;
+  Matrix2 Dp;
+  TEST("Cal3DS2::calibrate, loop over 1000", for (size_t j = 0; j < m; j++) K.calibrate(Point2(pi.col(j))))
+  TEST("Cal3DS2::calibrate with derivatives, loop over 1000", for (size_t j = 0; j < m; j++) K.calibrate(Point2(pi.col(j)), Dcal, Dp))
+  TEST("Cal3DS2::calibratePoints, batch of 1000", K.calibratePoints(pi))
+  TEST("UndistortionGrid<Cal3DS2>, batch of 1000", gridK.calibratePoints(pi))
+  TEST("Cal3Unified::calibratePoints, batch of 1000", U.calibratePoints(pi))
+  TEST("UndistortionGrid<Cal3Unified>, batch of 1000", gridU.calibratePoints(pi))
+
+  return 0;
+}
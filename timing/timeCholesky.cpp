@@ -19,6 +19,7 @@
 #include <gtsam/base/cholesky.h>
 
 #include <time.h>
+#include <chrono>
 #include <iostream>
 #include <iomanip>      // std::setprecision
 
@@ -56,5 +57,22 @@ int main() {
     cout << ms << " ms, " << ms/nFrontal << " ms/dim" << endl;
   }
 
+  // Large fronts, as in root cliques with big separators: the default tiled path
+  // against the single LLT/solve/rank-update on the whole front
+  for (size_t dim : {1024, 2048, 4096}) {
+    const size_t nFrontal = dim / 4;
+    const Matrix M = Matrix::Random(dim, dim);
+    const Matrix large = M.transpose() * M + double(dim) * Matrix::Identity(dim, dim);
+    for (size_t tileSize : {dim, size_t(128), size_t(256)}) {
+      Matrix RSL(large);
+      // wall time, as the tiles run in parallel with TBB
+      auto timeLog = std::chrono::steady_clock::now();
+      choleskyPartialBlocked(RSL, nFrontal, 0, tileSize);
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - timeLog;
+      cout << "partialCholesky " << dim << " (" << nFrontal << " frontal), tile "
+           << tileSize << ": " << seconds.count() << " s" << endl;
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,92 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeDiscreteElimination.cpp
+ * @brief   Time the decision tree and flat table products of EliminateDiscrete
+ *          against the density of the factors, to choose kMinDenseProductDensity
+ */
+
+#include <gtsam/discrete/DenseDiscreteFactor.h>
+#include <gtsam/discrete/DiscreteFactorGraph.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/random.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrStates = 4, nrKeys = 6, factorSize = 4, nrFactors = 4;
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 20;
+  boost::mt19937 rng(42);
+  boost::uniform_real<> uniform(0.1, 1.0);
+
+  DiscreteKeys keys;
+  for (size_t j = 0; j < nrKeys; ++j)
+    keys.push_back(DiscreteKey(j, nrStates));
+  Ordering frontals;
+  frontals += Key(0), Key(1);
+
+  // Every factor depends on its first `depth` keys only, so its tree has
+  // nrStates^depth leaves: depth == factorSize is a dense, unprunable table
+  for (size_t depth = 1; depth <= factorSize; ++depth) {
+    DiscreteFactorGraph graph;
+    for (size_t i = 0; i < nrFactors; ++i) {
+      DiscreteKeys factorKeys;
+      for (size_t j = 0; j < factorSize; ++j)
+        factorKeys.push_back(keys[(i + j) % nrKeys]);
+      size_t block = 1, size = 1;
+      for (size_t j = 0; j < factorSize; ++j) {
+        size *= nrStates;
+        if (j >= depth) block *= nrStates;
+      }
+      vector<double> table;
+      for (size_t k = 0; k < size; ++k) {
+        if (k % block == 0) table.push_back(uniform(rng));
+        else table.push_back(table.back());
+      }
+      graph.add(factorKeys, table);
+    }
+    const double density = DenseDiscreteFactor::Density(
+        static_cast<const DecisionTreeFactor&>(*graph[0]));
+
+    for (size_t trial = 0; trial < nrTrials; ++trial) {
+      {
+        gttic_(tree);
+        DecisionTreeFactor product;
+        for (const DiscreteFactor::shared_ptr& factor : graph)
+          product = (*factor) * product;
+        product.sum(frontals);
+      }
+      {
+        gttic_(dense);
+        DenseDiscreteFactor product;
+        for (const DiscreteFactor::shared_ptr& factor : graph)
+          product = DenseDiscreteFactor(
+              static_cast<const DecisionTreeFactor&>(*factor)) * product;
+        product.toDecisionTreeFactor();
+        product.sum(frontals)->toDecisionTreeFactor();
+      }
+      tictoc_finishedIteration_();
+    }
+
+    cout << "density " << density << endl;
+    tictoc_print_();
+    tictoc_reset_();
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeISAM2Bookkeeping.cpp
+ * @brief   Time ISAM2 updates that relinearize every step, on a chain with
+ *          regular loop closures, ordering the affected top with constrained
+ *          COLAMD and then incrementally, and report the fill of both. Build
+ *          with GTSAM_ENABLE_TIMING to also see the key bookkeeping of update:
+ *          gather_involved_keys, gather_relinearize_keys, fluid_find_all,
+ *          expmap, getAffectedFactors, relinearizedFactors,
+ *          check_candidates_and_linearize, Ordering and KeepTopOrdering.
+ */
+
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+// Run the chain, and return the number of non-zeros of the final Bayes tree
+size_t run(size_t nrPoses, size_t loopSpacing, bool incrementalReordering) {
+  const SharedNoiseModel odometry =
+      noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01));
+
+  // Relinearize every step, with a threshold low enough that the noisy
+  // odometry keeps a share of the keys above it
+  ISAM2Params params(ISAM2GaussNewtonParams(), 0.01, 1);
+  params.incrementalReordering = incrementalReordering;
+  ISAM2 isam(params);
+  srand(42);
+
+  // Poses on a circle of loopSpacing poses, so every lap closes loops
+  const Pose2 step(1.0, 0.0, 2.0 * M_PI / loopSpacing);
+  Pose2 pose;
+  for (size_t i = 0; i < nrPoses; ++i) {
+    NonlinearFactorGraph factors;
+    Values values;
+    if (i == 0) {
+      factors.add(PriorFactor<Pose2>(0, Pose2(), odometry));
+    } else {
+      const Pose2 measured = step.retract(0.01 * Vector3::Random());
+      factors.add(BetweenFactor<Pose2>(i - 1, i, measured, odometry));
+      if (i >= loopSpacing && i % 5 == 0)
+        factors.add(BetweenFactor<Pose2>(i - loopSpacing, i, Pose2(),
+                                         odometry));
+    }
+    pose = pose * step;
+    values.insert(i, pose.retract(0.05 * Vector3::Random()));
+
+    gttic_(update);
+    isam.update(factors, values);
+    gttoc_(update);
+    tictoc_finishedIteration_();
+  }
+  return isam.roots().front()->calculate_nnz();
+}
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrPoses = argc > 1 ? atoi(argv[1]) : 5000;
+  const size_t loopSpacing = argc > 2 ? atoi(argv[2]) : 50;
+
+  size_t colamdNnz, incrementalNnz;
+  {
+    gttic_(colamd);
+    colamdNnz = run(nrPoses, loopSpacing, false);
+  }
+  {
+    gttic_(incremental);
+    incrementalNnz = run(nrPoses, loopSpacing, true);
+  }
+
+  cout << nrPoses << " poses, loop closures every " << loopSpacing
+       << ", non-zeros of R with COLAMD " << colamdNnz
+       << ", with incremental reordering " << incrementalNnz << endl;
+  tictoc_print_();
+  return 0;
+}
@@ -0,0 +1,95 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeISAM2Wildfire.cpp
+ * @brief   Time the wildfire back-substitution of ISAM2 against the fraction
+ *          of replaced keys, to choose kParallelWildfireFraction. With TBB,
+ *          ISAM2 switches to the parallel wildfire above that fraction, which
+ *          is compared with the sequential one on the same update.
+ */
+
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrPoses = argc > 1 ? atoi(argv[1]) : 2000;
+  const size_t nrTrials = argc > 2 ? atoi(argv[2]) : 10;
+  const SharedNoiseModel odometry =
+      noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01));
+  const Pose2 step(1.0, 0.0, 0.01);
+
+  for (double fraction : {0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0}) {
+    // A loop closure reaching back far enough to replace the fraction of keys
+    const size_t last = nrPoses - 1;
+    const size_t first = last - max<size_t>(1, fraction * last);
+    size_t nrReplaced = 0;
+
+    for (size_t trial = 0; trial < nrTrials; ++trial) {
+      ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+      params.enableDetailedResults = true;
+      ISAM2 isam(params);
+
+      // A chain, eliminated so that the oldest poses are deepest in the tree
+      NonlinearFactorGraph factors;
+      Values values;
+      factors.add(PriorFactor<Pose2>(0, Pose2(), odometry));
+      values.insert(0, Pose2());
+      isam.update(factors, values);
+      Pose2 pose;
+      for (size_t i = 1; i < nrPoses; ++i) {
+        factors = NonlinearFactorGraph();
+        values.clear();
+        factors.add(BetweenFactor<Pose2>(i - 1, i, step, odometry));
+        pose = pose * step;
+        values.insert(i, pose.retract(Vector3(0.01, -0.02, 0.005)));
+        isam.update(factors, values);
+      }
+      VectorValues delta = isam.getDelta();
+
+      factors = NonlinearFactorGraph();
+      factors.add(BetweenFactor<Pose2>(first, last,
+          Pose2(double(last - first) + 0.1, 0.1, 0.0), odometry));
+      const ISAM2Result result = isam.update(factors);
+      KeySet replaced;
+      for (const auto& key_status : result.detail->variableStatus)
+        if (key_status.second.isReeliminated) replaced.insert(key_status.first);
+      nrReplaced = replaced.size();
+
+      {
+        gttic_(sequential);
+        for (const ISAM2::sharedClique& root : isam.roots())
+          optimizeWildfireNonRecursive(root, 0.001, replaced, &delta);
+      }
+      {
+        gttic_(isam2);
+        isam.getDelta();
+      }
+      tictoc_finishedIteration_();
+    }
+
+    cout << nrReplaced << " of " << nrPoses << " keys replaced" << endl;
+    tictoc_print_();
+    tictoc_reset_();
+  }
+
+  return 0;
+}
@@ -0,0 +1,84 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeLoopyBeliefPropagation.cpp
+ * @brief   Time max-product loopy belief propagation against elimination on grid MRFs
+ */
+
+#include <gtsam/discrete/LoopyBeliefPropagation.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/random.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrStates = 3;
+  const size_t maxSize = argc > 1 ? atoi(argv[1]) : 8;
+  boost::mt19937 rng(42);
+  boost::uniform_real<> uniform(0.1, 1.0);
+
+  for (size_t n = 2; n <= maxSize; ++n) {
+
+    // Create an n*n grid with random unary potentials and smoothing pairwise potentials
+    DiscreteFactorGraph graph;
+    vector<DiscreteKey> keys;
+    for (size_t i = 0; i < n * n; ++i)
+      keys.push_back(DiscreteKey(i, nrStates));
+    for (size_t i = 0; i < n * n; ++i) {
+      vector<double> unary;
+      for (size_t x = 0; x < nrStates; ++x)
+        unary.push_back(uniform(rng));
+      graph.add(keys[i], unary);
+    }
+    vector<double> pairwise;
+    for (size_t x = 0; x < nrStates; ++x)
+      for (size_t y = 0; y < nrStates; ++y)
+        pairwise.push_back(x == y ? 2.0 : 1.0);
+    for (size_t r = 0; r < n; ++r)
+      for (size_t c = 0; c < n; ++c) {
+        if (c + 1 < n) graph.add(keys[r * n + c], keys[r * n + c + 1], pairwise);
+        if (r + 1 < n) graph.add(keys[r * n + c], keys[(r + 1) * n + c], pairwise);
+      }
+
+    DiscreteFactor::sharedValues exact, approximate;
+    size_t iterations;
+    {
+      gttic_(elimination);
+      exact = graph.optimize();
+    }
+    {
+      gttic_(loopyBP);
+      LoopyBeliefPropagation bp(graph, LoopyBeliefPropagation::Parameters(true));
+      iterations = bp.run();
+      approximate = bp.optimize();
+    }
+
+    size_t agree = 0;
+    for (const DiscreteKey& key : keys)
+      agree += (exact->at(key.first) == approximate->at(key.first));
+    cout << n << "x" << n << " grid: loopy BP converged in " << iterations
+         << " iterations, agrees with elimination on " << agree << "/" << keys.size()
+         << " variables" << endl;
+
+    tictoc_finishedIteration_();
+    tictoc_print_();
+    tictoc_reset_();
+  }
+
+  return 0;
+}
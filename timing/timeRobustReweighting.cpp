@@ -0,0 +1,79 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeRobustReweighting.cpp
+ * @brief   Time graph-level robust reweighting against per-factor linearization on BAL
+ */
+
+#include <gtsam/nonlinear/RobustReweighting.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/timing.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::C;
+using symbol_shorthand::P;
+
+typedef PinholeCamera<Cal3Bundler> Camera;
+typedef GeneralSFMFactor<Camera, Point3> SfmFactor;
+
+int main(int argc, char* argv[]) {
+  // Load BAL file
+  SfM_data db;
+  string filename = argc > 1 ? argv[1] : findExampleDataFile("dubrovnik-16-22106-pre");
+  if (!readBAL(filename, db)) throw runtime_error("Could not access file!");
+
+  // Build graph with a Huber loss on every reprojection error
+  SharedNoiseModel huber = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345), noiseModel::Unit::Create(2));
+  NonlinearFactorGraph graph;
+  for (size_t j = 0; j < db.number_tracks(); j++)
+    for (const SfM_Measurement& m : db.tracks[j].measurements)
+      graph.emplace_shared<SfmFactor>(m.second, huber, C(m.first), P(j));
+
+  Values values;
+  size_t i = 0, j = 0;
+  for (const SfM_Camera& camera : db.cameras)
+    values.insert(C(i++), camera);
+  for (const SfM_Track& track : db.tracks)
+    values.insert(P(j++), track.p);
+
+  RobustReweighting reweighting(graph);
+  cout << graph.size() << " factors, " << reweighting.nrRobustFactors()
+       << " reweighted in " << reweighting.nrGroups() << " group(s)" << endl;
+
+  const size_t nrTrials = 10;
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    {
+      gttic_(perFactor_linearize);
+      graph.linearize(values);
+    }
+    {
+      gttic_(batch_linearize);
+      reweighting.linearize(values);
+    }
+    {
+      gttic_(batch_computeWeights);
+      reweighting.computeWeights(values);
+    }
+    tictoc_finishedIteration_();
+  }
+  tictoc_print_();
+
+  return 0;
+}
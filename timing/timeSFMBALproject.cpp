@@ -0,0 +1,70 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeSFMBALproject.cpp
+ * @brief   time projection of BAL points with Jacobians, per point and batched per camera
+ */
+
+#include "timeSFMBAL.h"
+
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/PinholeCamera.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char* argv[]) {
+  // parse options and read BAL file
+  SfM_data db = preamble(argc, argv);
+
+  // Collect the points seen by every camera
+  vector<vector<Point3> > points(db.number_cameras());
+  for (const SfM_Track& track : db.tracks)
+    for (const SfM_Measurement& m : track.measurements)
+      points[m.first].push_back(track.p);
+
+  const size_t nrTrials = 20;
+  double sum = 0;
+
+  // One point at a time, as GeneralSFMFactor::linearize does
+  Matrix26 Dpose;
+  Matrix23 Dpoint;
+  Matrix23 Dcal;
+  for (size_t trial = 0; trial < nrTrials; trial++) {
+    gttic_(projectPointByPoint);
+    for (size_t i = 0; i < db.number_cameras(); i++) {
+      const SfM_Camera& camera = db.cameras[i];
+      for (const Point3& point : points[i])
+        sum += camera.PinholeBaseK<Cal3Bundler>::project(point, Dpose, Dpoint, Dcal).x();
+    }
+    gttoc_(projectPointByPoint);
+    tictoc_finishedIteration_();
+  }
+
+  // All points of a camera in one batch
+  Matrix Hpose, Hpoints, Hcal;
+  for (size_t trial = 0; trial < nrTrials; trial++) {
+    gttic_(projectPoints);
+    for (size_t i = 0; i < db.number_cameras(); i++) {
+      if (points[i].empty()) continue; // no first coordinate to read back
+      sum += db.cameras[i].projectPoints(points[i], Hpose, Hpoints, Hcal)(0, 0);
+    }
+    gttoc_(projectPoints);
+    tictoc_finishedIteration_();
+  }
+
+  tictoc_print_();
+  cout << "checksum: " << sum << endl;
+  return 0;
+}
@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeSlabPool.cpp
+ * @brief   Time makeSlabShared against boost::make_shared for the conditionals
+ *          and factors of repeated eliminations, of which ISAM2 keeps a few
+ *          and discards the rest, and report the slabs SlabPool holds at the
+ *          end. Then time ISAM2 on a chain, which allocates from SlabPool.
+ */
+
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/GaussianConditional.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/base/SlabPool.h>
+#include <gtsam/base/timing.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+struct MakeShared {
+  template<class T>
+  boost::shared_ptr<void> operator()(const T& object) const {
+    return boost::make_shared<T>(object);
+  }
+};
+
+struct MakeSlabShared {
+  template<class T>
+  boost::shared_ptr<void> operator()(const T& object) const {
+    return makeSlabShared<T>(object);
+  }
+};
+
+// Repeated eliminations, each creating a conditional and a joint factor per
+// clique, of which the first clique is kept and the others are discarded by
+// the next update. Returns the most slabs SlabPool held.
+template<class MAKE>
+size_t eliminations(size_t nrUpdates, size_t nrCliques, MAKE make) {
+  const Matrix3 R = Matrix3::Identity() * 10.0;
+  const Vector3 d(1.0, 2.0, 3.0);
+  vector<boost::shared_ptr<void> > kept, top;
+  size_t slabs = SlabPool::NrSlabs();
+  for (size_t update = 0; update < nrUpdates; ++update) {
+    top.clear();
+    for (size_t k = 0; k < nrCliques; ++k) {
+      const Key key = update * nrCliques + k;
+      vector<boost::shared_ptr<void> >& objects = k == 0 ? kept : top;
+      objects.push_back(make(GaussianConditional(key, d, R, key + 1, R)));
+      objects.push_back(make(HessianFactor(key + 1, R, d, 1.0)));
+    }
+    slabs = max(slabs, SlabPool::NrSlabs());
+  }
+  return slabs;
+}
+}
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrUpdates = argc > 1 ? atoi(argv[1]) : 20000;
+  const size_t nrCliques = argc > 2 ? atoi(argv[2]) : 20;
+
+  const size_t before = SlabPool::NrSlabs();
+  {
+    gttic_(make_shared);
+    eliminations(nrUpdates, nrCliques, MakeShared());
+  }
+  size_t slabs;
+  {
+    gttic_(makeSlabShared);
+    slabs = eliminations(nrUpdates, nrCliques, MakeSlabShared());
+  }
+  cout << nrUpdates << " eliminations of " << nrCliques
+       << " cliques, at most " << slabs - before << " slabs of "
+       << SlabPool::kSlabSize / 1024 << "kB held, "
+       << SlabPool::NrSlabs() - before << " once all are freed" << endl;
+
+  // ISAM2 on a chain, with the slabs it holds at the end
+  const SharedNoiseModel odometry =
+      noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01));
+  {
+    ISAM2 isam;
+    NonlinearFactorGraph factors;
+    Values values;
+    factors.add(PriorFactor<Pose2>(0, Pose2(), odometry));
+    values.insert(0, Pose2());
+    isam.update(factors, values);
+    const Pose2 step(1.0, 0.0, 0.01);
+    Pose2 pose;
+    for (size_t i = 1; i < nrUpdates / 4; ++i) {
+      factors = NonlinearFactorGraph();
+      values.clear();
+      factors.add(BetweenFactor<Pose2>(i - 1, i, step, odometry));
+      pose = pose * step;
+      values.insert(i, pose.retract(Vector3(0.01, -0.02, 0.005)));
+      gttic_(isam2_update);
+      isam.update(factors, values);
+    }
+    cout << "ISAM2 on " << nrUpdates / 4 << " poses holds "
+         << SlabPool::NrSlabs() - before << " slabs" << endl;
+  }
+
+  tictoc_print_();
+  return 0;
+}
@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeTriangulation.cpp
+ * @brief   Time triangulating many tracks one by one and in a batch
+ */
+
+#include <gtsam/geometry/triangulation.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/random.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+typedef PinholeCamera<Cal3_S2> Camera;
+
+int main(int argc, char *argv[]) {
+
+  const size_t nrTracks = argc > 1 ? atoi(argv[1]) : 100000;
+  const size_t nrCameras = 20, trackLength = 4;
+  boost::mt19937 rng(42);
+  boost::uniform_real<> uniform(-1.0, 1.0);
+  boost::normal_distribution<> noise(0.0, 0.5);
+
+  // Cameras on a line, looking along the X-axis
+  const Cal3_S2 K(500, 500, 0, 320, 240);
+  const Rot3 upright = Rot3::Ypr(-M_PI / 2, 0., -M_PI / 2);
+  CameraSet<Camera> cameras;
+  for (size_t i = 0; i < nrCameras; ++i)
+    cameras.push_back(Camera(Pose3(upright, Point3(0, 0.2 * i, 1)), K));
+
+  // Each landmark is seen by trackLength consecutive cameras
+  Point2Vector measurements;
+  vector<size_t> cameraIndices, trackOffsets(1, 0);
+  for (size_t j = 0; j < nrTracks; ++j) {
+    const size_t first = j % (nrCameras - trackLength + 1);
+    const Point3 landmark(10 + 2 * uniform(rng), 0.2 * first + uniform(rng), 1 + uniform(rng));
+    for (size_t i = first; i < first + trackLength; ++i) {
+      measurements.push_back(cameras[i].project(landmark) + Point2(noise(rng), noise(rng)));
+      cameraIndices.push_back(i);
+    }
+    trackOffsets.push_back(measurements.size());
+  }
+
+  for (bool refine : {false, true}) {
+    TriangulationParameters params(1.0, refine);
+    size_t nrValid = 0;
+    {
+      gttic_(triangulateSafe);
+      for (size_t j = 0; j < nrTracks; ++j) {
+        CameraSet<Camera> trackCameras;
+        Point2Vector trackMeasurements;
+        for (size_t k = trackOffsets[j]; k < trackOffsets[j + 1]; ++k) {
+          trackCameras.push_back(cameras[cameraIndices[k]]);
+          trackMeasurements.push_back(measurements[k]);
+        }
+        nrValid += triangulateSafe(trackCameras, trackMeasurements, params).valid();
+      }
+    }
+    size_t nrValidBatch = 0;
+    {
+      gttic_(triangulateBatch);
+      vector<TriangulationResult> results = triangulateBatch(cameras,
+          measurements, cameraIndices, trackOffsets, params);
+      for (const TriangulationResult& result : results)
+        nrValidBatch += result.valid();
+    }
+    cout << nrTracks << " tracks, refinement " << (refine ? "on" : "off")
+         << ": " << nrValid << " valid one by one, " << nrValidBatch
+         << " valid in batch" << endl;
+    tictoc_finishedIteration_();
+    tictoc_print_();
+    tictoc_reset_();
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeUnit3.cpp
+ * @brief   time Unit3 functions, one at a time and in batch
+ */
+
+#include <time.h>
+#include <iostream>
+#include <vector>
+
+#include <gtsam/geometry/Unit3.h>
+
+using namespace std;
+using namespace gtsam;
+
+#define TEST(TITLE,STATEMENT) \
+  cout << endl << TITLE << endl;\
+  timeLog = clock();\
+  for(int i = 0; i < n; i++)\
+  STATEMENT;\
+  timeLog2 = clock();\
+  seconds = (double)(timeLog2-timeLog)/CLOCKS_PER_SEC;\
+  cout << seconds << " seconds" << endl;\
+  cout << ((double)n/seconds) << " calls/second" << endl;
+
+int main()
+{
+  int n = 1000000; long timeLog, timeLog2; double seconds;
+  const Unit3 p(0.1, -0.2, 0.9), q(0.3, 0.4, -0.8);
+  const Vector2 v(0.01, -0.02);
+  Matrix62 H6;
+  Matrix2 H_p, H_q;
+
+  TEST("Copy", Unit3 copy(p))
+  TEST("basis", p.basis())
+  TEST("basis with derivative", p.basis(H6))
+  TEST("errorVector", p.errorVector(q))
+  TEST("errorVector with derivatives", p.errorVector(q, H_p, H_q))
+  TEST("retract", p.retract(v))
+  TEST("localCoordinates", p.localCoordinates(q))
+
+  // Batch versions on m directions, each call processes all of them
+  const size_t m = 1000;
+  boost::mt19937 rng(42);
+  vector<Unit3> ps, qs;
+  Matrix vs(2, m);
+  for (size_t j = 0; j < m; j++) {
+    ps.push_back(Unit3::Random(rng));
+    qs.push_back(Unit3::Random(rng));
+    vs.col(j) = v;
+  }
+  n = 1000;
+  TEST("errorVector, loop over 1000", for (size_t j = 0; j < m; j++) ps[j].errorVector(qs[j]))
+  TEST("ErrorVectors, batch of 1000", Unit3::ErrorVectors(ps, qs))
+  TEST("retract, loop over 1000", for (size_t j = 0; j < m; j++) ps[j].retract(vs.col(j)))
+  TEST("Retract, batch of 1000", Unit3::Retract(ps, vs))
+
+  return 0;
+}
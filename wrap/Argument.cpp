@@ -152,6 +152,32 @@ std::string Argument::pyx_asParam() const {
   return cythonVar;
 }
 
+/* ************************************************************************* */
+std::string Argument::pyx_cLocalName(const std::string& suffix) const {
+  return "c_" + name + suffix;
+}
+
+/* ************************************************************************* */
+std::string Argument::pyx_cLocalType() const {
+  if (type.isNonBasicType())
+    return type.shared_pxd_class_in_pyx();
+  return type.pxd_class_in_pyx();
+}
+
+/* ************************************************************************* */
+std::string Argument::pyx_cLocalValue() const {
+  if (type.isNonBasicType())
+    return name + "." + type.shared_pxd_obj_in_pyx();
+  return pyx_asParam();
+}
+
+/* ************************************************************************* */
+std::string Argument::pyx_cLocalAsParam(const std::string& suffix) const {
+  if (type.isNonBasicType() && !is_ptr)
+    return "deref(" + pyx_cLocalName(suffix) + ")";
+  return pyx_cLocalName(suffix);
+}
+
 /* ************************************************************************* */
 string ArgumentList::types() const {
   string str;
@@ -270,6 +296,36 @@ std::string ArgumentList::pyx_asParams() const {
   return ret;
 }
 
+/* ************************************************************************* */
+std::string ArgumentList::pyx_declareCLocals(const std::string& indent,
+                                             const std::string& suffix) const {
+  string s;
+  for (size_t j = 0; j < size(); ++j)
+    s += indent + "cdef " + at(j).pyx_cLocalType() + " " +
+         at(j).pyx_cLocalName(suffix) + "\n";
+  return s;
+}
+
+/* ************************************************************************* */
+std::string ArgumentList::pyx_assignCLocals(const std::string& indent,
+                                            const std::string& suffix) const {
+  string s;
+  for (size_t j = 0; j < size(); ++j)
+    s += indent + at(j).pyx_cLocalName(suffix) + " = " +
+         at(j).pyx_cLocalValue() + "\n";
+  return s;
+}
+
+/* ************************************************************************* */
+std::string ArgumentList::pyx_cLocalsAsParams(const std::string& suffix) const {
+  string ret;
+  for (size_t j = 0; j < size(); ++j) {
+    ret += at(j).pyx_cLocalAsParam(suffix);
+    if (j < size() - 1) ret += ", ";
+  }
+  return ret;
+}
+
 /* ************************************************************************* */
 std::string ArgumentList::pyx_paramsList() const {
   string s;
@@ -75,6 +75,15 @@ struct Argument {
   std::string pyx_asParam() const;
   std::string pyx_convertEigenTypeAndStorageOrder() const;
 
+  /**
+   * Arguments of calls that release the GIL are first converted to C locals,
+   * named c_<name><suffix>, as the conversion needs the GIL
+   */
+  std::string pyx_cLocalName(const std::string& suffix) const;
+  std::string pyx_cLocalType() const;
+  std::string pyx_cLocalValue() const;
+  std::string pyx_cLocalAsParam(const std::string& suffix) const;
+
   friend std::ostream& operator<<(std::ostream& os, const Argument& arg) {
     os << (arg.is_const ? "const " : "") << arg.type << (arg.is_ptr ? "*" : "")
         << (arg.is_ref ? "&" : "");
@@ -134,6 +143,13 @@ struct ArgumentList: public std::vector<Argument> {
   std::string pyx_castParamsToPythonType(const std::string& indent) const;
   std::string pyx_convertEigenTypeAndStorageOrder(const std::string& indent) const;
 
+  /// C locals of calls that release the GIL, see Argument::pyx_cLocalName
+  std::string pyx_declareCLocals(const std::string& indent,
+                                 const std::string& suffix) const;
+  std::string pyx_assignCLocals(const std::string& indent,
+                                const std::string& suffix) const;
+  std::string pyx_cLocalsAsParams(const std::string& suffix) const;
+
   /**
    * emit checking arguments to MATLAB proxy
    * @param proxyFile output stream
@@ -343,12 +343,12 @@ vector<Class> Class::expandTemplate(Str templateArg,
 /* ************************************************************************* */
 void Class::addMethod(bool verbose, bool is_const, Str methodName,
     const ArgumentList& argumentList, const ReturnValue& returnValue,
-    const Template& tmplate) {
+    const Template& tmplate, bool nogil) {
   // Check if templated
   if (tmplate.valid()) {
     templateMethods_[methodName].addOverload(methodName, argumentList,
                                              returnValue, is_const,
-                                             tmplate.argName(), verbose);
+                                             tmplate.argName(), verbose, nogil);
     // Create method to expand
     // For all values of the template argument, create a new method
     for(const Qualified& instName: tmplate.argValues()) {
@@ -362,14 +362,14 @@ void Class::addMethod(bool verbose, bool is_const, Str methodName,
       // but note we use the same, unexpanded methodName in overload
       string expandedMethodName = methodName + instName.name();
       methods_[expandedMethodName].addOverload(methodName, expandedArgs,
-          expandedRetVal, is_const, instName, verbose);
+          expandedRetVal, is_const, instName, verbose, nogil);
     }
   } else {
     // just add overload
     methods_[methodName].addOverload(methodName, argumentList, returnValue,
-        is_const, boost::none, verbose);
+        is_const, boost::none, verbose, nogil);
     nontemplateMethods_[methodName].addOverload(methodName, argumentList, returnValue,
-        is_const, boost::none, verbose);
+        is_const, boost::none, verbose, nogil);
   }
 }
 
@@ -131,7 +131,7 @@ public:
   /// Add potentially overloaded, potentially templated method
   void addMethod(bool verbose, bool is_const, Str methodName,
       const ArgumentList& argumentList, const ReturnValue& returnValue,
-      const Template& tmplate);
+      const Template& tmplate, bool nogil = false);
 
   /// Post-process classes for serialization markers
   void erase_serialization(); // non-const !
@@ -227,7 +227,7 @@ struct ClassGrammar: public classic::grammar<ClassGrammar> {
     TemplateGrammar methodTemplate_g, classTemplate_g;
 
     std::string methodName;
-    bool isConst, T, F;
+    bool isConst, isNogil, T, F;
 
     // Parent class
     Qualified possibleParent;
@@ -240,30 +240,33 @@ struct ClassGrammar: public classic::grammar<ClassGrammar> {
     definition(ClassGrammar const& self) :
         argumentList_g(args), returnValue_g(retVal), //
         methodTemplate_g(methodTemplate), classTemplate_g(self.template_), //
-        T(true), F(false), classParent_g(possibleParent) {
+        isNogil(false), T(true), F(false), classParent_g(possibleParent) {
 
       using namespace classic;
       bool verbose = false; // TODO
 
       // ConstructorGrammar
-      constructor_p = (className_p >> argumentList_g >> ';' >> !comments_p) //
-          [bl::bind(&Constructor::push_back, bl::var(constructor),
-              bl::var(args))] //
-          [clear_a(args)];
+      constructor_p = (className_p >> argumentList_g
+          >> !str_p("nogil")[assign_a(isNogil, T)] >> ';' >> !comments_p) //
+          [bl::bind(&Constructor::addOverload, bl::var(constructor),
+              bl::var(args), bl::var(isNogil))] //
+          [clear_a(args)][assign_a(isNogil, F)];
 
       // MethodGrammar
       methodName_p = lexeme_d[(upper_p | lower_p) >> *(alnum_p | '_')];
 
       // gtsam::Values retract(const gtsam::VectorValues& delta) const;
+      // gtsam::Values optimize() nogil;
       method_p = !methodTemplate_g
           >> (returnValue_g >> methodName_p[assign_a(methodName)]
-              >> argumentList_g >> !str_p("const")[assign_a(isConst, T)] >> ';'
+              >> argumentList_g >> !str_p("const")[assign_a(isConst, T)]
+              >> !str_p("nogil")[assign_a(isNogil, T)] >> ';'
               >> *comments_p) //
           [bl::bind(&Class::addMethod, bl::var(self.cls_), verbose,
               bl::var(isConst), bl::var(methodName), bl::var(args),
-              bl::var(retVal), bl::var(methodTemplate))] //
+              bl::var(retVal), bl::var(methodTemplate), bl::var(isNogil))] //
           [assign_a(retVal, retVal0)][clear_a(args)] //
-          [clear_a(methodTemplate)][assign_a(isConst, F)];
+          [clear_a(methodTemplate)][assign_a(isConst, F)][assign_a(isNogil, F)];
 
       // StaticMethodGrammar
       staticMethodName_p = lexeme_d[(upper_p | lower_p) >> *(alnum_p | '_')];
@@ -136,12 +136,18 @@ void Constructor::emit_cython_pxd(FileWriter& pxdFile, const Class& cls) const {
     // generate the constructor
     pxdFile.oss << "        " << cls.pxdClassName() << "(";
     args.emit_cython_pxd(pxdFile, cls.pxdClassName(), cls.templateArgs);
-    pxdFile.oss << ") " << "except +\n";
+    pxdFile.oss << ") " << (releasesGil(i) ? "nogil " : "") << "except +\n";
   }
 }
 
 /* ************************************************************************* */
 void Constructor::emit_cython_pyx(FileWriter& pyxFile, const Class& cls) const {
+  // C locals cannot be declared inside the try blocks
+  for (size_t i = 0; i < nrOverloads(); i++)
+    if (releasesGil(i))
+      pyxFile.oss << argumentList(i).pyx_declareCLocals("        ",
+                                                        "_" + to_string(i));
+
   for (size_t i = 0; i < nrOverloads(); i++) {
     ArgumentList args = argumentList(i);
     pyxFile.oss << "        try:\n";
@@ -149,9 +155,18 @@ void Constructor::emit_cython_pyx(FileWriter& pyxFile, const Class& cls) const {
     pyxFile.oss
         << argumentList(i).pyx_convertEigenTypeAndStorageOrder("            ");
 
-    pyxFile.oss << "            self." << cls.shared_pxd_obj_in_pyx() << " = "
+    string params = args.pyx_asParams();
+    string indent = "            ";
+    if (releasesGil(i)) {
+      const string suffix = "_" + to_string(i);
+      pyxFile.oss << args.pyx_assignCLocals(indent, suffix);
+      pyxFile.oss << indent << "with nogil:\n";
+      params = args.pyx_cLocalsAsParams(suffix);
+      indent += "    ";
+    }
+    pyxFile.oss << indent << "self." << cls.shared_pxd_obj_in_pyx() << " = "
         << cls.shared_pxd_class_in_pyx() << "(new " << cls.pxd_class_in_pyx()
-        << "(" << args.pyx_asParams() << "))\n";
+        << "(" << params << "))\n";
     pyxFile.oss << "        except (AssertionError, ValueError):\n";
     pyxFile.oss << "            pass\n";
   }
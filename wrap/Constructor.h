@@ -38,6 +38,18 @@ struct Constructor: public OverloadedFunction {
     verbose_ = verbose;
   }
 
+  /// Add an overload, which may release the GIL in Cython
+  void addOverload(const ArgumentList& args, bool nogil) {
+    push_back(args);
+    nogil_.resize(nrOverloads() - 1, false);
+    nogil_.push_back(nogil);
+  }
+
+  /// Whether the Cython wrapper of overload i releases the GIL
+  bool releasesGil(size_t i) const {
+    return i < nogil_.size() && nogil_[i];
+  }
+
   Constructor expandTemplate(const TemplateSubstitution& ts) const {
     Constructor inst = *this;
     inst.argLists_ = expandArgumentListsTemplate(ts);
@@ -94,6 +106,8 @@ struct Constructor: public OverloadedFunction {
     return os;
   }
 
+private:
+  std::vector<bool> nogil_; ///< per overload, see releasesGil
 };
 
 } // \namespace wrap
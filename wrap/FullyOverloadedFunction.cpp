@@ -10,6 +10,14 @@ const std::array<std::string, 2> FullyOverloadedFunction::pythonKeywords{
 std::string FullyOverloadedFunction::pyx_functionCall(
     const std::string& caller,
     const std::string& funcName, size_t iOverload) const {
+  return pyx_functionCall(caller, funcName, iOverload,
+                          argumentList(iOverload).pyx_asParams());
+}
+
+/* ************************************************************************* */
+std::string FullyOverloadedFunction::pyx_functionCall(
+    const std::string& caller, const std::string& funcName, size_t iOverload,
+    const std::string& params) const {
 
   string ret;
   if (!returnVals_[iOverload].isPair && !returnVals_[iOverload].type1.isPtr &&
@@ -22,7 +30,7 @@ std::string FullyOverloadedFunction::pyx_functionCall(
   ret += funcName;
   if (templateArgValue_) ret += "[" + templateArgValue_->pxd_class_in_pyx() + "]";
   //... with argument list
-  ret += "(" + argumentList(iOverload).pyx_asParams() + ")";
+  ret += "(" + params + ")";
 
   if (!returnVals_[iOverload].isPair && !returnVals_[iOverload].type1.isPtr &&
       returnVals_[iOverload].type1.isNonBasicType())
@@ -121,6 +121,10 @@ public:
   std::string pyx_functionCall(const std::string& caller, const std::string& funcName,
                         size_t iOverload) const;
 
+  // emit cython pyx function call with the given parameters, e.g., C locals
+  std::string pyx_functionCall(const std::string& caller, const std::string& funcName,
+                        size_t iOverload, const std::string& params) const;
+
   /// Cython: Rename functions which names are python keywords
   static const std::array<std::string, 2> pythonKeywords;
   static std::string pyRename(const std::string& name) {
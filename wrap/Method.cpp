@@ -32,10 +32,15 @@ using namespace wrap;
 bool Method::addOverload(Str name, const ArgumentList& args,
                          const ReturnValue& retVal, bool is_const,
                          boost::optional<const Qualified> instName,
-                         bool verbose) {
+                         bool verbose, bool nogil) {
   bool first = MethodBase::addOverload(name, args, retVal, instName, verbose);
-  if (first)
+  if (first) {
     is_const_ = is_const;
+    nogil_ = nogil;
+  } else if (nogil != nogil_)
+    throw std::runtime_error(
+        "Method::addOverload: all overloads of " + name +
+        " have to be designated nogil, or none");
   else if (is_const && !is_const_)
     throw std::runtime_error(
         "Method::addOverload now designated as const whereas before it was "
@@ -94,6 +99,7 @@ void Method::emit_cython_pxd(FileWriter& file, const Class& cls) const {
     argumentList(i).emit_cython_pxd(file, cls.pxdClassName(), cls.templateArgs);
     file.oss << ")";
     // if (is_const_) file.oss << " const";
+    if (nogil_) file.oss << " nogil";
     file.oss << " except +";
     file.oss << "\n";
   }
@@ -128,6 +134,10 @@ void Method::emit_cython_pyx_no_overload(FileWriter& file,
   /// Call cython corresponding function and return
   file.oss << argumentList(0).pyx_convertEigenTypeAndStorageOrder("        ");
   string caller = "self." + cls.shared_pxd_obj_in_pyx() + ".get()";
+  if (nogil_) {
+    emit_cython_pyx_nogil_call(file, caller, funcName, 0, "", "        ");
+    return;
+  }
   string ret = pyx_functionCall(caller, funcName, 0);
   if (!returnVals_[0].isVoid()) {
     file.oss << "        cdef " << returnVals_[0].pyx_returnType()
@@ -177,6 +187,12 @@ void Method::emit_cython_pyx(FileWriter& file, const Class& cls) const {
     }
   }
 
+  // C locals cannot be declared inside the try blocks
+  if (nogil_)
+    for (size_t i = 0; i < nrOverloads(); ++i)
+      file.oss << argumentList(i).pyx_declareCLocals("        ",
+                                                     "_" + to_string(i));
+
   for (size_t i = 0; i < nrOverloads(); ++i) {
     ArgumentList args = argumentList(i);
     file.oss << "        try:\n";
@@ -185,6 +201,25 @@ void Method::emit_cython_pyx(FileWriter& file, const Class& cls) const {
     /// Call corresponding cython function
     file.oss << args.pyx_convertEigenTypeAndStorageOrder("            ");
     string caller = "self." + cls.shared_pxd_obj_in_pyx() + ".get()";
+    if (nogil_) {
+      const string suffix = "_" + to_string(i);
+      file.oss << args.pyx_assignCLocals("            ", suffix);
+      file.oss << "            with nogil:\n";
+      string call = pyx_functionCall(caller, funcName, i,
+                                     args.pyx_cLocalsAsParams(suffix));
+      if (!returnVals_[i].isVoid()) {
+        const string value = return_value[return_type[i]];
+        file.oss << "                " << value << " = " << call << "\n";
+        file.oss << "            return "
+                 << returnVals_[i].pyx_casting(value) << "\n";
+      } else {
+        file.oss << "                " << call << "\n";
+        file.oss << "            return\n";
+      }
+      file.oss << "        except (AssertionError, ValueError):\n";
+      file.oss << "            pass\n";
+      continue;
+    }
     string call = pyx_functionCall(caller, funcName, i);
     if (!returnVals_[i].isVoid()) {
       const string type = return_type[i];
@@ -203,3 +238,29 @@ void Method::emit_cython_pyx(FileWriter& file, const Class& cls) const {
       << "        raise TypeError('Incorrect arguments or types for method call.')\n\n";
 }
 /* ************************************************************************* */
+
+/* ************************************************************************* */
+void Method::emit_cython_pyx_nogil_call(FileWriter& file, const string& caller,
+                                        const string& funcName, size_t i,
+                                        const string& suffix,
+                                        const string& indent) const {
+  const ArgumentList& args = argumentList(i);
+  for (size_t j = 0; j < args.size(); ++j)
+    file.oss << indent << "cdef " << args[j].pyx_cLocalType() << " "
+             << args[j].pyx_cLocalName(suffix) << " = "
+             << args[j].pyx_cLocalValue() << "\n";
+  const string call =
+      pyx_functionCall(caller, funcName, i, args.pyx_cLocalsAsParams(suffix));
+  if (!returnVals_[i].isVoid()) {
+    file.oss << indent << "cdef " << returnVals_[i].pyx_returnType()
+             << " ret\n";
+    file.oss << indent << "with nogil:\n";
+    file.oss << indent << "    ret = " << call << "\n";
+    file.oss << indent << "return " << returnVals_[i].pyx_casting("ret")
+             << "\n";
+  } else {
+    file.oss << indent << "with nogil:\n";
+    file.oss << indent << "    " << call << "\n";
+  }
+}
+/* ************************************************************************* */
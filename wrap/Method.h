@@ -27,6 +27,7 @@ class Method: public MethodBase {
 
 protected:
   bool is_const_;
+  bool nogil_;  ///< release the GIL around the call, in Cython
 
 public:
 
@@ -35,7 +36,7 @@ public:
   bool addOverload(Str name, const ArgumentList& args,
       const ReturnValue& retVal, bool is_const,
       boost::optional<const Qualified> instName = boost::none, bool verbose =
-          false);
+          false, bool nogil = false);
 
   virtual bool isStatic() const {
     return false;
@@ -45,8 +46,13 @@ public:
     return is_const_;
   }
 
+  /// Whether the Cython wrapper releases the GIL while calling the method
+  bool releasesGil() const {
+    return nogil_;
+  }
+
   bool isSameModifiers(const Method& other) const {
-      return is_const_ == other.is_const_ &&
+      return is_const_ == other.is_const_ && nogil_ == other.nogil_ &&
              ((templateArgValue_ && other.templateArgValue_) ||
               (!templateArgValue_ && !other.templateArgValue_));
   }
@@ -63,6 +69,12 @@ public:
 
 private:
 
+  // Cython: convert the arguments to C locals, then call without the GIL
+  void emit_cython_pyx_nogil_call(FileWriter& file, const std::string& caller,
+                                  const std::string& funcName, size_t i,
+                                  const std::string& suffix,
+                                  const std::string& indent) const;
+
   // Emit method header
   void proxy_header(FileWriter& proxyFile) const;
 
@@ -343,7 +343,7 @@ void Module::emit_cython_pxd(FileWriter& pxdFile) const {
                  "from libcpp cimport bool\n\n";
 
   // boost shared_ptr
-  pxdFile.oss << "cdef extern from \"boost/shared_ptr.hpp\" namespace \"boost\":\n"
+  pxdFile.oss << "cdef extern from \"boost/shared_ptr.hpp\" namespace \"boost\" nogil:\n"
                  "    cppclass shared_ptr[T]:\n"
                  "        shared_ptr()\n"
                  "        shared_ptr(T*)\n"
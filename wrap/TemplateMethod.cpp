@@ -29,19 +29,20 @@ void TemplateMethod::emit_cython_pxd(FileWriter& file, const Class& cls) const {
     returnVals_[i].emit_cython_pxd(file, cls.pxdClassName(), templateArgs);
     file.oss << name_ << "[" << argName << "]" << "(";
     argumentList(i).emit_cython_pxd(file, cls.pxdClassName(), templateArgs);
-    file.oss << ") except +\n";
+    file.oss << ")" << (nogil_ ? " nogil" : "") << " except +\n";
   }
 }
 
 /* ************************************************************************* */
 bool TemplateMethod::addOverload(Str name, const ArgumentList& args,
     const ReturnValue& retVal, bool is_const,
-    std::string _argName, bool verbose) {
+    std::string _argName, bool verbose, bool nogil) {
   argName = _argName;
   bool first = MethodBase::addOverload(name, args, retVal, boost::none, verbose);
-  if (first)
+  if (first) {
     is_const_ = is_const;
-  else if (is_const && !is_const_)
+    nogil_ = nogil;
+  } else if (is_const && !is_const_)
     throw std::runtime_error(
         "Method::addOverload now designated as const whereas before it was not");
   else if (!is_const && is_const_)
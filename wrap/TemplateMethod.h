@@ -28,7 +28,8 @@ struct TemplateMethod: public Method {
   void emit_cython_pxd(FileWriter& file, const Class& cls) const;
   bool addOverload(Str name, const ArgumentList& args,
                    const ReturnValue& retVal, bool is_const,
-                   std::string argName, bool verbose = false);
+                   std::string argName, bool verbose = false,
+                   bool nogil = false);
 
   friend std::ostream& operator<<(std::ostream& os, const TemplateMethod& m) {
     for (size_t i = 0; i < m.nrOverloads(); i++)
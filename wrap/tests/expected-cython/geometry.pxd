@@ -7,7 +7,7 @@ from libcpp.set cimport set
 from libcpp.map cimport map
 from libcpp cimport bool
 
-cdef extern from "boost/shared_ptr.hpp" namespace "boost":
+cdef extern from "boost/shared_ptr.hpp" namespace "boost" nogil:
     cppclass shared_ptr[T]:
         shared_ptr()
         shared_ptr(T*)
@@ -277,6 +277,47 @@ TEST( Class, Virtualness ) {
   EXPECT(parse(markup.c_str(), g, space_p).full);
   EXPECT(cls.isVirtual);
 }
+
+//******************************************************************************
+TEST( Class, Nogil ) {
+  using classic::space_p;
+  Class cls;
+  Template t;
+  ClassGrammar g(cls, t);
+  string markup(
+      string("class Solver {                        \n")
+          + string(" Solver(const Graph& graph) nogil;  \n")
+          + string(" Solver();                          \n")
+          + string(" Values optimize() const nogil;     \n")
+          + string(" double error(const Values& x) nogil;\n")
+          + string(" void print() const;                \n")
+          + string("};"));
+  EXPECT(parse(markup.c_str(), g, space_p).full);
+
+  EXPECT(cls.constructor.releasesGil(0));
+  EXPECT(!cls.constructor.releasesGil(1));
+  EXPECT(cls.method("optimize").isConst());
+  EXPECT(cls.method("optimize").releasesGil());
+  EXPECT(cls.method("error").releasesGil());
+  EXPECT(!cls.method("print").releasesGil());
+
+  // The arguments are converted before the GIL is released
+  FileWriter pyxFile("Solver.pyx", false, "#");
+  cls.emit_cython_pyx(pyxFile, vector<Class>());
+  const string pyx = pyxFile.oss.str();
+  EXPECT(pyx.find("cdef shared_ptr[CGraph] c_graph_0\n") != string::npos);
+  EXPECT(pyx.find("            c_graph_0 = graph.CGraph_\n"
+                  "            with nogil:\n"
+                  "                self.CSolver_ = shared_ptr[CSolver](new CSolver(deref(c_graph_0)))\n")
+         != string::npos);
+  EXPECT(pyx.find("        cdef shared_ptr[CValues] c_x = x.CValues_\n"
+                  "        cdef double ret\n"
+                  "        with nogil:\n"
+                  "            ret = self.CSolver_.get().error(deref(c_x))\n")
+         != string::npos);
+  EXPECT(pyx.find("self.CSolver_.get().print_") != string::npos);
+}
+
 //******************************************************************************
 int main() {
   TestResult tr;